@@ -0,0 +1,26 @@
+// Copyright (C) 2018 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#include "Benchmark.hpp"
+
+using namespace ouzel;
+
+Benchmark::Benchmark():
+    camera(Size2(800.0F, 600.0F), scene::Camera::ScaleMode::SHOW_ALL),
+    randomEngine(1)
+{
+    cameraActor.addComponent(&camera);
+    layer.addChild(&cameraActor);
+    addLayer(&layer);
+}
+
+Vector2 Benchmark::getRandomPosition()
+{
+    std::uniform_real_distribution<float> xDistribution(-400.0F, 400.0F);
+    std::uniform_real_distribution<float> yDistribution(-300.0F, 300.0F);
+
+    float x = xDistribution(randomEngine);
+    float y = yDistribution(randomEngine);
+
+    return Vector2(x, y);
+}
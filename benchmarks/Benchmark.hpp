@@ -0,0 +1,26 @@
+// Copyright (C) 2018 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#pragma once
+
+#include <random>
+
+// scene with a layer and a camera that shows an 800x600 area, the actors are placed with a fixed seed, so that the
+// runs are comparable
+class Benchmark: public ouzel::scene::Scene
+{
+public:
+    Benchmark();
+
+protected:
+    ouzel::Vector2 getRandomPosition();
+
+    ouzel::scene::Layer layer;
+    ouzel::scene::Camera camera;
+    ouzel::scene::Actor cameraActor;
+
+    ouzel::scene::UpdateCallback updateCallback;
+
+private:
+    std::mt19937 randomEngine;
+};
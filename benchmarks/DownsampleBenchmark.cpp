@@ -0,0 +1,48 @@
+// Copyright (C) 2018 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#include "DownsampleBenchmark.hpp"
+
+using namespace ouzel;
+
+DownsampleBenchmark::DownsampleBenchmark(uint32_t count, bool initVectorized):
+    size(count), vectorized(initVectorized)
+{
+    std::mt19937 randomEngine(1);
+    std::uniform_int_distribution<uint32_t> distribution(0, 255);
+
+    for (graphics::PixelFormat pixelFormat : {graphics::PixelFormat::RGBA8_UNORM,
+                                              graphics::PixelFormat::RG8_UNORM,
+                                              graphics::PixelFormat::R8_UNORM,
+                                              graphics::PixelFormat::A8_UNORM})
+    {
+        Image image;
+        image.pixelFormat = pixelFormat;
+
+        for (uint32_t levelSize = size; levelSize > 0; levelSize >>= 1)
+            image.levels.push_back(std::vector<uint8_t>(graphics::getLevelDataSize(pixelFormat, levelSize, levelSize)));
+
+        // random pixels, so that the transparent pixels are mixed with the opaque ones
+        for (uint8_t& value : image.levels.front())
+            value = static_cast<uint8_t>(distribution(randomEngine) < 64 ? 0 : distribution(randomEngine));
+
+        images.push_back(image);
+    }
+
+    updateCallback.callback = std::bind(&DownsampleBenchmark::update, this, std::placeholders::_1);
+    engine->getSceneManager()->scheduleUpdate(&updateCallback);
+}
+
+void DownsampleBenchmark::update(float)
+{
+    for (Image& image : images)
+    {
+        uint32_t levelSize = size;
+
+        for (size_t level = 1; level < image.levels.size(); ++level, levelSize >>= 1)
+            graphics::imageDownsample2x2(image.pixelFormat, levelSize, levelSize,
+                                         graphics::getPitch(image.pixelFormat, levelSize),
+                                         image.levels[level - 1].data(), image.levels[level].data(),
+                                         vectorized);
+    }
+}
@@ -0,0 +1,28 @@
+// Copyright (C) 2018 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#pragma once
+
+#include <vector>
+#include "Benchmark.hpp"
+
+// generates the mipmaps of square images of all the uncompressed pixel formats every frame, with either the
+// vectorized or the scalar downsampling kernels, the update time is the time of the kernels
+class DownsampleBenchmark: public Benchmark
+{
+public:
+    DownsampleBenchmark(uint32_t count, bool vectorized);
+
+private:
+    struct Image
+    {
+        ouzel::graphics::PixelFormat pixelFormat;
+        std::vector<std::vector<uint8_t>> levels;
+    };
+
+    void update(float delta);
+
+    uint32_t size;
+    bool vectorized;
+    std::vector<Image> images;
+};
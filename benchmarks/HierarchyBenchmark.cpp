@@ -0,0 +1,46 @@
+// Copyright (C) 2018 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#include "HierarchyBenchmark.hpp"
+
+using namespace ouzel;
+
+static const uint32_t CHAIN_DEPTH = 32;
+
+HierarchyBenchmark::HierarchyBenchmark(uint32_t count)
+{
+    for (uint32_t created = 0; created < count; created += CHAIN_DEPTH)
+    {
+        std::unique_ptr<scene::Actor> root(new scene::Actor());
+        root->setPosition(getRandomPosition());
+
+        scene::Actor* parent = root.get();
+        uint32_t depth = std::min(count - created, CHAIN_DEPTH);
+
+        for (uint32_t level = 0; level < depth; ++level)
+        {
+            std::unique_ptr<scene::Actor> child(new scene::Actor());
+            child->addComponent(std::unique_ptr<scene::Sprite>(new scene::Sprite("ball.png")));
+            child->setPosition(Vector2(4.0F, 0.0F));
+            child->setScale(Vector2(0.95F, 0.95F));
+
+            scene::Actor* childPointer = child.get();
+            parent->addChild(std::move(child));
+            parent = childPointer;
+        }
+
+        roots.push_back(root.get());
+        layer.addChild(std::move(root));
+    }
+
+    updateCallback.callback = std::bind(&HierarchyBenchmark::update, this, std::placeholders::_1);
+    engine->getSceneManager()->scheduleUpdate(&updateCallback);
+}
+
+void HierarchyBenchmark::update(float delta)
+{
+    rotation += delta;
+
+    for (scene::Actor* root : roots)
+        root->setRotation(rotation);
+}
@@ -0,0 +1,20 @@
+// Copyright (C) 2018 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#pragma once
+
+#include <vector>
+#include "Benchmark.hpp"
+
+// chains of nested sprites whose roots rotate, so that all the world transforms change every frame
+class HierarchyBenchmark: public Benchmark
+{
+public:
+    explicit HierarchyBenchmark(uint32_t count);
+
+private:
+    void update(float delta);
+
+    std::vector<ouzel::scene::Actor*> roots;
+    float rotation = 0.0F;
+};
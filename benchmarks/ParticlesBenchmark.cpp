@@ -0,0 +1,28 @@
+// Copyright (C) 2018 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#include "ParticlesBenchmark.hpp"
+
+using namespace ouzel;
+
+static const uint32_t MAX_EMITTER_PARTICLES = 1000;
+
+ParticlesBenchmark::ParticlesBenchmark(uint32_t count, bool gpuSimulation)
+{
+    scene::ParticleSystemData particleSystemData = engine->getCache()->getParticleSystemData("flame.json");
+
+    for (uint32_t emitted = 0; emitted < count; emitted += MAX_EMITTER_PARTICLES)
+    {
+        particleSystemData.maxParticles = std::min(count - emitted, MAX_EMITTER_PARTICLES);
+        particleSystemData.emissionRate = static_cast<float>(particleSystemData.maxParticles) / particleSystemData.particleLifespan;
+
+        std::unique_ptr<scene::ParticleSystem> particleSystem(new scene::ParticleSystem());
+        particleSystem->setGPUSimulation(gpuSimulation);
+        particleSystem->init(particleSystemData);
+
+        std::unique_ptr<scene::Actor> actor(new scene::Actor());
+        actor->addComponent(std::move(particleSystem));
+        actor->setPosition(getRandomPosition());
+        layer.addChild(std::move(actor));
+    }
+}
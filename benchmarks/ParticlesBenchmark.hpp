@@ -0,0 +1,14 @@
+// Copyright (C) 2018 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#pragma once
+
+#include "Benchmark.hpp"
+
+// particle systems that keep the given number of particles alive in total, simulated either on the CPU or in the
+// vertex shader
+class ParticlesBenchmark: public Benchmark
+{
+public:
+    explicit ParticlesBenchmark(uint32_t count, bool gpuSimulation = false);
+};
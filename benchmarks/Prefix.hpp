@@ -0,0 +1,4 @@
+// Copyright (C) 2018 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#include "ouzel.hpp"
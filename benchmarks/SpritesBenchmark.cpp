@@ -0,0 +1,31 @@
+// Copyright (C) 2018 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#include "SpritesBenchmark.hpp"
+
+using namespace ouzel;
+
+SpritesBenchmark::SpritesBenchmark(uint32_t count)
+{
+    actors.reserve(count);
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        std::unique_ptr<scene::Actor> actor(new scene::Actor());
+        actor->addComponent(std::unique_ptr<scene::Sprite>(new scene::Sprite("witch.png")));
+        actor->setPosition(getRandomPosition());
+        actors.push_back(actor.get());
+        layer.addChild(std::move(actor));
+    }
+
+    updateCallback.callback = std::bind(&SpritesBenchmark::update, this, std::placeholders::_1);
+    engine->getSceneManager()->scheduleUpdate(&updateCallback);
+}
+
+void SpritesBenchmark::update(float delta)
+{
+    rotation += delta;
+
+    for (scene::Actor* actor : actors)
+        actor->setRotation(rotation);
+}
@@ -0,0 +1,20 @@
+// Copyright (C) 2018 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#pragma once
+
+#include <vector>
+#include "Benchmark.hpp"
+
+// rotating sprites that share one texture
+class SpritesBenchmark: public Benchmark
+{
+public:
+    explicit SpritesBenchmark(uint32_t count);
+
+private:
+    void update(float delta);
+
+    std::vector<ouzel::scene::Actor*> actors;
+    float rotation = 0.0F;
+};
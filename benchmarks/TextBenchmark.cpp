@@ -0,0 +1,34 @@
+// Copyright (C) 2018 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#include "TextBenchmark.hpp"
+
+using namespace ouzel;
+
+TextBenchmark::TextBenchmark(uint32_t count)
+{
+    textRenderers.reserve(count);
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        std::unique_ptr<scene::TextRenderer> textRenderer(new scene::TextRenderer("AmosisTechnik.ttf", true, 16.0F,
+                                                                                  "Label " + std::to_string(i)));
+        textRenderers.push_back(textRenderer.get());
+
+        std::unique_ptr<scene::Actor> actor(new scene::Actor());
+        actor->addComponent(std::move(textRenderer));
+        actor->setPosition(getRandomPosition());
+        layer.addChild(std::move(actor));
+    }
+
+    updateCallback.callback = std::bind(&TextBenchmark::update, this, std::placeholders::_1);
+    engine->getSceneManager()->scheduleUpdate(&updateCallback);
+}
+
+void TextBenchmark::update(float)
+{
+    ++frame;
+
+    for (size_t i = 0; i < textRenderers.size(); ++i)
+        textRenderers[i]->setText("Label " + std::to_string(i) + "\n" + std::to_string(frame));
+}
@@ -0,0 +1,20 @@
+// Copyright (C) 2018 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#pragma once
+
+#include <vector>
+#include "Benchmark.hpp"
+
+// text labels with a static line and a line that changes every frame
+class TextBenchmark: public Benchmark
+{
+public:
+    explicit TextBenchmark(uint32_t count);
+
+private:
+    void update(float delta);
+
+    std::vector<ouzel::scene::TextRenderer*> textRenderers;
+    uint32_t frame = 0;
+};
@@ -0,0 +1,190 @@
+// Copyright (C) 2018 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include "core/EngineHeadless.hpp"
+#include "graphics/RenderDevice.hpp"
+#include "DownsampleBenchmark.hpp"
+#include "HierarchyBenchmark.hpp"
+#include "ParticlesBenchmark.hpp"
+#include "SpritesBenchmark.hpp"
+#include "TextBenchmark.hpp"
+
+std::string DEVELOPER_NAME = "org.ouzel";
+std::string APPLICATION_NAME = "benchmarks";
+
+using namespace ouzel;
+
+struct BenchmarkInfo
+{
+    std::string name;
+    uint32_t defaultCount;
+    std::function<scene::Scene*(uint32_t)> create;
+};
+
+static const uint32_t WARMUP_FRAME_COUNT = 30;
+
+// times (in milliseconds) of a phase over all the measured frames
+static json::Value getPhaseStatistics(std::vector<float> times)
+{
+    json::Value result = json::Value::Type::OBJECT;
+
+    if (times.empty()) return result;
+
+    std::sort(times.begin(), times.end());
+
+    float sum = 0.0F;
+    for (float time : times) sum += time;
+
+    result["mean"] = sum * 1000.0F / static_cast<float>(times.size());
+    result["min"] = times.front() * 1000.0F;
+    result["median"] = times[times.size() / 2] * 1000.0F;
+    result["p95"] = times[(times.size() * 95) / 100] * 1000.0F;
+    result["max"] = times.back() * 1000.0F;
+
+    return result;
+}
+
+int main(int argc, char* argv[])
+{
+    // only the results are written to the standard output
+    Log::threshold = Log::Level::WARN;
+
+    try
+    {
+        EngineHeadless engine(argc, argv);
+        engine.run();
+        return EXIT_SUCCESS;
+    }
+    catch (const std::exception& e)
+    {
+        Log(Log::Level::ERR) << e.what();
+        return EXIT_FAILURE;
+    }
+    catch (...)
+    {
+        Log(Log::Level::ERR) << "Unknown error occurred";
+        return EXIT_FAILURE;
+    }
+}
+
+void ouzelMain(const std::vector<std::string>& args)
+{
+    EngineHeadless* headlessEngine = static_cast<EngineHeadless*>(engine);
+
+    std::string benchmarkName;
+    std::string output;
+    std::string trace;
+    uint32_t frameCount = 300;
+    uint32_t count = 0; // the default count of each benchmark if zero
+
+    for (auto arg = args.begin(); arg != args.end(); ++arg)
+    {
+        if (arg == args.begin())
+        {
+            // skip the first parameter
+            continue;
+        }
+
+        auto nextArg = arg + 1;
+
+        if (nextArg == args.end())
+            ouzel::Log(ouzel::Log::Level::WARN) << "No value specified for \"" << *arg << "\"";
+        else if (*arg == "-benchmark")
+            benchmarkName = *++arg;
+        else if (*arg == "-frames")
+            frameCount = static_cast<uint32_t>(std::stoul(*++arg));
+        else if (*arg == "-count")
+            count = static_cast<uint32_t>(std::stoul(*++arg));
+        else if (*arg == "-output")
+            output = *++arg;
+        else if (*arg == "-trace")
+            trace = *++arg;
+        else
+            ouzel::Log(ouzel::Log::Level::WARN) << "Invalid argument \"" << *arg << "\"";
+    }
+
+    engine->getFileSystem()->addResourcePath("Resources");
+    engine->getFileSystem()->addResourcePath("../samples/Resources");
+
+    std::vector<BenchmarkInfo> benchmarks = {
+        {"sprites", 10000, [](uint32_t c) { return new SpritesBenchmark(c); }},
+        {"particles", 10000, [](uint32_t c) { return new ParticlesBenchmark(c); }},
+        {"particles100k", 100000, [](uint32_t c) { return new ParticlesBenchmark(c); }},
+        {"particlesGPU100k", 100000, [](uint32_t c) { return new ParticlesBenchmark(c, true); }},
+        {"text", 1000, [](uint32_t c) { return new TextBenchmark(c); }},
+        {"hierarchy", 10000, [](uint32_t c) { return new HierarchyBenchmark(c); }},
+        {"downsample", 1024, [](uint32_t c) { return new DownsampleBenchmark(c, true); }},
+        {"downsampleScalar", 1024, [](uint32_t c) { return new DownsampleBenchmark(c, false); }}
+    };
+
+    json::Data result;
+    result["frames"] = frameCount;
+    json::Value& results = result["benchmarks"];
+    results = json::Value::Type::ARRAY;
+
+    for (const BenchmarkInfo& benchmark : benchmarks)
+    {
+        if (!benchmarkName.empty() && benchmark.name != benchmarkName) continue;
+
+        uint32_t benchmarkCount = count ? count : benchmark.defaultCount;
+
+        std::unique_ptr<scene::Scene> scene(benchmark.create(benchmarkCount));
+        engine->getSceneManager()->setScene(scene.get());
+
+        for (uint32_t frame = 0; frame < WARMUP_FRAME_COUNT; ++frame)
+            headlessEngine->step();
+
+        // only the measured frames are captured
+        if (!trace.empty()) Profiler::setEnabled(true);
+
+        std::vector<float> updateTimes;
+        std::vector<float> visitTimes;
+        std::vector<float> drawTimes;
+        std::vector<float> processTimes;
+        std::vector<float> frameTimes;
+        uint32_t drawCallCount = 0;
+
+        for (uint32_t frame = 0; frame < frameCount; ++frame)
+        {
+            headlessEngine->step();
+
+            const EngineHeadless::FrameTimings& frameTimings = headlessEngine->getFrameTimings();
+            updateTimes.push_back(frameTimings.update);
+            visitTimes.push_back(frameTimings.visit);
+            drawTimes.push_back(frameTimings.draw);
+            processTimes.push_back(frameTimings.process);
+            frameTimes.push_back(frameTimings.update + frameTimings.draw + frameTimings.process);
+            drawCallCount = engine->getRenderer()->getDevice()->getFrameStatistics().drawCallCount;
+        }
+
+        Profiler::setEnabled(false);
+
+        engine->getSceneManager()->removeScene(scene.get());
+
+        json::Value benchmarkResult = json::Value::Type::OBJECT;
+        benchmarkResult["name"] = benchmark.name;
+        benchmarkResult["count"] = benchmarkCount;
+        benchmarkResult["drawCalls"] = drawCallCount;
+        benchmarkResult["update"] = getPhaseStatistics(updateTimes);
+        benchmarkResult["visit"] = getPhaseStatistics(visitTimes);
+        benchmarkResult["draw"] = getPhaseStatistics(drawTimes);
+        benchmarkResult["process"] = getPhaseStatistics(processTimes);
+        benchmarkResult["frame"] = getPhaseStatistics(frameTimes);
+        results.asArray().push_back(benchmarkResult);
+    }
+
+    std::vector<uint8_t> data = result.encode();
+
+    if (output.empty())
+        std::cout << std::string(data.begin(), data.end()) << std::endl;
+    else
+        engine->getFileSystem()->writeFile(output, data);
+
+    if (!trace.empty())
+        engine->getFileSystem()->writeFile(trace, Profiler::exportChromeTrace());
+
+    engine->exit();
+}
@@ -30,8 +30,10 @@ LOCAL_SRC_FILES :=../../ouzel/animators/Animator.cpp \
     ../../ouzel/assets/Loader.cpp \
     ../../ouzel/assets/LoaderBMF.cpp \
     ../../ouzel/assets/LoaderCollada.cpp \
+    ../../ouzel/assets/LoaderDDS.cpp \
 	../../ouzel/assets/LoaderGLTF.cpp \
     ../../ouzel/assets/LoaderImage.cpp \
+    ../../ouzel/assets/LoaderKTX.cpp \
     ../../ouzel/assets/LoaderMTL.cpp \
     ../../ouzel/assets/LoaderOBJ.cpp \
     ../../ouzel/assets/LoaderParticleSystem.cpp \
@@ -58,6 +60,7 @@ LOCAL_SRC_FILES :=../../ouzel/animators/Animator.cpp \
     ../../ouzel/core/android/main.cpp \
     ../../ouzel/core/android/NativeWindowAndroid.cpp \
     ../../ouzel/core/Engine.cpp \
+    ../../ouzel/core/EngineHeadless.cpp \
 	../../ouzel/core/NativeWindow.cpp \
     ../../ouzel/core/Timer.cpp \
     ../../ouzel/core/Window.cpp \
@@ -79,12 +82,16 @@ LOCAL_SRC_FILES :=../../ouzel/animators/Animator.cpp \
 	../../ouzel/graphics/opengl/RenderTargetResourceOGL.cpp \
     ../../ouzel/graphics/opengl/ShaderResourceOGL.cpp \
     ../../ouzel/graphics/opengl/TextureResourceOGL.cpp \
+    ../../ouzel/graphics/AtlasPacker.cpp \
     ../../ouzel/graphics/BlendState.cpp \
     ../../ouzel/graphics/BlendStateResource.cpp \
     ../../ouzel/graphics/Buffer.cpp \
     ../../ouzel/graphics/BufferResource.cpp \
     ../../ouzel/graphics/ImageData.cpp \
+    ../../ouzel/graphics/ImageDataDDS.cpp \
+    ../../ouzel/graphics/ImageDataKTX.cpp \
     ../../ouzel/graphics/ImageDataSTB.cpp \
+    ../../ouzel/graphics/ImageDownsample.cpp \
     ../../ouzel/graphics/Material.cpp \
     ../../ouzel/graphics/Renderer.cpp \
     ../../ouzel/graphics/RenderDevice.cpp \
@@ -93,7 +100,9 @@ LOCAL_SRC_FILES :=../../ouzel/animators/Animator.cpp \
     ../../ouzel/graphics/Shader.cpp \
     ../../ouzel/graphics/ShaderResource.cpp \
     ../../ouzel/graphics/Texture.cpp \
+    ../../ouzel/graphics/TextureAtlas.cpp \
     ../../ouzel/graphics/TextureResource.cpp \
+    ../../ouzel/graphics/TextureStreamer.cpp \
     ../../ouzel/graphics/Vertex.cpp \
     ../../ouzel/gui/BMFont.cpp \
     ../../ouzel/gui/TTFont.cpp \
@@ -147,17 +156,22 @@ LOCAL_SRC_FILES :=../../ouzel/animators/Animator.cpp \
     ../../ouzel/scene/Scene.cpp \
     ../../ouzel/scene/SceneManager.cpp \
     ../../ouzel/scene/ShapeRenderer.cpp \
+    ../../ouzel/scene/SpatialIndex.cpp \
     ../../ouzel/scene/Sprite.cpp \
+    ../../ouzel/scene/SpriteBatch.cpp \
     ../../ouzel/scene/SpriteData.cpp \
     ../../ouzel/scene/TextRenderer.cpp \
+    ../../ouzel/scene/TransformSystem.cpp \
 	../../ouzel/scene/UpdateCallback.cpp \
     ../../ouzel/thread/Condition.cpp \
+    ../../ouzel/thread/JobSystem.cpp \
     ../../ouzel/thread/Mutex.cpp \
     ../../ouzel/thread/Thread.cpp \
     ../../ouzel/utils/INI.cpp \
     ../../ouzel/utils/JSON.cpp \
     ../../ouzel/utils/Log.cpp \
     ../../ouzel/utils/OBF.cpp \
+    ../../ouzel/utils/Profiler.cpp \
     ../../ouzel/utils/Utils.cpp \
     ../../ouzel/utils/XML.cpp
 
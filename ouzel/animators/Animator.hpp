@@ -30,6 +30,10 @@ namespace ouzel
             bool isRunning() const { return running; }
             bool isDone() const { return done; }
 
+            // runs the update on the job system, only for animators whose target actors are not touched by other updates
+            inline bool isParallelUpdate() const { return updateCallback.parallel; }
+            inline void setParallelUpdate(bool newParallelUpdate) { updateCallback.parallel = newParallelUpdate; }
+
             inline float getLength() const { return length; }
             inline float getCurrentTime() const { return currentTime; }
 
@@ -4,6 +4,8 @@
 #include <algorithm>
 #include "Cache.hpp"
 #include "Loader.hpp"
+#include "core/Engine.hpp"
+#include "graphics/ImageDataSTB.hpp"
 #include "graphics/Renderer.hpp"
 #include "graphics/TextureResource.hpp"
 #include "graphics/ShaderResource.hpp"
@@ -14,23 +16,30 @@
 #include "audio/SoundDataVorbis.hpp"
 #include "gui/BMFont.hpp"
 #include "gui/TTFont.hpp"
+#include "thread/Lock.hpp"
 #include "utils/Errors.hpp"
+#include "utils/Profiler.hpp"
 
 namespace ouzel
 {
     namespace assets
     {
         Cache::Cache(FileSystem& initFileSystem):
-            fileSystem(initFileSystem)
+            fileSystem(initFileSystem),
+            loaderTTFDistanceField(true)
         {
             addLoader(&loaderBMF);
             addLoader(&loaderCollada);
+            addLoader(&loaderDDS);
             addLoader(&loaderGLTF);
             addLoader(&loaderImage);
+            addLoader(&loaderKTX);
             addLoader(&loaderMTL);
             addLoader(&loaderOBJ);
             addLoader(&loaderParticleSystem);
             addLoader(&loaderSprite);
+            // added before the bitmap font loader, so that the assets loaded by the extension are bitmap fonts
+            addLoader(&loaderTTFDistanceField);
             addLoader(&loaderTTF);
             addLoader(&loaderVorbis);
             addLoader(&loaderWave);
@@ -77,6 +86,8 @@ namespace ouzel
 
         void Cache::loadAsset(uint32_t loaderType, const std::string& filename, bool mipmaps) const
         {
+            ProfilerZone zone("Cache::loadAsset");
+
             std::vector<uint8_t> data = fileSystem.readFile(filename);
 
             std::string extension = fileSystem.getExtensionPart(filename);
@@ -97,6 +108,8 @@ namespace ouzel
 
         void Cache::loadAsset(const std::string& filename, bool mipmaps) const
         {
+            ProfilerZone zone("Cache::loadAsset");
+
             std::vector<uint8_t> data = fileSystem.readFile(filename);
 
             std::string extension = fileSystem.getExtensionPart(filename);
@@ -181,7 +194,11 @@ namespace ouzel
             {
                 // don't delete default shaders
                 if (i->first == graphics::SHADER_COLOR ||
-                    i->first == graphics::SHADER_TEXTURE)
+                    i->first == graphics::SHADER_TEXTURE ||
+                    i->first == graphics::SHADER_PARTICLE ||
+                    i->first == graphics::SHADER_INSTANCED ||
+                    i->first == graphics::SHADER_TEXT ||
+                    i->first == graphics::SHADER_SDF)
                     ++i;
                 else
                     i = shaders.erase(i);
@@ -221,46 +238,30 @@ namespace ouzel
             }
         }
 
+        bool Cache::isImage(const std::string& filename) const
+        {
+            std::string extension = fileSystem.getExtensionPart(filename);
+
+            for (const Loader* loader : loaders)
+            {
+                if (loader->getType() == Loader::IMAGE &&
+                    std::find(loader->extensions.begin(), loader->extensions.end(), extension) != loader->extensions.end())
+                    return true;
+            }
+
+            return false;
+        }
+
         void Cache::preloadSpriteData(const std::string& filename, bool mipmaps,
                                       uint32_t spritesX, uint32_t spritesY,
                                       const Vector2& pivot)
         {
-            if (std::find(loaderImage.extensions.begin(), loaderImage.extensions.end(),
-                          fileSystem.getExtensionPart(filename)) != loaderImage.extensions.end())
+            if (isImage(filename))
             {
                 scene::SpriteData newSpriteData;
 
-                if (spritesX == 0) spritesX = 1;
-                if (spritesY == 0) spritesY = 1;
-
-                newSpriteData.texture = getTexture(filename, mipmaps);
-
-                if (newSpriteData.texture)
-                {
-                    Size2 spriteSize = Size2(newSpriteData.texture->getSize().width / spritesX,
-                                             newSpriteData.texture->getSize().height / spritesY);
-
-                    scene::SpriteData::Animation animation;
-                    animation.frames.reserve(spritesX * spritesY);
-
-                    for (uint32_t x = 0; x < spritesX; ++x)
-                    {
-                        for (uint32_t y = 0; y < spritesY; ++y)
-                        {
-                            Rect rectangle(spriteSize.width * x,
-                                           spriteSize.height * y,
-                                           spriteSize.width,
-                                           spriteSize.height);
-
-                            scene::SpriteData::Frame frame = scene::SpriteData::Frame(filename, newSpriteData.texture->getSize(), rectangle, false, spriteSize, Vector2(), pivot);
-                            animation.frames.push_back(frame);
-                        }
-                    }
-
-                    newSpriteData.animations[""] = std::move(animation);
-
+                if (createImageSpriteData(filename, mipmaps, spritesX, spritesY, pivot, newSpriteData))
                     spriteData[filename] = newSpriteData;
-                }
             }
             else
                 loadAsset(Loader::SPRITE, filename, mipmaps);
@@ -276,40 +277,10 @@ namespace ouzel
                 return i->second;
             else
             {
-                if (std::find(loaderImage.extensions.begin(), loaderImage.extensions.end(),
-                              fileSystem.getExtensionPart(filename)) != loaderImage.extensions.end())
+                if (isImage(filename))
                 {
                     scene::SpriteData newSpriteData;
-
-                    if (spritesX == 0) spritesX = 1;
-                    if (spritesY == 0) spritesY = 1;
-
-                    newSpriteData.texture = getTexture(filename, mipmaps);
-
-                    if (newSpriteData.texture)
-                    {
-                        scene::SpriteData::Animation animation;
-                        animation.frames.reserve(spritesX * spritesY);
-
-                        Size2 spriteSize = Size2(newSpriteData.texture->getSize().width / spritesX,
-                                                 newSpriteData.texture->getSize().height / spritesY);
-
-                        for (uint32_t x = 0; x < spritesX; ++x)
-                        {
-                            for (uint32_t y = 0; y < spritesY; ++y)
-                            {
-                                Rect rectangle(spriteSize.width * x,
-                                               spriteSize.height * y,
-                                               spriteSize.width,
-                                               spriteSize.height);
-
-                                scene::SpriteData::Frame frame = scene::SpriteData::Frame(filename, newSpriteData.texture->getSize(), rectangle, false, spriteSize, Vector2(), pivot);
-                                animation.frames.push_back(frame);
-                            }
-                        }
-
-                        newSpriteData.animations[""] = std::move(animation);
-                    }
+                    createImageSpriteData(filename, mipmaps, spritesX, spritesY, pivot, newSpriteData);
 
                     i = spriteData.insert(std::make_pair(filename, newSpriteData)).first;
                 }
@@ -338,6 +309,97 @@ namespace ouzel
         void Cache::releaseSpriteData()
         {
             spriteData.clear();
+
+            Lock lock(spriteAtlasMutex);
+            if (spriteAtlas) spriteAtlas->clear();
+        }
+
+        void Cache::releaseSpriteData(const std::string& filename)
+        {
+            spriteData.erase(filename);
+
+            Lock lock(spriteAtlasMutex);
+            if (spriteAtlas) spriteAtlas->removeImage(filename);
+        }
+
+        void Cache::setSpriteAtlasEnabled(bool enabled)
+        {
+            spriteAtlasEnabled = enabled;
+        }
+
+        void Cache::uploadSpriteAtlas()
+        {
+            Lock lock(spriteAtlasMutex);
+            if (spriteAtlas) spriteAtlas->upload();
+        }
+
+        bool Cache::createImageSpriteData(const std::string& filename, bool mipmaps,
+                                          uint32_t spritesX, uint32_t spritesY,
+                                          const Vector2& pivot,
+                                          scene::SpriteData& newSpriteData) const
+        {
+            if (spritesX == 0) spritesX = 1;
+            if (spritesY == 0) spritesY = 1;
+
+            Rect imageRectangle;
+
+            // only the images decoded by LoaderImage can be packed (compressed images are kept in separate textures)
+            if (spriteAtlasEnabled &&
+                std::find(loaderImage.extensions.begin(), loaderImage.extensions.end(),
+                          fileSystem.getExtensionPart(filename)) != loaderImage.extensions.end())
+            {
+                Lock lock(spriteAtlasMutex);
+
+                if (!spriteAtlas)
+                    spriteAtlas.reset(new graphics::TextureAtlas(engine->getRenderer()));
+
+                if (!spriteAtlas->hasImage(filename))
+                {
+                    graphics::ImageDataSTB image(fileSystem.readFile(filename));
+                    spriteAtlas->addImage(filename, image, mipmaps);
+                }
+
+                if (spriteAtlas->hasImage(filename))
+                {
+                    const graphics::TextureAtlas::Region& region = spriteAtlas->getRegion(filename);
+                    newSpriteData.texture = region.texture;
+                    imageRectangle = region.rectangle;
+                }
+            }
+
+            // images that are too large for the atlas get their own texture
+            if (!newSpriteData.texture)
+            {
+                newSpriteData.texture = getTexture(filename, mipmaps);
+
+                if (!newSpriteData.texture) return false;
+
+                imageRectangle = Rect(Vector2(), newSpriteData.texture->getSize());
+            }
+
+            Size2 spriteSize = Size2(imageRectangle.size.width / spritesX,
+                                     imageRectangle.size.height / spritesY);
+
+            scene::SpriteData::Animation animation;
+            animation.frames.reserve(spritesX * spritesY);
+
+            for (uint32_t x = 0; x < spritesX; ++x)
+            {
+                for (uint32_t y = 0; y < spritesY; ++y)
+                {
+                    Rect rectangle(imageRectangle.position.x + spriteSize.width * x,
+                                   imageRectangle.position.y + spriteSize.height * y,
+                                   spriteSize.width,
+                                   spriteSize.height);
+
+                    scene::SpriteData::Frame frame = scene::SpriteData::Frame(filename, newSpriteData.texture->getSize(), rectangle, false, spriteSize, Vector2(), pivot);
+                    animation.frames.push_back(frame);
+                }
+            }
+
+            newSpriteData.animations[""] = std::move(animation);
+
+            return true;
         }
 
         const scene::ParticleSystemData& Cache::getParticleSystemData(const std::string& filename, bool mipmaps) const
@@ -370,20 +432,22 @@ namespace ouzel
             particleSystemData.clear();
         }
 
-        const std::shared_ptr<Font>& Cache::getFont(const std::string& filename, bool mipmaps) const
+        const std::shared_ptr<Font>& Cache::getFont(const std::string& filename, bool mipmaps, bool distanceField) const
         {
-            auto i = fonts.find(filename);
+            std::map<std::string, std::shared_ptr<Font>>& fontMap = distanceField ? distanceFieldFonts : fonts;
 
-            if (i == fonts.end())
+            auto i = fontMap.find(filename);
+
+            if (i == fontMap.end())
             {
-                loadAsset(Loader::FONT, filename, mipmaps);
+                loadAsset(distanceField ? Loader::DISTANCE_FIELD_FONT : Loader::FONT, filename, mipmaps);
 
-                i = fonts.find(filename);
+                i = fontMap.find(filename);
 
-                if (i == fonts.end())
+                if (i == fontMap.end())
                 {
                     std::shared_ptr<Font> result;
-                    i = fonts.insert(std::make_pair(filename, result)).first;
+                    i = fontMap.insert(std::make_pair(filename, result)).first;
                 }
             }
 
@@ -395,9 +459,15 @@ namespace ouzel
             fonts[filename] = font;
         }
 
+        void Cache::setDistanceFieldFont(const std::string& filename, const std::shared_ptr<Font>& font)
+        {
+            distanceFieldFonts[filename] = font;
+        }
+
         void Cache::releaseFonts()
         {
             fonts.clear();
+            distanceFieldFonts.clear();
         }
 
         const std::shared_ptr<audio::SoundData>& Cache::getSoundData(const std::string& filename) const
@@ -7,8 +7,10 @@
 #include <map>
 #include "assets/LoaderBMF.hpp"
 #include "assets/LoaderCollada.hpp"
+#include "assets/LoaderDDS.hpp"
 #include "assets/LoaderGLTF.hpp"
 #include "assets/LoaderImage.hpp"
+#include "assets/LoaderKTX.hpp"
 #include "assets/LoaderMTL.hpp"
 #include "assets/LoaderOBJ.hpp"
 #include "assets/LoaderParticleSystem.hpp"
@@ -22,10 +24,12 @@
 #include "graphics/Material.hpp"
 #include "graphics/Shader.hpp"
 #include "graphics/Texture.hpp"
+#include "graphics/TextureAtlas.hpp"
 #include "gui/Font.hpp"
 #include "scene/MeshData.hpp"
 #include "scene/SpriteData.hpp"
 #include "scene/ParticleSystemData.hpp"
+#include "thread/Mutex.hpp"
 
 namespace ouzel
 {
@@ -72,13 +76,24 @@ namespace ouzel
                                                    const Vector2& pivot = Vector2(0.5F, 0.5F)) const;
             void setSpriteData(const std::string& filename, const scene::SpriteData& newSpriteData);
             void releaseSpriteData();
+            // the atlas space of the sprite is reused, so sprites still using the data must be removed first
+            void releaseSpriteData(const std::string& filename);
+
+            // packs the images loaded as sprites into shared atlas pages instead of separate textures
+            void setSpriteAtlasEnabled(bool enabled);
+            inline bool isSpriteAtlasEnabled() const { return spriteAtlasEnabled; }
+            inline graphics::TextureAtlas* getSpriteAtlas() const { return spriteAtlas.get(); }
+            // uploads the atlas pages modified since the last upload (called by the engine before drawing)
+            void uploadSpriteAtlas();
 
             const scene::ParticleSystemData& getParticleSystemData(const std::string& filename, bool mipmaps = true) const;
             void setParticleSystemData(const std::string& filename, const scene::ParticleSystemData& newParticleSystemData);
             void releaseParticleSystemData();
 
-            const std::shared_ptr<Font>& getFont(const std::string& filename, bool mipmaps = true) const;
+            // the distance field fonts are cached separately from the bitmap fonts of the same file
+            const std::shared_ptr<Font>& getFont(const std::string& filename, bool mipmaps = true, bool distanceField = false) const;
             void setFont(const std::string& filename, const std::shared_ptr<Font>& font);
+            void setDistanceFieldFont(const std::string& filename, const std::shared_ptr<Font>& font);
             void releaseFonts();
 
             const std::shared_ptr<audio::SoundData>& getSoundData(const std::string& filename) const;
@@ -94,17 +109,28 @@ namespace ouzel
             void releaseMeshData();
 
         private:
+            // whether the file can be loaded by one of the image loaders
+            bool isImage(const std::string& filename) const;
+            // creates the sprite data of an image sliced into a grid of frames
+            bool createImageSpriteData(const std::string& filename, bool mipmaps,
+                                       uint32_t spritesX, uint32_t spritesY,
+                                       const Vector2& pivot,
+                                       scene::SpriteData& newSpriteData) const;
+
             FileSystem& fileSystem;
 
             LoaderBMF loaderBMF;
             LoaderCollada loaderCollada;
+            LoaderDDS loaderDDS;
             LoaderGLTF loaderGLTF;
             LoaderImage loaderImage;
+            LoaderKTX loaderKTX;
             LoaderMTL loaderMTL;
             LoaderOBJ loaderOBJ;
             LoaderParticleSystem loaderParticleSystem;
             LoaderSprite loaderSprite;
             LoaderTTF loaderTTF;
+            LoaderTTF loaderTTFDistanceField;
             LoaderVorbis loaderVorbis;
             LoaderWave loaderWave;
             std::vector<Loader*> loaders;
@@ -113,7 +139,12 @@ namespace ouzel
             mutable std::map<std::string, scene::ParticleSystemData> particleSystemData;
             mutable std::map<std::string, std::shared_ptr<graphics::BlendState>> blendStates;
             mutable std::map<std::string, scene::SpriteData> spriteData;
+            bool spriteAtlasEnabled = false;
+            // the sprites of the layers recorded in parallel can be added to the atlas
+            mutable Mutex spriteAtlasMutex;
+            mutable std::unique_ptr<graphics::TextureAtlas> spriteAtlas;
             mutable std::map<std::string, std::shared_ptr<Font>> fonts;
+            mutable std::map<std::string, std::shared_ptr<Font>> distanceFieldFonts;
             mutable std::map<std::string, std::shared_ptr<audio::SoundData>> soundData;
             mutable std::map<std::string, std::shared_ptr<graphics::Material>> materials;
             mutable std::map<std::string, scene::MeshData> meshData;
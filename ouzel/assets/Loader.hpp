@@ -19,6 +19,7 @@ namespace ouzel
             {
                 NONE,
                 FONT,
+                DISTANCE_FIELD_FONT,
                 MESH,
                 SKINNED_MESH,
                 IMAGE,
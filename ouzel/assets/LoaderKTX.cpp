@@ -0,0 +1,40 @@
+// Copyright 2015-2018 Elviss Strazdins. All rights reserved.
+
+#include "LoaderKTX.hpp"
+#include "Cache.hpp"
+#include "core/Engine.hpp"
+#include "graphics/ImageDataKTX.hpp"
+#include "graphics/RenderDevice.hpp"
+#include "graphics/Texture.hpp"
+
+namespace ouzel
+{
+    namespace assets
+    {
+        LoaderKTX::LoaderKTX():
+            Loader(TYPE, {"ktx"})
+        {
+        }
+
+        bool LoaderKTX::loadAsset(const std::string& filename, const std::vector<uint8_t>& data, bool mipmaps)
+        {
+            graphics::ImageDataKTX image(data, engine->getRenderer()->getDevice()->getMaxTextureSize());
+            const std::vector<graphics::Texture::Level>& levels = image.getLevels();
+
+            std::shared_ptr<graphics::Texture> texture = std::make_shared<graphics::Texture>(*engine->getRenderer());
+
+            // the mip levels of uncompressed images without them are generated, compressed images use only the stored levels
+            if (levels.size() == 1 && !graphics::isCompressed(image.getPixelFormat()))
+                texture->init(levels.front().data, image.getSize(), 0, mipmaps ? 0 : 1, image.getPixelFormat());
+            else if (mipmaps)
+                texture->init(levels, image.getSize(), 0, image.getPixelFormat());
+            else
+                texture->init(std::vector<graphics::Texture::Level>(levels.begin(), levels.begin() + 1),
+                              image.getSize(), 0, image.getPixelFormat());
+
+            cache->setTexture(filename, texture);
+
+            return true;
+        }
+    } // namespace assets
+} // namespace ouzel
@@ -8,15 +8,20 @@ namespace ouzel
 {
     namespace assets
     {
-        LoaderTTF::LoaderTTF():
-            Loader(TYPE, {"ttf"})
+        LoaderTTF::LoaderTTF(bool initDistanceField):
+            Loader(initDistanceField ? Loader::DISTANCE_FIELD_FONT : Loader::FONT, {"ttf"}),
+            distanceField(initDistanceField)
         {
         }
 
         bool LoaderTTF::loadAsset(const std::string& filename, const std::vector<uint8_t>& data, bool mipmaps)
         {
-            std::shared_ptr<TTFont> font = std::make_shared<TTFont>(data, mipmaps);
-            cache->setFont(filename, font);
+            std::shared_ptr<TTFont> font = std::make_shared<TTFont>(data, mipmaps, distanceField);
+
+            if (distanceField)
+                cache->setDistanceFieldFont(filename, font);
+            else
+                cache->setFont(filename, font);
 
             return true;
         }
@@ -13,8 +13,11 @@ namespace ouzel
         public:
             static const uint32_t TYPE = Loader::FONT;
 
-            LoaderTTF();
+            explicit LoaderTTF(bool initDistanceField = false);
             virtual bool loadAsset(const std::string& filename, const std::vector<uint8_t>& data, bool mipmaps = true) override;
+
+        private:
+            bool distanceField = false;
         };
     } // namespace assets
 } // namespace ouzel
@@ -5,6 +5,7 @@
 #include "math/MathUtils.hpp"
 #include "thread/Lock.hpp"
 #include "utils/Errors.hpp"
+#include "utils/Profiler.hpp"
 
 namespace ouzel
 {
@@ -130,6 +131,8 @@ namespace ouzel
 
         void AudioDevice::getData(uint32_t frames, std::vector<uint8_t>& result)
         {
+            ProfilerZone zone("AudioDevice::getData");
+
             currentBuffer = 0;
             uint32_t buffer = currentBuffer;
 
@@ -6,6 +6,7 @@
 #include "utils/INI.hpp"
 #include "utils/Errors.hpp"
 #include "utils/Log.hpp"
+#include "utils/Profiler.hpp"
 #include "utils/Utils.hpp"
 #include "graphics/Renderer.hpp"
 #include "graphics/RenderDevice.hpp"
@@ -37,6 +38,11 @@ namespace ouzel
     ouzel::Engine* engine = nullptr;
 
     Engine::Engine():
+#if OUZEL_MULTITHREADED
+        jobSystem(getCPUCount()),
+#else
+        jobSystem(0),
+#endif
         cache(fileSystem), active(false), paused(false), screenSaverEnabled(true)
     {
         engine = this;
@@ -83,6 +89,7 @@ namespace ouzel
         bool verticalSync = true;
         bool depth = false;
         bool debugRenderer = false;
+        bool tripleBuffering = false;
         bool exclusiveFullscreen = false;
         bool highDpi = true; // should high DPI resolution be used
         audio::Audio::Driver audioDriver = audio::Audio::Driver::DEFAULT;
@@ -165,6 +172,9 @@ namespace ouzel
         std::string debugRendererValue = userEngineSection.getValue("debugRenderer", defaultEngineSection.getValue("debugRenderer"));
         if (!debugRendererValue.empty()) debugRenderer = (debugRendererValue == "true" || debugRendererValue == "1" || debugRendererValue == "yes");
 
+        std::string tripleBufferingValue = userEngineSection.getValue("tripleBuffering", defaultEngineSection.getValue("tripleBuffering"));
+        if (!tripleBufferingValue.empty()) tripleBuffering = (tripleBufferingValue == "true" || tripleBufferingValue == "1" || tripleBufferingValue == "yes");
+
         std::string highDpiValue = userEngineSection.getValue("highDpi", defaultEngineSection.getValue("highDpi"));
         if (!highDpiValue.empty()) highDpi = (highDpiValue == "true" || highDpiValue == "1" || highDpiValue == "yes");
 
@@ -192,9 +202,18 @@ namespace ouzel
                 throw ConfigError("Invalid audio driver specified");
         }
 
+        std::string profilerValue = userEngineSection.getValue("profiler", defaultEngineSection.getValue("profiler"));
+        if (!profilerValue.empty()) Profiler::setEnabled(profilerValue == "true" || profilerValue == "1" || profilerValue == "yes");
+
         std::string debugAudioValue = userEngineSection.getValue("debugAudio", defaultEngineSection.getValue("debugAudio"));
         if (!debugAudioValue.empty()) debugAudio = (debugAudioValue == "true" || debugAudioValue == "1" || debugAudioValue == "yes");
 
+        if (headless)
+        {
+            graphicsDriver = graphics::Renderer::Driver::EMPTY;
+            audioDriver = audio::Audio::Driver::EMPTY;
+        }
+
         if (graphicsDriver == graphics::Renderer::Driver::DEFAULT)
         {
             auto availableDrivers = graphics::Renderer::getAvailableRenderDrivers();
@@ -228,6 +247,8 @@ namespace ouzel
                                               depth,
                                               debugRenderer));
 
+        renderer->getDevice()->setTripleBuffering(tripleBuffering);
+
         if (audioDriver == audio::Audio::Driver::DEFAULT)
         {
             auto availableDrivers = audio::Audio::getAvailableAudioDrivers();
@@ -250,23 +271,28 @@ namespace ouzel
 
         audio.reset(new audio::Audio(audioDriver, debugAudio, window.get()));
 
+        if (headless)
+            inputManager.reset(new input::InputManager());
+        else
+        {
 #if OUZEL_PLATFORM_MACOS
-        inputManager.reset(new input::InputManagerMacOS());
+            inputManager.reset(new input::InputManagerMacOS());
 #elif OUZEL_PLATFORM_IOS
-        inputManager.reset(new input::InputManagerIOS());
+            inputManager.reset(new input::InputManagerIOS());
 #elif OUZEL_PLATFORM_TVOS
-        inputManager.reset(new input::InputManagerTVOS());
+            inputManager.reset(new input::InputManagerTVOS());
 #elif OUZEL_PLATFORM_ANDROID
-        inputManager.reset(new input::InputManagerAndroid());
+            inputManager.reset(new input::InputManagerAndroid());
 #elif OUZEL_PLATFORM_LINUX
-        inputManager.reset(new input::InputManagerLinux());
+            inputManager.reset(new input::InputManagerLinux());
 #elif OUZEL_PLATFORM_WINDOWS
-        inputManager.reset(new input::InputManagerWin());
+            inputManager.reset(new input::InputManagerWin());
 #elif OUZEL_PLATFORM_EMSCRIPTEN
-        inputManager.reset(new input::InputManagerEm());
+            inputManager.reset(new input::InputManagerEm());
 #else
-        inputManager.reset(new input::InputManager());
+            inputManager.reset(new input::InputManager());
 #endif
+        }
     }
 
     void Engine::start()
@@ -346,12 +372,15 @@ namespace ouzel
 
     void Engine::update()
     {
+        ProfilerZone zone("Engine::update");
+
         eventDispatcher.dispatchEvents();
 
         sceneManager.update();
 
         if (renderer->getDevice()->getRefillQueue())
         {
+            cache.uploadSpriteAtlas();
             sceneManager.draw();
             renderer->getDevice()->flushCommands();
         }
@@ -17,6 +17,7 @@
 #include "localization/Localization.hpp"
 #include "network/Network.hpp"
 #include "thread/Condition.hpp"
+#include "thread/JobSystem.hpp"
 #include "thread/Mutex.hpp"
 #include "thread/Thread.hpp"
 #include "utils/INI.hpp"
@@ -43,6 +44,7 @@ namespace ouzel
 
         inline FileSystem* getFileSystem() { return &fileSystem; }
         inline EventDispatcher* getEventDispatcher() { return &eventDispatcher; }
+        inline JobSystem* getJobSystem() { return &jobSystem; }
         inline assets::Cache* getCache() { return &cache; }
         inline Window* getWindow() { return window.get(); }
         inline graphics::Renderer* getRenderer() const { return renderer.get(); }
@@ -61,6 +63,8 @@ namespace ouzel
         void resume();
         void exit();
 
+        // headless engines use the empty render and audio drivers and do not open a window
+        inline bool isHeadless() const { return headless; }
         inline bool isPaused() const { return paused; }
         inline bool isActive() const { return active; }
 
@@ -78,6 +82,7 @@ namespace ouzel
 
         FileSystem fileSystem;
         EventDispatcher eventDispatcher;
+        JobSystem jobSystem;
         std::unique_ptr<Window> window;
         std::unique_ptr<graphics::Renderer> renderer;
         std::unique_ptr<audio::Audio> audio;
@@ -96,6 +101,7 @@ namespace ouzel
         Condition updateCondition;
 #endif
 
+        bool headless = false;
         std::atomic<bool> active;
         std::atomic<bool> paused;
 
@@ -0,0 +1,101 @@
+// Copyright 2015-2018 Elviss Strazdins. All rights reserved.
+
+#include <chrono>
+#include "EngineHeadless.hpp"
+#include "events/Event.hpp"
+#include "graphics/RenderDevice.hpp"
+#include "scene/Layer.hpp"
+#include "scene/Scene.hpp"
+#include "thread/Lock.hpp"
+
+namespace ouzel
+{
+    EngineHeadless::EngineHeadless(int initArgc, char* initArgv[])
+    {
+        headless = true;
+
+        for (int i = 0; i < initArgc; ++i)
+            args.push_back(initArgv[i]);
+    }
+
+    void EngineHeadless::run()
+    {
+        init();
+
+        // the update thread is not started, ouzelMain and the frames run on this thread
+        Event event;
+        event.type = Event::Type::ENGINE_START;
+        eventDispatcher.postEvent(event);
+
+        active = true;
+        paused = false;
+
+        ouzelMain(args);
+
+        while (active)
+            step();
+
+        exit();
+    }
+
+    void EngineHeadless::step()
+    {
+        std::chrono::steady_clock::time_point updateStartTime = std::chrono::steady_clock::now();
+
+        executeAll();
+        eventDispatcher.dispatchEvents();
+        sceneManager.update();
+
+        std::chrono::steady_clock::time_point drawStartTime = std::chrono::steady_clock::now();
+        frameTimings.update = std::chrono::duration_cast<std::chrono::nanoseconds>(drawStartTime - updateStartTime).count() / 1000000000.0F;
+
+        cache.uploadSpriteAtlas();
+        sceneManager.draw();
+        renderer->getDevice()->flushCommands();
+
+        std::chrono::steady_clock::time_point processStartTime = std::chrono::steady_clock::now();
+        frameTimings.draw = std::chrono::duration_cast<std::chrono::nanoseconds>(processStartTime - drawStartTime).count() / 1000000000.0F;
+
+        // the command queue was just flushed, so the render device does not wait for it
+        renderer->getDevice()->process();
+
+        frameTimings.process = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - processStartTime).count() / 1000000000.0F;
+
+        frameTimings.visit = 0.0F;
+
+        if (scene::Scene* scene = sceneManager.getScene())
+        {
+            for (const scene::Layer* layer : scene->getLayers())
+                frameTimings.visit += layer->getVisitTime();
+        }
+
+        audio->update();
+    }
+
+    void EngineHeadless::executeOnMainThread(const std::function<void(void)>& func)
+    {
+        Lock lock(executeMutex);
+
+        executeQueue.push(func);
+    }
+
+    void EngineHeadless::executeAll()
+    {
+        std::function<void(void)> func;
+
+        for (;;)
+        {
+            {
+                Lock lock(executeMutex);
+
+                if (executeQueue.empty())
+                    break;
+
+                func = std::move(executeQueue.front());
+                executeQueue.pop();
+            }
+
+            if (func) func();
+        }
+    }
+}
@@ -0,0 +1,42 @@
+// Copyright 2015-2018 Elviss Strazdins. All rights reserved.
+
+#pragma once
+
+#include <queue>
+#include "core/Engine.hpp"
+
+namespace ouzel
+{
+    // engine without a window and without an update or render thread, the frames are updated, recorded and
+    // processed one after another on the thread that calls step
+    class EngineHeadless: public Engine
+    {
+    public:
+        // time (in seconds) spent in each phase of the last frame
+        struct FrameTimings
+        {
+            float update = 0.0F;
+            float visit = 0.0F; // updating, culling and sorting the actors of the layers, included in draw
+            float draw = 0.0F;
+            float process = 0.0F;
+        };
+
+        EngineHeadless(int initArgc, char* initArgv[]);
+
+        // calls ouzelMain and steps the frames until exit is called
+        virtual void run() override;
+        void step();
+
+        inline const FrameTimings& getFrameTimings() const { return frameTimings; }
+
+        virtual void executeOnMainThread(const std::function<void(void)>& func) override;
+
+    private:
+        void executeAll();
+
+        std::queue<std::function<void(void)>> executeQueue;
+        Mutex executeMutex;
+
+        FrameTimings frameTimings;
+    };
+}
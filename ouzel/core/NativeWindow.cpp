@@ -16,6 +16,7 @@ namespace ouzel
                                const std::string& newTitle,
                                bool newHighDpi):
         size(newSize),
+        resolution(newSize),
         resizable(newResizable),
         fullscreen(newFullscreen),
         exclusiveFullscreen(newExclusiveFullscreen),
@@ -196,3 +196,7 @@
 #if defined(__SSE__)
 #  define OUZEL_SUPPORTS_SSE 1
 #endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  define OUZEL_SUPPORTS_SSE2 1
+#endif
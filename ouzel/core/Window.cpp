@@ -34,79 +34,93 @@ namespace ouzel
                    bool newHighDpi,
                    bool depth)
     {
+        if (engine->isHeadless())
+        {
+            OUZEL_UNUSED(graphicsDriver);
+            OUZEL_UNUSED(depth);
+            nativeWindow = new NativeWindow(newSize,
+                                            newResizable,
+                                            newFullscreen,
+                                            newExclusiveFullscreen,
+                                            newTitle,
+                                            newHighDpi);
+        }
+        else
+        {
 #if OUZEL_PLATFORM_MACOS
-        OUZEL_UNUSED(depth);
-        nativeWindow = new NativeWindowMacOS(newSize,
-                                             newResizable,
-                                             newFullscreen,
-                                             newExclusiveFullscreen,
-                                             newTitle,
-                                             graphicsDriver,
-                                             newHighDpi);
+            OUZEL_UNUSED(depth);
+            nativeWindow = new NativeWindowMacOS(newSize,
+                                                 newResizable,
+                                                 newFullscreen,
+                                                 newExclusiveFullscreen,
+                                                 newTitle,
+                                                 graphicsDriver,
+                                                 newHighDpi);
 #elif OUZEL_PLATFORM_IOS
-        OUZEL_UNUSED(newSize);
-        OUZEL_UNUSED(newResizable);
-        OUZEL_UNUSED(newFullscreen);
-        OUZEL_UNUSED(newExclusiveFullscreen);
-        OUZEL_UNUSED(depth);
-        nativeWindow = new NativeWindowIOS(newTitle,
-                                           graphicsDriver,
-                                           newHighDpi);
+            OUZEL_UNUSED(newSize);
+            OUZEL_UNUSED(newResizable);
+            OUZEL_UNUSED(newFullscreen);
+            OUZEL_UNUSED(newExclusiveFullscreen);
+            OUZEL_UNUSED(depth);
+            nativeWindow = new NativeWindowIOS(newTitle,
+                                               graphicsDriver,
+                                               newHighDpi);
 #elif OUZEL_PLATFORM_TVOS
-        OUZEL_UNUSED(newSize);
-        OUZEL_UNUSED(newResizable);
-        OUZEL_UNUSED(newFullscreen);
-        OUZEL_UNUSED(newExclusiveFullscreen);
-        OUZEL_UNUSED(depth);
-        nativeWindow = new NativeWindowTVOS(newTitle,
-                                            graphicsDriver,
-                                            newHighDpi);
+            OUZEL_UNUSED(newSize);
+            OUZEL_UNUSED(newResizable);
+            OUZEL_UNUSED(newFullscreen);
+            OUZEL_UNUSED(newExclusiveFullscreen);
+            OUZEL_UNUSED(depth);
+            nativeWindow = new NativeWindowTVOS(newTitle,
+                                                graphicsDriver,
+                                                newHighDpi);
 #elif OUZEL_PLATFORM_ANDROID
-        OUZEL_UNUSED(newSize);
-        OUZEL_UNUSED(newResizable);
-        OUZEL_UNUSED(newFullscreen);
-        OUZEL_UNUSED(newExclusiveFullscreen);
-        OUZEL_UNUSED(graphicsDriver);
-        OUZEL_UNUSED(newHighDpi);
-        OUZEL_UNUSED(depth);
-        nativeWindow = new NativeWindowAndroid(newTitle);
+            OUZEL_UNUSED(newSize);
+            OUZEL_UNUSED(newResizable);
+            OUZEL_UNUSED(newFullscreen);
+            OUZEL_UNUSED(newExclusiveFullscreen);
+            OUZEL_UNUSED(graphicsDriver);
+            OUZEL_UNUSED(newHighDpi);
+            OUZEL_UNUSED(depth);
+            nativeWindow = new NativeWindowAndroid(newTitle);
 #elif OUZEL_PLATFORM_LINUX
-        OUZEL_UNUSED(newHighDpi);
-        nativeWindow = new NativeWindowLinux(newSize,
-                                             newResizable,
-                                             newFullscreen,
-                                             newExclusiveFullscreen,
-                                             newTitle,
-                                             graphicsDriver,
-                                             depth);
+            OUZEL_UNUSED(newHighDpi);
+            nativeWindow = new NativeWindowLinux(newSize,
+                                                 newResizable,
+                                                 newFullscreen,
+                                                 newExclusiveFullscreen,
+                                                 newTitle,
+                                                 graphicsDriver,
+                                                 depth);
 #elif OUZEL_PLATFORM_WINDOWS
-        OUZEL_UNUSED(graphicsDriver);
-        OUZEL_UNUSED(depth);
-        nativeWindow = new NativeWindowWin(newSize,
-                                           newResizable,
-                                           newFullscreen,
-                                           newExclusiveFullscreen,
-                                           newTitle,
-                                           newHighDpi);
+            OUZEL_UNUSED(graphicsDriver);
+            OUZEL_UNUSED(depth);
+            nativeWindow = new NativeWindowWin(newSize,
+                                               newResizable,
+                                               newFullscreen,
+                                               newExclusiveFullscreen,
+                                               newTitle,
+                                               newHighDpi);
 #elif OUZEL_PLATFORM_EMSCRIPTEN
-        OUZEL_UNUSED(newResizable);
-        OUZEL_UNUSED(newExclusiveFullscreen);
-        OUZEL_UNUSED(graphicsDriver);
-        OUZEL_UNUSED(depth);
-        nativeWindow = new NativeWindowEm(newSize,
-                                          newFullscreen,
-                                          newTitle,
-                                          newHighDpi);
+            OUZEL_UNUSED(newResizable);
+            OUZEL_UNUSED(newExclusiveFullscreen);
+            OUZEL_UNUSED(graphicsDriver);
+            OUZEL_UNUSED(depth);
+            nativeWindow = new NativeWindowEm(newSize,
+                                              newFullscreen,
+                                              newTitle,
+                                              newHighDpi);
 #else
-        OUZEL_UNUSED(graphicsDriver);
-        OUZEL_UNUSED(depth);
-        resource = new NativeWindow(newSize,
-                                    newResizable,
-                                    newFullscreen,
-                                    newExclusiveFullscreen,
-                                    newTitle,
-                                    newHighDpi);
+            OUZEL_UNUSED(graphicsDriver);
+            OUZEL_UNUSED(depth);
+            nativeWindow = new NativeWindow(newSize,
+                                            newResizable,
+                                            newFullscreen,
+                                            newExclusiveFullscreen,
+                                            newTitle,
+                                            newHighDpi);
 #endif
+        }
 
         nativeWindow->setListener(this);
 
@@ -0,0 +1,306 @@
+// Copyright 2015-2018 Elviss Strazdins. All rights reserved.
+
+#include <algorithm>
+#include <limits>
+#include "AtlasPacker.hpp"
+
+namespace ouzel
+{
+    namespace graphics
+    {
+        AtlasPacker::AtlasPacker(uint32_t initWidth, uint32_t initHeight, uint32_t initPadding):
+            width(initWidth), height(initHeight), padding(initPadding)
+        {
+            clear();
+        }
+
+        bool AtlasPacker::insert(uint32_t newWidth, uint32_t newHeight, uint32_t& x, uint32_t& y)
+        {
+            uint32_t paddedWidth = newWidth + padding * 2;
+            uint32_t paddedHeight = newHeight + padding * 2;
+
+            if (newWidth == 0 || newHeight == 0 ||
+                paddedWidth > width || paddedHeight > height)
+                return false;
+
+            if (!insertFree(paddedWidth, paddedHeight, x, y) &&
+                !insertSkyline(paddedWidth, paddedHeight, x, y))
+                return false;
+
+            x += padding;
+            y += padding;
+
+            ++count;
+            usedArea += static_cast<uint64_t>(paddedWidth) * paddedHeight;
+
+            return true;
+        }
+
+        void AtlasPacker::remove(uint32_t x, uint32_t y, uint32_t oldWidth, uint32_t oldHeight)
+        {
+            if (count == 0) return;
+
+            // the whole page is reclaimed when the last rectangle is removed
+            if (--count == 0)
+            {
+                clear();
+                return;
+            }
+
+            FreeRect freeRect = {x - padding, y - padding, oldWidth + padding * 2, oldHeight + padding * 2};
+            usedArea -= static_cast<uint64_t>(freeRect.width) * freeRect.height;
+            reclaim(freeRect);
+        }
+
+        void AtlasPacker::clear()
+        {
+            skyline.clear();
+            skyline.push_back({0, 0, width});
+            freeRects.clear();
+            count = 0;
+            usedArea = 0;
+        }
+
+        float AtlasPacker::getOccupancy() const
+        {
+            if (width == 0 || height == 0) return 0.0F;
+
+            return static_cast<float>(static_cast<double>(usedArea) / (static_cast<double>(width) * height));
+        }
+
+        bool AtlasPacker::insertFree(uint32_t paddedWidth, uint32_t paddedHeight, uint32_t& x, uint32_t& y)
+        {
+            // best area fit
+            size_t bestIndex = freeRects.size();
+            uint64_t bestArea = std::numeric_limits<uint64_t>::max();
+
+            for (size_t i = 0; i < freeRects.size(); ++i)
+            {
+                const FreeRect& freeRect = freeRects[i];
+
+                if (freeRect.width >= paddedWidth && freeRect.height >= paddedHeight)
+                {
+                    uint64_t area = static_cast<uint64_t>(freeRect.width) * freeRect.height;
+
+                    if (area < bestArea)
+                    {
+                        bestIndex = i;
+                        bestArea = area;
+                    }
+                }
+            }
+
+            if (bestIndex == freeRects.size()) return false;
+
+            FreeRect freeRect = freeRects[bestIndex];
+            freeRects[bestIndex] = freeRects.back();
+            freeRects.pop_back();
+
+            x = freeRect.x;
+            y = freeRect.y;
+
+            // guillotine split along the shorter leftover axis, so that the larger leftover stays in one piece
+            uint32_t leftoverWidth = freeRect.width - paddedWidth;
+            uint32_t leftoverHeight = freeRect.height - paddedHeight;
+
+            if (leftoverWidth < leftoverHeight)
+            {
+                if (leftoverWidth > 0) freeRects.push_back({freeRect.x + paddedWidth, freeRect.y, leftoverWidth, paddedHeight});
+                if (leftoverHeight > 0) freeRects.push_back({freeRect.x, freeRect.y + paddedHeight, freeRect.width, leftoverHeight});
+            }
+            else
+            {
+                if (leftoverWidth > 0) freeRects.push_back({freeRect.x + paddedWidth, freeRect.y, leftoverWidth, freeRect.height});
+                if (leftoverHeight > 0) freeRects.push_back({freeRect.x, freeRect.y + paddedHeight, paddedWidth, leftoverHeight});
+            }
+
+            return true;
+        }
+
+        bool AtlasPacker::insertSkyline(uint32_t paddedWidth, uint32_t paddedHeight, uint32_t& x, uint32_t& y)
+        {
+            size_t bestIndex = skyline.size();
+            uint32_t bestBottom = std::numeric_limits<uint32_t>::max();
+            uint32_t bestWidth = std::numeric_limits<uint32_t>::max();
+            uint32_t bestY = 0;
+
+            for (size_t i = 0; i < skyline.size(); ++i)
+            {
+                uint32_t nodeY;
+
+                if (fit(i, paddedWidth, paddedHeight, nodeY))
+                {
+                    uint32_t bottom = nodeY + paddedHeight;
+
+                    if (bottom < bestBottom ||
+                        (bottom == bestBottom && skyline[i].width < bestWidth))
+                    {
+                        bestIndex = i;
+                        bestBottom = bottom;
+                        bestWidth = skyline[i].width;
+                        bestY = nodeY;
+                    }
+                }
+            }
+
+            if (bestIndex == skyline.size()) return false;
+
+            x = skyline[bestIndex].x;
+            y = bestY;
+
+            // raise the skyline under the new rectangle
+            Node node = {x, y + paddedHeight, paddedWidth};
+            skyline.insert(skyline.begin() + static_cast<std::ptrdiff_t>(bestIndex), node);
+
+            for (size_t i = bestIndex + 1; i < skyline.size();)
+            {
+                Node& previous = skyline[i - 1];
+                Node& current = skyline[i];
+
+                if (current.x < previous.x + previous.width)
+                {
+                    uint32_t shrink = previous.x + previous.width - current.x;
+
+                    if (current.width <= shrink)
+                    {
+                        skyline.erase(skyline.begin() + static_cast<std::ptrdiff_t>(i));
+                        continue;
+                    }
+
+                    current.x += shrink;
+                    current.width -= shrink;
+                }
+
+                break;
+            }
+
+            // merge the neighbouring nodes of the same height
+            for (size_t i = 1; i < skyline.size();)
+            {
+                if (skyline[i - 1].y == skyline[i].y)
+                {
+                    skyline[i - 1].width += skyline[i].width;
+                    skyline.erase(skyline.begin() + static_cast<std::ptrdiff_t>(i));
+                }
+                else
+                    ++i;
+            }
+
+            return true;
+        }
+
+        void AtlasPacker::reclaim(FreeRect freeRect)
+        {
+            for (;;)
+            {
+                // merge with the free rectangles that share a whole edge with it
+                auto i = std::find_if(freeRects.begin(), freeRects.end(), [&freeRect](const FreeRect& other) {
+                    return (other.x == freeRect.x && other.width == freeRect.width &&
+                            (other.y + other.height == freeRect.y || freeRect.y + freeRect.height == other.y)) ||
+                        (other.y == freeRect.y && other.height == freeRect.height &&
+                         (other.x + other.width == freeRect.x || freeRect.x + freeRect.width == other.x));
+                });
+
+                if (i != freeRects.end())
+                {
+                    uint32_t right = std::max(freeRect.x + freeRect.width, i->x + i->width);
+                    uint32_t bottom = std::max(freeRect.y + freeRect.height, i->y + i->height);
+                    freeRect.x = std::min(freeRect.x, i->x);
+                    freeRect.y = std::min(freeRect.y, i->y);
+                    freeRect.width = right - freeRect.x;
+                    freeRect.height = bottom - freeRect.y;
+
+                    *i = freeRects.back();
+                    freeRects.pop_back();
+                    continue;
+                }
+
+                if (!lowerSkyline(freeRect))
+                {
+                    freeRects.push_back(freeRect);
+                    return;
+                }
+
+                // lowering the skyline can expose the free rectangles under it
+                i = std::find_if(freeRects.begin(), freeRects.end(), [this](const FreeRect& other) {
+                    uint32_t top = other.y + other.height;
+
+                    for (const Node& node : skyline)
+                        if (node.x < other.x + other.width && node.x + node.width > other.x && node.y != top)
+                            return false;
+
+                    return true;
+                });
+
+                if (i == freeRects.end()) return;
+
+                freeRect = *i;
+                *i = freeRects.back();
+                freeRects.pop_back();
+            }
+        }
+
+        bool AtlasPacker::lowerSkyline(const FreeRect& freeRect)
+        {
+            uint32_t top = freeRect.y + freeRect.height;
+            uint32_t left = freeRect.x;
+            uint32_t right = freeRect.x + freeRect.width;
+
+            // the rectangle must be directly under the skyline along its whole width
+            for (const Node& node : skyline)
+                if (node.x < right && node.x + node.width > left && node.y != top)
+                    return false;
+
+            std::vector<Node> newSkyline;
+            newSkyline.reserve(skyline.size() + 2);
+
+            for (const Node& node : skyline)
+            {
+                uint32_t nodeRight = node.x + node.width;
+
+                if (nodeRight <= left || node.x >= right)
+                    newSkyline.push_back(node);
+                else
+                {
+                    if (node.x < left) newSkyline.push_back({node.x, node.y, left - node.x});
+                    uint32_t start = std::max(node.x, left);
+                    uint32_t end = std::min(nodeRight, right);
+                    newSkyline.push_back({start, freeRect.y, end - start});
+                    if (nodeRight > right) newSkyline.push_back({right, node.y, nodeRight - right});
+                }
+            }
+
+            skyline.clear();
+
+            for (const Node& node : newSkyline)
+            {
+                if (!skyline.empty() && skyline.back().y == node.y)
+                    skyline.back().width += node.width;
+                else
+                    skyline.push_back(node);
+            }
+
+            return true;
+        }
+
+        bool AtlasPacker::fit(size_t index, uint32_t paddedWidth, uint32_t paddedHeight, uint32_t& y) const
+        {
+            if (skyline[index].x + paddedWidth > width) return false;
+
+            uint32_t remainingWidth = paddedWidth;
+            y = skyline[index].y;
+
+            for (size_t i = index; remainingWidth > 0; ++i)
+            {
+                if (i >= skyline.size()) return false;
+
+                if (skyline[i].y > y) y = skyline[i].y;
+                if (y + paddedHeight > height) return false;
+
+                remainingWidth = (skyline[i].width >= remainingWidth) ? 0 : remainingWidth - skyline[i].width;
+            }
+
+            return true;
+        }
+    } // namespace graphics
+} // namespace ouzel
@@ -0,0 +1,66 @@
+// Copyright 2015-2018 Elviss Strazdins. All rights reserved.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ouzel
+{
+    namespace graphics
+    {
+        // packs rectangles into a fixed size page with the skyline bottom-left heuristic,
+        // the space of the removed rectangles is reused for the following insertions
+        class AtlasPacker final
+        {
+        public:
+            AtlasPacker(uint32_t initWidth, uint32_t initHeight, uint32_t initPadding = 0);
+
+            // returns the position of the rectangle (excluding the padding around it) or false if it does not fit
+            bool insert(uint32_t width, uint32_t height, uint32_t& x, uint32_t& y);
+            // the position and size must be the same as for the insertion
+            void remove(uint32_t x, uint32_t y, uint32_t width, uint32_t height);
+            void clear();
+
+            inline uint32_t getWidth() const { return width; }
+            inline uint32_t getHeight() const { return height; }
+            inline uint32_t getPadding() const { return padding; }
+            inline uint32_t getCount() const { return count; }
+
+            // ratio of the used area (including the padding) to the page area
+            float getOccupancy() const;
+
+        private:
+            struct Node
+            {
+                uint32_t x;
+                uint32_t y;
+                uint32_t width;
+            };
+
+            struct FreeRect
+            {
+                uint32_t x;
+                uint32_t y;
+                uint32_t width;
+                uint32_t height;
+            };
+
+            bool insertFree(uint32_t paddedWidth, uint32_t paddedHeight, uint32_t& x, uint32_t& y);
+            bool insertSkyline(uint32_t paddedWidth, uint32_t paddedHeight, uint32_t& x, uint32_t& y);
+            bool fit(size_t index, uint32_t paddedWidth, uint32_t paddedHeight, uint32_t& y) const;
+            void reclaim(FreeRect freeRect);
+            bool lowerSkyline(const FreeRect& freeRect);
+
+            uint32_t width;
+            uint32_t height;
+            uint32_t padding;
+            uint32_t count = 0;
+            uint64_t usedArea = 0;
+
+            std::vector<Node> skyline;
+            std::vector<FreeRect> freeRects;
+        };
+    } // namespace graphics
+} // namespace ouzel
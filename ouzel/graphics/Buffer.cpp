@@ -1,5 +1,6 @@
 // Copyright 2015-2018 Elviss Strazdins. All rights reserved.
 
+#include <algorithm>
 #include "Buffer.hpp"
 #include "BufferResource.hpp"
 #include "Renderer.hpp"
@@ -23,6 +24,8 @@ namespace ouzel
 
         void Buffer::init(Usage newUsage, uint32_t newFlags, uint32_t newSize)
         {
+            if (newFlags & Buffer::STREAMING) newFlags |= Buffer::DYNAMIC;
+
             usage = newUsage;
             flags = newFlags;
             size = newSize;
@@ -50,6 +53,8 @@ namespace ouzel
             if (!newData.empty() && newSize != newData.size())
                 throw DataError("Invalid buffer data");
 
+            if (newFlags & Buffer::STREAMING) newFlags |= Buffer::DYNAMIC;
+
             usage = newUsage;
             flags = newFlags;
             size = newSize;
@@ -65,6 +70,15 @@ namespace ouzel
 
         void Buffer::setData(const void* newData, uint32_t newSize)
         {
+            if (flags & Buffer::STREAMING)
+            {
+                std::copy(static_cast<const uint8_t*>(newData),
+                          static_cast<const uint8_t*>(newData) + newSize,
+                          static_cast<uint8_t*>(map(newSize)));
+                unmap();
+                return;
+            }
+
             RenderDevice* renderDevice = renderer.getDevice();
 
             renderDevice->addCommand(SetBufferDataCommand(resource,
@@ -80,6 +94,12 @@ namespace ouzel
             if (newData.empty())
                 throw DataError("Invalid buffer data");
 
+            if (flags & Buffer::STREAMING)
+            {
+                setData(newData.data(), static_cast<uint32_t>(newData.size()));
+                return;
+            }
+
             if (newData.size() > size) size = static_cast<uint32_t>(newData.size());
 
             RenderDevice* renderDevice = renderer.getDevice();
@@ -87,5 +107,61 @@ namespace ouzel
             renderDevice->addCommand(SetBufferDataCommand(resource,
                                                           newData));
         }
+
+        void Buffer::setData(const void* newData, uint32_t newSize, uint32_t offset)
+        {
+            if (!(flags & Buffer::DYNAMIC))
+                throw DataError("Buffer is not dynamic");
+
+            if (flags & Buffer::STREAMING)
+                throw DataError("Streaming buffers can't be partially updated");
+
+            if (!newData || newSize == 0)
+                throw DataError("Invalid buffer data");
+
+            if (offset + newSize > size) size = offset + newSize;
+
+            RenderDevice* renderDevice = renderer.getDevice();
+
+            renderDevice->addCommand(SetBufferDataRangeCommand(resource,
+                                                               offset,
+                                                               std::vector<uint8_t>(static_cast<const uint8_t*>(newData),
+                                                                                    static_cast<const uint8_t*>(newData) + newSize)));
+        }
+
+        void* Buffer::map(uint32_t newMapSize)
+        {
+            if (!(flags & Buffer::STREAMING))
+                throw DataError("Buffer is not streaming");
+
+            if (mapped)
+                throw DataError("Buffer is already mapped");
+
+            if (newMapSize == 0)
+                throw DataError("Invalid buffer data");
+
+            RenderDevice* renderDevice = renderer.getDevice();
+
+            mapped = true;
+            mapSize = newMapSize;
+            mapOffset = renderDevice->reserveUploadData(newMapSize);
+
+            return renderDevice->getUploadData(mapOffset);
+        }
+
+        void Buffer::unmap()
+        {
+            if (!mapped)
+                throw DataError("Buffer is not mapped");
+
+            mapped = false;
+            if (mapSize > size) size = mapSize;
+
+            RenderDevice* renderDevice = renderer.getDevice();
+
+            renderDevice->addCommand(UploadBufferDataCommand(resource,
+                                                             mapOffset,
+                                                             mapSize));
+        }
     } // namespace graphics
 } // namespace ouzel
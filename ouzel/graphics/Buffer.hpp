@@ -17,7 +17,8 @@ namespace ouzel
         public:
             enum Flags
             {
-                DYNAMIC = 0x01
+                DYNAMIC = 0x01,
+                STREAMING = 0x02 // dynamic buffer that is updated often, uploads are suballocated from a ring buffer
             };
 
             enum class Usage
@@ -42,6 +43,13 @@ namespace ouzel
 
             void setData(const void* newData, uint32_t newSize);
             void setData(const std::vector<uint8_t>& newData);
+            // replaces newSize bytes at the offset, the rest of the contents stays, not available for streaming buffers
+            void setData(const void* newData, uint32_t newSize, uint32_t offset);
+
+            // returns memory for the new contents of a streaming buffer, no other data can be uploaded until unmap is called
+            void* map(uint32_t mapSize);
+            void unmap();
+            inline bool isMapped() const { return mapped; }
 
             inline BufferResource* getResource() const { return resource; }
 
@@ -56,6 +64,10 @@ namespace ouzel
             Buffer::Usage usage;
             uint32_t flags = 0;
             uint32_t size = 0;
+
+            bool mapped = false;
+            uint32_t mapOffset = 0;
+            uint32_t mapSize = 0;
         };
     } // namespace graphics
 } // namespace ouzel
@@ -1,5 +1,6 @@
 // Copyright 2015-2018 Elviss Strazdins. All rights reserved.
 
+#include <algorithm>
 #include "BufferResource.hpp"
 #include "utils/Errors.hpp"
 
@@ -18,11 +19,16 @@ namespace ouzel
 
         void BufferResource::init(Buffer::Usage newUsage, uint32_t newFlags,
                                   const std::vector<uint8_t>& newData,
-                                  uint32_t)
+                                  uint32_t newSize)
         {
             usage = newUsage;
             flags = newFlags;
             data = newData;
+            size = static_cast<uint32_t>(data.size());
+
+            offset = 0;
+            ringPosition = size;
+            ringSize = newSize;
         }
 
         void BufferResource::setData(const std::vector<uint8_t>& newData)
@@ -34,6 +40,55 @@ namespace ouzel
                 throw DataError("Data is empty");
 
             data = newData;
+            size = static_cast<uint32_t>(data.size());
+        }
+
+        void BufferResource::setData(const std::vector<uint8_t>& newData, uint32_t dataOffset)
+        {
+            if (!(flags & Buffer::DYNAMIC))
+                throw DataError("Buffer is not dynamic");
+
+            if (newData.empty())
+                throw DataError("Data is empty");
+
+            if (dataOffset + newData.size() > data.size())
+                data.resize(dataOffset + newData.size());
+
+            std::copy(newData.begin(), newData.end(), data.begin() + dataOffset);
+            size = static_cast<uint32_t>(data.size());
+        }
+
+        void BufferResource::upload(const uint8_t* newData, uint32_t newSize)
+        {
+            setData(std::vector<uint8_t>(newData, newData + newSize));
+        }
+
+        bool BufferResource::allocateRing(uint32_t newSize)
+        {
+            if (!(flags & Buffer::STREAMING))
+                throw DataError("Buffer is not streaming");
+
+            if (newSize == 0)
+                throw DataError("Data is empty");
+
+            size = newSize;
+
+            uint32_t alignedPosition = (ringPosition + RING_ALIGNMENT - 1) & ~(RING_ALIGNMENT - 1);
+
+            if (ringSize >= alignedPosition && ringSize - alignedPosition >= newSize)
+            {
+                offset = alignedPosition;
+                ringPosition = offset + newSize;
+                return true;
+            }
+
+            // new storage has room for several uploads of this size, so that wrapping around is rare
+            uint32_t newRingSize = ((newSize + RING_ALIGNMENT - 1) & ~(RING_ALIGNMENT - 1)) * RING_UPLOAD_COUNT;
+            if (newRingSize > ringSize) ringSize = newRingSize;
+
+            offset = 0;
+            ringPosition = newSize;
+            return false;
         }
     } // namespace graphics
 } // namespace ouzel
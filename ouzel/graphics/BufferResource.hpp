@@ -22,19 +22,36 @@ namespace ouzel
                               uint32_t newSize);
 
             virtual void setData(const std::vector<uint8_t>& newData);
+            // replaces a part of the contents, the rest of the buffer is kept
+            virtual void setData(const std::vector<uint8_t>& newData, uint32_t dataOffset);
+            // uploads new contents of a streaming buffer, they are placed at getOffset()
+            virtual void upload(const uint8_t* newData, uint32_t newSize);
 
             inline uint32_t getFlags() const { return flags; }
             inline Buffer::Usage getUsage() const { return usage; }
-            inline uint32_t getSize() const { return static_cast<uint32_t>(data.size()); }
+            inline uint32_t getSize() const { return size; }
+            // offset of the current contents in the buffer
+            inline uint32_t getOffset() const { return offset; }
 
         protected:
+            static const uint32_t RING_ALIGNMENT = 256; // satisfies the offset alignment of all the backends
+            static const uint32_t RING_UPLOAD_COUNT = 4;
+
             BufferResource(RenderDevice& initRenderDevice);
 
+            // suballocates the next upload from the ring, returns false if the ring has to start over in new storage of ringSize bytes
+            bool allocateRing(uint32_t newSize);
+
             RenderDevice& renderDevice;
 
             Buffer::Usage usage;
             uint32_t flags = 0;
             std::vector<uint8_t> data;
+            uint32_t size = 0;
+
+            uint32_t offset = 0;
+            uint32_t ringPosition = 0;
+            uint32_t ringSize = 0;
         };
     } // namespace graphics
 } // namespace ouzel
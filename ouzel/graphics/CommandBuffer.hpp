@@ -2,10 +2,14 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cassert>
+#include <iterator>
 #include <memory>
+#include <vector>
 #include "graphics/BlendState.hpp"
 #include "graphics/Buffer.hpp"
+#include "graphics/Renderer.hpp"
 #include "graphics/RenderTarget.hpp"
 #include "graphics/Shader.hpp"
 #include "graphics/Texture.hpp"
@@ -31,11 +35,14 @@ namespace ouzel
                 SET_DEPTH_STATE,
                 SET_PIPELINE_STATE,
                 DRAW,
+                DRAW_INSTANCED,
                 PUSH_DEBUG_MARKER,
                 POP_DEBUG_MARKER,
                 INIT_BLEND_STATE,
                 INIT_BUFFER,
                 SET_BUFFER_DATA,
+                SET_BUFFER_DATA_RANGE,
+                UPLOAD_BUFFER_DATA,
                 INIT_SHADER,
                 SET_SHADER_CONSTANTS,
                 INIT_TEXTURE,
@@ -44,6 +51,8 @@ namespace ouzel
                 SET_TEXTURES
             };
 
+            static const uint32_t TYPE_COUNT = SET_TEXTURES + 1;
+
             Command(Type initType):
                 type(initType)
             {
@@ -52,6 +61,22 @@ namespace ouzel
             const Type type;
         };
 
+        struct FrameStatistics
+        {
+            // recorded commands (elided commands are not counted)
+            uint32_t commandCounts[Command::TYPE_COUNT] = {};
+            uint32_t drawCallCount = 0;
+            uint64_t indexCount = 0; // indices submitted by draw calls
+            uint64_t bufferUploadSize = 0;
+            uint64_t textureUploadSize = 0;
+
+            // times in seconds
+            float frameTime = 0.0F;
+            float waitTime = 0.0F; // waiting for the game thread to finish the frame
+            float executeTime = 0.0F; // executing the functions queued with executeOnRenderThread
+            float processTime = 0.0F; // processing the commands
+        };
+
         struct InitRenderTargetCommand: public Command
         {
             InitRenderTargetCommand(RenderTarget* initRenderTarget):
@@ -207,13 +232,46 @@ namespace ouzel
                         uint32_t initIndexSize,
                         BufferResource* initVertexBuffer,
                         Renderer::DrawMode initDrawMode,
-                        uint32_t initStartIndex):
+                        uint32_t initStartIndex,
+                        uint32_t initBaseVertex):
                 Command(Command::Type::DRAW),
                 indexBuffer(initIndexBuffer),
                 indexCount(initIndexCount),
                 indexSize(initIndexSize),
                 vertexBuffer(initVertexBuffer),
                 drawMode(initDrawMode),
+                startIndex(initStartIndex),
+                baseVertex(initBaseVertex)
+            {
+            }
+
+            BufferResource* indexBuffer;
+            uint32_t indexCount;
+            uint32_t indexSize;
+            BufferResource* vertexBuffer;
+            Renderer::DrawMode drawMode;
+            uint32_t startIndex;
+            uint32_t baseVertex;
+        };
+
+        struct DrawInstancedCommand: public Command
+        {
+            DrawInstancedCommand(BufferResource* initIndexBuffer,
+                                 uint32_t initIndexCount,
+                                 uint32_t initIndexSize,
+                                 BufferResource* initVertexBuffer,
+                                 BufferResource* initInstanceBuffer,
+                                 uint32_t initInstanceCount,
+                                 Renderer::DrawMode initDrawMode,
+                                 uint32_t initStartIndex):
+                Command(Command::Type::DRAW_INSTANCED),
+                indexBuffer(initIndexBuffer),
+                indexCount(initIndexCount),
+                indexSize(initIndexSize),
+                vertexBuffer(initVertexBuffer),
+                instanceBuffer(initInstanceBuffer),
+                instanceCount(initInstanceCount),
+                drawMode(initDrawMode),
                 startIndex(initStartIndex)
             {
             }
@@ -222,6 +280,8 @@ namespace ouzel
             uint32_t indexCount;
             uint32_t indexSize;
             BufferResource* vertexBuffer;
+            BufferResource* instanceBuffer; // array of Instance structures
+            uint32_t instanceCount;
             Renderer::DrawMode drawMode;
             uint32_t startIndex;
         };
@@ -317,6 +377,41 @@ namespace ouzel
             std::vector<uint8_t> data;
         };
 
+        struct SetBufferDataRangeCommand: public Command
+        {
+            SetBufferDataRangeCommand(BufferResource* initBuffer,
+                                      uint32_t initOffset,
+                                      const std::vector<uint8_t>& initData):
+                Command(Command::Type::SET_BUFFER_DATA_RANGE),
+                buffer(initBuffer),
+                offset(initOffset),
+                data(initData)
+            {
+            }
+
+            BufferResource* buffer;
+            uint32_t offset;
+            std::vector<uint8_t> data;
+        };
+
+        // uploads data of a streaming buffer that was written directly to the upload arena of the command buffer
+        struct UploadBufferDataCommand: public Command
+        {
+            UploadBufferDataCommand(BufferResource* initBuffer,
+                                    uint32_t initDataOffset,
+                                    uint32_t initSize):
+                Command(Command::Type::UPLOAD_BUFFER_DATA),
+                buffer(initBuffer),
+                dataOffset(initDataOffset),
+                size(initSize)
+            {
+            }
+
+            BufferResource* buffer;
+            uint32_t dataOffset;
+            uint32_t size;
+        };
+
         struct InitShaderCommand: public Command
         {
             InitShaderCommand(ShaderResource* initShader,
@@ -357,16 +452,23 @@ namespace ouzel
 
         struct SetShaderConstantsCommand: public Command
         {
-            SetShaderConstantsCommand(std::vector<std::vector<float>> initFragmentShaderConstants,
-                                      std::vector<std::vector<float>> initVertexShaderConstants):
+            SetShaderConstantsCommand(uint32_t initFragmentShaderConstantOffset,
+                                      uint32_t initFragmentShaderConstantSize,
+                                      uint32_t initVertexShaderConstantOffset,
+                                      uint32_t initVertexShaderConstantSize):
                 Command(Command::Type::SET_SHADER_CONSTANTS),
-                fragmentShaderConstants(initFragmentShaderConstants),
-                vertexShaderConstants(initVertexShaderConstants)
+                fragmentShaderConstantOffset(initFragmentShaderConstantOffset),
+                fragmentShaderConstantSize(initFragmentShaderConstantSize),
+                vertexShaderConstantOffset(initVertexShaderConstantOffset),
+                vertexShaderConstantSize(initVertexShaderConstantSize)
             {
             }
 
-            std::vector<std::vector<float>> fragmentShaderConstants;
-            std::vector<std::vector<float>> vertexShaderConstants;
+            // offsets and sizes (in floats) of the tightly packed constants in the command buffer's data
+            uint32_t fragmentShaderConstantOffset;
+            uint32_t fragmentShaderConstantSize;
+            uint32_t vertexShaderConstantOffset;
+            uint32_t vertexShaderConstantSize;
         };
 
         struct InitTextureCommand: public Command
@@ -417,42 +519,81 @@ namespace ouzel
         class CommandBuffer
         {
         public:
+            // commands are stored in chunks of this size, so that they never have to be relocated
+            static const size_t CHUNK_SIZE = 65536;
+
             CommandBuffer() {}
             CommandBuffer(const CommandBuffer&) = delete;
             CommandBuffer(CommandBuffer&& other)
             {
-                buffer = std::move(other.buffer);
-                capacity = other.capacity;
-                count = other.count;
-                size = other.size;
+                chunks = std::move(other.chunks);
+                data = std::move(other.data);
+                uploadData = std::move(other.uploadData);
+                writeChunk = other.writeChunk;
+                readChunk = other.readChunk;
                 position = other.position;
+                count = other.count;
                 current = other.current;
-
-                other.capacity = 0;
-                other.count = 0;
-                other.size = 0;
+                state = other.state;
+                statistics = other.statistics;
+                elidedCount = other.elidedCount;
+                discardCount = other.discardCount;
+                maxCount = other.maxCount;
+                maxChunkCount = other.maxChunkCount;
+                maxDataSize = other.maxDataSize;
+
+                other.data.clear();
+                other.uploadData.clear();
+                other.writeChunk = 0;
+                other.readChunk = 0;
                 other.position = 0;
+                other.count = 0;
                 other.current = 0;
+                other.state = State();
+                other.statistics = FrameStatistics();
+                other.elidedCount = 0;
+                other.discardCount = 0;
+                other.maxCount = 0;
+                other.maxChunkCount = 0;
+                other.maxDataSize = 0;
             }
             CommandBuffer& operator=(const CommandBuffer&) = delete;
             CommandBuffer& operator=(CommandBuffer&& other)
             {
                 if (&other != this)
                 {
-                    if (buffer) deleteCommands();
+                    deleteCommands();
 
-                    buffer = std::move(other.buffer);
-                    capacity = other.capacity;
-                    count = other.count;
-                    size = other.size;
+                    chunks = std::move(other.chunks);
+                    data = std::move(other.data);
+                    uploadData = std::move(other.uploadData);
+                    writeChunk = other.writeChunk;
+                    readChunk = other.readChunk;
                     position = other.position;
+                    count = other.count;
                     current = other.current;
-
-                    other.capacity = 0;
-                    other.count = 0;
-                    other.size = 0;
+                    state = other.state;
+                    statistics = other.statistics;
+                    elidedCount = other.elidedCount;
+                    discardCount = other.discardCount;
+                    maxCount = other.maxCount;
+                    maxChunkCount = other.maxChunkCount;
+                    maxDataSize = other.maxDataSize;
+
+                    other.data.clear();
+                    other.uploadData.clear();
+                    other.writeChunk = 0;
+                    other.readChunk = 0;
                     other.position = 0;
+                    other.count = 0;
                     other.current = 0;
+                    other.state = State();
+                    other.statistics = FrameStatistics();
+                    other.elidedCount = 0;
+                    other.discardCount = 0;
+                    other.maxCount = 0;
+                    other.maxChunkCount = 0;
+                    other.maxDataSize = 0;
                 }
 
                 return *this;
@@ -460,187 +601,532 @@ namespace ouzel
 
             ~CommandBuffer()
             {
-                if (buffer) deleteCommands();
+                deleteCommands();
             }
 
             template<typename T> void push(const T& command)
             {
                 static_assert(std::is_base_of<Command, T>::value, "Not derived from Command");
+                static_assert(sizeof(T) <= CHUNK_SIZE, "Command does not fit in a chunk");
 
-                size_t offset = size;
-                if (offset % alignof(Command*) != 0) offset += alignof(Command*) - (offset % alignof(Command*));
+                if (isRedundant(command))
+                {
+                    ++elidedCount;
+                    return;
+                }
+
+                ++statistics.commandCounts[command.type];
+                addStatistics(command);
+
+                if (chunks.empty()) chunks.push_back(Chunk());
+
+                size_t offset = align(chunks[writeChunk].size);
+
+                if (offset + sizeof(T) > CHUNK_SIZE)
+                {
+                    // continue in the next chunk, allocate a new one only if none is retained from the previous frames
+                    if (++writeChunk == chunks.size()) chunks.push_back(Chunk());
+                    offset = 0;
+                }
+
+                Chunk& chunk = chunks[writeChunk];
+                new (chunk.data.get() + offset) T(command);
+                chunk.size = offset + sizeof(T);
+                ++count;
+
+                if (count > maxCount) maxCount = count;
+                if (chunks.size() > maxChunkCount) maxChunkCount = static_cast<uint32_t>(chunks.size());
+            }
+
+            // moves all the commands of the other buffer to the end of this buffer by taking over its chunks
+            void append(CommandBuffer& other)
+            {
+                assert(other.current == 0);
+
+                if (other.count == 0)
+                {
+                    elidedCount += other.elidedCount;
+                    other.elidedCount = 0;
+                    return;
+                }
 
-                if (capacity < offset + sizeof(T))
+                // shader constant and upload offsets are relative to the data of the buffer they were recorded in
+                uint32_t dataOffset = static_cast<uint32_t>(data.size());
+                uint32_t uploadDataOffset = static_cast<uint32_t>(uploadData.size());
+                if ((dataOffset > 0 && !other.data.empty()) ||
+                    (uploadDataOffset > 0 && !other.uploadData.empty()))
                 {
-                    capacity *= 2;
-                    if (capacity < offset + sizeof(T)) capacity = offset + sizeof(T);
-                    std::unique_ptr<uint8_t[]> newBuffer(new uint8_t[capacity]);
-                    if (buffer)
+                    size_t chunkIndex = 0;
+                    size_t offset = 0;
+
+                    for (uint32_t i = 0; i < other.count; ++i)
                     {
-                        moveCommands(newBuffer.get());
-                        deleteCommands();
+                        Command* command = other.getCommand(chunkIndex, offset);
+
+                        if (command->type == Command::Type::SET_SHADER_CONSTANTS)
+                        {
+                            SetShaderConstantsCommand* setShaderConstantsCommand = static_cast<SetShaderConstantsCommand*>(command);
+                            setShaderConstantsCommand->fragmentShaderConstantOffset += dataOffset;
+                            setShaderConstantsCommand->vertexShaderConstantOffset += dataOffset;
+                        }
+                        else if (command->type == Command::Type::UPLOAD_BUFFER_DATA)
+                            static_cast<UploadBufferDataCommand*>(command)->dataOffset += uploadDataOffset;
+
+                        offset += getCommandSize(command);
                     }
-                    buffer = std::move(newBuffer);
                 }
 
-                size = offset + sizeof(T);
-                ++count;
-                new (buffer.get() + offset) T(command);
+                data.insert(data.end(), other.data.begin(), other.data.end());
+                uploadData.insert(uploadData.end(), other.uploadData.begin(), other.uploadData.end());
+
+                // the chunks of the other buffer are inserted after the chunk that is being written
+                size_t usedChunkCount = other.writeChunk + 1;
+                size_t insertPosition = (count == 0) ? 0 : writeChunk + 1;
+
+                std::vector<Chunk> usedChunks;
+                usedChunks.reserve(usedChunkCount);
+                for (size_t i = 0; i < usedChunkCount; ++i)
+                    usedChunks.push_back(std::move(other.chunks[i]));
+
+                // give spare chunks back to the other buffer, so that neither of them has to allocate in the next frame
+                for (size_t i = 0; i < usedChunkCount; ++i)
+                {
+                    if (chunks.size() > insertPosition + ((count == 0) ? 1 : 0))
+                    {
+                        other.chunks[i] = std::move(chunks.back());
+                        chunks.pop_back();
+                        other.chunks[i].size = 0;
+                    }
+                    else
+                        other.chunks[i] = Chunk();
+                }
+
+                chunks.insert(chunks.begin() + static_cast<std::ptrdiff_t>(insertPosition),
+                              std::make_move_iterator(usedChunks.begin()),
+                              std::make_move_iterator(usedChunks.end()));
+
+                writeChunk = insertPosition + usedChunkCount - 1;
+                count += other.count;
+                elidedCount += other.elidedCount;
+                state = other.state;
+
+                for (uint32_t type = 0; type < Command::TYPE_COUNT; ++type)
+                    statistics.commandCounts[type] += other.statistics.commandCounts[type];
+                statistics.drawCallCount += other.statistics.drawCallCount;
+                statistics.indexCount += other.statistics.indexCount;
+                statistics.bufferUploadSize += other.statistics.bufferUploadSize;
+
+                if (count > maxCount) maxCount = count;
+                if (chunks.size() > maxChunkCount) maxChunkCount = static_cast<uint32_t>(chunks.size());
+                if (data.size() > maxDataSize) maxDataSize = static_cast<uint32_t>(data.size());
+
+                other.writeChunk = 0;
+                other.count = 0;
+                other.data.clear();
+                other.uploadData.clear();
+                other.state = State();
+                other.statistics = FrameStatistics();
+                other.elidedCount = 0;
+                other.discardCount = 0;
             }
 
-            Command* front() const
+            // appends the values to the data arena, which is reset together with the commands, and returns their offset
+            uint32_t pushData(const float* values, uint32_t valueCount)
             {
-                if (current >= count) return nullptr;
+                uint32_t offset = static_cast<uint32_t>(data.size());
+                data.insert(data.end(), values, values + valueCount);
+                if (data.size() > maxDataSize) maxDataSize = static_cast<uint32_t>(data.size());
+                return offset;
+            }
 
-                size_t offset = position;
-                if (offset % alignof(Command*) != 0) offset += alignof(Command*) - (offset % alignof(Command*));
-                Command* command = reinterpret_cast<Command*>(buffer.get() + offset);
+            inline const float* getData(uint32_t offset) const { return data.data() + offset; }
+            inline uint32_t getDataSize() const { return static_cast<uint32_t>(data.size()); }
 
-                return command;
+            // reserves space in the upload arena, the returned offset stays valid until the commands are executed,
+            // but the pointer returned by getUploadData only until the next reservation
+            uint32_t reserveUploadData(uint32_t size)
+            {
+                uint32_t offset = static_cast<uint32_t>(uploadData.size());
+                uploadData.resize(uploadData.size() + size);
+                return offset;
             }
 
-            void pop()
+            inline uint8_t* getUploadData(uint32_t offset) { return uploadData.data() + offset; }
+            inline const uint8_t* getUploadData(uint32_t offset) const { return uploadData.data() + offset; }
+
+            inline const FrameStatistics& getStatistics() const { return statistics; }
+
+            // number of state commands that were dropped because they matched the current state
+            inline uint32_t getElidedCount() const { return elidedCount; }
+
+            // high-water marks for tuning the chunk size
+            inline uint32_t getChunkCount() const { return static_cast<uint32_t>(chunks.size()); }
+            inline uint32_t getMaxChunkCount() const { return maxChunkCount; }
+            inline uint32_t getMaxCommandCount() const { return maxCount; }
+            inline uint32_t getMaxDataSize() const { return maxDataSize; }
+
+            Command* front()
             {
-                if (current >= count) return;
+                while (current < count)
+                {
+                    size_t chunkIndex = readChunk;
+                    size_t offset = position;
+                    Command* command = getCommand(chunkIndex, offset);
 
-                if (position % alignof(Command*) != 0) position += alignof(Command*) - (position % alignof(Command*));
-                Command* command = reinterpret_cast<Command*>(buffer.get() + position);
+                    if (current >= discardCount || isResourceCommand(command->type))
+                        return command;
 
-                switch (command->type)
+                    pop();
+                }
+
+                return nullptr;
+            }
+
+            // skips all the frame commands that are currently in the buffer, but keeps the commands that initialize or update resources
+            void discardFrameCommands()
+            {
+                discardCount = count;
+
+                // only the resource commands remain
+                for (uint32_t type = 0; type < Command::TYPE_COUNT; ++type)
                 {
-                    case Command::Type::INIT_RENDER_TARGET: position += deleteCommand(static_cast<InitRenderTargetCommand*>(command)); break;
-                    case Command::Type::SET_RENDER_TARGET_PARAMETERS: position += deleteCommand(static_cast<SetRenderTargetParametersCommand*>(command)); break;
-                    case Command::Type::SET_RENDER_TARGET: position += deleteCommand(static_cast<SetRenderTargetCommand*>(command)); break;
-                    case Command::Type::CLEAR: position += deleteCommand(static_cast<ClearCommand*>(command)); break;
-                    case Command::Type::SET_CULL_MODE: position += deleteCommand(static_cast<SetCullModeCommad*>(command)); break;
-                    case Command::Type::SET_FILL_MODE: position += deleteCommand(static_cast<SetFillModeCommad*>(command)); break;
-                    case Command::Type::SET_SCISSOR_TEST: position += deleteCommand(static_cast<SetScissorTestCommand*>(command)); break;
-                    case Command::Type::SET_VIEWPORT: position += deleteCommand(static_cast<SetViewportCommand*>(command)); break;
-                    case Command::Type::SET_DEPTH_STATE: position += deleteCommand(static_cast<SetDepthStateCommand*>(command)); break;
-                    case Command::Type::SET_PIPELINE_STATE: position += deleteCommand(static_cast<SetPipelineStateCommand*>(command)); break;
-                    case Command::Type::DRAW: position += deleteCommand(static_cast<DrawCommand*>(command)); break;
-                    case Command::Type::PUSH_DEBUG_MARKER: position += deleteCommand(static_cast<PushDebugMarkerCommand*>(command)); break;
-                    case Command::Type::POP_DEBUG_MARKER: position += deleteCommand(static_cast<PopDebugMarkerCommand*>(command)); break;
-                    case Command::Type::INIT_BLEND_STATE: position += deleteCommand(static_cast<InitBlendStateCommand*>(command)); break;
-                    case Command::Type::INIT_BUFFER: position += deleteCommand(static_cast<InitBufferCommand*>(command)); break;
-                    case Command::Type::SET_BUFFER_DATA: position += deleteCommand(static_cast<SetBufferDataCommand*>(command)); break;
-                    case Command::Type::INIT_SHADER: position += deleteCommand(static_cast<InitShaderCommand*>(command)); break;
-                    case Command::Type::SET_SHADER_CONSTANTS: position += deleteCommand(static_cast<SetShaderConstantsCommand*>(command)); break;
-                    case Command::Type::INIT_TEXTURE: position += deleteCommand(static_cast<InitTextureCommand*>(command)); break;
-                    case Command::Type::SET_TEXTURE_DATA: position += deleteCommand(static_cast<SetTextureDataCommand*>(command)); break;
-                    case Command::Type::SET_TEXTURE_PARAMETERS: position += deleteCommand(static_cast<SetTextureParametersCommand*>(command)); break;
-                    case Command::Type::SET_TEXTURES: position += deleteCommand(static_cast<SetTexturesCommand*>(command)); break;
-                    default: break;
+                    if (!isResourceCommand(static_cast<Command::Type>(type))) statistics.commandCounts[type] = 0;
                 }
 
+                statistics.drawCallCount = 0;
+                statistics.indexCount = 0;
+            }
+
+            void pop()
+            {
+                if (current >= count) return;
+
+                Command* command = getCommand(readChunk, position);
+                position += deleteCommand(command);
+
                 ++current;
 
                 if (current == count)
                 {
-                    count = 0;
-                    size = 0;
+                    // keeps the chunks and the data capacity for the next frame
+                    for (Chunk& chunk : chunks)
+                        chunk.size = 0;
+
+                    writeChunk = 0;
+                    readChunk = 0;
                     position = 0;
+                    count = 0;
                     current = 0;
+                    data.clear();
+                    uploadData.clear();
+                    state = State();
+                    statistics = FrameStatistics();
+                    elidedCount = 0;
+                    discardCount = 0;
                 }
             }
 
+            // the device can rebind its textures while updating a texture resource
+            void invalidateTextures()
+            {
+                state.texturesSet = false;
+            }
+
         private:
-            template<typename T> uint32_t deleteCommand(T* command)
+            // state that was last recorded in this buffer, the device state is unknown at the start of the buffer
+            struct State
+            {
+                bool cullModeSet = false;
+                Renderer::CullMode cullMode = Renderer::CullMode::NONE;
+                bool fillModeSet = false;
+                Renderer::FillMode fillMode = Renderer::FillMode::SOLID;
+                bool depthStateSet = false;
+                bool depthTest = false;
+                bool depthWrite = false;
+                bool pipelineStateSet = false;
+                BlendStateResource* blendState = nullptr;
+                ShaderResource* shader = nullptr;
+                bool texturesSet = false;
+                TextureResource* textures[Texture::LAYERS] = {};
+            };
+
+            template<typename T> bool isRedundant(const T&)
+            {
+                return false;
+            }
+
+            // render target change can reset the state of the device (e.g. new render command encoder on Metal)
+            bool isRedundant(const SetRenderTargetCommand&)
+            {
+                state = State();
+                return false;
+            }
+
+            bool isRedundant(const ClearCommand&)
+            {
+                state = State();
+                return false;
+            }
+
+            bool isRedundant(const InitTextureCommand&)
+            {
+                invalidateTextures();
+                return false;
+            }
+
+            bool isRedundant(const SetTextureDataCommand&)
+            {
+                invalidateTextures();
+                return false;
+            }
+
+            bool isRedundant(const SetTextureParametersCommand&)
+            {
+                invalidateTextures();
+                return false;
+            }
+
+            bool isRedundant(const SetCullModeCommad& command)
+            {
+                if (state.cullModeSet && state.cullMode == command.cullMode) return true;
+
+                state.cullModeSet = true;
+                state.cullMode = command.cullMode;
+                return false;
+            }
+
+            bool isRedundant(const SetFillModeCommad& command)
+            {
+                if (state.fillModeSet && state.fillMode == command.fillMode) return true;
+
+                state.fillModeSet = true;
+                state.fillMode = command.fillMode;
+                return false;
+            }
+
+            bool isRedundant(const SetDepthStateCommand& command)
+            {
+                if (state.depthStateSet &&
+                    state.depthTest == command.depthTest &&
+                    state.depthWrite == command.depthWrite) return true;
+
+                state.depthStateSet = true;
+                state.depthTest = command.depthTest;
+                state.depthWrite = command.depthWrite;
+                return false;
+            }
+
+            bool isRedundant(const SetPipelineStateCommand& command)
+            {
+                if (state.pipelineStateSet &&
+                    state.blendState == command.blendState &&
+                    state.shader == command.shader) return true;
+
+                state.pipelineStateSet = true;
+                state.blendState = command.blendState;
+                state.shader = command.shader;
+                return false;
+            }
+
+            bool isRedundant(const SetTexturesCommand& command)
+            {
+                if (state.texturesSet &&
+                    std::equal(std::begin(state.textures), std::end(state.textures), std::begin(command.textures))) return true;
+
+                state.texturesSet = true;
+                std::copy(std::begin(command.textures), std::end(command.textures), std::begin(state.textures));
+                return false;
+            }
+
+            struct Chunk
+            {
+                Chunk():
+                    data(new uint8_t[CHUNK_SIZE])
+                {
+                }
+
+                std::unique_ptr<uint8_t[]> data;
+                size_t size = 0;
+            };
+
+            static inline size_t align(size_t offset)
+            {
+                return (offset % alignof(Command*) != 0) ? offset + alignof(Command*) - (offset % alignof(Command*)) : offset;
+            }
+
+            // advances the chunk index and offset to the next command
+            Command* getCommand(size_t& chunkIndex, size_t& offset) const
+            {
+                offset = align(offset);
+
+                if (offset >= chunks[chunkIndex].size)
+                {
+                    ++chunkIndex;
+                    offset = 0;
+                }
+
+                return reinterpret_cast<Command*>(chunks[chunkIndex].data.get() + offset);
+            }
+
+            template<typename T> static uint32_t deleteCommand(T* command)
             {
                 (void)command; // silence the unreferenced parameter warning in Visual Studio
                 command->~T();
                 return sizeof(*command);
             }
 
-            template<typename T> uint32_t moveCommand(T* command, void* newPointer)
+            template<typename T> void addStatistics(const T&)
             {
-                (void)command; // silence the unreferenced parameter warning in Visual Studio
-                new (newPointer) T(std::move(*command));
-                return sizeof(*command);
             }
 
-            void moveCommands(uint8_t* newBuffer)
+            void addStatistics(const DrawCommand& command)
             {
-                size_t offset = position;
+                ++statistics.drawCallCount;
+                statistics.indexCount += command.indexCount;
+            }
 
-                for (uint32_t i = current; i < count; ++i)
-                {
-                    if (offset % alignof(Command*) != 0) offset += alignof(Command*) - (offset % alignof(Command*));
-                    Command* command = reinterpret_cast<Command*>(buffer.get() + offset);
+            void addStatistics(const DrawInstancedCommand& command)
+            {
+                ++statistics.drawCallCount;
+                statistics.indexCount += static_cast<uint64_t>(command.indexCount) * command.instanceCount;
+            }
 
-                    switch (command->type)
-                    {
-                        case Command::Type::INIT_RENDER_TARGET: offset += moveCommand(static_cast<InitRenderTargetCommand*>(command), newBuffer + offset); break;
-                        case Command::Type::SET_RENDER_TARGET_PARAMETERS: offset += moveCommand(static_cast<SetRenderTargetParametersCommand*>(command), newBuffer + offset); break;
-                        case Command::Type::SET_RENDER_TARGET: offset += moveCommand(static_cast<SetRenderTargetCommand*>(command), newBuffer + offset); break;
-                        case Command::Type::CLEAR: offset += moveCommand(static_cast<ClearCommand*>(command), newBuffer + offset); break;
-                        case Command::Type::SET_CULL_MODE: offset += moveCommand(static_cast<SetCullModeCommad*>(command), newBuffer + offset); break;
-                        case Command::Type::SET_FILL_MODE: offset += moveCommand(static_cast<SetFillModeCommad*>(command), newBuffer + offset); break;
-                        case Command::Type::SET_SCISSOR_TEST: offset += moveCommand(static_cast<SetScissorTestCommand*>(command), newBuffer + offset); break;
-                        case Command::Type::SET_VIEWPORT: offset += moveCommand(static_cast<SetViewportCommand*>(command), newBuffer + offset); break;
-                        case Command::Type::SET_DEPTH_STATE: offset += moveCommand(static_cast<SetDepthStateCommand*>(command), newBuffer + offset); break;
-                        case Command::Type::SET_PIPELINE_STATE: offset += moveCommand(static_cast<SetPipelineStateCommand*>(command), newBuffer + offset); break;
-                        case Command::Type::DRAW: offset += moveCommand(static_cast<DrawCommand*>(command), newBuffer + offset); break;
-                        case Command::Type::PUSH_DEBUG_MARKER: offset += moveCommand(static_cast<PushDebugMarkerCommand*>(command), newBuffer + offset); break;
-                        case Command::Type::POP_DEBUG_MARKER: offset += moveCommand(static_cast<PopDebugMarkerCommand*>(command), newBuffer + offset); break;
-                        case Command::Type::INIT_BLEND_STATE: offset += moveCommand(static_cast<InitBlendStateCommand*>(command), newBuffer + offset); break;
-                        case Command::Type::INIT_BUFFER: offset += moveCommand(static_cast<InitBufferCommand*>(command), newBuffer + offset); break;
-                        case Command::Type::SET_BUFFER_DATA: offset += moveCommand(static_cast<SetBufferDataCommand*>(command), newBuffer + offset); break;
-                        case Command::Type::INIT_SHADER: offset += moveCommand(static_cast<InitShaderCommand*>(command), newBuffer + offset); break;
-                        case Command::Type::SET_SHADER_CONSTANTS: offset += moveCommand(static_cast<SetShaderConstantsCommand*>(command), newBuffer + offset); break;
-                        case Command::Type::INIT_TEXTURE: offset += moveCommand(static_cast<InitTextureCommand*>(command), newBuffer + offset); break;
-                        case Command::Type::SET_TEXTURE_DATA: offset += moveCommand(static_cast<SetTextureDataCommand*>(command), newBuffer + offset); break;
-                        case Command::Type::SET_TEXTURE_PARAMETERS: offset += moveCommand(static_cast<SetTextureParametersCommand*>(command), newBuffer + offset); break;
-                        case Command::Type::SET_TEXTURES: offset += moveCommand(static_cast<SetTexturesCommand*>(command), newBuffer + offset); break;
-                        default: assert(false);
-                    }
+            void addStatistics(const InitBufferCommand& command)
+            {
+                statistics.bufferUploadSize += command.data.size();
+            }
+
+            void addStatistics(const SetBufferDataCommand& command)
+            {
+                statistics.bufferUploadSize += command.data.size();
+            }
+
+            void addStatistics(const SetBufferDataRangeCommand& command)
+            {
+                statistics.bufferUploadSize += command.data.size();
+            }
+
+            void addStatistics(const UploadBufferDataCommand& command)
+            {
+                statistics.bufferUploadSize += command.size;
+            }
+
+            static bool isResourceCommand(Command::Type type)
+            {
+                switch (type)
+                {
+                    case Command::Type::INIT_RENDER_TARGET:
+                    case Command::Type::SET_RENDER_TARGET_PARAMETERS:
+                    case Command::Type::INIT_BLEND_STATE:
+                    case Command::Type::INIT_BUFFER:
+                    case Command::Type::SET_BUFFER_DATA:
+                    case Command::Type::SET_BUFFER_DATA_RANGE:
+                    case Command::Type::UPLOAD_BUFFER_DATA:
+                    case Command::Type::INIT_SHADER:
+                    case Command::Type::INIT_TEXTURE:
+                    case Command::Type::SET_TEXTURE_DATA:
+                    case Command::Type::SET_TEXTURE_PARAMETERS:
+                        return true;
+                    default:
+                        return false;
                 }
             }
 
-            void deleteCommands()
+            static uint32_t getCommandSize(const Command* command)
             {
-                size_t offset = position;
+                switch (command->type)
+                {
+                    case Command::Type::INIT_RENDER_TARGET: return sizeof(InitRenderTargetCommand);
+                    case Command::Type::SET_RENDER_TARGET_PARAMETERS: return sizeof(SetRenderTargetParametersCommand);
+                    case Command::Type::SET_RENDER_TARGET: return sizeof(SetRenderTargetCommand);
+                    case Command::Type::CLEAR: return sizeof(ClearCommand);
+                    case Command::Type::SET_CULL_MODE: return sizeof(SetCullModeCommad);
+                    case Command::Type::SET_FILL_MODE: return sizeof(SetFillModeCommad);
+                    case Command::Type::SET_SCISSOR_TEST: return sizeof(SetScissorTestCommand);
+                    case Command::Type::SET_VIEWPORT: return sizeof(SetViewportCommand);
+                    case Command::Type::SET_DEPTH_STATE: return sizeof(SetDepthStateCommand);
+                    case Command::Type::SET_PIPELINE_STATE: return sizeof(SetPipelineStateCommand);
+                    case Command::Type::DRAW: return sizeof(DrawCommand);
+                    case Command::Type::DRAW_INSTANCED: return sizeof(DrawInstancedCommand);
+                    case Command::Type::PUSH_DEBUG_MARKER: return sizeof(PushDebugMarkerCommand);
+                    case Command::Type::POP_DEBUG_MARKER: return sizeof(PopDebugMarkerCommand);
+                    case Command::Type::INIT_BLEND_STATE: return sizeof(InitBlendStateCommand);
+                    case Command::Type::INIT_BUFFER: return sizeof(InitBufferCommand);
+                    case Command::Type::SET_BUFFER_DATA: return sizeof(SetBufferDataCommand);
+                    case Command::Type::SET_BUFFER_DATA_RANGE: return sizeof(SetBufferDataRangeCommand);
+                    case Command::Type::UPLOAD_BUFFER_DATA: return sizeof(UploadBufferDataCommand);
+                    case Command::Type::INIT_SHADER: return sizeof(InitShaderCommand);
+                    case Command::Type::SET_SHADER_CONSTANTS: return sizeof(SetShaderConstantsCommand);
+                    case Command::Type::INIT_TEXTURE: return sizeof(InitTextureCommand);
+                    case Command::Type::SET_TEXTURE_DATA: return sizeof(SetTextureDataCommand);
+                    case Command::Type::SET_TEXTURE_PARAMETERS: return sizeof(SetTextureParametersCommand);
+                    case Command::Type::SET_TEXTURES: return sizeof(SetTexturesCommand);
+                    default: assert(false);
+                }
 
-                for (uint32_t i = current; i < count; ++i)
+                return 0;
+            }
+
+            static uint32_t deleteCommand(Command* command)
+            {
+                switch (command->type)
                 {
-                    if (offset % alignof(Command*) != 0) offset += alignof(Command*) - (offset % alignof(Command*));
-                    Command* command = reinterpret_cast<Command*>(buffer.get() + offset);
+                    case Command::Type::INIT_RENDER_TARGET: return deleteCommand(static_cast<InitRenderTargetCommand*>(command));
+                    case Command::Type::SET_RENDER_TARGET_PARAMETERS: return deleteCommand(static_cast<SetRenderTargetParametersCommand*>(command));
+                    case Command::Type::SET_RENDER_TARGET: return deleteCommand(static_cast<SetRenderTargetCommand*>(command));
+                    case Command::Type::CLEAR: return deleteCommand(static_cast<ClearCommand*>(command));
+                    case Command::Type::SET_CULL_MODE: return deleteCommand(static_cast<SetCullModeCommad*>(command));
+                    case Command::Type::SET_FILL_MODE: return deleteCommand(static_cast<SetFillModeCommad*>(command));
+                    case Command::Type::SET_SCISSOR_TEST: return deleteCommand(static_cast<SetScissorTestCommand*>(command));
+                    case Command::Type::SET_VIEWPORT: return deleteCommand(static_cast<SetViewportCommand*>(command));
+                    case Command::Type::SET_DEPTH_STATE: return deleteCommand(static_cast<SetDepthStateCommand*>(command));
+                    case Command::Type::SET_PIPELINE_STATE: return deleteCommand(static_cast<SetPipelineStateCommand*>(command));
+                    case Command::Type::DRAW: return deleteCommand(static_cast<DrawCommand*>(command));
+                    case Command::Type::DRAW_INSTANCED: return deleteCommand(static_cast<DrawInstancedCommand*>(command));
+                    case Command::Type::PUSH_DEBUG_MARKER: return deleteCommand(static_cast<PushDebugMarkerCommand*>(command));
+                    case Command::Type::POP_DEBUG_MARKER: return deleteCommand(static_cast<PopDebugMarkerCommand*>(command));
+                    case Command::Type::INIT_BLEND_STATE: return deleteCommand(static_cast<InitBlendStateCommand*>(command));
+                    case Command::Type::INIT_BUFFER: return deleteCommand(static_cast<InitBufferCommand*>(command));
+                    case Command::Type::SET_BUFFER_DATA: return deleteCommand(static_cast<SetBufferDataCommand*>(command));
+                    case Command::Type::SET_BUFFER_DATA_RANGE: return deleteCommand(static_cast<SetBufferDataRangeCommand*>(command));
+                    case Command::Type::UPLOAD_BUFFER_DATA: return deleteCommand(static_cast<UploadBufferDataCommand*>(command));
+                    case Command::Type::INIT_SHADER: return deleteCommand(static_cast<InitShaderCommand*>(command));
+                    case Command::Type::SET_SHADER_CONSTANTS: return deleteCommand(static_cast<SetShaderConstantsCommand*>(command));
+                    case Command::Type::INIT_TEXTURE: return deleteCommand(static_cast<InitTextureCommand*>(command));
+                    case Command::Type::SET_TEXTURE_DATA: return deleteCommand(static_cast<SetTextureDataCommand*>(command));
+                    case Command::Type::SET_TEXTURE_PARAMETERS: return deleteCommand(static_cast<SetTextureParametersCommand*>(command));
+                    case Command::Type::SET_TEXTURES: return deleteCommand(static_cast<SetTexturesCommand*>(command));
+                    default: assert(false);
+                }
 
-                    switch (command->type)
-                    {
-                        case Command::Type::INIT_RENDER_TARGET: offset += deleteCommand(static_cast<InitRenderTargetCommand*>(command)); break;
-                        case Command::Type::SET_RENDER_TARGET_PARAMETERS: offset += deleteCommand(static_cast<SetRenderTargetParametersCommand*>(command)); break;
-                        case Command::Type::SET_RENDER_TARGET: offset += deleteCommand(static_cast<SetRenderTargetCommand*>(command)); break;
-                        case Command::Type::CLEAR: offset += deleteCommand(static_cast<ClearCommand*>(command)); break;
-                        case Command::Type::SET_CULL_MODE: offset += deleteCommand(static_cast<SetCullModeCommad*>(command)); break;
-                        case Command::Type::SET_FILL_MODE: offset += deleteCommand(static_cast<SetFillModeCommad*>(command)); break;
-                        case Command::Type::SET_SCISSOR_TEST: offset += deleteCommand(static_cast<SetScissorTestCommand*>(command)); break;
-                        case Command::Type::SET_VIEWPORT: offset += deleteCommand(static_cast<SetViewportCommand*>(command)); break;
-                        case Command::Type::SET_DEPTH_STATE: offset += deleteCommand(static_cast<SetDepthStateCommand*>(command)); break;
-                        case Command::Type::SET_PIPELINE_STATE: offset += deleteCommand(static_cast<SetPipelineStateCommand*>(command)); break;
-                        case Command::Type::DRAW: offset += deleteCommand(static_cast<DrawCommand*>(command)); break;
-                        case Command::Type::PUSH_DEBUG_MARKER: offset += deleteCommand(static_cast<PushDebugMarkerCommand*>(command)); break;
-                        case Command::Type::POP_DEBUG_MARKER: offset += deleteCommand(static_cast<PopDebugMarkerCommand*>(command)); break;
-                        case Command::Type::INIT_BLEND_STATE: offset += deleteCommand(static_cast<InitBlendStateCommand*>(command)); break;
-                        case Command::Type::INIT_BUFFER: offset += deleteCommand(static_cast<InitBufferCommand*>(command)); break;
-                        case Command::Type::SET_BUFFER_DATA: offset += deleteCommand(static_cast<SetBufferDataCommand*>(command)); break;
-                        case Command::Type::INIT_SHADER: offset += deleteCommand(static_cast<InitShaderCommand*>(command)); break;
-                        case Command::Type::SET_SHADER_CONSTANTS: offset += deleteCommand(static_cast<SetShaderConstantsCommand*>(command)); break;
-                        case Command::Type::INIT_TEXTURE: offset += deleteCommand(static_cast<InitTextureCommand*>(command)); break;
-                        case Command::Type::SET_TEXTURE_DATA: offset += deleteCommand(static_cast<SetTextureDataCommand*>(command)); break;
-                        case Command::Type::SET_TEXTURE_PARAMETERS: offset += deleteCommand(static_cast<SetTextureParametersCommand*>(command)); break;
-                        case Command::Type::SET_TEXTURES: offset += deleteCommand(static_cast<SetTexturesCommand*>(command)); break;
-                        default: assert(false);
-                    }
+                return 0;
+            }
+
+            void deleteCommands()
+            {
+                while (current < count)
+                {
+                    Command* command = getCommand(readChunk, position);
+                    position += deleteCommand(command);
+                    ++current;
                 }
             }
 
-            std::unique_ptr<uint8_t[]> buffer;
-            size_t capacity = 0;
-            size_t size = 0; // write position
-            size_t position = 0; // read postion
+            std::vector<Chunk> chunks;
+            std::vector<float> data;
+            std::vector<uint8_t> uploadData;
+            size_t writeChunk = 0; // chunk that is being written
+            size_t readChunk = 0; // chunk that is being read
+            size_t position = 0; // read position in the read chunk
             uint32_t count = 0;
             uint32_t current = 0;
+            State state;
+            FrameStatistics statistics;
+            uint32_t elidedCount = 0;
+            uint32_t discardCount = 0; // number of commands from which only the resource commands are executed
+            uint32_t maxCount = 0;
+            uint32_t maxChunkCount = 0;
+            uint32_t maxDataSize = 0;
         };
     } // namespace graphics
 } // namespace ouzel
@@ -0,0 +1,152 @@
+// Copyright 2015-2018 Elviss Strazdins. All rights reserved.
+
+#include <algorithm>
+#include "ImageDataDDS.hpp"
+#include "utils/Errors.hpp"
+#include "utils/Utils.hpp"
+
+namespace ouzel
+{
+    namespace graphics
+    {
+        static const uint32_t DDS_HEADER_SIZE = 128; // magic and DDS_HEADER
+        static const uint32_t DDS_DX10_HEADER_SIZE = 20;
+
+        static const uint32_t DDSD_MIPMAPCOUNT = 0x20000;
+        static const uint32_t DDPF_FOURCC = 0x4;
+        static const uint32_t DDPF_RGB = 0x40;
+        static const uint32_t DDSCAPS2_CUBEMAP = 0x200;
+        static const uint32_t DDSCAPS2_VOLUME = 0x200000;
+        static const uint32_t D3D10_RESOURCE_DIMENSION_TEXTURE2D = 3;
+
+        static uint32_t makeFourCC(char a, char b, char c, char d)
+        {
+            return static_cast<uint32_t>(static_cast<uint8_t>(a)) |
+                static_cast<uint32_t>(static_cast<uint8_t>(b)) << 8 |
+                static_cast<uint32_t>(static_cast<uint8_t>(c)) << 16 |
+                static_cast<uint32_t>(static_cast<uint8_t>(d)) << 24;
+        }
+
+        static PixelFormat getDXGIPixelFormat(uint32_t dxgiFormat)
+        {
+            switch (dxgiFormat)
+            {
+                case 28: return PixelFormat::RGBA8_UNORM; // DXGI_FORMAT_R8G8B8A8_UNORM
+                case 49: return PixelFormat::RG8_UNORM; // DXGI_FORMAT_R8G8_UNORM
+                case 61: return PixelFormat::R8_UNORM; // DXGI_FORMAT_R8_UNORM
+                case 65: return PixelFormat::A8_UNORM; // DXGI_FORMAT_A8_UNORM
+                case 71: return PixelFormat::BC1_UNORM; // DXGI_FORMAT_BC1_UNORM
+                case 74: return PixelFormat::BC2_UNORM; // DXGI_FORMAT_BC2_UNORM
+                case 77: return PixelFormat::BC3_UNORM; // DXGI_FORMAT_BC3_UNORM
+                case 80: return PixelFormat::BC4_UNORM; // DXGI_FORMAT_BC4_UNORM
+                case 83: return PixelFormat::BC5_UNORM; // DXGI_FORMAT_BC5_UNORM
+                case 98: return PixelFormat::BC7_UNORM; // DXGI_FORMAT_BC7_UNORM
+                default: return PixelFormat::DEFAULT;
+            }
+        }
+
+        ImageDataDDS::ImageDataDDS(const std::vector<uint8_t>& newData, uint32_t maxSize)
+        {
+            if (newData.size() < DDS_HEADER_SIZE ||
+                decodeUInt32Little(newData.data()) != makeFourCC('D', 'D', 'S', ' ') ||
+                decodeUInt32Little(newData.data() + 4) != 124)
+                throw ParseError("Not a DDS file");
+
+            uint32_t flags = decodeUInt32Little(newData.data() + 8);
+            uint32_t height = decodeUInt32Little(newData.data() + 12);
+            uint32_t width = decodeUInt32Little(newData.data() + 16);
+            uint32_t levelCount = decodeUInt32Little(newData.data() + 28);
+            uint32_t pixelFormatFlags = decodeUInt32Little(newData.data() + 80);
+            uint32_t fourCC = decodeUInt32Little(newData.data() + 84);
+            uint32_t rgbBitCount = decodeUInt32Little(newData.data() + 88);
+            uint32_t redMask = decodeUInt32Little(newData.data() + 92);
+            uint32_t greenMask = decodeUInt32Little(newData.data() + 96);
+            uint32_t blueMask = decodeUInt32Little(newData.data() + 100);
+            uint32_t alphaMask = decodeUInt32Little(newData.data() + 104);
+            uint32_t caps2 = decodeUInt32Little(newData.data() + 112);
+
+            if (width == 0 || height == 0)
+                throw ParseError("Invalid DDS image size");
+
+            if (maxSize && (width > maxSize || height > maxSize))
+                throw ParseError("DDS image is too big");
+
+            if (caps2 & (DDSCAPS2_CUBEMAP | DDSCAPS2_VOLUME))
+                throw ParseError("Only 2D DDS images are supported");
+
+            size_t offset = DDS_HEADER_SIZE;
+
+            if (pixelFormatFlags & DDPF_FOURCC)
+            {
+                if (fourCC == makeFourCC('D', 'X', '1', '0'))
+                {
+                    if (newData.size() < DDS_HEADER_SIZE + DDS_DX10_HEADER_SIZE)
+                        throw ParseError("Not enough data");
+
+                    uint32_t dxgiFormat = decodeUInt32Little(newData.data() + 128);
+                    uint32_t resourceDimension = decodeUInt32Little(newData.data() + 132);
+                    uint32_t miscFlags = decodeUInt32Little(newData.data() + 136);
+                    uint32_t arraySize = decodeUInt32Little(newData.data() + 140);
+
+                    // 0x4 is D3D11_RESOURCE_MISC_TEXTURECUBE
+                    if (resourceDimension != D3D10_RESOURCE_DIMENSION_TEXTURE2D || (miscFlags & 0x4) || arraySize > 1)
+                        throw ParseError("Only 2D DDS images are supported");
+
+                    pixelFormat = getDXGIPixelFormat(dxgiFormat);
+
+                    if (pixelFormat == PixelFormat::DEFAULT)
+                        throw ParseError("Unsupported DXGI format " + std::to_string(dxgiFormat));
+
+                    offset += DDS_DX10_HEADER_SIZE;
+                }
+                else if (fourCC == makeFourCC('D', 'X', 'T', '1'))
+                    pixelFormat = PixelFormat::BC1_UNORM;
+                else if (fourCC == makeFourCC('D', 'X', 'T', '3'))
+                    pixelFormat = PixelFormat::BC2_UNORM;
+                else if (fourCC == makeFourCC('D', 'X', 'T', '5'))
+                    pixelFormat = PixelFormat::BC3_UNORM;
+                else if (fourCC == makeFourCC('A', 'T', 'I', '1') ||
+                         fourCC == makeFourCC('B', 'C', '4', 'U'))
+                    pixelFormat = PixelFormat::BC4_UNORM;
+                else if (fourCC == makeFourCC('A', 'T', 'I', '2') ||
+                         fourCC == makeFourCC('B', 'C', '5', 'U'))
+                    pixelFormat = PixelFormat::BC5_UNORM;
+                else
+                    throw ParseError("Unsupported DDS FourCC");
+            }
+            else if ((pixelFormatFlags & DDPF_RGB) && rgbBitCount == 32 &&
+                     redMask == 0x000000FF && greenMask == 0x0000FF00 &&
+                     blueMask == 0x00FF0000 && alphaMask == 0xFF000000)
+                pixelFormat = PixelFormat::RGBA8_UNORM;
+            else
+                throw ParseError("Unsupported DDS pixel format");
+
+            if (!(flags & DDSD_MIPMAPCOUNT) || levelCount == 0) levelCount = 1;
+
+            if (levelCount > getMaxLevelCount(width, height))
+                throw ParseError("Invalid DDS level count");
+
+            size.width = static_cast<float>(width);
+            size.height = static_cast<float>(height);
+
+            for (uint32_t level = 0; level < levelCount; ++level)
+            {
+                uint32_t levelWidth = std::max(width >> level, 1U);
+                uint32_t levelHeight = std::max(height >> level, 1U);
+                uint32_t levelSize = getLevelDataSize(pixelFormat, levelWidth, levelHeight);
+
+                if (levelSize > newData.size() - offset)
+                    throw ParseError("Not enough data");
+
+                Texture::Level textureLevel;
+                textureLevel.size = Size2(static_cast<float>(levelWidth), static_cast<float>(levelHeight));
+                textureLevel.pitch = getPitch(pixelFormat, levelWidth);
+                textureLevel.data.assign(newData.begin() + static_cast<std::ptrdiff_t>(offset),
+                                         newData.begin() + static_cast<std::ptrdiff_t>(offset + levelSize));
+                levels.push_back(std::move(textureLevel));
+
+                offset += levelSize;
+            }
+        }
+    } // namespace graphics
+} // namespace ouzel
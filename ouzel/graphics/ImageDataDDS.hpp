@@ -0,0 +1,28 @@
+// Copyright 2015-2018 Elviss Strazdins. All rights reserved.
+
+#pragma once
+
+#include <vector>
+#include "graphics/ImageData.hpp"
+#include "graphics/Texture.hpp"
+
+namespace ouzel
+{
+    namespace graphics
+    {
+        // DDS container (with an optional DX10 header) with a single 2D image and its precomputed mip levels
+        class ImageDataDDS: public ImageData
+        {
+        public:
+            ImageDataDDS() {}
+
+            // images wider or higher than maxSize are rejected, zero for no limit
+            explicit ImageDataDDS(const std::vector<uint8_t>& newData, uint32_t maxSize = 0);
+
+            inline const std::vector<Texture::Level>& getLevels() const { return levels; }
+
+        private:
+            std::vector<Texture::Level> levels;
+        };
+    } // namespace graphics
+} // namespace ouzel
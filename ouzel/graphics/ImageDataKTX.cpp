@@ -0,0 +1,119 @@
+// Copyright 2015-2018 Elviss Strazdins. All rights reserved.
+
+#include <algorithm>
+#include "ImageDataKTX.hpp"
+#include "utils/Errors.hpp"
+#include "utils/Utils.hpp"
+
+namespace ouzel
+{
+    namespace graphics
+    {
+        static const uint8_t KTX_IDENTIFIER[] = {0xAB, 0x4B, 0x54, 0x58, 0x20, 0x31, 0x31, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A};
+        static const uint32_t KTX_HEADER_SIZE = 64;
+
+        static PixelFormat getKTXPixelFormat(uint32_t glInternalFormat)
+        {
+            switch (glInternalFormat)
+            {
+                case 0x8229: return PixelFormat::R8_UNORM; // GL_R8
+                case 0x822B: return PixelFormat::RG8_UNORM; // GL_RG8
+                case 0x8058: return PixelFormat::RGBA8_UNORM; // GL_RGBA8
+                case 0x83F1: return PixelFormat::BC1_UNORM; // GL_COMPRESSED_RGBA_S3TC_DXT1_EXT
+                case 0x83F2: return PixelFormat::BC2_UNORM; // GL_COMPRESSED_RGBA_S3TC_DXT3_EXT
+                case 0x83F3: return PixelFormat::BC3_UNORM; // GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+                case 0x8DBB: return PixelFormat::BC4_UNORM; // GL_COMPRESSED_RED_RGTC1
+                case 0x8DBD: return PixelFormat::BC5_UNORM; // GL_COMPRESSED_RG_RGTC2
+                case 0x8E8C: return PixelFormat::BC7_UNORM; // GL_COMPRESSED_RGBA_BPTC_UNORM
+                case 0x9274: return PixelFormat::ETC2_RGB8_UNORM; // GL_COMPRESSED_RGB8_ETC2
+                case 0x9278: return PixelFormat::ETC2_RGBA8_UNORM; // GL_COMPRESSED_RGBA8_ETC2_EAC
+                case 0x93B0: return PixelFormat::ASTC_4X4_UNORM; // GL_COMPRESSED_RGBA_ASTC_4x4_KHR
+                case 0x93B7: return PixelFormat::ASTC_8X8_UNORM; // GL_COMPRESSED_RGBA_ASTC_8x8_KHR
+                default: return PixelFormat::DEFAULT;
+            }
+        }
+
+        ImageDataKTX::ImageDataKTX(const std::vector<uint8_t>& newData, uint32_t maxSize)
+        {
+            if (newData.size() < KTX_HEADER_SIZE ||
+                !std::equal(std::begin(KTX_IDENTIFIER), std::end(KTX_IDENTIFIER), newData.begin()))
+                throw ParseError("Not a KTX file");
+
+            bool bigEndian;
+            uint32_t endianness = decodeUInt32Little(newData.data() + 12);
+
+            if (endianness == 0x04030201) bigEndian = false;
+            else if (endianness == 0x01020304) bigEndian = true;
+            else throw ParseError("Invalid KTX endianness");
+
+            auto decodeUInt32 = [bigEndian](const uint8_t* buffer) {
+                return bigEndian ? decodeUInt32Big(buffer) : decodeUInt32Little(buffer);
+            };
+
+            uint32_t glInternalFormat = decodeUInt32(newData.data() + 28);
+            uint32_t width = decodeUInt32(newData.data() + 36);
+            uint32_t height = decodeUInt32(newData.data() + 40);
+            uint32_t depth = decodeUInt32(newData.data() + 44);
+            uint32_t arrayElementCount = decodeUInt32(newData.data() + 48);
+            uint32_t faceCount = decodeUInt32(newData.data() + 52);
+            uint32_t levelCount = decodeUInt32(newData.data() + 56);
+            uint32_t keyValueDataSize = decodeUInt32(newData.data() + 60);
+
+            if (width == 0 || height == 0)
+                throw ParseError("Invalid KTX image size");
+
+            if (maxSize && (width > maxSize || height > maxSize))
+                throw ParseError("KTX image is too big");
+
+            if (depth > 0 || arrayElementCount > 0 || faceCount != 1)
+                throw ParseError("Only 2D KTX images are supported");
+
+            pixelFormat = getKTXPixelFormat(glInternalFormat);
+
+            if (pixelFormat == PixelFormat::DEFAULT)
+                throw ParseError("Unsupported KTX pixel format " + std::to_string(glInternalFormat));
+
+            // zero levels means that the mip levels should be generated by the loader
+            if (levelCount == 0) levelCount = 1;
+
+            if (levelCount > getMaxLevelCount(width, height))
+                throw ParseError("Invalid KTX level count");
+
+            size.width = static_cast<float>(width);
+            size.height = static_cast<float>(height);
+
+            if (keyValueDataSize > newData.size() - KTX_HEADER_SIZE)
+                throw ParseError("Not enough data");
+
+            size_t offset = KTX_HEADER_SIZE + keyValueDataSize;
+
+            for (uint32_t level = 0; level < levelCount; ++level)
+            {
+                if (offset > newData.size() || sizeof(uint32_t) > newData.size() - offset)
+                    throw ParseError("Not enough data");
+
+                uint32_t imageSize = decodeUInt32(newData.data() + offset);
+                offset += sizeof(uint32_t);
+
+                uint32_t levelWidth = std::max(width >> level, 1U);
+                uint32_t levelHeight = std::max(height >> level, 1U);
+
+                if (imageSize != getLevelDataSize(pixelFormat, levelWidth, levelHeight))
+                    throw ParseError("Invalid KTX level size");
+
+                if (imageSize > newData.size() - offset)
+                    throw ParseError("Not enough data");
+
+                Texture::Level textureLevel;
+                textureLevel.size = Size2(static_cast<float>(levelWidth), static_cast<float>(levelHeight));
+                textureLevel.pitch = getPitch(pixelFormat, levelWidth);
+                textureLevel.data.assign(newData.begin() + static_cast<std::ptrdiff_t>(offset),
+                                         newData.begin() + static_cast<std::ptrdiff_t>(offset + imageSize));
+                levels.push_back(std::move(textureLevel));
+
+                // levels are padded to 4 bytes
+                offset += (static_cast<size_t>(imageSize) + 3) & ~static_cast<size_t>(3);
+            }
+        }
+    } // namespace graphics
+} // namespace ouzel
@@ -60,12 +60,29 @@ namespace ouzel
             size.height = static_cast<float>(height);
         }
 
+        ImageDataSTB::ImageDataSTB(const Size2& newSize,
+                                   const std::vector<uint8_t>& newData,
+                                   PixelFormat newPixelFormat)
+        {
+            size = newSize;
+            data = newData;
+            pixelFormat = newPixelFormat;
+        }
+
         std::vector<uint8_t> ImageDataSTB::encode() const
         {
+            if (getChannelSize(pixelFormat) != 1 || isCompressed(pixelFormat))
+                throw DataError("Only images with 8-bit channels can be encoded");
+
             int len;
-            int x, y;
-            int comp;
-            int strideBytes;
+            int x = static_cast<int>(size.width);
+            int y = static_cast<int>(size.height);
+            int comp = static_cast<int>(getChannelCount(pixelFormat));
+            int strideBytes = x * static_cast<int>(getPixelSize(pixelFormat));
+
+            if (data.size() < static_cast<size_t>(strideBytes) * static_cast<size_t>(y))
+                throw DataError("Invalid image data size");
+
             std::unique_ptr<unsigned char, std::function<void(unsigned char*)>> png(stbi_write_png_to_mem(const_cast<unsigned char*>(data.data()),
                                                                                                           strideBytes, x, y, comp, &len),
                                                                                     [](unsigned char* p){ STBI_FREE(p); });
@@ -16,6 +16,10 @@ namespace ouzel
 
             ImageDataSTB(const std::vector<uint8_t>& newData,
                          PixelFormat newPixelFormat = PixelFormat::RGBA8_UNORM);
+            // wraps raw pixels, so that they can be encoded
+            ImageDataSTB(const Size2& newSize,
+                         const std::vector<uint8_t>& newData,
+                         PixelFormat newPixelFormat);
 
             std::vector<uint8_t> encode() const;
         };
@@ -0,0 +1,603 @@
+// Copyright 2015-2018 Elviss Strazdins. All rights reserved.
+
+#include <cmath>
+#include <vector>
+#include "core/Setup.h"
+#if OUZEL_SUPPORTS_NEON
+#include <arm_neon.h>
+#elif OUZEL_SUPPORTS_SSE2
+#include <emmintrin.h>
+#endif
+#include "ImageDownsample.hpp"
+#include "utils/Errors.hpp"
+#include "utils/Utils.hpp"
+
+extern uint8_t GAMMA_ENCODE[256];
+extern float GAMMA_DECODE[256];
+
+namespace ouzel
+{
+    namespace graphics
+    {
+        // GAMMA_DECODE holds rounded values, so the sums of the decoded values are exact integers and the
+        // divisions and roundf of the scalar downsampling can be done with integer arithmetic without changing the result
+        static void gammaDecodeRow(const uint8_t* decodeTable, const uint8_t* src, uint8_t* dst, uint32_t size, bool alpha)
+        {
+            if (alpha)
+            {
+                for (uint32_t i = 0; i < size; i += 4)
+                {
+                    dst[i + 0] = decodeTable[src[i + 0]];
+                    dst[i + 1] = decodeTable[src[i + 1]];
+                    dst[i + 2] = decodeTable[src[i + 2]];
+                    dst[i + 3] = src[i + 3];
+                }
+            }
+            else
+            {
+                for (uint32_t i = 0; i < size; ++i)
+                    dst[i] = decodeTable[src[i]];
+            }
+        }
+
+        static void gammaEncodeRow(uint8_t* data, uint32_t size, bool alpha)
+        {
+            if (alpha)
+            {
+                for (uint32_t i = 0; i < size; i += 4)
+                {
+                    data[i + 0] = GAMMA_ENCODE[data[i + 0]];
+                    data[i + 1] = GAMMA_ENCODE[data[i + 1]];
+                    data[i + 2] = GAMMA_ENCODE[data[i + 2]];
+                }
+            }
+            else
+            {
+                for (uint32_t i = 0; i < size; ++i)
+                    data[i] = GAMMA_ENCODE[data[i]];
+            }
+        }
+
+        // averages 2x2 blocks of single channel rows, the result is rounded if round is set and truncated otherwise
+        static void downsampleRow1(const uint8_t* top, const uint8_t* bottom, uint8_t* dst, uint32_t dstWidth,
+                                   bool round, bool vectorized)
+        {
+            uint32_t x = 0;
+            const uint32_t vectorWidth = vectorized ? dstWidth : 0;
+
+#if OUZEL_SUPPORTS_NEON
+#  if OUZEL_SUPPORTS_NEON_CHECK
+            if (anrdoidNEONChecker.isNEONAvailable())
+#  endif
+            {
+                for (; x + 8 <= vectorWidth; x += 8, top += 16, bottom += 16, dst += 8)
+                {
+                    uint16x8_t sum = vaddq_u16(vpaddlq_u8(vld1q_u8(top)), vpaddlq_u8(vld1q_u8(bottom)));
+                    vst1_u8(dst, round ? vrshrn_n_u16(sum, 2) : vshrn_n_u16(sum, 2));
+                }
+            }
+#elif OUZEL_SUPPORTS_SSE2
+            const __m128i lowMask = _mm_set1_epi16(0x00FF);
+            const __m128i bias = _mm_set1_epi16(round ? 2 : 0);
+
+            for (; x + 8 <= vectorWidth; x += 8, top += 16, bottom += 16, dst += 8)
+            {
+                __m128i t = _mm_loadu_si128(reinterpret_cast<const __m128i*>(top));
+                __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bottom));
+
+                __m128i sum = _mm_add_epi16(_mm_add_epi16(_mm_and_si128(t, lowMask), _mm_srli_epi16(t, 8)),
+                                            _mm_add_epi16(_mm_and_si128(b, lowMask), _mm_srli_epi16(b, 8)));
+                sum = _mm_srli_epi16(_mm_add_epi16(sum, bias), 2);
+
+                _mm_storel_epi64(reinterpret_cast<__m128i*>(dst), _mm_packus_epi16(sum, sum));
+            }
+#endif
+
+            for (; x < dstWidth; ++x, top += 2, bottom += 2, dst += 1)
+            {
+                uint32_t sum = top[0] + top[1] + bottom[0] + bottom[1];
+                dst[0] = static_cast<uint8_t>((sum + (round ? 2 : 0)) >> 2);
+            }
+        }
+
+        // averages 2x2 blocks of two channel rows with rounding
+        static void downsampleRow2(const uint8_t* top, const uint8_t* bottom, uint8_t* dst, uint32_t dstWidth,
+                                   bool vectorized)
+        {
+            uint32_t x = 0;
+            const uint32_t vectorWidth = vectorized ? dstWidth : 0;
+
+#if OUZEL_SUPPORTS_NEON
+#  if OUZEL_SUPPORTS_NEON_CHECK
+            if (anrdoidNEONChecker.isNEONAvailable())
+#  endif
+            {
+                for (; x + 8 <= vectorWidth; x += 8, top += 32, bottom += 32, dst += 16)
+                {
+                    uint8x16x2_t t = vld2q_u8(top);
+                    uint8x16x2_t b = vld2q_u8(bottom);
+                    uint8x8x2_t result;
+                    result.val[0] = vrshrn_n_u16(vaddq_u16(vpaddlq_u8(t.val[0]), vpaddlq_u8(b.val[0])), 2);
+                    result.val[1] = vrshrn_n_u16(vaddq_u16(vpaddlq_u8(t.val[1]), vpaddlq_u8(b.val[1])), 2);
+                    vst2_u8(dst, result);
+                }
+            }
+#elif OUZEL_SUPPORTS_SSE2
+            const __m128i zero = _mm_setzero_si128();
+            const __m128i bias = _mm_set1_epi16(2);
+
+            for (; x + 4 <= vectorWidth; x += 4, top += 16, bottom += 16, dst += 8)
+            {
+                __m128i t = _mm_loadu_si128(reinterpret_cast<const __m128i*>(top));
+                __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bottom));
+
+                // every 32-bit lane holds both channels of a pixel
+                __m128i low = _mm_add_epi16(_mm_unpacklo_epi8(t, zero), _mm_unpacklo_epi8(b, zero));
+                __m128i high = _mm_add_epi16(_mm_unpackhi_epi8(t, zero), _mm_unpackhi_epi8(b, zero));
+
+                low = _mm_add_epi16(_mm_shuffle_epi32(low, _MM_SHUFFLE(2, 0, 2, 0)), _mm_shuffle_epi32(low, _MM_SHUFFLE(3, 1, 3, 1)));
+                high = _mm_add_epi16(_mm_shuffle_epi32(high, _MM_SHUFFLE(2, 0, 2, 0)), _mm_shuffle_epi32(high, _MM_SHUFFLE(3, 1, 3, 1)));
+
+                __m128i sum = _mm_srli_epi16(_mm_add_epi16(_mm_unpacklo_epi64(low, high), bias), 2);
+
+                _mm_storel_epi64(reinterpret_cast<__m128i*>(dst), _mm_packus_epi16(sum, sum));
+            }
+#endif
+
+            for (; x < dstWidth; ++x, top += 4, bottom += 4, dst += 2)
+            {
+                dst[0] = static_cast<uint8_t>((top[0] + top[2] + bottom[0] + bottom[2] + 2) >> 2);
+                dst[1] = static_cast<uint8_t>((top[1] + top[3] + bottom[1] + bottom[3] + 2) >> 2);
+            }
+        }
+
+#if OUZEL_SUPPORTS_SSE2 && !OUZEL_SUPPORTS_NEON
+        // sets all the lanes of a pixel to 0xFFFF if its alpha is not zero
+        static inline __m128i getAlphaMask(__m128i pixels)
+        {
+            __m128i alpha = _mm_shufflehi_epi16(_mm_shufflelo_epi16(pixels, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+            return _mm_cmpgt_epi16(alpha, _mm_setzero_si128());
+        }
+
+        // adds the 64-bit halves of both vectors and packs the results into a single vector
+        static inline __m128i addHalves(__m128i first, __m128i second)
+        {
+            return _mm_unpacklo_epi64(_mm_add_epi16(first, _mm_srli_si128(first, 8)),
+                                      _mm_add_epi16(second, _mm_srli_si128(second, 8)));
+        }
+#endif
+
+        // averages the color of the 2x2 blocks over the pixels with a non-zero alpha (with rounding)
+        // and the alpha over all the pixels (with truncation)
+        static void downsampleRow4(const uint8_t* top, const uint8_t* bottom, uint8_t* dst, uint32_t dstWidth,
+                                   bool vectorized)
+        {
+            uint32_t x = 0;
+            const uint32_t vectorWidth = vectorized ? dstWidth : 0;
+
+            // round(sum / count) = (2 * sum + count) / (2 * count), the division is done by a multiplication with
+            // 65536 / (2 * count) and a shift by 16, which is exact for all the sums of up to four pixels
+#if OUZEL_SUPPORTS_NEON
+#  if OUZEL_SUPPORTS_NEON_CHECK
+            if (anrdoidNEONChecker.isNEONAvailable())
+#  endif
+            {
+                const uint8x16_t zero = vdupq_n_u8(0);
+                const uint8x16_t one = vdupq_n_u8(1);
+
+                for (; x + 8 <= vectorWidth; x += 8, top += 64, bottom += 64, dst += 32)
+                {
+                    uint8x16x4_t t = vld4q_u8(top);
+                    uint8x16x4_t b = vld4q_u8(bottom);
+
+                    uint8x16_t topMask = vcgtq_u8(t.val[3], zero);
+                    uint8x16_t bottomMask = vcgtq_u8(b.val[3], zero);
+
+                    uint16x8_t count = vaddq_u16(vpaddlq_u8(vandq_u8(topMask, one)), vpaddlq_u8(vandq_u8(bottomMask, one)));
+
+                    uint16x8_t multiplier = vandq_u16(vceqq_u16(count, vdupq_n_u16(1)), vdupq_n_u16(32768));
+                    multiplier = vorrq_u16(multiplier, vandq_u16(vceqq_u16(count, vdupq_n_u16(2)), vdupq_n_u16(16384)));
+                    multiplier = vorrq_u16(multiplier, vandq_u16(vceqq_u16(count, vdupq_n_u16(3)), vdupq_n_u16(10923)));
+                    multiplier = vorrq_u16(multiplier, vandq_u16(vceqq_u16(count, vdupq_n_u16(4)), vdupq_n_u16(8192)));
+
+                    uint8x8x4_t result;
+
+                    for (int channel = 0; channel < 3; ++channel)
+                    {
+                        uint16x8_t sum = vaddq_u16(vpaddlq_u8(vandq_u8(t.val[channel], topMask)),
+                                                   vpaddlq_u8(vandq_u8(b.val[channel], bottomMask)));
+                        uint16x8_t value = vaddq_u16(vshlq_n_u16(sum, 1), count);
+
+                        uint32x4_t low = vmull_u16(vget_low_u16(value), vget_low_u16(multiplier));
+                        uint32x4_t high = vmull_u16(vget_high_u16(value), vget_high_u16(multiplier));
+
+                        result.val[channel] = vmovn_u16(vcombine_u16(vshrn_n_u32(low, 16), vshrn_n_u32(high, 16)));
+                    }
+
+                    result.val[3] = vshrn_n_u16(vaddq_u16(vpaddlq_u8(t.val[3]), vpaddlq_u8(b.val[3])), 2);
+
+                    vst4_u8(dst, result);
+                }
+            }
+#elif OUZEL_SUPPORTS_SSE2
+            const __m128i zero = _mm_setzero_si128();
+            const __m128i one = _mm_set1_epi16(1);
+            const __m128i alphaMask = _mm_set_epi16(-1, 0, 0, 0, -1, 0, 0, 0);
+
+            for (; x + 2 <= vectorWidth; x += 2, top += 16, bottom += 16, dst += 8)
+            {
+                __m128i t = _mm_loadu_si128(reinterpret_cast<const __m128i*>(top));
+                __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bottom));
+
+                // every 64-bit lane holds all the channels of a pixel, the low lanes belong to the first block
+                // and the high lanes to the second block
+                __m128i topLow = _mm_unpacklo_epi8(t, zero);
+                __m128i topHigh = _mm_unpackhi_epi8(t, zero);
+                __m128i bottomLow = _mm_unpacklo_epi8(b, zero);
+                __m128i bottomHigh = _mm_unpackhi_epi8(b, zero);
+
+                __m128i topLowMask = getAlphaMask(topLow);
+                __m128i topHighMask = getAlphaMask(topHigh);
+                __m128i bottomLowMask = getAlphaMask(bottomLow);
+                __m128i bottomHighMask = getAlphaMask(bottomHigh);
+
+                __m128i sum = addHalves(_mm_add_epi16(_mm_and_si128(topLow, topLowMask), _mm_and_si128(bottomLow, bottomLowMask)),
+                                        _mm_add_epi16(_mm_and_si128(topHigh, topHighMask), _mm_and_si128(bottomHigh, bottomHighMask)));
+                __m128i count = addHalves(_mm_add_epi16(_mm_and_si128(topLowMask, one), _mm_and_si128(bottomLowMask, one)),
+                                          _mm_add_epi16(_mm_and_si128(topHighMask, one), _mm_and_si128(bottomHighMask, one)));
+                __m128i alpha = addHalves(_mm_add_epi16(topLow, bottomLow),
+                                          _mm_add_epi16(topHigh, bottomHigh));
+
+                __m128i multiplier = _mm_and_si128(_mm_cmpeq_epi16(count, _mm_set1_epi16(1)), _mm_set1_epi16(-32768));
+                multiplier = _mm_or_si128(multiplier, _mm_and_si128(_mm_cmpeq_epi16(count, _mm_set1_epi16(2)), _mm_set1_epi16(16384)));
+                multiplier = _mm_or_si128(multiplier, _mm_and_si128(_mm_cmpeq_epi16(count, _mm_set1_epi16(3)), _mm_set1_epi16(10923)));
+                multiplier = _mm_or_si128(multiplier, _mm_and_si128(_mm_cmpeq_epi16(count, _mm_set1_epi16(4)), _mm_set1_epi16(8192)));
+
+                __m128i color = _mm_mulhi_epu16(_mm_add_epi16(_mm_slli_epi16(sum, 1), count), multiplier);
+                __m128i result = _mm_or_si128(_mm_andnot_si128(alphaMask, color),
+                                              _mm_and_si128(alphaMask, _mm_srli_epi16(alpha, 2)));
+
+                _mm_storel_epi64(reinterpret_cast<__m128i*>(dst), _mm_packus_epi16(result, result));
+            }
+#endif
+
+            for (; x < dstWidth; ++x, top += 8, bottom += 8, dst += 4)
+            {
+                const uint8_t* pixels[4] = {top, top + 4, bottom, bottom + 4};
+
+                uint32_t sum[3] = {0, 0, 0};
+                uint32_t count = 0;
+                uint32_t alpha = 0;
+
+                for (const uint8_t* pixel : pixels)
+                {
+                    if (pixel[3] > 0)
+                    {
+                        sum[0] += pixel[0];
+                        sum[1] += pixel[1];
+                        sum[2] += pixel[2];
+                        ++count;
+                    }
+                    alpha += pixel[3];
+                }
+
+                for (uint32_t channel = 0; channel < 3; ++channel)
+                    dst[channel] = count ? static_cast<uint8_t>((2 * sum[channel] + count) / (2 * count)) : 0;
+                dst[3] = static_cast<uint8_t>(alpha >> 2);
+            }
+        }
+
+        static void imageA8Downsample2x2(uint32_t width, uint32_t height, uint32_t pitch, const uint8_t* src, uint8_t* dst,
+                                         bool vectorized)
+        {
+            const uint32_t dstWidth = width >> 1;
+            const uint32_t dstHeight = height >> 1;
+
+            if (dstWidth > 0 && dstHeight > 0)
+            {
+                for (uint32_t y = 0; y < dstHeight; ++y, src += pitch * 2, dst += dstWidth)
+                    downsampleRow1(src, src + pitch, dst, dstWidth, false, vectorized);
+            }
+            else if (dstHeight > 0)
+            {
+                uint32_t y;
+                uint32_t ystep;
+
+                for (y = 0, ystep = pitch * 2; y < dstHeight; ++y, src += ystep, dst += 1)
+                {
+                    const uint8_t* pixel = src;
+
+                    float a = 0.0F;
+                    a += pixel[0];
+                    a += pixel[pitch + 0];
+                    a /= 2.0F;
+                    dst[0] = static_cast<uint8_t>(a);
+                }
+            }
+            else if (dstWidth > 0)
+            {
+                const uint8_t* pixel = src;
+                for (uint32_t x = 0; x < dstWidth; ++x, pixel += 2, dst += 1)
+                {
+                    float a = 0.0F;
+                    a += pixel[0];
+                    a += pixel[1];
+                    a /= 2.0F;
+                    dst[0] = static_cast<uint8_t>(a);
+                }
+            }
+        }
+
+        static void imageR8Downsample2x2(uint32_t width, uint32_t height, uint32_t pitch, const uint8_t* src, uint8_t* dst,
+                                         bool vectorized)
+        {
+            const uint32_t dstWidth = width >> 1;
+            const uint32_t dstHeight = height >> 1;
+
+            if (dstWidth > 0 && dstHeight > 0)
+            {
+                uint8_t decodeTable[256];
+                for (uint32_t i = 0; i < 256; ++i) decodeTable[i] = static_cast<uint8_t>(GAMMA_DECODE[i]);
+
+                const uint32_t rowSize = dstWidth * 2;
+                std::vector<uint8_t> rows(rowSize * 2);
+
+                for (uint32_t y = 0; y < dstHeight; ++y, src += pitch * 2, dst += dstWidth)
+                {
+                    gammaDecodeRow(decodeTable, src, rows.data(), rowSize, false);
+                    gammaDecodeRow(decodeTable, src + pitch, rows.data() + rowSize, rowSize, false);
+                    downsampleRow1(rows.data(), rows.data() + rowSize, dst, dstWidth, true, vectorized);
+                    gammaEncodeRow(dst, dstWidth, false);
+                }
+            }
+            else if (dstHeight > 0)
+            {
+                uint32_t y;
+                uint32_t ystep;
+
+                for (y = 0, ystep = pitch * 2; y < dstHeight; ++y, src += ystep, dst += 1)
+                {
+                    const uint8_t* pixel = src;
+
+                    float r = 0.0F;
+                    r += GAMMA_DECODE[pixel[0]];
+                    r += GAMMA_DECODE[pixel[pitch + 0]];
+                    r /= 2.0F;
+                    dst[0] = GAMMA_ENCODE[static_cast<uint8_t>(roundf(r))];
+                }
+            }
+            else if (dstWidth > 0)
+            {
+                const uint8_t* pixel = src;
+                for (uint32_t x = 0; x < dstWidth; ++x, pixel += 2, dst += 1)
+                {
+                    float r = 0.0F;
+                    r += GAMMA_DECODE[pixel[0]];
+                    r += GAMMA_DECODE[pixel[1]];
+                    r /= 2.0F;
+                    dst[0] = GAMMA_ENCODE[static_cast<uint8_t>(roundf(r))];
+                }
+            }
+        }
+
+        static void imageRG8Downsample2x2(uint32_t width, uint32_t height, uint32_t pitch, const uint8_t* src, uint8_t* dst,
+                                          bool vectorized)
+        {
+            const uint32_t dstWidth = width >> 1;
+            const uint32_t dstHeight = height >> 1;
+
+            if (dstWidth > 0 && dstHeight > 0)
+            {
+                uint8_t decodeTable[256];
+                for (uint32_t i = 0; i < 256; ++i) decodeTable[i] = static_cast<uint8_t>(GAMMA_DECODE[i]);
+
+                const uint32_t rowSize = dstWidth * 2 * 2;
+                std::vector<uint8_t> rows(rowSize * 2);
+
+                for (uint32_t y = 0; y < dstHeight; ++y, src += pitch * 2, dst += dstWidth * 2)
+                {
+                    gammaDecodeRow(decodeTable, src, rows.data(), rowSize, false);
+                    gammaDecodeRow(decodeTable, src + pitch, rows.data() + rowSize, rowSize, false);
+                    downsampleRow2(rows.data(), rows.data() + rowSize, dst, dstWidth, vectorized);
+                    gammaEncodeRow(dst, dstWidth * 2, false);
+                }
+            }
+            else if (dstHeight > 0)
+            {
+                uint32_t y;
+                uint32_t ystep;
+                for (y = 0, ystep = pitch * 2; y < dstHeight; ++y, src += ystep, dst += 2)
+                {
+                    const uint8_t* pixel = src;
+                    float r = 0.0F;
+                    float g = 0.0F;
+
+                    r += GAMMA_DECODE[pixel[0]];
+                    g += GAMMA_DECODE[pixel[1]];
+
+                    r += GAMMA_DECODE[pixel[pitch + 0]];
+                    g += GAMMA_DECODE[pixel[pitch + 1]];
+
+                    r /= 2.0F;
+                    g /= 2.0F;
+
+                    dst[0] = GAMMA_ENCODE[static_cast<uint8_t>(roundf(r))];
+                    dst[1] = GAMMA_ENCODE[static_cast<uint8_t>(roundf(g))];
+                }
+            }
+            else if (dstWidth > 0)
+            {
+                const uint8_t* pixel = src;
+                for (uint32_t x = 0; x < dstWidth; ++x, pixel += 4, dst += 2)
+                {
+                    float r = 0.0F;
+                    float g = 0.0F;
+
+                    r += GAMMA_DECODE[pixel[0]];
+                    g += GAMMA_DECODE[pixel[1]];
+
+                    r += GAMMA_DECODE[pixel[2]];
+                    g += GAMMA_DECODE[pixel[3]];
+
+                    r /= 2.0F;
+                    g /= 2.0F;
+
+                    dst[0] = GAMMA_ENCODE[static_cast<uint8_t>(roundf(r))];
+                    dst[1] = GAMMA_ENCODE[static_cast<uint8_t>(roundf(g))];
+                }
+            }
+        }
+
+        static void imageRGBA8Downsample2x2(uint32_t width, uint32_t height, uint32_t pitch, const uint8_t* src, uint8_t* dst,
+                                            bool vectorized)
+        {
+            const uint32_t dstWidth = width >> 1;
+            const uint32_t dstHeight = height >> 1;
+
+            if (dstWidth > 0 && dstHeight > 0)
+            {
+                uint8_t decodeTable[256];
+                for (uint32_t i = 0; i < 256; ++i) decodeTable[i] = static_cast<uint8_t>(GAMMA_DECODE[i]);
+
+                const uint32_t rowSize = dstWidth * 2 * 4;
+                std::vector<uint8_t> rows(rowSize * 2);
+
+                for (uint32_t y = 0; y < dstHeight; ++y, src += pitch * 2, dst += dstWidth * 4)
+                {
+                    gammaDecodeRow(decodeTable, src, rows.data(), rowSize, true);
+                    gammaDecodeRow(decodeTable, src + pitch, rows.data() + rowSize, rowSize, true);
+                    downsampleRow4(rows.data(), rows.data() + rowSize, dst, dstWidth, vectorized);
+                    gammaEncodeRow(dst, dstWidth * 4, true);
+                }
+            }
+            else if (dstHeight > 0)
+            {
+                uint32_t y;
+                uint32_t ystep;
+
+                for (y = 0, ystep = pitch * 2; y < dstHeight; ++y, src += ystep, dst += 4)
+                {
+                    const uint8_t* pixel = src;
+
+                    float pixels = 0.0F;
+                    float r = 0.0F;
+                    float g = 0.0F;
+                    float b = 0.0F;
+                    float a = 0.0F;
+
+                    if (pixel[3] > 0)
+                    {
+                        r += GAMMA_DECODE[pixel[0]];
+                        g += GAMMA_DECODE[pixel[1]];
+                        b += GAMMA_DECODE[pixel[2]];
+                        pixels += 1.0F;
+                    }
+                    a = pixel[3];
+
+                    if (pixel[pitch + 3] > 0)
+                    {
+                        r += GAMMA_DECODE[pixel[pitch + 0]];
+                        g += GAMMA_DECODE[pixel[pitch + 1]];
+                        b += GAMMA_DECODE[pixel[pitch + 2]];
+                        pixels += 1.0F;
+                    }
+                    a += pixel[pitch + 3];
+
+                    if (pixels > 0.0F)
+                    {
+                        r /= pixels;
+                        g /= pixels;
+                        b /= pixels;
+                        a *= 0.5F;
+                        dst[0] = GAMMA_ENCODE[static_cast<uint8_t>(roundf(r))];
+                        dst[1] = GAMMA_ENCODE[static_cast<uint8_t>(roundf(g))];
+                        dst[2] = GAMMA_ENCODE[static_cast<uint8_t>(roundf(b))];
+                        dst[3] = static_cast<uint8_t>(a);
+                    }
+                    else
+                    {
+                        dst[0] = 0;
+                        dst[1] = 0;
+                        dst[2] = 0;
+                        dst[3] = 0;
+                    }
+                }
+            }
+            else if (dstWidth > 0)
+            {
+                const uint8_t* pixel = src;
+                for (uint32_t x = 0; x < dstWidth; ++x, pixel += 8, dst += 4)
+                {
+                    float pixels = 0.0F;
+                    float r = 0.0F;
+                    float g = 0.0F;
+                    float b = 0.0F;
+                    float a = 0.0F;
+
+                    if (pixel[3] > 0)
+                    {
+                        r += GAMMA_DECODE[pixel[0]];
+                        g += GAMMA_DECODE[pixel[1]];
+                        b += GAMMA_DECODE[pixel[2]];
+                        pixels += 1.0F;
+                    }
+                    a += pixel[3];
+
+                    if (pixel[7] > 0)
+                    {
+                        r += GAMMA_DECODE[pixel[4]];
+                        g += GAMMA_DECODE[pixel[5]];
+                        b += GAMMA_DECODE[pixel[6]];
+                        pixels += 1.0F;
+                    }
+                    a += pixel[7];
+
+                    if (pixels > 0.0F)
+                    {
+                        r /= pixels;
+                        g /= pixels;
+                        b /= pixels;
+                        a *= 0.5F;
+                        dst[0] = GAMMA_ENCODE[static_cast<uint8_t>(roundf(r))];
+                        dst[1] = GAMMA_ENCODE[static_cast<uint8_t>(roundf(g))];
+                        dst[2] = GAMMA_ENCODE[static_cast<uint8_t>(roundf(b))];
+                        dst[3] = static_cast<uint8_t>(a);
+                    }
+                    else
+                    {
+                        dst[0] = 0;
+                        dst[1] = 0;
+                        dst[2] = 0;
+                        dst[3] = 0;
+                    }
+                }
+            }
+        }
+
+        void imageDownsample2x2(PixelFormat pixelFormat, uint32_t width, uint32_t height, uint32_t pitch,
+                                const uint8_t* src, uint8_t* dst, bool vectorized)
+        {
+            switch (pixelFormat)
+            {
+                case PixelFormat::RGBA8_UNORM:
+                    imageRGBA8Downsample2x2(width, height, pitch, src, dst, vectorized);
+                    break;
+
+                case PixelFormat::RG8_UNORM:
+                    imageRG8Downsample2x2(width, height, pitch, src, dst, vectorized);
+                    break;
+
+                case PixelFormat::R8_UNORM:
+                    imageR8Downsample2x2(width, height, pitch, src, dst, vectorized);
+                    break;
+
+                case PixelFormat::A8_UNORM:
+                    imageA8Downsample2x2(width, height, pitch, src, dst, vectorized);
+                    break;
+
+                default:
+                    throw DataError("Invalid pixel format");
+            }
+        }
+    } // namespace graphics
+} // namespace ouzel
@@ -0,0 +1,17 @@
+// Copyright 2015-2018 Elviss Strazdins. All rights reserved.
+
+#pragma once
+
+#include <cstdint>
+#include "graphics/PixelFormat.hpp"
+
+namespace ouzel
+{
+    namespace graphics
+    {
+        // averages the 2x2 blocks of the image into the destination, the vectorized kernels can be disabled to
+        // compare them with the scalar path
+        void imageDownsample2x2(PixelFormat pixelFormat, uint32_t width, uint32_t height, uint32_t pitch,
+                                const uint8_t* src, uint8_t* dst, bool vectorized = true);
+    } // namespace graphics
+} // namespace ouzel
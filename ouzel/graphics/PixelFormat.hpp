@@ -2,6 +2,11 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include "utils/Errors.hpp"
+
 namespace ouzel
 {
     namespace graphics
@@ -37,9 +42,39 @@ namespace ouzel
             RGBA16_FLOAT,
             RGBA32_UINT,
             RGBA32_SINT,
-            RGBA32_FLOAT
+            RGBA32_FLOAT,
+            BC1_UNORM,
+            BC2_UNORM,
+            BC3_UNORM,
+            BC4_UNORM,
+            BC5_UNORM,
+            BC7_UNORM,
+            ETC2_RGB8_UNORM,
+            ETC2_RGBA8_UNORM,
+            ASTC_4X4_UNORM,
+            ASTC_8X8_UNORM
         };
 
+        inline bool isCompressed(PixelFormat pixelFormat)
+        {
+            switch (pixelFormat)
+            {
+                case PixelFormat::BC1_UNORM:
+                case PixelFormat::BC2_UNORM:
+                case PixelFormat::BC3_UNORM:
+                case PixelFormat::BC4_UNORM:
+                case PixelFormat::BC5_UNORM:
+                case PixelFormat::BC7_UNORM:
+                case PixelFormat::ETC2_RGB8_UNORM:
+                case PixelFormat::ETC2_RGBA8_UNORM:
+                case PixelFormat::ASTC_4X4_UNORM:
+                case PixelFormat::ASTC_8X8_UNORM:
+                    return true;
+                default:
+                    return false;
+            }
+        }
+
         inline uint32_t getPixelSize(PixelFormat pixelFormat)
         {
             switch (pixelFormat)
@@ -104,6 +139,16 @@ namespace ouzel
                 case PixelFormat::RGBA8_SNORM:
                 case PixelFormat::RGBA8_UINT:
                 case PixelFormat::RGBA8_SINT:
+                case PixelFormat::BC1_UNORM:
+                case PixelFormat::BC2_UNORM:
+                case PixelFormat::BC3_UNORM:
+                case PixelFormat::BC4_UNORM:
+                case PixelFormat::BC5_UNORM:
+                case PixelFormat::BC7_UNORM:
+                case PixelFormat::ETC2_RGB8_UNORM:
+                case PixelFormat::ETC2_RGBA8_UNORM:
+                case PixelFormat::ASTC_4X4_UNORM:
+                case PixelFormat::ASTC_8X8_UNORM:
                     return 1;
                 case PixelFormat::R16_UNORM:
                 case PixelFormat::R16_SNORM:
@@ -147,11 +192,13 @@ namespace ouzel
                 case PixelFormat::R32_UINT:
                 case PixelFormat::R32_SINT:
                 case PixelFormat::R32_FLOAT:
+                case PixelFormat::BC4_UNORM:
                     return 1;
                 case PixelFormat::RG8_UNORM:
                 case PixelFormat::RG8_SNORM:
                 case PixelFormat::RG8_UINT:
                 case PixelFormat::RG8_SINT:
+                case PixelFormat::BC5_UNORM:
                     return 2;
                 case PixelFormat::RGBA8_UNORM:
                 case PixelFormat::RGBA8_SNORM:
@@ -165,6 +212,14 @@ namespace ouzel
                 case PixelFormat::RGBA32_UINT:
                 case PixelFormat::RGBA32_SINT:
                 case PixelFormat::RGBA32_FLOAT:
+                case PixelFormat::BC1_UNORM:
+                case PixelFormat::BC2_UNORM:
+                case PixelFormat::BC3_UNORM:
+                case PixelFormat::BC7_UNORM:
+                case PixelFormat::ETC2_RGB8_UNORM:
+                case PixelFormat::ETC2_RGBA8_UNORM:
+                case PixelFormat::ASTC_4X4_UNORM:
+                case PixelFormat::ASTC_8X8_UNORM:
                     return 4;
                 case PixelFormat::DEFAULT:
                     return 0;
@@ -172,5 +227,86 @@ namespace ouzel
                     return 0;
             }
         }
+
+        // uncompressed formats have 1x1 blocks
+        inline uint32_t getBlockWidth(PixelFormat pixelFormat)
+        {
+            switch (pixelFormat)
+            {
+                case PixelFormat::BC1_UNORM:
+                case PixelFormat::BC2_UNORM:
+                case PixelFormat::BC3_UNORM:
+                case PixelFormat::BC4_UNORM:
+                case PixelFormat::BC5_UNORM:
+                case PixelFormat::BC7_UNORM:
+                case PixelFormat::ETC2_RGB8_UNORM:
+                case PixelFormat::ETC2_RGBA8_UNORM:
+                case PixelFormat::ASTC_4X4_UNORM:
+                    return 4;
+                case PixelFormat::ASTC_8X8_UNORM:
+                    return 8;
+                default:
+                    return 1;
+            }
+        }
+
+        inline uint32_t getBlockHeight(PixelFormat pixelFormat)
+        {
+            // all the supported block formats have square blocks
+            return getBlockWidth(pixelFormat);
+        }
+
+        // size of a block in bytes (size of a pixel for uncompressed formats)
+        inline uint32_t getBlockSize(PixelFormat pixelFormat)
+        {
+            switch (pixelFormat)
+            {
+                case PixelFormat::BC1_UNORM:
+                case PixelFormat::BC4_UNORM:
+                case PixelFormat::ETC2_RGB8_UNORM:
+                    return 8;
+                case PixelFormat::BC2_UNORM:
+                case PixelFormat::BC3_UNORM:
+                case PixelFormat::BC5_UNORM:
+                case PixelFormat::BC7_UNORM:
+                case PixelFormat::ETC2_RGBA8_UNORM:
+                case PixelFormat::ASTC_4X4_UNORM:
+                case PixelFormat::ASTC_8X8_UNORM:
+                    return 16;
+                default:
+                    return getPixelSize(pixelFormat);
+            }
+        }
+
+        // size of a row of blocks in bytes, the sizes are calculated in 64 bits, so that they can't wrap around
+        inline uint32_t getPitch(PixelFormat pixelFormat, uint32_t width)
+        {
+            uint64_t blockWidth = getBlockWidth(pixelFormat);
+            uint64_t pitch = (width + blockWidth - 1) / blockWidth * getBlockSize(pixelFormat);
+
+            if (pitch > std::numeric_limits<uint32_t>::max())
+                throw DataError("Image is too big");
+
+            return static_cast<uint32_t>(pitch);
+        }
+
+        inline uint32_t getLevelDataSize(PixelFormat pixelFormat, uint32_t width, uint32_t height)
+        {
+            uint64_t blockHeight = getBlockHeight(pixelFormat);
+            uint64_t levelDataSize = getPitch(pixelFormat, width) * ((height + blockHeight - 1) / blockHeight);
+
+            if (levelDataSize > std::numeric_limits<uint32_t>::max())
+                throw DataError("Image is too big");
+
+            return static_cast<uint32_t>(levelDataSize);
+        }
+
+        // number of the levels of a full mip chain, which ends with a 1x1 level
+        inline uint32_t getMaxLevelCount(uint32_t width, uint32_t height)
+        {
+            uint32_t levelCount = 1;
+            for (uint32_t levelSize = std::max(width, height); levelSize > 1; levelSize >>= 1) ++levelCount;
+            return levelCount;
+        }
     } // namespace graphics
 } // namespace ouzel
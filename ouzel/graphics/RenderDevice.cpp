@@ -1,18 +1,35 @@
 // Copyright 2015-2018 Elviss Strazdins. All rights reserved.
 
 #include <algorithm>
+#include <cmath>
+#include <iterator>
 #include "RenderDevice.hpp"
+#include "math/MathUtils.hpp"
 #include "thread/Lock.hpp"
+#include "utils/Profiler.hpp"
 
 namespace ouzel
 {
     namespace graphics
     {
+        ThreadLocal CommandBuffer* RenderDevice::recordBuffer = nullptr;
+
         RenderDevice::RenderDevice(Renderer::Driver initDriver):
             driver(initDriver),
             projectionTransform(Matrix4::identity()),
             renderTargetProjectionTransform(Matrix4::identity()),
+            textureUploadBudget(1024 * 1024),
+            drawCallCount(0),
+            textureUploadSize(0),
+            elidedCommandCount(0),
+            maxCommandCount(0),
+            maxCommandChunkCount(0),
+            maxCommandDataSize(0),
             refillQueue(true),
+            tripleBuffering(false),
+            frameLatency(0.0F),
+            accumulatedFrameLatency(0.0F),
+            droppedFrameCount(0),
             currentFPS(0.0F),
             accumulatedFPS(0.0F)
         {
@@ -46,6 +63,8 @@ namespace ouzel
 
         void RenderDevice::process()
         {
+            ProfilerZone zone("RenderDevice::process");
+
             std::chrono::steady_clock::time_point currentTime = std::chrono::steady_clock::now();
             auto diff = std::chrono::duration_cast<std::chrono::nanoseconds>(currentTime - previousFrameTime);
             previousFrameTime = currentTime;
@@ -58,11 +77,13 @@ namespace ouzel
             accumulatedTime += delta;
             currentAccumulatedFPS += 1.0F;
 
+            bool accumulationFinished = false;
             if (accumulatedTime > 1.0F)
             {
                 accumulatedFPS = currentAccumulatedFPS;
                 accumulatedTime = 0.0F;
                 currentAccumulatedFPS = 0.0F;
+                accumulationFinished = true;
             }
 
             std::vector<std::unique_ptr<RenderResource>> deleteResources; // will be cleared at the end of the scope
@@ -71,21 +92,195 @@ namespace ouzel
                 deleteResources = std::move(resourceDeleteSet);
             }
 
+            FrameStatistics statistics;
+            statistics.frameTime = delta;
+
+            std::chrono::steady_clock::time_point waitStartTime = std::chrono::steady_clock::now();
+
+            {
 #if OUZEL_MULTITHREADED
-            Lock lock(commandQueueMutex);
-            while (!queueFinished) commandQueueCondition.wait(lock);
+                Lock lock(commandQueueMutex);
+                while (tripleBuffering ? !frameReady : !queueFinished) commandQueueCondition.wait(lock);
 #endif
 
-            std::swap(fillBuffer, renderBuffer);
+                bool newFrame = true;
 
-            queueFinished = false;
+                if (tripleBuffering)
+                {
+                    if (frameReady)
+                    {
+                        std::swap(readyBuffer, renderBuffer);
+                        frameReady = false;
+                    }
+                    else
+                        newFrame = false;
+                }
+                else
+                    std::swap(fillBuffer, renderBuffer);
+
+                if (newFrame)
+                {
+                    auto latency = std::chrono::steady_clock::now() - flushTimes[renderBuffer - commandBuffers];
+                    frameLatency = std::chrono::duration_cast<std::chrono::nanoseconds>(latency).count() / 1000000000.0F;
+                    accumulatedLatency += frameLatency;
+                    ++accumulatedLatencyCount;
+                }
+
+                queueFinished = false;
+
+                // refills the draw queue
+                refillQueue = true;
+            }
+
+            std::chrono::steady_clock::time_point executeStartTime = std::chrono::steady_clock::now();
+            statistics.waitTime = std::chrono::duration_cast<std::chrono::nanoseconds>(executeStartTime - waitStartTime).count() / 1000000000.0F;
+
+            if (accumulationFinished && accumulatedLatencyCount > 0)
+            {
+                accumulatedFrameLatency = accumulatedLatency / accumulatedLatencyCount;
+                accumulatedLatency = 0.0F;
+                accumulatedLatencyCount = 0;
+            }
+
+            elidedCommandCount = renderBuffer->getElidedCount();
+            for (const CommandBuffer& commandBuffer : commandBuffers)
+            {
+                if (commandBuffer.getMaxCommandCount() > maxCommandCount) maxCommandCount = commandBuffer.getMaxCommandCount();
+                if (commandBuffer.getMaxChunkCount() > maxCommandChunkCount) maxCommandChunkCount = commandBuffer.getMaxChunkCount();
+                if (commandBuffer.getMaxDataSize() > maxCommandDataSize) maxCommandDataSize = commandBuffer.getMaxDataSize();
+            }
 
-            // refills the draw queue
-            refillQueue = true;
+            // the statistics of the buffer are reset once all of its commands are processed
+            const FrameStatistics& bufferStatistics = renderBuffer->getStatistics();
+            std::copy(std::begin(bufferStatistics.commandCounts), std::end(bufferStatistics.commandCounts), std::begin(statistics.commandCounts));
+            statistics.drawCallCount = bufferStatistics.drawCallCount;
+            statistics.indexCount = bufferStatistics.indexCount;
+            statistics.bufferUploadSize = bufferStatistics.bufferUploadSize;
+            statistics.textureUploadSize = textureUploadSize.exchange(0);
 
             executeAll();
 
-            processCommands(*renderBuffer);
+            statistics.textureUploadSize += textureStreamer.upload(textureUploadBudget);
+
+            std::chrono::steady_clock::time_point processStartTime = std::chrono::steady_clock::now();
+            statistics.executeTime = std::chrono::duration_cast<std::chrono::nanoseconds>(processStartTime - executeStartTime).count() / 1000000000.0F;
+
+            {
+                ProfilerZone processZone("RenderDevice::processCommands");
+                processCommands(*renderBuffer);
+            }
+
+            statistics.processTime = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - processStartTime).count() / 1000000000.0F;
+
+            drawCallCount = statistics.drawCallCount;
+
+            Lock lock(statisticsMutex);
+            frameStatistics = statistics;
+
+            if (frameStatisticsHistory.size() < statisticsHistorySize)
+                frameStatisticsHistory.push_back(statistics);
+            else if (!frameStatisticsHistory.empty())
+                frameStatisticsHistory[frameStatisticsHistoryPosition] = statistics;
+
+            if (++frameStatisticsHistoryPosition >= statisticsHistorySize)
+                frameStatisticsHistoryPosition = 0;
+        }
+
+        FrameStatistics RenderDevice::getFrameStatistics() const
+        {
+            Lock lock(statisticsMutex);
+            return frameStatistics;
+        }
+
+        std::vector<FrameStatistics> RenderDevice::getFrameStatisticsHistory() const
+        {
+            Lock lock(statisticsMutex);
+
+            // oldest frame first
+            std::vector<FrameStatistics> result;
+            result.reserve(frameStatisticsHistory.size());
+
+            if (frameStatisticsHistory.size() < statisticsHistorySize)
+                result = frameStatisticsHistory;
+            else
+            {
+                result.insert(result.end(), frameStatisticsHistory.begin() + static_cast<std::ptrdiff_t>(frameStatisticsHistoryPosition), frameStatisticsHistory.end());
+                result.insert(result.end(), frameStatisticsHistory.begin(), frameStatisticsHistory.begin() + static_cast<std::ptrdiff_t>(frameStatisticsHistoryPosition));
+            }
+
+            return result;
+        }
+
+        void RenderDevice::setStatisticsHistorySize(uint32_t newStatisticsHistorySize)
+        {
+            Lock lock(statisticsMutex);
+
+            statisticsHistorySize = newStatisticsHistorySize;
+            frameStatisticsHistory.clear();
+            frameStatisticsHistoryPosition = 0;
+        }
+
+        float RenderDevice::getFrameTimePercentile(float percentile) const
+        {
+            std::vector<float> frameTimes;
+
+            {
+                Lock lock(statisticsMutex);
+
+                frameTimes.reserve(frameStatisticsHistory.size());
+                for (const FrameStatistics& statistics : frameStatisticsHistory)
+                    frameTimes.push_back(statistics.frameTime);
+            }
+
+            if (frameTimes.empty()) return 0.0F;
+
+            // nearest-rank percentile
+            float rank = clamp(percentile, 0.0F, 100.0F) / 100.0F * static_cast<float>(frameTimes.size());
+            size_t index = (rank > 0.0F) ? static_cast<size_t>(std::ceil(rank)) - 1 : 0;
+            if (index >= frameTimes.size()) index = frameTimes.size() - 1;
+
+            std::nth_element(frameTimes.begin(), frameTimes.begin() + static_cast<std::ptrdiff_t>(index), frameTimes.end());
+            return frameTimes[index];
+        }
+
+        bool RenderDevice::isPixelFormatSupported(PixelFormat pixelFormat) const
+        {
+            switch (pixelFormat)
+            {
+                case PixelFormat::BC1_UNORM:
+                case PixelFormat::BC2_UNORM:
+                case PixelFormat::BC3_UNORM:
+                    return s3tcSupported;
+                case PixelFormat::BC4_UNORM:
+                case PixelFormat::BC5_UNORM:
+                    return rgtcSupported;
+                case PixelFormat::BC7_UNORM:
+                    return bptcSupported;
+                case PixelFormat::ETC2_RGB8_UNORM:
+                case PixelFormat::ETC2_RGBA8_UNORM:
+                    return etc2Supported;
+                case PixelFormat::ASTC_4X4_UNORM:
+                case PixelFormat::ASTC_8X8_UNORM:
+                    return astcSupported;
+                default:
+                    return true;
+            }
+        }
+
+        void RenderDevice::setTripleBuffering(bool newTripleBuffering)
+        {
+#if OUZEL_MULTITHREADED
+            Lock lock(commandQueueMutex);
+#endif
+
+            tripleBuffering = newTripleBuffering;
+
+            // the game thread can always record the next frame
+            if (tripleBuffering) refillQueue = true;
+
+#if OUZEL_MULTITHREADED
+            commandQueueCondition.signal();
+#endif
         }
 
         void RenderDevice::setClearColorBuffer(bool clear)
@@ -141,14 +336,38 @@ namespace ouzel
 
             //drawCallCount = static_cast<uint32_t>(fillBuffer->size());
 
-            refillQueue = false;
-            queueFinished = true;
+            if (tripleBuffering)
+            {
+                if (frameReady)
+                {
+                    // the previous frame was not rendered yet, replace it with the new one but keep its resource commands
+                    readyBuffer->discardFrameCommands();
+                    readyBuffer->append(*fillBuffer);
+                    ++droppedFrameCount;
+                }
+                else
+                    std::swap(fillBuffer, readyBuffer);
+
+                flushTimes[readyBuffer - commandBuffers] = std::chrono::steady_clock::now();
+                frameReady = true;
+            }
+            else
+            {
+                flushTimes[fillBuffer - commandBuffers] = std::chrono::steady_clock::now();
+                refillQueue = false;
+                queueFinished = true;
+            }
 
 #if OUZEL_MULTITHREADED
             commandQueueCondition.signal();
 #endif
         }
 
+        void RenderDevice::submitCommands(CommandBuffer& buffer)
+        {
+            getRecordBuffer()->append(buffer);
+        }
+
         void RenderDevice::generateScreenshot(const std::string&)
         {
         }
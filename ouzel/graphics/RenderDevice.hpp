@@ -10,8 +10,10 @@
 #include "graphics/RenderTargetResource.hpp"
 #include "graphics/ShaderResource.hpp"
 #include "graphics/TextureResource.hpp"
+#include "graphics/TextureStreamer.hpp"
 #include "thread/Condition.hpp"
 #include "thread/Mutex.hpp"
+#include "thread/Thread.hpp"
 
 namespace ouzel
 {
@@ -58,11 +60,42 @@ namespace ouzel
 
             inline bool getRefillQueue() const { return refillQueue; }
 
+            // mailbox mode, the game thread never waits for the render thread and the render thread renders the newest complete frame
+            void setTripleBuffering(bool newTripleBuffering);
+            inline bool isTripleBuffering() const { return tripleBuffering; }
+
+            // time between the completion of a frame and the start of its rendering (in seconds)
+            inline float getFrameLatency() const { return frameLatency; }
+            inline float getAccumulatedFrameLatency() const { return accumulatedFrameLatency; }
+            // frames that were replaced by a newer frame before they were rendered
+            inline uint32_t getDroppedFrameCount() const { return droppedFrameCount; }
+
             template<typename T> void addCommand(const T& command)
             {
-                fillBuffer->push(command);
+                getRecordBuffer()->push(command);
+            }
+
+            uint32_t addData(const float* values, uint32_t valueCount)
+            {
+                return getRecordBuffer()->pushData(values, valueCount);
+            }
+
+            inline uint32_t getDataOffset() const { return getRecordBuffer()->getDataSize(); }
+
+            uint32_t reserveUploadData(uint32_t size)
+            {
+                return getRecordBuffer()->reserveUploadData(size);
             }
 
+            inline uint8_t* getUploadData(uint32_t offset) { return getRecordBuffer()->getUploadData(offset); }
+
+            // commands of the calling thread are recorded into the given buffer instead of the frame's buffer
+            void setRecordBuffer(CommandBuffer* buffer) { recordBuffer = buffer; }
+            inline CommandBuffer* getRecordBuffer() const { return recordBuffer ? recordBuffer : fillBuffer; }
+
+            // appends the commands of the buffer to the frame's buffer
+            void submitCommands(CommandBuffer& buffer);
+
             void flushCommands();
 
             Vector2 convertScreenToNormalizedLocation(const Vector2& position)
@@ -79,6 +112,21 @@ namespace ouzel
 
             inline uint32_t getDrawCallCount() const { return drawCallCount; }
 
+            // statistics of the last rendered frame
+            FrameStatistics getFrameStatistics() const;
+            // statistics of the last rendered frames, oldest frame first
+            std::vector<FrameStatistics> getFrameStatisticsHistory() const;
+            inline uint32_t getStatisticsHistorySize() const { return statisticsHistorySize; }
+            void setStatisticsHistorySize(uint32_t newStatisticsHistorySize);
+            // frame time (in seconds) at the given percentile (0-100) of the frames in the history
+            float getFrameTimePercentile(float percentile) const;
+            inline uint32_t getElidedCommandCount() const { return elidedCommandCount; }
+
+            // command buffer high-water marks
+            inline uint32_t getMaxCommandCount() const { return maxCommandCount; }
+            inline uint32_t getMaxCommandChunkCount() const { return maxCommandChunkCount; }
+            inline uint32_t getMaxCommandDataSize() const { return maxCommandDataSize; }
+
             inline uint16_t getAPIMajorVersion() const { return apiMajorVersion; }
             inline uint16_t getAPIMinorVersion() const { return apiMinorVersion; }
 
@@ -86,6 +134,15 @@ namespace ouzel
             inline bool isMultisamplingSupported() const { return multisamplingSupported; }
             inline bool isAnisotropicFilteringSupported() const { return anisotropicFilteringSupported; }
             inline bool isRenderTargetsSupported() const { return renderTargetsSupported; }
+            inline bool isInstancingSupported() const { return instancingSupported; }
+            inline bool isUInt32IndicesSupported() const { return uint32IndicesSupported; }
+            inline bool isS3TCSupported() const { return s3tcSupported; }
+            inline bool isRGTCSupported() const { return rgtcSupported; }
+            inline bool isBPTCSupported() const { return bptcSupported; }
+            inline bool isETC2Supported() const { return etc2Supported; }
+            inline bool isASTCSupported() const { return astcSupported; }
+            inline uint32_t getMaxTextureSize() const { return maxTextureSize; }
+            bool isPixelFormatSupported(PixelFormat pixelFormat) const;
 
             const Matrix4& getProjectionTransform(bool renderTarget) const
             {
@@ -97,6 +154,11 @@ namespace ouzel
 
             void executeOnRenderThread(const std::function<void(void)>& func);
 
+            inline TextureStreamer& getTextureStreamer() { return textureStreamer; }
+            // maximum number of bytes of streaming texture levels uploaded per frame
+            inline uint64_t getTextureUploadBudget() const { return textureUploadBudget; }
+            inline void setTextureUploadBudget(uint64_t newTextureUploadBudget) { textureUploadBudget = newTextureUploadBudget; }
+
         protected:
             explicit RenderDevice(Renderer::Driver initDriver);
 
@@ -141,6 +203,14 @@ namespace ouzel
             bool multisamplingSupported = true;
             bool anisotropicFilteringSupported = true;
             bool renderTargetsSupported = true;
+            bool instancingSupported = true;
+            bool uint32IndicesSupported = true;
+            bool s3tcSupported = true; // BC1-BC3
+            bool rgtcSupported = true; // BC4 and BC5
+            bool bptcSupported = true; // BC7
+            bool etc2Supported = true;
+            bool astcSupported = true;
+            uint32_t maxTextureSize = 16384; // maximum width and height of a texture
 
             Matrix4 projectionTransform;
             Matrix4 renderTargetProjectionTransform;
@@ -151,15 +221,34 @@ namespace ouzel
             bool clearColorBuffer = true;
             bool clearDepthBuffer = false;
 
+            // declared before the resources, so that it outlives them
+            TextureStreamer textureStreamer;
+            std::atomic<uint64_t> textureUploadBudget;
+
             Mutex resourceMutex;
             std::vector<std::unique_ptr<RenderResource>> resources;
             std::vector<std::unique_ptr<RenderResource>> resourceDeleteSet;
 
-            uint32_t drawCallCount = 0;
+            std::atomic<uint32_t> drawCallCount;
+            std::atomic<uint64_t> textureUploadSize;
+
+            mutable Mutex statisticsMutex;
+            FrameStatistics frameStatistics;
+            std::vector<FrameStatistics> frameStatisticsHistory;
+            uint32_t statisticsHistorySize = 300;
+            uint32_t frameStatisticsHistoryPosition = 0;
+            std::atomic<uint32_t> elidedCommandCount;
+            std::atomic<uint32_t> maxCommandCount;
+            std::atomic<uint32_t> maxCommandChunkCount;
+            std::atomic<uint32_t> maxCommandDataSize;
 
-            CommandBuffer commandBuffers[2];
+            static ThreadLocal CommandBuffer* recordBuffer;
+
+            CommandBuffer commandBuffers[3];
             CommandBuffer* fillBuffer = &commandBuffers[0];
             CommandBuffer* renderBuffer = &commandBuffers[1];
+            CommandBuffer* readyBuffer = &commandBuffers[2]; // newest complete frame in the triple buffering mode
+            std::chrono::steady_clock::time_point flushTimes[3];
 
             Mutex commandQueueMutex;
             Condition commandQueueCondition;
@@ -167,6 +256,14 @@ namespace ouzel
             bool queueFinished = false;
             std::atomic<bool> refillQueue;
 
+            std::atomic<bool> tripleBuffering;
+            bool frameReady = false;
+            std::atomic<float> frameLatency;
+            std::atomic<float> accumulatedFrameLatency;
+            float accumulatedLatency = 0.0F;
+            uint32_t accumulatedLatencyCount = 0;
+            std::atomic<uint32_t> droppedFrameCount;
+
             std::atomic<float> currentFPS;
             std::chrono::steady_clock::time_point previousFrameTime;
 
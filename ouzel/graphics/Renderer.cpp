@@ -44,23 +44,39 @@
 #    include "opengl/ColorVSGLES2.h"
 #    include "opengl/TexturePSGLES2.h"
 #    include "opengl/TextureVSGLES2.h"
+#    include "opengl/TextPSGLES2.h"
+#    include "opengl/SDFPSGLES2.h"
 #    include "opengl/ColorPSGLES3.h"
 #    include "opengl/ColorVSGLES3.h"
 #    include "opengl/TexturePSGLES3.h"
 #    include "opengl/TextureVSGLES3.h"
+#    include "opengl/TextPSGLES3.h"
+#    include "opengl/SDFPSGLES3.h"
+#    include "opengl/ParticleVSGLES3.h"
+#    include "opengl/InstancedVSGLES3.h"
 #  else
 #    include "opengl/ColorPSGL2.h"
 #    include "opengl/ColorVSGL2.h"
 #    include "opengl/TexturePSGL2.h"
 #    include "opengl/TextureVSGL2.h"
+#    include "opengl/TextPSGL2.h"
+#    include "opengl/SDFPSGL2.h"
 #    include "opengl/ColorPSGL3.h"
 #    include "opengl/ColorVSGL3.h"
 #    include "opengl/TexturePSGL3.h"
 #    include "opengl/TextureVSGL3.h"
+#    include "opengl/TextPSGL3.h"
+#    include "opengl/SDFPSGL3.h"
+#    include "opengl/ParticleVSGL3.h"
+#    include "opengl/InstancedVSGL3.h"
 #    include "opengl/ColorPSGL4.h"
 #    include "opengl/ColorVSGL4.h"
 #    include "opengl/TexturePSGL4.h"
 #    include "opengl/TextureVSGL4.h"
+#    include "opengl/TextPSGL4.h"
+#    include "opengl/SDFPSGL4.h"
+#    include "opengl/ParticleVSGL4.h"
+#    include "opengl/InstancedVSGL4.h"
 #  endif
 #endif
 
@@ -311,6 +327,182 @@ namespace ouzel
                     }
 
                     engine->getCache()->setShader(SHADER_COLOR, colorShader);
+
+                    // the text shader takes the coverage of the glyphs from the alpha channel of the texture
+                    std::shared_ptr<Shader> textShader = std::make_shared<Shader>(*this);
+
+                    switch (device->getAPIMajorVersion())
+                    {
+#  if OUZEL_SUPPORTS_OPENGLES
+                        case 2:
+                            textShader->init(std::vector<uint8_t>(std::begin(TextPSGLES2_glsl), std::end(TextPSGLES2_glsl)),
+                                             std::vector<uint8_t>(std::begin(TextureVSGLES2_glsl), std::end(TextureVSGLES2_glsl)),
+                                             {Vertex::Attribute::Usage::POSITION, Vertex::Attribute::Usage::COLOR, Vertex::Attribute::Usage::TEXTURE_COORDINATES0},
+                                             {{"color", DataType::FLOAT_VECTOR4}},
+                                             {{"modelViewProj", DataType::FLOAT_MATRIX4}});
+                            break;
+                        case 3:
+                            textShader->init(std::vector<uint8_t>(std::begin(TextPSGLES3_glsl), std::end(TextPSGLES3_glsl)),
+                                             std::vector<uint8_t>(std::begin(TextureVSGLES3_glsl), std::end(TextureVSGLES3_glsl)),
+                                             {Vertex::Attribute::Usage::POSITION, Vertex::Attribute::Usage::COLOR, Vertex::Attribute::Usage::TEXTURE_COORDINATES0},
+                                             {{"color", DataType::FLOAT_VECTOR4}},
+                                             {{"modelViewProj", DataType::FLOAT_MATRIX4}});
+                            break;
+#  else
+                        case 2:
+                            textShader->init(std::vector<uint8_t>(std::begin(TextPSGL2_glsl), std::end(TextPSGL2_glsl)),
+                                             std::vector<uint8_t>(std::begin(TextureVSGL2_glsl), std::end(TextureVSGL2_glsl)),
+                                             {Vertex::Attribute::Usage::POSITION, Vertex::Attribute::Usage::COLOR, Vertex::Attribute::Usage::TEXTURE_COORDINATES0},
+                                             {{"color", DataType::FLOAT_VECTOR4}},
+                                             {{"modelViewProj", DataType::FLOAT_MATRIX4}});
+                            break;
+                        case 3:
+                            textShader->init(std::vector<uint8_t>(std::begin(TextPSGL3_glsl), std::end(TextPSGL3_glsl)),
+                                             std::vector<uint8_t>(std::begin(TextureVSGL3_glsl), std::end(TextureVSGL3_glsl)),
+                                             {Vertex::Attribute::Usage::POSITION, Vertex::Attribute::Usage::COLOR, Vertex::Attribute::Usage::TEXTURE_COORDINATES0},
+                                             {{"color", DataType::FLOAT_VECTOR4}},
+                                             {{"modelViewProj", DataType::FLOAT_MATRIX4}});
+                            break;
+                        case 4:
+                            textShader->init(std::vector<uint8_t>(std::begin(TextPSGL4_glsl), std::end(TextPSGL4_glsl)),
+                                             std::vector<uint8_t>(std::begin(TextureVSGL4_glsl), std::end(TextureVSGL4_glsl)),
+                                             {Vertex::Attribute::Usage::POSITION, Vertex::Attribute::Usage::COLOR, Vertex::Attribute::Usage::TEXTURE_COORDINATES0},
+                                             {{"color", DataType::FLOAT_VECTOR4}},
+                                             {{"modelViewProj", DataType::FLOAT_MATRIX4}});
+                            break;
+#  endif
+                        default:
+                            throw SystemError("Unsupported OpenGL version");
+                    }
+
+                    engine->getCache()->setShader(SHADER_TEXT, textShader);
+
+                    // the distance field shader takes the distance to the edge of the glyphs from the alpha channel of the texture
+                    std::shared_ptr<Shader> sdfShader = std::make_shared<Shader>(*this);
+
+                    switch (device->getAPIMajorVersion())
+                    {
+#  if OUZEL_SUPPORTS_OPENGLES
+                        case 2:
+                            sdfShader->init(std::vector<uint8_t>(std::begin(SDFPSGLES2_glsl), std::end(SDFPSGLES2_glsl)),
+                                            std::vector<uint8_t>(std::begin(TextureVSGLES2_glsl), std::end(TextureVSGLES2_glsl)),
+                                            {Vertex::Attribute::Usage::POSITION, Vertex::Attribute::Usage::COLOR, Vertex::Attribute::Usage::TEXTURE_COORDINATES0},
+                                            {{"color", DataType::FLOAT_VECTOR4}},
+                                            {{"modelViewProj", DataType::FLOAT_MATRIX4}});
+                            break;
+                        case 3:
+                            sdfShader->init(std::vector<uint8_t>(std::begin(SDFPSGLES3_glsl), std::end(SDFPSGLES3_glsl)),
+                                            std::vector<uint8_t>(std::begin(TextureVSGLES3_glsl), std::end(TextureVSGLES3_glsl)),
+                                            {Vertex::Attribute::Usage::POSITION, Vertex::Attribute::Usage::COLOR, Vertex::Attribute::Usage::TEXTURE_COORDINATES0},
+                                            {{"color", DataType::FLOAT_VECTOR4}},
+                                            {{"modelViewProj", DataType::FLOAT_MATRIX4}});
+                            break;
+#  else
+                        case 2:
+                            sdfShader->init(std::vector<uint8_t>(std::begin(SDFPSGL2_glsl), std::end(SDFPSGL2_glsl)),
+                                            std::vector<uint8_t>(std::begin(TextureVSGL2_glsl), std::end(TextureVSGL2_glsl)),
+                                            {Vertex::Attribute::Usage::POSITION, Vertex::Attribute::Usage::COLOR, Vertex::Attribute::Usage::TEXTURE_COORDINATES0},
+                                            {{"color", DataType::FLOAT_VECTOR4}},
+                                            {{"modelViewProj", DataType::FLOAT_MATRIX4}});
+                            break;
+                        case 3:
+                            sdfShader->init(std::vector<uint8_t>(std::begin(SDFPSGL3_glsl), std::end(SDFPSGL3_glsl)),
+                                            std::vector<uint8_t>(std::begin(TextureVSGL3_glsl), std::end(TextureVSGL3_glsl)),
+                                            {Vertex::Attribute::Usage::POSITION, Vertex::Attribute::Usage::COLOR, Vertex::Attribute::Usage::TEXTURE_COORDINATES0},
+                                            {{"color", DataType::FLOAT_VECTOR4}},
+                                            {{"modelViewProj", DataType::FLOAT_MATRIX4}});
+                            break;
+                        case 4:
+                            sdfShader->init(std::vector<uint8_t>(std::begin(SDFPSGL4_glsl), std::end(SDFPSGL4_glsl)),
+                                            std::vector<uint8_t>(std::begin(TextureVSGL4_glsl), std::end(TextureVSGL4_glsl)),
+                                            {Vertex::Attribute::Usage::POSITION, Vertex::Attribute::Usage::COLOR, Vertex::Attribute::Usage::TEXTURE_COORDINATES0},
+                                            {{"color", DataType::FLOAT_VECTOR4}},
+                                            {{"modelViewProj", DataType::FLOAT_MATRIX4}});
+                            break;
+#  endif
+                        default:
+                            throw SystemError("Unsupported OpenGL version");
+                    }
+
+                    engine->getCache()->setShader(SHADER_SDF, sdfShader);
+
+                    // the particle shader expands the particles from the per-instance data, it needs GLSL 3
+                    if (device->isInstancingSupported() && device->getAPIMajorVersion() >= 3)
+                    {
+                        std::shared_ptr<Shader> particleShader = std::make_shared<Shader>(*this);
+
+                        switch (device->getAPIMajorVersion())
+                        {
+#  if OUZEL_SUPPORTS_OPENGLES
+                            case 3:
+                                particleShader->init(std::vector<uint8_t>(std::begin(TexturePSGLES3_glsl), std::end(TexturePSGLES3_glsl)),
+                                                     std::vector<uint8_t>(std::begin(ParticleVSGLES3_glsl), std::end(ParticleVSGLES3_glsl)),
+                                                     {Vertex::Attribute::Usage::POSITION, Vertex::Attribute::Usage::COLOR, Vertex::Attribute::Usage::TEXTURE_COORDINATES0,
+                                                      Vertex::Attribute::Usage::INSTANCE_TRANSFORM, Vertex::Attribute::Usage::INSTANCE_COLOR},
+                                                     {{"color", DataType::FLOAT_VECTOR4}},
+                                                     {{"modelViewProj", DataType::FLOAT_MATRIX4}, {"params", DataType::FLOAT_VECTOR4}, {"gravity", DataType::FLOAT_VECTOR4}});
+                                break;
+#  else
+                            case 3:
+                                particleShader->init(std::vector<uint8_t>(std::begin(TexturePSGL3_glsl), std::end(TexturePSGL3_glsl)),
+                                                     std::vector<uint8_t>(std::begin(ParticleVSGL3_glsl), std::end(ParticleVSGL3_glsl)),
+                                                     {Vertex::Attribute::Usage::POSITION, Vertex::Attribute::Usage::COLOR, Vertex::Attribute::Usage::TEXTURE_COORDINATES0,
+                                                      Vertex::Attribute::Usage::INSTANCE_TRANSFORM, Vertex::Attribute::Usage::INSTANCE_COLOR},
+                                                     {{"color", DataType::FLOAT_VECTOR4}},
+                                                     {{"modelViewProj", DataType::FLOAT_MATRIX4}, {"params", DataType::FLOAT_VECTOR4}, {"gravity", DataType::FLOAT_VECTOR4}});
+                                break;
+                            case 4:
+                                particleShader->init(std::vector<uint8_t>(std::begin(TexturePSGL4_glsl), std::end(TexturePSGL4_glsl)),
+                                                     std::vector<uint8_t>(std::begin(ParticleVSGL4_glsl), std::end(ParticleVSGL4_glsl)),
+                                                     {Vertex::Attribute::Usage::POSITION, Vertex::Attribute::Usage::COLOR, Vertex::Attribute::Usage::TEXTURE_COORDINATES0,
+                                                      Vertex::Attribute::Usage::INSTANCE_TRANSFORM, Vertex::Attribute::Usage::INSTANCE_COLOR},
+                                                     {{"color", DataType::FLOAT_VECTOR4}},
+                                                     {{"modelViewProj", DataType::FLOAT_MATRIX4}, {"params", DataType::FLOAT_VECTOR4}, {"gravity", DataType::FLOAT_VECTOR4}});
+                                break;
+#  endif
+                            default:
+                                throw SystemError("Unsupported OpenGL version");
+                        }
+
+                        engine->getCache()->setShader(SHADER_PARTICLE, particleShader);
+
+                        std::shared_ptr<Shader> instancedShader = std::make_shared<Shader>(*this);
+
+                        switch (device->getAPIMajorVersion())
+                        {
+#  if OUZEL_SUPPORTS_OPENGLES
+                            case 3:
+                                instancedShader->init(std::vector<uint8_t>(std::begin(TexturePSGLES3_glsl), std::end(TexturePSGLES3_glsl)),
+                                                      std::vector<uint8_t>(std::begin(InstancedVSGLES3_glsl), std::end(InstancedVSGLES3_glsl)),
+                                                      {Vertex::Attribute::Usage::POSITION, Vertex::Attribute::Usage::COLOR, Vertex::Attribute::Usage::TEXTURE_COORDINATES0,
+                                                       Vertex::Attribute::Usage::INSTANCE_TRANSFORM, Vertex::Attribute::Usage::INSTANCE_COLOR},
+                                                      {{"color", DataType::FLOAT_VECTOR4}},
+                                                      {{"modelViewProj", DataType::FLOAT_MATRIX4}});
+                                break;
+#  else
+                            case 3:
+                                instancedShader->init(std::vector<uint8_t>(std::begin(TexturePSGL3_glsl), std::end(TexturePSGL3_glsl)),
+                                                      std::vector<uint8_t>(std::begin(InstancedVSGL3_glsl), std::end(InstancedVSGL3_glsl)),
+                                                      {Vertex::Attribute::Usage::POSITION, Vertex::Attribute::Usage::COLOR, Vertex::Attribute::Usage::TEXTURE_COORDINATES0,
+                                                       Vertex::Attribute::Usage::INSTANCE_TRANSFORM, Vertex::Attribute::Usage::INSTANCE_COLOR},
+                                                      {{"color", DataType::FLOAT_VECTOR4}},
+                                                      {{"modelViewProj", DataType::FLOAT_MATRIX4}});
+                                break;
+                            case 4:
+                                instancedShader->init(std::vector<uint8_t>(std::begin(TexturePSGL4_glsl), std::end(TexturePSGL4_glsl)),
+                                                      std::vector<uint8_t>(std::begin(InstancedVSGL4_glsl), std::end(InstancedVSGL4_glsl)),
+                                                      {Vertex::Attribute::Usage::POSITION, Vertex::Attribute::Usage::COLOR, Vertex::Attribute::Usage::TEXTURE_COORDINATES0,
+                                                       Vertex::Attribute::Usage::INSTANCE_TRANSFORM, Vertex::Attribute::Usage::INSTANCE_COLOR},
+                                                      {{"color", DataType::FLOAT_VECTOR4}},
+                                                      {{"modelViewProj", DataType::FLOAT_MATRIX4}});
+                                break;
+#  endif
+                            default:
+                                throw SystemError("Unsupported OpenGL version");
+                        }
+
+                        engine->getCache()->setShader(SHADER_INSTANCED, instancedShader);
+                    }
                     break;
                 }
 #endif
@@ -388,6 +580,26 @@ namespace ouzel
                                       {{"modelViewProj", DataType::FLOAT_MATRIX4}});
 
                     engine->getCache()->setShader(SHADER_COLOR, colorShader);
+
+                    std::shared_ptr<Shader> textShader = std::make_shared<Shader>(*this);
+
+                    textShader->init(std::vector<uint8_t>(),
+                                     std::vector<uint8_t>(),
+                                     {Vertex::Attribute::Usage::POSITION, Vertex::Attribute::Usage::COLOR, Vertex::Attribute::Usage::TEXTURE_COORDINATES0},
+                                     {{"color", DataType::FLOAT_VECTOR4}},
+                                     {{"modelViewProj", DataType::FLOAT_MATRIX4}});
+
+                    engine->getCache()->setShader(SHADER_TEXT, textShader);
+
+                    std::shared_ptr<Shader> sdfShader = std::make_shared<Shader>(*this);
+
+                    sdfShader->init(std::vector<uint8_t>(),
+                                    std::vector<uint8_t>(),
+                                    {Vertex::Attribute::Usage::POSITION, Vertex::Attribute::Usage::COLOR, Vertex::Attribute::Usage::TEXTURE_COORDINATES0},
+                                    {{"color", DataType::FLOAT_VECTOR4}},
+                                    {{"modelViewProj", DataType::FLOAT_MATRIX4}});
+
+                    engine->getCache()->setShader(SHADER_SDF, sdfShader);
                     break;
                 }
             }
@@ -539,17 +751,52 @@ namespace ouzel
                             uint32_t indexSize,
                             const std::shared_ptr<Buffer>& vertexBuffer,
                             DrawMode drawMode,
-                            uint32_t startIndex)
+                            uint32_t startIndex,
+                            uint32_t baseVertex)
         {
             if (!indexBuffer || !vertexBuffer)
                 throw DataError("Invalid mesh buffer passed to render queue");
 
+            if (indexSize != sizeof(uint16_t) && indexSize != sizeof(uint32_t))
+                throw DataError("Invalid index size");
+
+            if (indexSize == sizeof(uint32_t) && !device->isUInt32IndicesSupported())
+                throw DataError("32-bit indices are not supported");
+
             device->addCommand(DrawCommand(indexBuffer->getResource(),
                                            indexCount,
                                            indexSize,
                                            vertexBuffer->getResource(),
                                            drawMode,
-                                           startIndex));
+                                           startIndex,
+                                           baseVertex));
+        }
+
+        void Renderer::drawInstanced(const std::shared_ptr<Buffer>& indexBuffer,
+                                     uint32_t indexCount,
+                                     uint32_t indexSize,
+                                     const std::shared_ptr<Buffer>& vertexBuffer,
+                                     const std::shared_ptr<Buffer>& instanceBuffer,
+                                     uint32_t instanceCount,
+                                     DrawMode drawMode,
+                                     uint32_t startIndex)
+        {
+            if (!indexBuffer || !vertexBuffer || !instanceBuffer)
+                throw DataError("Invalid mesh buffer passed to render queue");
+
+            if (!device->isInstancingSupported())
+                throw DataError("Instanced drawing is not supported");
+
+            if (instanceCount == 0) return;
+
+            device->addCommand(DrawInstancedCommand(indexBuffer->getResource(),
+                                                    indexCount,
+                                                    indexSize,
+                                                    vertexBuffer->getResource(),
+                                                    instanceBuffer->getResource(),
+                                                    instanceCount,
+                                                    drawMode,
+                                                    startIndex));
         }
 
         void Renderer::pushDebugMarker(const std::string& name)
@@ -562,11 +809,32 @@ namespace ouzel
             device->addCommand(PopDebugMarkerCommand());
         }
 
-        void Renderer::setShaderConstants(std::vector<std::vector<float>> fragmentShaderConstants,
-                                          std::vector<std::vector<float>> vertexShaderConstants)
+        void Renderer::setShaderConstants(const std::vector<std::vector<float>>& fragmentShaderConstants,
+                                          const std::vector<std::vector<float>>& vertexShaderConstants)
         {
-            device->addCommand(SetShaderConstantsCommand(fragmentShaderConstants,
-                                                         vertexShaderConstants));
+            uint32_t fragmentShaderConstantOffset = device->getDataOffset();
+            for (const std::vector<float>& fragmentShaderConstant : fragmentShaderConstants)
+                device->addData(fragmentShaderConstant.data(), static_cast<uint32_t>(fragmentShaderConstant.size()));
+
+            uint32_t vertexShaderConstantOffset = device->getDataOffset();
+            for (const std::vector<float>& vertexShaderConstant : vertexShaderConstants)
+                device->addData(vertexShaderConstant.data(), static_cast<uint32_t>(vertexShaderConstant.size()));
+
+            device->addCommand(SetShaderConstantsCommand(fragmentShaderConstantOffset,
+                                                         vertexShaderConstantOffset - fragmentShaderConstantOffset,
+                                                         vertexShaderConstantOffset,
+                                                         device->getDataOffset() - vertexShaderConstantOffset));
+        }
+
+        void Renderer::setShaderConstants(const float* fragmentShaderConstants,
+                                          uint32_t fragmentShaderConstantSize,
+                                          const float* vertexShaderConstants,
+                                          uint32_t vertexShaderConstantSize)
+        {
+            device->addCommand(SetShaderConstantsCommand(device->addData(fragmentShaderConstants, fragmentShaderConstantSize),
+                                                         fragmentShaderConstantSize,
+                                                         device->addData(vertexShaderConstants, vertexShaderConstantSize),
+                                                         vertexShaderConstantSize));
         }
 
         void Renderer::setTextures(const std::vector<std::shared_ptr<Texture>>& textures)
@@ -581,5 +849,15 @@ namespace ouzel
 
             device->addCommand(SetTexturesCommand(newTextures));
         }
+
+        void Renderer::setCommandBuffer(CommandBuffer* commandBuffer)
+        {
+            device->setRecordBuffer(commandBuffer);
+        }
+
+        void Renderer::submitCommandBuffer(CommandBuffer& commandBuffer)
+        {
+            device->submitCommands(commandBuffer);
+        }
     } // namespace graphics
 } // namespace ouzel
@@ -25,6 +25,10 @@ namespace ouzel
     {
         const std::string SHADER_TEXTURE = "shaderTexture";
         const std::string SHADER_COLOR = "shaderColor";
+        const std::string SHADER_PARTICLE = "shaderParticle";
+        const std::string SHADER_INSTANCED = "shaderInstanced";
+        const std::string SHADER_TEXT = "shaderText";
+        const std::string SHADER_SDF = "shaderSDF";
 
         const std::string BLEND_NO_BLEND = "blendNoBlend";
         const std::string BLEND_ADD = "blendAdd";
@@ -35,6 +39,7 @@ namespace ouzel
         const std::string TEXTURE_WHITE_PIXEL = "textureWhitePixel";
 
         class RenderDevice;
+        class CommandBuffer;
         class BlendState;
         class Buffer;
         class Shader;
@@ -112,18 +117,39 @@ namespace ouzel
             void setDepthState(bool depthTest, bool depthWrite);
             void setPipelineState(const std::shared_ptr<BlendState>& blendState,
                                   const std::shared_ptr<Shader>& shader);
+            // baseVertex is added to the indices, so that the meshes with more vertices than the index type can
+            // address are drawn in chunks
             void draw(const std::shared_ptr<Buffer>& indexBuffer,
                       uint32_t indexCount,
                       uint32_t indexSize,
                       const std::shared_ptr<Buffer>& vertexBuffer,
                       DrawMode drawMode,
-                      uint32_t startIndex);
+                      uint32_t startIndex,
+                      uint32_t baseVertex = 0);
+            // draws instanceCount copies of the mesh, instanceBuffer holds an Instance structure for every copy
+            void drawInstanced(const std::shared_ptr<Buffer>& indexBuffer,
+                               uint32_t indexCount,
+                               uint32_t indexSize,
+                               const std::shared_ptr<Buffer>& vertexBuffer,
+                               const std::shared_ptr<Buffer>& instanceBuffer,
+                               uint32_t instanceCount,
+                               DrawMode drawMode,
+                               uint32_t startIndex);
             void pushDebugMarker(const std::string& name);
             void popDebugMarker();
-            void setShaderConstants(std::vector<std::vector<float>> fragmentShaderConstants,
-                                    std::vector<std::vector<float>> vertexShaderConstants);
+            void setShaderConstants(const std::vector<std::vector<float>>& fragmentShaderConstants,
+                                    const std::vector<std::vector<float>>& vertexShaderConstants);
+            void setShaderConstants(const float* fragmentShaderConstants,
+                                    uint32_t fragmentShaderConstantSize,
+                                    const float* vertexShaderConstants,
+                                    uint32_t vertexShaderConstantSize);
             void setTextures(const std::vector<std::shared_ptr<Texture>>& textures);
 
+            // records the commands issued from the calling thread into the buffer (nullptr to record into the frame's buffer)
+            void setCommandBuffer(CommandBuffer* commandBuffer);
+            // appends the recorded commands to the frame in the order of submission
+            void submitCommandBuffer(CommandBuffer& commandBuffer);
+
         protected:
             explicit Renderer(Driver driver,
                               Window* newWindow,
@@ -37,13 +37,19 @@ namespace ouzel
             if ((flags & RENDER_TARGET) && (mipmaps == 0 || mipmaps > 1))
                 throw DataError("Invalid mip map count");
 
-            renderer.executeOnRenderThread(std::bind(static_cast<void(TextureResource::*)(const Size2&, uint32_t, uint32_t, uint32_t, PixelFormat)>(&TextureResource::init),
-                                                     resource,
-                                                     newSize,
-                                                     newFlags,
-                                                     newMipmaps,
-                                                     newSampleCount,
-                                                     newPixelFormat));
+            if (flags & STREAMING)
+                throw DataError("Only textures initialized with data can be streamed");
+
+            if (isCompressed(pixelFormat))
+                throw DataError("Compressed textures must be initialized with data");
+
+            updateResource(std::bind(static_cast<void(TextureResource::*)(const Size2&, uint32_t, uint32_t, uint32_t, PixelFormat)>(&TextureResource::init),
+                                     resource,
+                                     newSize,
+                                     newFlags,
+                                     newMipmaps,
+                                     newSampleCount,
+                                     newPixelFormat));
         }
 
         void Texture::init(const std::vector<uint8_t>& newData,
@@ -61,13 +67,34 @@ namespace ouzel
             if ((flags & RENDER_TARGET) && (mipmaps == 0 || mipmaps > 1))
                 throw DataError("Invalid mip map count");
 
-            renderer.executeOnRenderThread(std::bind(static_cast<void(TextureResource::*)(const std::vector<uint8_t>&, const Size2&, uint32_t, uint32_t, PixelFormat)>(&TextureResource::init),
-                                                     resource,
-                                                     newData,
-                                                     newSize,
-                                                     newFlags,
-                                                     newMipmaps,
-                                                     newPixelFormat));
+            if ((flags & STREAMING) && (flags & (DYNAMIC | RENDER_TARGET)))
+                throw DataError("Streaming texture can not be dynamic or a render target");
+
+            if (isCompressed(pixelFormat))
+            {
+                // mip maps can not be generated from the compressed data, they have to be passed as levels
+                if (mipmaps != 1 || (flags & (DYNAMIC | RENDER_TARGET | STREAMING)))
+                    throw DataError("Compressed texture must have one mip map and can not be dynamic, streamed or a render target");
+
+                if (newData.size() != getLevelDataSize(pixelFormat,
+                                                       static_cast<uint32_t>(size.width),
+                                                       static_cast<uint32_t>(size.height)))
+                    throw DataError("Invalid texture data size");
+
+                if (!renderer.getDevice()->isPixelFormatSupported(pixelFormat))
+                    throw DataError("Pixel format is not supported");
+            }
+
+            // the levels of streaming textures are counted when they are uploaded
+            if (!(flags & STREAMING)) renderer.getDevice()->textureUploadSize += newData.size();
+
+            updateResource(std::bind(static_cast<void(TextureResource::*)(const std::vector<uint8_t>&, const Size2&, uint32_t, uint32_t, PixelFormat)>(&TextureResource::init),
+                                     resource,
+                                     newData,
+                                     newSize,
+                                     newFlags,
+                                     newMipmaps,
+                                     newPixelFormat));
         }
 
         void Texture::init(const std::vector<Level>& newLevels,
@@ -84,12 +111,33 @@ namespace ouzel
             if ((flags & RENDER_TARGET) && (mipmaps == 0 || mipmaps > 1))
                 throw DataError("Invalid mip map count");
 
-            renderer.executeOnRenderThread(std::bind(static_cast<void(TextureResource::*)(const std::vector<Level>&, const Size2&, uint32_t, PixelFormat)>(&TextureResource::init),
-                                                     resource,
-                                                     newLevels,
-                                                     newSize,
-                                                     newFlags,
-                                                     newPixelFormat));
+            if (flags & STREAMING)
+                throw DataError("Only textures initialized with data can be streamed");
+
+            if (isCompressed(pixelFormat))
+            {
+                if (flags & (DYNAMIC | RENDER_TARGET))
+                    throw DataError("Compressed texture can not be dynamic or a render target");
+
+                if (!renderer.getDevice()->isPixelFormatSupported(pixelFormat))
+                    throw DataError("Pixel format is not supported");
+            }
+
+            for (const Level& level : newLevels)
+                if (level.data.size() != getLevelDataSize(pixelFormat,
+                                                          static_cast<uint32_t>(level.size.width),
+                                                          static_cast<uint32_t>(level.size.height)))
+                    throw DataError("Invalid texture level data size");
+
+            for (const Level& level : newLevels)
+                renderer.getDevice()->textureUploadSize += level.data.size();
+
+            updateResource(std::bind(static_cast<void(TextureResource::*)(const std::vector<Level>&, const Size2&, uint32_t, PixelFormat)>(&TextureResource::init),
+                                     resource,
+                                     newLevels,
+                                     newSize,
+                                     newFlags,
+                                     newPixelFormat));
         }
 
         void Texture::setSize(const Size2& newSize)
@@ -102,9 +150,9 @@ namespace ouzel
 
             size = newSize;
 
-            renderer.executeOnRenderThread(std::bind(&TextureResource::setSize,
-                                                     resource,
-                                                     newSize));
+            updateResource(std::bind(&TextureResource::setSize,
+                                     resource,
+                                     newSize));
         }
 
         void Texture::setData(const std::vector<uint8_t>& newData, const Size2& newSize)
@@ -117,82 +165,104 @@ namespace ouzel
 
             size = newSize;
 
-            renderer.executeOnRenderThread(std::bind(&TextureResource::setData,
-                                                     resource,
-                                                     newData,
-                                                     newSize));
+            renderer.getDevice()->textureUploadSize += newData.size();
+
+            updateResource(std::bind(&TextureResource::setData,
+                                     resource,
+                                     newData,
+                                     newSize));
+        }
+
+        void Texture::setRegionData(const std::vector<uint8_t>& newData,
+                                    uint32_t x, uint32_t y,
+                                    uint32_t regionWidth, uint32_t regionHeight)
+        {
+            if (!(flags & Texture::DYNAMIC) || flags & Texture::RENDER_TARGET)
+                throw DataError("Texture is not dynamic");
+
+            if (x + regionWidth > static_cast<uint32_t>(size.width) ||
+                y + regionHeight > static_cast<uint32_t>(size.height))
+                throw DataError("Invalid texture region");
+
+            renderer.getDevice()->textureUploadSize += newData.size();
+
+            updateResource(std::bind(&TextureResource::setRegionData,
+                                     resource,
+                                     newData,
+                                     x, y,
+                                     regionWidth, regionHeight));
         }
 
         void Texture::setFilter(Filter newFilter)
         {
             filter = newFilter;
 
-            renderer.executeOnRenderThread(std::bind(&TextureResource::setFilter,
-                                                     resource,
-                                                     newFilter));
+            updateResource(std::bind(&TextureResource::setFilter,
+                                     resource,
+                                     newFilter));
         }
 
         void Texture::setAddressX(Address newAddressX)
         {
             addressX = newAddressX;
 
-            renderer.executeOnRenderThread(std::bind(&TextureResource::setAddressX,
-                                                     resource,
-                                                     newAddressX));
+            updateResource(std::bind(&TextureResource::setAddressX,
+                                     resource,
+                                     newAddressX));
         }
 
         void Texture::setAddressY(Address newAddressY)
         {
             addressY = newAddressY;
 
-            renderer.executeOnRenderThread(std::bind(&TextureResource::setAddressY,
-                                                     resource,
-                                                     newAddressY));
+            updateResource(std::bind(&TextureResource::setAddressY,
+                                     resource,
+                                     newAddressY));
         }
 
         void Texture::setMaxAnisotropy(uint32_t newMaxAnisotropy)
         {
             maxAnisotropy = newMaxAnisotropy;
 
-            renderer.executeOnRenderThread(std::bind(&TextureResource::setMaxAnisotropy,
-                                                     resource,
-                                                     newMaxAnisotropy));
+            updateResource(std::bind(&TextureResource::setMaxAnisotropy,
+                                     resource,
+                                     newMaxAnisotropy));
         }
 
         void Texture::setClearColorBuffer(bool clear)
         {
             clearColorBuffer = clear;
 
-            renderer.executeOnRenderThread(std::bind(&TextureResource::setClearColorBuffer,
-                                                     resource,
-                                                     clear));
+            updateResource(std::bind(&TextureResource::setClearColorBuffer,
+                                     resource,
+                                     clear));
         }
 
         void Texture::setClearDepthBuffer(bool clear)
         {
             clearDepthBuffer = clear;
 
-            renderer.executeOnRenderThread(std::bind(&TextureResource::setClearDepthBuffer,
-                                                     resource,
-                                                     clear));
+            updateResource(std::bind(&TextureResource::setClearDepthBuffer,
+                                     resource,
+                                     clear));
         }
 
         void Texture::setClearColor(Color color)
         {
             clearColor = color;
 
-            renderer.executeOnRenderThread(std::bind(&TextureResource::setClearColor,
-                                                     resource,
-                                                     color));
+            updateResource(std::bind(&TextureResource::setClearColor,
+                                     resource,
+                                     color));
         }
 
         void Texture::setClearDepth(float depth)
         {
             clearDepth = depth;
 
-            renderer.executeOnRenderThread(std::bind(&TextureResource::setClearDepth,
-                                                     resource,
-                                                     depth));
+            updateResource(std::bind(&TextureResource::setClearDepth,
+                                     resource,
+                                     depth));
         }
 
     } // namespace graphics
@@ -3,6 +3,7 @@
 #pragma once
 
 #include <cstdint>
+#include <functional>
 #include <string>
 #include <vector>
 #include "graphics/PixelFormat.hpp"
@@ -26,6 +27,7 @@ namespace ouzel
                 DEPTH_BUFFER = 0x04,
                 BINDABLE_COLOR_BUFFER = 0x08,
                 BINDABLE_DEPTH_BUFFER = 0x10,
+                STREAMING = 0x20 // mip levels are generated on a worker thread and uploaded over several frames
             };
 
             enum class Filter
@@ -83,6 +85,10 @@ namespace ouzel
             void setSize(const Size2& newSize);
 
             void setData(const std::vector<uint8_t>& newData, const Size2& newSize);
+            // replaces a rectangle of the first level, the other levels are regenerated from it
+            void setRegionData(const std::vector<uint8_t>& newData,
+                               uint32_t x, uint32_t y,
+                               uint32_t regionWidth, uint32_t regionHeight);
 
             inline uint32_t getFlags() const { return flags; }
             inline uint32_t getMipmaps() const { return mipmaps; }
@@ -116,6 +122,8 @@ namespace ouzel
             void setClearDepth(float depth);
 
         private:
+            void updateResource(const std::function<void(void)>& func);
+
             Renderer& renderer;
             TextureResource* resource = nullptr;
 
@@ -0,0 +1,261 @@
+// Copyright 2015-2018 Elviss Strazdins. All rights reserved.
+
+#include <algorithm>
+#include "TextureAtlas.hpp"
+#include "ImageDataSTB.hpp"
+#include "Renderer.hpp"
+#include "utils/Errors.hpp"
+#include "utils/JSON.hpp"
+
+namespace ouzel
+{
+    namespace graphics
+    {
+        TextureAtlas::TextureAtlas(Renderer* initRenderer,
+                                   uint32_t initPageWidth,
+                                   uint32_t initPageHeight,
+                                   uint32_t initPadding):
+            renderer(initRenderer),
+            pageWidth(initPageWidth),
+            pageHeight(initPageHeight),
+            padding(initPadding)
+        {
+            if (pageWidth == 0 || pageHeight == 0)
+                throw DataError("Invalid atlas page size");
+        }
+
+        bool TextureAtlas::addImage(const std::string& name, const ImageData& image, bool mipmaps)
+        {
+            if (image.getPixelFormat() != PixelFormat::RGBA8_UNORM)
+                throw DataError("Only RGBA8 images can be added to an atlas");
+
+            uint32_t width = static_cast<uint32_t>(image.getSize().width);
+            uint32_t height = static_cast<uint32_t>(image.getSize().height);
+
+            if (image.getData().size() != width * height * 4)
+                throw DataError("Invalid image data size");
+
+            removeImage(name);
+
+            uint32_t x = 0;
+            uint32_t y = 0;
+            uint32_t pageIndex;
+
+            for (pageIndex = 0; pageIndex < pages.size(); ++pageIndex)
+                if (pages[pageIndex]->mipmaps == mipmaps &&
+                    pages[pageIndex]->packer.insert(width, height, x, y)) break;
+
+            if (pageIndex == pages.size())
+            {
+                std::unique_ptr<Page> page(new Page(pageWidth, pageHeight, padding, mipmaps));
+
+                if (!page->packer.insert(width, height, x, y))
+                    return false;
+
+                // the texture is created with the empty page, then only the rectangles of the images are uploaded
+                if (renderer)
+                {
+                    page->texture = std::make_shared<Texture>(*renderer);
+                    page->texture->init(page->data, Size2(static_cast<float>(pageWidth), static_cast<float>(pageHeight)),
+                                        Texture::DYNAMIC, mipmaps ? 0 : 1, PixelFormat::RGBA8_UNORM);
+                }
+
+                pages.push_back(std::move(page));
+            }
+
+            Page& page = *pages[pageIndex];
+
+            Region& region = regions[name];
+            region.page = pageIndex;
+            region.rectangle = Rect(static_cast<float>(x), static_cast<float>(y),
+                                    static_cast<float>(width), static_cast<float>(height));
+            region.texture = page.texture;
+
+            copyImage(page, region.rectangle, image.getData());
+
+            return true;
+        }
+
+        void TextureAtlas::removeImage(const std::string& name)
+        {
+            auto i = regions.find(name);
+
+            if (i == regions.end()) return;
+
+            // the pixels are left in the page until they are overwritten by another image
+            const Rect& rectangle = i->second.rectangle;
+            pages[i->second.page]->packer.remove(static_cast<uint32_t>(rectangle.position.x),
+                                                 static_cast<uint32_t>(rectangle.position.y),
+                                                 static_cast<uint32_t>(rectangle.size.width),
+                                                 static_cast<uint32_t>(rectangle.size.height));
+
+            regions.erase(i);
+        }
+
+        void TextureAtlas::clear()
+        {
+            regions.clear();
+            pages.clear();
+        }
+
+        const TextureAtlas::Region& TextureAtlas::getRegion(const std::string& name) const
+        {
+            auto i = regions.find(name);
+
+            if (i == regions.end())
+                throw DataError("Image " + name + " is not in the atlas");
+
+            return i->second;
+        }
+
+        void TextureAtlas::upload()
+        {
+            for (const std::unique_ptr<Page>& page : pages)
+            {
+                if (page->texture)
+                {
+                    // the mipmaps are regenerated only under the uploaded rectangles
+                    for (const Rect& rectangle : page->dirtyRectangles)
+                    {
+                        uint32_t x = static_cast<uint32_t>(rectangle.position.x);
+                        uint32_t y = static_cast<uint32_t>(rectangle.position.y);
+                        uint32_t width = static_cast<uint32_t>(rectangle.size.width);
+                        uint32_t height = static_cast<uint32_t>(rectangle.size.height);
+
+                        std::vector<uint8_t> regionData(width * height * 4);
+
+                        for (uint32_t row = 0; row < height; ++row)
+                        {
+                            const uint8_t* source = page->data.data() + ((y + row) * pageWidth + x) * 4;
+                            std::copy(source, source + width * 4, regionData.data() + row * width * 4);
+                        }
+
+                        page->texture->setRegionData(regionData, x, y, width, height);
+                    }
+                }
+
+                page->dirtyRectangles.clear();
+            }
+        }
+
+        float TextureAtlas::getPageOccupancy(uint32_t page) const
+        {
+            if (page >= pages.size())
+                throw DataError("Invalid atlas page");
+
+            return pages[page]->packer.getOccupancy();
+        }
+
+        std::vector<uint8_t> TextureAtlas::encodePage(uint32_t page) const
+        {
+            if (page >= pages.size())
+                throw DataError("Invalid atlas page");
+
+            ImageDataSTB image(Size2(static_cast<float>(pageWidth), static_cast<float>(pageHeight)),
+                               pages[page]->data,
+                               PixelFormat::RGBA8_UNORM);
+
+            return image.encode();
+        }
+
+        std::vector<uint8_t> TextureAtlas::encodePageMetadata(uint32_t page, const std::string& imageFilename) const
+        {
+            if (page >= pages.size())
+                throw DataError("Invalid atlas page");
+
+            json::Data document;
+
+            json::Value& framesArray = document["frames"];
+            framesArray = json::Value::Type::ARRAY;
+
+            for (const auto& region : regions)
+            {
+                if (region.second.page != page) continue;
+
+                const Rect& rectangle = region.second.rectangle;
+
+                json::Value frameObject(json::Value::Type::OBJECT);
+                frameObject["filename"] = region.first;
+
+                json::Value& frameRectangleObject = frameObject["frame"];
+                frameRectangleObject = json::Value::Type::OBJECT;
+                frameRectangleObject["x"] = static_cast<uint32_t>(rectangle.position.x);
+                frameRectangleObject["y"] = static_cast<uint32_t>(rectangle.position.y);
+                frameRectangleObject["w"] = static_cast<uint32_t>(rectangle.size.width);
+                frameRectangleObject["h"] = static_cast<uint32_t>(rectangle.size.height);
+
+                frameObject["rotated"] = false;
+                frameObject["trimmed"] = false;
+
+                json::Value& spriteSourceSizeObject = frameObject["spriteSourceSize"];
+                spriteSourceSizeObject = json::Value::Type::OBJECT;
+                spriteSourceSizeObject["x"] = 0U;
+                spriteSourceSizeObject["y"] = 0U;
+                spriteSourceSizeObject["w"] = static_cast<uint32_t>(rectangle.size.width);
+                spriteSourceSizeObject["h"] = static_cast<uint32_t>(rectangle.size.height);
+
+                json::Value& sourceSizeObject = frameObject["sourceSize"];
+                sourceSizeObject = json::Value::Type::OBJECT;
+                sourceSizeObject["w"] = static_cast<uint32_t>(rectangle.size.width);
+                sourceSizeObject["h"] = static_cast<uint32_t>(rectangle.size.height);
+
+                json::Value& pivotObject = frameObject["pivot"];
+                pivotObject = json::Value::Type::OBJECT;
+                pivotObject["x"] = 0.5;
+                pivotObject["y"] = 0.5;
+
+                framesArray.asArray().push_back(frameObject);
+            }
+
+            json::Value& metaObject = document["meta"];
+            metaObject = json::Value::Type::OBJECT;
+            metaObject["image"] = imageFilename;
+            metaObject["format"] = std::string("RGBA8888");
+
+            json::Value& sizeObject = metaObject["size"];
+            sizeObject = json::Value::Type::OBJECT;
+            sizeObject["w"] = pageWidth;
+            sizeObject["h"] = pageHeight;
+
+            return document.encode();
+        }
+
+        void TextureAtlas::copyImage(Page& page, const Rect& rectangle, const std::vector<uint8_t>& imageData)
+        {
+            uint32_t x = static_cast<uint32_t>(rectangle.position.x);
+            uint32_t y = static_cast<uint32_t>(rectangle.position.y);
+            uint32_t width = static_cast<uint32_t>(rectangle.size.width);
+            uint32_t height = static_cast<uint32_t>(rectangle.size.height);
+            uint32_t pitch = pageWidth * 4;
+
+            for (uint32_t row = 0; row < height; ++row)
+            {
+                const uint8_t* source = imageData.data() + row * width * 4;
+                uint8_t* destination = page.data.data() + (y + row) * pitch + x * 4;
+
+                std::copy(source, source + width * 4, destination);
+
+                // extrude the edge pixels into the padding, so that the filtering does not sample the neighbouring images
+                for (uint32_t i = 1; i <= padding; ++i)
+                {
+                    std::copy(destination, destination + 4, destination - i * 4);
+                    std::copy(destination + (width - 1) * 4, destination + width * 4, destination + (width - 1 + i) * 4);
+                }
+            }
+
+            uint8_t* firstRow = page.data.data() + y * pitch + (x - padding) * 4;
+            uint8_t* lastRow = page.data.data() + (y + height - 1) * pitch + (x - padding) * 4;
+            uint32_t paddedRowSize = (width + padding * 2) * 4;
+
+            for (uint32_t i = 1; i <= padding; ++i)
+            {
+                std::copy(firstRow, firstRow + paddedRowSize, firstRow - i * pitch);
+                std::copy(lastRow, lastRow + paddedRowSize, lastRow + i * pitch);
+            }
+
+            page.dirtyRectangles.push_back(Rect(static_cast<float>(x - padding), static_cast<float>(y - padding),
+                                                static_cast<float>(width + padding * 2),
+                                                static_cast<float>(height + padding * 2)));
+        }
+    } // namespace graphics
+} // namespace ouzel
@@ -0,0 +1,93 @@
+// Copyright 2015-2018 Elviss Strazdins. All rights reserved.
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "graphics/AtlasPacker.hpp"
+#include "graphics/ImageData.hpp"
+#include "graphics/Texture.hpp"
+#include "math/Rect.hpp"
+
+namespace ouzel
+{
+    namespace graphics
+    {
+        class Renderer;
+
+        // packs RGBA8 images into shared pages, so that the sprites using them can be batched together
+        class TextureAtlas final
+        {
+        public:
+            struct Region
+            {
+                uint32_t page;
+                Rect rectangle; // in pixels
+                std::shared_ptr<Texture> texture; // null if the atlas has no renderer
+            };
+
+            // without a renderer the pages are only kept in memory (e.g. for packing the atlas offline)
+            explicit TextureAtlas(Renderer* initRenderer,
+                                  uint32_t initPageWidth = 2048,
+                                  uint32_t initPageHeight = 2048,
+                                  uint32_t initPadding = 2);
+
+            TextureAtlas(const TextureAtlas&) = delete;
+            TextureAtlas& operator=(const TextureAtlas&) = delete;
+
+            TextureAtlas(TextureAtlas&&) = delete;
+            TextureAtlas& operator=(TextureAtlas&&) = delete;
+
+            // returns false if the image does not fit in an empty page, images with and without mipmaps are packed
+            // into separate pages
+            bool addImage(const std::string& name, const ImageData& image, bool mipmaps = true);
+            void removeImage(const std::string& name);
+            void clear();
+
+            inline bool hasImage(const std::string& name) const { return regions.find(name) != regions.end(); }
+            const Region& getRegion(const std::string& name) const;
+
+            // uploads the rectangles of the images that were added since the last upload
+            void upload();
+
+            inline uint32_t getPageCount() const { return static_cast<uint32_t>(pages.size()); }
+            inline uint32_t getPageWidth() const { return pageWidth; }
+            inline uint32_t getPageHeight() const { return pageHeight; }
+            float getPageOccupancy(uint32_t page) const;
+
+            // PNG image of the page
+            std::vector<uint8_t> encodePage(uint32_t page) const;
+            // sprite sheet description of the page in the format read by LoaderSprite
+            std::vector<uint8_t> encodePageMetadata(uint32_t page, const std::string& imageFilename) const;
+
+        private:
+            struct Page
+            {
+                Page(uint32_t width, uint32_t height, uint32_t padding, bool initMipmaps):
+                    packer(width, height, padding),
+                    data(width * height * 4),
+                    mipmaps(initMipmaps)
+                {
+                }
+
+                AtlasPacker packer;
+                std::vector<uint8_t> data;
+                bool mipmaps;
+                std::shared_ptr<Texture> texture;
+                std::vector<Rect> dirtyRectangles; // including the padding
+            };
+
+            void copyImage(Page& page, const Rect& rectangle, const std::vector<uint8_t>& imageData);
+
+            Renderer* renderer;
+            uint32_t pageWidth;
+            uint32_t pageHeight;
+            uint32_t padding;
+
+            std::vector<std::unique_ptr<Page>> pages;
+            std::map<std::string, Region> regions;
+        };
+    } // namespace graphics
+} // namespace ouzel
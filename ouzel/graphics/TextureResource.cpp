@@ -2,11 +2,13 @@
 
 #include <algorithm>
 #include "TextureResource.hpp"
+#include "ImageDownsample.hpp"
 #include "Renderer.hpp"
 #include "RenderDevice.hpp"
 #include "core/Engine.hpp"
 #include "math/MathUtils.hpp"
 #include "utils/Errors.hpp"
+#include "utils/Utils.hpp"
 
 extern uint8_t GAMMA_ENCODE[256];
 extern float GAMMA_DECODE[256];
@@ -15,6 +17,114 @@ namespace ouzel
 {
     namespace graphics
     {
+        // box filters the source directly to the size of the destination in a single pass, with the same gamma and
+        // alpha handling as the 2x2 downsampling
+        static void imageDownsample(const Texture::Level& source, Texture::Level& destination, PixelFormat pixelFormat)
+        {
+            uint32_t channels;
+            bool gamma = true;
+            bool alpha = false;
+
+            switch (pixelFormat)
+            {
+                case PixelFormat::RGBA8_UNORM:
+                    channels = 4;
+                    alpha = true;
+                    break;
+                case PixelFormat::RG8_UNORM:
+                    channels = 2;
+                    break;
+                case PixelFormat::R8_UNORM:
+                    channels = 1;
+                    break;
+                case PixelFormat::A8_UNORM:
+                    channels = 1;
+                    gamma = false;
+                    break;
+                default:
+                    throw DataError("Invalid pixel format");
+            }
+
+            const uint32_t sourceWidth = static_cast<uint32_t>(source.size.width);
+            const uint32_t sourceHeight = static_cast<uint32_t>(source.size.height);
+            const uint32_t destinationWidth = static_cast<uint32_t>(destination.size.width);
+            const uint32_t destinationHeight = static_cast<uint32_t>(destination.size.height);
+
+            for (uint32_t dy = 0; dy < destinationHeight; ++dy)
+            {
+                const uint32_t y0 = dy * sourceHeight / destinationHeight;
+                const uint32_t y1 = std::max(y0 + 1, (dy + 1) * sourceHeight / destinationHeight);
+
+                uint8_t* dst = destination.data.data() + dy * destination.pitch;
+
+                for (uint32_t dx = 0; dx < destinationWidth; ++dx, dst += channels)
+                {
+                    const uint32_t x0 = dx * sourceWidth / destinationWidth;
+                    const uint32_t x1 = std::max(x0 + 1, (dx + 1) * sourceWidth / destinationWidth);
+
+                    // GAMMA_DECODE holds rounded values, so the sums are exact
+                    uint64_t sums[4] = {0, 0, 0, 0};
+                    uint64_t pixels = 0;
+
+                    for (uint32_t y = y0; y < y1; ++y)
+                    {
+                        const uint8_t* pixel = source.data.data() + y * source.pitch + x0 * channels;
+
+                        for (uint32_t x = x0; x < x1; ++x, pixel += channels)
+                        {
+                            if (alpha)
+                            {
+                                // the color of the transparent pixels is ignored
+                                if (pixel[3] > 0)
+                                {
+                                    sums[0] += static_cast<uint32_t>(GAMMA_DECODE[pixel[0]]);
+                                    sums[1] += static_cast<uint32_t>(GAMMA_DECODE[pixel[1]]);
+                                    sums[2] += static_cast<uint32_t>(GAMMA_DECODE[pixel[2]]);
+                                    ++pixels;
+                                }
+                                sums[3] += pixel[3];
+                            }
+                            else
+                            {
+                                for (uint32_t channel = 0; channel < channels; ++channel)
+                                    sums[channel] += gamma ? static_cast<uint32_t>(GAMMA_DECODE[pixel[channel]]) : pixel[channel];
+                            }
+                        }
+                    }
+
+                    const uint64_t count = static_cast<uint64_t>(x1 - x0) * (y1 - y0);
+
+                    if (alpha)
+                    {
+                        if (pixels > 0)
+                        {
+                            dst[0] = GAMMA_ENCODE[(sums[0] + pixels / 2) / pixels];
+                            dst[1] = GAMMA_ENCODE[(sums[1] + pixels / 2) / pixels];
+                            dst[2] = GAMMA_ENCODE[(sums[2] + pixels / 2) / pixels];
+                            dst[3] = static_cast<uint8_t>(sums[3] / count);
+                        }
+                        else
+                        {
+                            dst[0] = 0;
+                            dst[1] = 0;
+                            dst[2] = 0;
+                            dst[3] = 0;
+                        }
+                    }
+                    else
+                    {
+                        for (uint32_t channel = 0; channel < channels; ++channel)
+                        {
+                            if (gamma)
+                                dst[channel] = GAMMA_ENCODE[(sums[channel] + count / 2) / count];
+                            else
+                                dst[channel] = static_cast<uint8_t>(sums[channel] / count);
+                        }
+                    }
+                }
+            }
+        }
+
         TextureResource::TextureResource(RenderDevice& initRenderDevice):
             renderDevice(initRenderDevice)
         {
@@ -22,6 +132,7 @@ namespace ouzel
 
         TextureResource::~TextureResource()
         {
+            if (flags & Texture::STREAMING) renderDevice.getTextureStreamer().cancel(this);
         }
 
         void TextureResource::init(const Size2& newSize,
@@ -56,7 +167,26 @@ namespace ouzel
                 throw DataError("Invalid mip map count");
 
             calculateSizes(newSize);
-            calculateData(newData);
+
+            if (flags & Texture::STREAMING)
+            {
+                // only the smallest level is uploaded at init, the rest are streamed
+                std::vector<Texture::Level> streamLevels = levels;
+                streamLevels[0].data = newData;
+
+                for (size_t level = 0; level < levels.size() - 1; ++level)
+                    levels[level].data.clear();
+
+                // the placeholder is downsampled directly from the data, because the chain of the levels between them
+                // is generated later on the streaming thread
+                imageDownsample(streamLevels[0], levels.back(), pixelFormat);
+
+                baseLevel = static_cast<uint32_t>(levels.size() - 1);
+
+                renderDevice.getTextureStreamer().addTexture(this, streamLevels, pixelFormat);
+            }
+            else
+                calculateData(newData);
         }
 
         void TextureResource::init(const std::vector<Texture::Level>& newLevels,
@@ -98,450 +228,151 @@ namespace ouzel
             calculateData(newData);
         }
 
-        void TextureResource::calculateSizes(const Size2& newSize)
+        void TextureResource::setRegionData(const std::vector<uint8_t>& newData,
+                                            uint32_t x, uint32_t y,
+                                            uint32_t regionWidth, uint32_t regionHeight)
         {
-            levels.clear();
-            size = newSize;
-
-            uint32_t newWidth = static_cast<uint32_t>(newSize.width);
-            uint32_t newHeight = static_cast<uint32_t>(newSize.height);
+            if (!(flags & Texture::DYNAMIC) || flags & Texture::RENDER_TARGET)
+                throw DataError("Texture is not dynamic");
 
-            uint32_t pixelSize = getPixelSize(pixelFormat);
-            uint32_t pitch = newWidth * pixelSize;
-            uint32_t bufferSize = pitch * newHeight;
-            levels.push_back({newSize, pitch, std::vector<uint8_t>(bufferSize)});
+            if (isCompressed(pixelFormat))
+                throw DataError("Compressed textures can not be updated partially");
 
-            if (!(flags & Texture::RENDER_TARGET) && // don't generate mipmaps for render targets
-                (renderDevice.isNPOTTexturesSupported() || (isPOT(newWidth) && isPOT(newHeight))))
-            {
-                while ((newWidth > 1 || newHeight > 1) &&
-                       (mipmaps == 0 || levels.size() < mipmaps))
-                {
-                    newWidth >>= 1;
-                    newHeight >>= 1;
+            if (levels.empty() ||
+                x + regionWidth > static_cast<uint32_t>(levels[0].size.width) ||
+                y + regionHeight > static_cast<uint32_t>(levels[0].size.height))
+                throw DataError("Invalid texture region");
 
-                    if (newWidth < 1) newWidth = 1;
-                    if (newHeight < 1) newHeight = 1;
+            uint32_t pixelSize = getPixelSize(pixelFormat);
 
-                    Size2 mipMapSize = Size2(static_cast<float>(newWidth), static_cast<float>(newHeight));
-                    pitch = newWidth * pixelSize;
-                    bufferSize = pitch * newHeight;
-                    levels.push_back({mipMapSize, pitch, std::vector<uint8_t>(bufferSize)});
-                }
-            }
-        }
+            if (newData.size() != regionWidth * regionHeight * pixelSize)
+                throw DataError("Invalid texture region data size");
 
-        static void imageA8Downsample2x2(uint32_t width, uint32_t height, uint32_t pitch, const uint8_t* src, uint8_t* dst)
-        {
-            const uint32_t dstWidth = width >> 1;
-            const uint32_t dstHeight = height >> 1;
+            Texture::Level& firstLevel = levels[0];
 
-            if (dstWidth > 0 && dstHeight > 0)
-            {
-                uint32_t y;
-                uint32_t ystep;
+            for (uint32_t row = 0; row < regionHeight; ++row)
+                std::copy(newData.begin() + row * regionWidth * pixelSize,
+                          newData.begin() + (row + 1) * regionWidth * pixelSize,
+                          firstLevel.data.begin() + (y + row) * firstLevel.pitch + x * pixelSize);
 
-                for (y = 0, ystep = pitch * 2; y < dstHeight; ++y, src += ystep)
-                {
-                    const uint8_t* pixel = src;
-                    for (uint32_t x = 0; x < dstWidth; ++x, pixel += 2, dst += 1)
-                    {
-                        float a = 0.0F;
-                        a += pixel[0];
-                        a += pixel[1];
-                        a += pixel[pitch + 0];
-                        a += pixel[pitch + 1];
-                        a /= 4.0F;
-                        dst[0] = static_cast<uint8_t>(a);
-                    }
-                }
-            }
-            else if (dstHeight > 0)
+            // only the pixels of the other levels that depend on the region are generated again
+            for (size_t level = 1; level < levels.size(); ++level)
             {
-                uint32_t y;
-                uint32_t ystep;
+                const Texture::Level& previousLevel = levels[level - 1];
+                uint32_t previousWidth = static_cast<uint32_t>(previousLevel.size.width);
+                uint32_t previousHeight = static_cast<uint32_t>(previousLevel.size.height);
 
-                for (y = 0, ystep = pitch * 2; y < dstHeight; ++y, src += ystep, dst += 1)
-                {
-                    const uint8_t* pixel = src;
+                uint32_t levelX = x;
+                uint32_t levelY = y;
+                uint32_t levelWidth = regionWidth;
+                uint32_t levelHeight = regionHeight;
+                getLevelRegion(level, levelX, levelY, levelWidth, levelHeight);
 
-                    float a = 0.0F;
-                    a += pixel[0];
-                    a += pixel[pitch + 0];
-                    a /= 2.0F;
-                    dst[0] = static_cast<uint8_t>(a);
-                }
-            }
-            else if (dstWidth > 0)
-            {
-                const uint8_t* pixel = src;
-                for (uint32_t x = 0; x < dstWidth; ++x, pixel += 2, dst += 1)
+                if (previousWidth > 1 && previousHeight > 1)
                 {
-                    float a = 0.0F;
-                    a += pixel[0];
-                    a += pixel[1];
-                    a /= 2.0F;
-                    dst[0] = static_cast<uint8_t>(a);
+                    for (uint32_t row = levelY; row < levelY + levelHeight; ++row)
+                        imageDownsample2x2(pixelFormat, levelWidth * 2, 2, previousLevel.pitch,
+                                           previousLevel.data.data() + row * 2 * previousLevel.pitch + levelX * 2 * pixelSize,
+                                           levels[level].data.data() + row * levels[level].pitch + levelX * pixelSize);
                 }
+                else
+                    imageDownsample2x2(pixelFormat, previousWidth, previousHeight, previousLevel.pitch,
+                                       previousLevel.data.data(), levels[level].data.data());
             }
         }
 
-        static void imageR8Downsample2x2(uint32_t width, uint32_t height, uint32_t pitch, const uint8_t* src, uint8_t* dst)
+        void TextureResource::setLevelData(uint32_t level, const std::vector<uint8_t>& newData)
         {
-            const uint32_t dstWidth = width >> 1;
-            const uint32_t dstHeight = height >> 1;
-
-            if (dstWidth > 0 && dstHeight > 0)
-            {
-                uint32_t y;
-                uint32_t ystep;
-
-                for (y = 0, ystep = pitch * 2; y < dstHeight; ++y, src += ystep)
-                {
-                    const uint8_t* pixel = src;
-                    for (uint32_t x = 0; x < dstWidth; ++x, pixel += 2, dst += 1)
-                    {
-                        float r = 0.0F;
-                        r += GAMMA_DECODE[pixel[0]];
-                        r += GAMMA_DECODE[pixel[1]];
-                        r += GAMMA_DECODE[pixel[pitch + 0]];
-                        r += GAMMA_DECODE[pixel[pitch + 1]];
-                        r /= 4.0F;
-                        dst[0] = GAMMA_ENCODE[static_cast<uint8_t>(roundf(r))];
-                    }
-                }
-            }
-            else if (dstHeight > 0)
-            {
-                uint32_t y;
-                uint32_t ystep;
+            if (level >= levels.size())
+                throw DataError("Invalid texture level");
 
-                for (y = 0, ystep = pitch * 2; y < dstHeight; ++y, src += ystep, dst += 1)
-                {
-                    const uint8_t* pixel = src;
+            if (newData.size() != getLevelDataSize(pixelFormat,
+                                                   static_cast<uint32_t>(levels[level].size.width),
+                                                   static_cast<uint32_t>(levels[level].size.height)))
+                throw DataError("Invalid texture level data size");
 
-                    float r = 0.0F;
-                    r += GAMMA_DECODE[pixel[0]];
-                    r += GAMMA_DECODE[pixel[pitch + 0]];
-                    r /= 2.0F;
-                    dst[0] = GAMMA_ENCODE[static_cast<uint8_t>(roundf(r))];
-                }
-            }
-            else if (dstWidth > 0)
-            {
-                const uint8_t* pixel = src;
-                for (uint32_t x = 0; x < dstWidth; ++x, pixel += 2, dst += 1)
-                {
-                    float r = 0.0F;
-                    r += GAMMA_DECODE[pixel[0]];
-                    r += GAMMA_DECODE[pixel[1]];
-                    r /= 2.0F;
-                    dst[0] = GAMMA_ENCODE[static_cast<uint8_t>(roundf(r))];
-                }
-            }
+            levels[level].data = newData;
+            if (level < baseLevel) baseLevel = level;
         }
 
-        static void imageRG8Downsample2x2(uint32_t width, uint32_t height, uint32_t pitch, const uint8_t* src, uint8_t* dst)
+        void TextureResource::calculateSizes(const Size2& newSize)
         {
-            const uint32_t dstWidth = width >> 1;
-            const uint32_t dstHeight = height >> 1;
-
-            if (dstWidth > 0 && dstHeight > 0)
-            {
-                uint32_t y;
-                uint32_t ystep;
-
-                for (y = 0, ystep = pitch * 2; y < dstHeight; ++y, src += ystep)
-                {
-                    const uint8_t* pixel = src;
-                    for (uint32_t x = 0; x < dstWidth; ++x, pixel += 4, dst += 2)
-                    {
-                        float r = 0.0F;
-                        float g = 0.0F;
-
-                        r += GAMMA_DECODE[pixel[0]];
-                        g += GAMMA_DECODE[pixel[1]];
-
-                        r += GAMMA_DECODE[pixel[2]];
-                        g += GAMMA_DECODE[pixel[3]];
-
-                        r += GAMMA_DECODE[pixel[pitch + 0]];
-                        g += GAMMA_DECODE[pixel[pitch + 1]];
-
-                        r += GAMMA_DECODE[pixel[pitch + 2]];
-                        g += GAMMA_DECODE[pixel[pitch + 3]];
-
-                        r /= 4.0F;
-                        g /= 4.0F;
-
-                        r = GAMMA_ENCODE[static_cast<uint8_t>(roundf(r))];
-                        g = GAMMA_ENCODE[static_cast<uint8_t>(roundf(g))];
-                        dst[0] = static_cast<uint8_t>(r);
-                        dst[1] = static_cast<uint8_t>(g);
-                    }
-                }
-            }
-            else if (dstHeight > 0)
-            {
-                uint32_t y;
-                uint32_t ystep;
-                for (y = 0, ystep = pitch * 2; y < dstHeight; ++y, src += ystep, dst += 2)
-                {
-                    const uint8_t* pixel = src;
-                    float r = 0.0F;
-                    float g = 0.0F;
-
-                    r += GAMMA_DECODE[pixel[0]];
-                    g += GAMMA_DECODE[pixel[1]];
+            levels.clear();
+            size = newSize;
+            baseLevel = 0;
 
-                    r += GAMMA_DECODE[pixel[pitch + 0]];
-                    g += GAMMA_DECODE[pixel[pitch + 1]];
+            uint32_t newWidth = static_cast<uint32_t>(newSize.width);
+            uint32_t newHeight = static_cast<uint32_t>(newSize.height);
 
-                    r /= 2.0F;
-                    g /= 2.0F;
+            uint32_t pitch = getPitch(pixelFormat, newWidth);
+            uint32_t bufferSize = getLevelDataSize(pixelFormat, newWidth, newHeight);
+            levels.push_back({newSize, pitch, std::vector<uint8_t>(bufferSize)});
 
-                    dst[0] = GAMMA_ENCODE[static_cast<uint8_t>(roundf(r))];
-                    dst[1] = GAMMA_ENCODE[static_cast<uint8_t>(roundf(g))];
-                }
-            }
-            else if (dstWidth > 0)
+            if (!(flags & Texture::RENDER_TARGET) && // don't generate mipmaps for render targets
+                (renderDevice.isNPOTTexturesSupported() || (isPOT(newWidth) && isPOT(newHeight))))
             {
-                const uint8_t* pixel = src;
-                for (uint32_t x = 0; x < dstWidth; ++x, pixel += 4, dst += 2)
+                while ((newWidth > 1 || newHeight > 1) &&
+                       (mipmaps == 0 || levels.size() < mipmaps))
                 {
-                    float r = 0.0F;
-                    float g = 0.0F;
-
-                    r += GAMMA_DECODE[pixel[0]];
-                    g += GAMMA_DECODE[pixel[1]];
-
-                    r += GAMMA_DECODE[pixel[2]];
-                    g += GAMMA_DECODE[pixel[3]];
+                    newWidth >>= 1;
+                    newHeight >>= 1;
 
-                    r /= 2.0F;
-                    g /= 2.0F;
+                    if (newWidth < 1) newWidth = 1;
+                    if (newHeight < 1) newHeight = 1;
 
-                    dst[0] = GAMMA_ENCODE[static_cast<uint8_t>(roundf(r))];
-                    dst[1] = GAMMA_ENCODE[static_cast<uint8_t>(roundf(g))];
+                    Size2 mipMapSize = Size2(static_cast<float>(newWidth), static_cast<float>(newHeight));
+                    pitch = getPitch(pixelFormat, newWidth);
+                    bufferSize = getLevelDataSize(pixelFormat, newWidth, newHeight);
+                    levels.push_back({mipMapSize, pitch, std::vector<uint8_t>(bufferSize)});
                 }
             }
         }
 
-        static void imageRGBA8Downsample2x2(uint32_t width, uint32_t height, uint32_t pitch, const uint8_t* src, uint8_t* dst)
+        void TextureResource::calculateData(const std::vector<uint8_t>& newData)
         {
-            const uint32_t dstWidth = width >> 1;
-            const uint32_t dstHeight = height >> 1;
-
-            if (dstWidth > 0 && dstHeight > 0)
-            {
-                uint32_t y;
-                uint32_t ystep;
-                for (y = 0, ystep = pitch * 2; y < dstHeight; ++y, src += ystep)
-                {
-                    const uint8_t* pixel = src;
-                    for (uint32_t x = 0; x < dstWidth; ++x, pixel += 8, dst += 4)
-                    {
-                        float pixels = 0.0F;
-                        float r = 0.0F;
-                        float g = 0.0F;
-                        float b = 0.0F;
-                        float a = 0.0F;
-
-                        if (pixel[3] > 0)
-                        {
-                            r += GAMMA_DECODE[pixel[0]];
-                            g += GAMMA_DECODE[pixel[1]];
-                            b += GAMMA_DECODE[pixel[2]];
-                            pixels += 1.0F;
-                        }
-                        a += pixel[3];
-
-                        if (pixel[7] > 0)
-                        {
-                            r += GAMMA_DECODE[pixel[4]];
-                            g += GAMMA_DECODE[pixel[5]];
-                            b += GAMMA_DECODE[pixel[6]];
-                            pixels += 1.0F;
-                        }
-                        a += pixel[7];
-
-                        if (pixel[pitch + 3] > 0)
-                        {
-                            r += GAMMA_DECODE[pixel[pitch + 0]];
-                            g += GAMMA_DECODE[pixel[pitch + 1]];
-                            b += GAMMA_DECODE[pixel[pitch + 2]];
-                            pixels += 1.0F;
-                        }
-                        a += pixel[pitch + 3];
-
-                        if (pixel[pitch + 7] > 0)
-                        {
-                            r += GAMMA_DECODE[pixel[pitch + 4]];
-                            g += GAMMA_DECODE[pixel[pitch + 5]];
-                            b += GAMMA_DECODE[pixel[pitch + 6]];
-                            pixels += 1.0F;
-                        }
-                        a += pixel[pitch + 7];
-
-                        if (pixels > 0.0F)
-                        {
-                            r /= pixels;
-                            g /= pixels;
-                            b /= pixels;
-                            a *= 0.25F;
-                            dst[0] = GAMMA_ENCODE[static_cast<uint8_t>(roundf(r))];
-                            dst[1] = GAMMA_ENCODE[static_cast<uint8_t>(roundf(g))];
-                            dst[2] = GAMMA_ENCODE[static_cast<uint8_t>(roundf(b))];
-                            dst[3] = static_cast<uint8_t>(a);
-                        }
-                        else
-                        {
-                            dst[0] = 0;
-                            dst[1] = 0;
-                            dst[2] = 0;
-                            dst[3] = 0;
-                        }
-                    }
-                }
-            }
-            else if (dstHeight > 0)
-            {
-                uint32_t y;
-                uint32_t ystep;
-
-                for (y = 0, ystep = pitch * 2; y < dstHeight; ++y, src += ystep, dst += 4)
-                {
-                    const uint8_t* pixel = src;
-
-                    float pixels = 0.0F;
-                    float r = 0.0F;
-                    float g = 0.0F;
-                    float b = 0.0F;
-                    float a = 0.0F;
-
-                    if (pixel[3] > 0)
-                    {
-                        r += GAMMA_DECODE[pixel[0]];
-                        g += GAMMA_DECODE[pixel[1]];
-                        b += GAMMA_DECODE[pixel[2]];
-                        pixels += 1.0F;
-                    }
-                    a = pixel[3];
-
-                    if (pixel[pitch + 3] > 0)
-                    {
-                        r += GAMMA_DECODE[pixel[pitch + 0]];
-                        g += GAMMA_DECODE[pixel[pitch + 1]];
-                        b += GAMMA_DECODE[pixel[pitch + 2]];
-                        pixels += 1.0F;
-                    }
-                    a += pixel[pitch + 3];
-
-                    if (pixels > 0.0F)
-                    {
-                        r /= pixels;
-                        g /= pixels;
-                        b /= pixels;
-                        a *= 0.5F;
-                        dst[0] = GAMMA_ENCODE[static_cast<uint8_t>(roundf(r))];
-                        dst[1] = GAMMA_ENCODE[static_cast<uint8_t>(roundf(g))];
-                        dst[2] = GAMMA_ENCODE[static_cast<uint8_t>(roundf(b))];
-                        dst[3] = static_cast<uint8_t>(a);
-                    }
-                    else
-                    {
-                        dst[0] = 0;
-                        dst[1] = 0;
-                        dst[2] = 0;
-                        dst[3] = 0;
-                    }
-                }
-            }
-            else if (dstWidth > 0)
-            {
-                const uint8_t* pixel = src;
-                for (uint32_t x = 0; x < dstWidth; ++x, pixel += 8, dst += 4)
-                {
-                    float pixels = 0.0F;
-                    float r = 0.0F;
-                    float g = 0.0F;
-                    float b = 0.0F;
-                    float a = 0.0F;
-
-                    if (pixel[3] > 0)
-                    {
-                        r += GAMMA_DECODE[pixel[0]];
-                        g += GAMMA_DECODE[pixel[1]];
-                        b += GAMMA_DECODE[pixel[2]];
-                        pixels += 1.0F;
-                    }
-                    a += pixel[3];
-
-                    if (pixel[7] > 0)
-                    {
-                        r += GAMMA_DECODE[pixel[4]];
-                        g += GAMMA_DECODE[pixel[5]];
-                        b += GAMMA_DECODE[pixel[6]];
-                        pixels += 1.0F;
-                    }
-                    a += pixel[7];
+            levels[0].data = newData;
 
-                    if (pixels > 0.0F)
-                    {
-                        r /= pixels;
-                        g /= pixels;
-                        b /= pixels;
-                        a *= 0.5F;
-                        dst[0] = GAMMA_ENCODE[static_cast<uint8_t>(roundf(r))];
-                        dst[1] = GAMMA_ENCODE[static_cast<uint8_t>(roundf(g))];
-                        dst[2] = GAMMA_ENCODE[static_cast<uint8_t>(roundf(b))];
-                        dst[3] = static_cast<uint8_t>(a);
-                    }
-                    else
-                    {
-                        dst[0] = 0;
-                        dst[1] = 0;
-                        dst[2] = 0;
-                        dst[3] = 0;
-                    }
-                }
-            }
+            generateLevels(levels, pixelFormat);
         }
 
-        void TextureResource::calculateData(const std::vector<uint8_t>& newData)
+        void TextureResource::generateLevels(std::vector<Texture::Level>& levels, PixelFormat pixelFormat)
         {
-            levels[0].data = newData;
+            for (size_t level = 1; level < levels.size(); ++level)
+                imageDownsample2x2(pixelFormat,
+                                   static_cast<uint32_t>(levels[level - 1].size.width),
+                                   static_cast<uint32_t>(levels[level - 1].size.height),
+                                   levels[level - 1].pitch,
+                                   levels[level - 1].data.data(), levels[level].data.data());
+        }
 
-            for (uint32_t level = 1; level < static_cast<uint32_t>(levels.size()); ++level)
+        void TextureResource::getLevelRegion(size_t level,
+                                             uint32_t& x, uint32_t& y,
+                                             uint32_t& regionWidth, uint32_t& regionHeight) const
+        {
+            for (size_t current = 1; current <= level; ++current)
             {
-                uint32_t previousWidth = static_cast<uint32_t>(levels[level - 1].size.width);
-                uint32_t previousHeight = static_cast<uint32_t>(levels[level - 1].size.height);
-                uint32_t previousPitch = static_cast<uint32_t>(levels[level - 1].pitch);
+                uint32_t previousWidth = static_cast<uint32_t>(levels[current - 1].size.width);
+                uint32_t previousHeight = static_cast<uint32_t>(levels[current - 1].size.height);
+                uint32_t width = static_cast<uint32_t>(levels[current].size.width);
+                uint32_t height = static_cast<uint32_t>(levels[current].size.height);
 
-                switch (pixelFormat)
+                if (previousWidth > 1 && previousHeight > 1)
+                {
+                    // every pixel is the average of a 2x2 block of the previous level
+                    uint32_t endX = std::min((x + regionWidth + 1) / 2, width);
+                    uint32_t endY = std::min((y + regionHeight + 1) / 2, height);
+                    x /= 2;
+                    y /= 2;
+                    regionWidth = endX - x;
+                    regionHeight = endY - y;
+                }
+                else
                 {
-                    case PixelFormat::RGBA8_UNORM:
-                        imageRGBA8Downsample2x2(previousWidth, previousHeight, previousPitch,
-                                                levels[level - 1].data.data(), levels[level].data.data());
-                        break;
-
-                    case PixelFormat::RG8_UNORM:
-                        imageRG8Downsample2x2(previousWidth, previousHeight, previousPitch,
-                                              levels[level - 1].data.data(), levels[level].data.data());
-                        break;
-
-                    case PixelFormat::R8_UNORM:
-                        imageR8Downsample2x2(previousWidth, previousHeight, previousPitch,
-                                             levels[level - 1].data.data(), levels[level].data.data());
-                        break;
-
-                    case PixelFormat::A8_UNORM:
-                        imageA8Downsample2x2(previousWidth, previousHeight, previousPitch,
-                                             levels[level - 1].data.data(), levels[level].data.data());
-                        break;
-
-                    default:
-                        throw DataError("Invalid pixel format");
+                    // the levels of a single row or column are generated whole
+                    x = 0;
+                    y = 0;
+                    regionWidth = width;
+                    regionHeight = height;
                 }
             }
         }
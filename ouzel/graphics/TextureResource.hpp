@@ -40,6 +40,14 @@ namespace ouzel
             inline const Size2& getSize() const { return size; }
 
             virtual void setData(const std::vector<uint8_t>& newData, const Size2& newSize);
+            virtual void setRegionData(const std::vector<uint8_t>& newData,
+                                       uint32_t x, uint32_t y,
+                                       uint32_t regionWidth, uint32_t regionHeight);
+            // called by the texture streamer on the render thread once the data of the level is generated
+            virtual void setLevelData(uint32_t level, const std::vector<uint8_t>& newData);
+
+            // the most detailed level that has its data uploaded
+            inline uint32_t getBaseLevel() const { return baseLevel; }
 
             inline uint32_t getFlags() const { return flags; }
             inline uint32_t getMipmaps() const { return mipmaps; }
@@ -72,12 +80,20 @@ namespace ouzel
 
             inline PixelFormat getPixelFormat() const { return pixelFormat; }
 
+            // generates the data of all the levels from the data of the first level
+            static void generateLevels(std::vector<Texture::Level>& levels, PixelFormat pixelFormat);
+
         protected:
             TextureResource(RenderDevice& initRenderDevice);
 
             void calculateSizes(const Size2& newSize);
             void calculateData(const std::vector<uint8_t>& newData);
 
+            // converts the region of the first level to the region of the level that depends on it
+            void getLevelRegion(size_t level,
+                                uint32_t& x, uint32_t& y,
+                                uint32_t& regionWidth, uint32_t& regionHeight) const;
+
             RenderDevice& renderDevice;
             Size2 size;
             uint32_t flags = 0;
@@ -86,6 +102,7 @@ namespace ouzel
             bool clearDepthBuffer = false;
             float clearDepth = 1.0F;
             std::vector<Texture::Level> levels;
+            uint32_t baseLevel = 0;
             uint32_t sampleCount = 1;
             PixelFormat pixelFormat = PixelFormat::RGBA8_UNORM;
             Color clearColor;
@@ -0,0 +1,173 @@
+// Copyright 2015-2018 Elviss Strazdins. All rights reserved.
+
+#include <algorithm>
+#include "TextureStreamer.hpp"
+#include "TextureResource.hpp"
+#include "thread/Lock.hpp"
+#include "utils/Log.hpp"
+
+namespace ouzel
+{
+    namespace graphics
+    {
+        TextureStreamer::TextureStreamer():
+            pendingCount(0)
+        {
+        }
+
+        TextureStreamer::~TextureStreamer()
+        {
+#if OUZEL_MULTITHREADED
+            {
+                Lock lock(jobMutex);
+                running = false;
+            }
+
+            if (workerThread.isJoinable()) workerThread.join();
+#endif
+        }
+
+        void TextureStreamer::addTexture(TextureResource* resource,
+                                         const std::vector<Texture::Level>& newLevels,
+                                         PixelFormat pixelFormat)
+        {
+            Job job;
+            job.resource = resource;
+            job.levels = newLevels;
+            job.pixelFormat = pixelFormat;
+
+            ++pendingCount;
+
+#if OUZEL_MULTITHREADED
+            Lock lock(jobMutex);
+            jobs.push_back(std::move(job));
+
+            // the worker thread exits when it runs out of jobs and is started again by the next texture
+            if (!workerRunning)
+            {
+                if (workerThread.isJoinable()) workerThread.join();
+
+                workerRunning = true;
+                workerThread = Thread(std::bind(&TextureStreamer::main, this), "Streaming");
+            }
+#else
+            generate(job);
+#endif
+        }
+
+        void TextureStreamer::cancel(TextureResource* resource)
+        {
+            Lock lock(jobMutex);
+
+            auto jobIterator = std::remove_if(jobs.begin(), jobs.end(), [resource](const Job& job) {
+                return job.resource == resource;
+            });
+            pendingCount -= static_cast<uint32_t>(std::distance(jobIterator, jobs.end()));
+            jobs.erase(jobIterator, jobs.end());
+
+            if (currentResource == resource) currentCancelled = true;
+
+            Lock uploadLock(uploadMutex);
+
+            auto uploadIterator = std::remove_if(uploads.begin(), uploads.end(), [resource](const Upload& upload) {
+                return upload.resource == resource;
+            });
+
+            // the pending count is decreased only by the upload of the last level
+            if (std::any_of(uploadIterator, uploads.end(), [](const Upload& upload) { return upload.level == 0; }))
+                --pendingCount;
+
+            uploads.erase(uploadIterator, uploads.end());
+        }
+
+        uint64_t TextureStreamer::upload(uint64_t budget)
+        {
+            uint64_t uploadedSize = 0;
+
+            for (;;)
+            {
+                Upload upload;
+
+                {
+                    Lock lock(uploadMutex);
+
+                    if (uploads.empty()) break;
+
+                    if (uploadedSize > 0 && uploadedSize + uploads.front().data.size() > budget)
+                        break;
+
+                    upload = std::move(uploads.front());
+                    uploads.pop_front();
+                }
+
+                upload.resource->setLevelData(upload.level, upload.data);
+                uploadedSize += upload.data.size();
+
+                if (upload.level == 0) --pendingCount;
+            }
+
+            return uploadedSize;
+        }
+
+        void TextureStreamer::main()
+        {
+            Thread::setCurrentThreadName("Streaming");
+
+            for (;;)
+            {
+                Job job;
+
+                {
+                    Lock lock(jobMutex);
+
+                    if (!running || jobs.empty())
+                    {
+                        workerRunning = false;
+                        break;
+                    }
+
+                    job = std::move(jobs.front());
+                    jobs.pop_front();
+
+                    currentResource = job.resource;
+                    currentCancelled = false;
+                }
+
+                try
+                {
+                    generate(job);
+                }
+                catch (const std::exception& e)
+                {
+                    Log(Log::Level::ERR) << "Failed to generate texture levels, error: " << e.what();
+
+                    Lock lock(jobMutex);
+                    --pendingCount;
+                    currentResource = nullptr;
+                }
+            }
+        }
+
+        void TextureStreamer::generate(Job& job)
+        {
+            TextureResource::generateLevels(job.levels, job.pixelFormat);
+
+            Lock lock(jobMutex);
+
+            if (currentResource == job.resource && currentCancelled)
+            {
+                --pendingCount;
+                currentResource = nullptr;
+                return;
+            }
+
+            currentResource = nullptr;
+
+            Lock uploadLock(uploadMutex);
+
+            // the smallest levels are uploaded first
+            for (uint32_t level = static_cast<uint32_t>(job.levels.size()); level > 0; --level)
+                uploads.push_back({job.resource, level - 1, std::move(job.levels[level - 1].data)});
+        }
+    } // namespace graphics
+} // namespace ouzel
@@ -0,0 +1,84 @@
+// Copyright 2015-2018 Elviss Strazdins. All rights reserved.
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <vector>
+#include "core/Setup.h"
+#include "graphics/PixelFormat.hpp"
+#include "graphics/Texture.hpp"
+#include "thread/Mutex.hpp"
+#include "thread/Thread.hpp"
+
+namespace ouzel
+{
+    namespace graphics
+    {
+        class TextureResource;
+
+        // generates the mip levels of streaming textures on a worker thread and uploads them over several frames,
+        // smallest level first, so that the textures can be sampled before all of their levels are uploaded, the
+        // worker thread runs only while there are textures to generate
+        class TextureStreamer final
+        {
+        public:
+            TextureStreamer();
+            ~TextureStreamer();
+
+            TextureStreamer(const TextureStreamer&) = delete;
+            TextureStreamer& operator=(const TextureStreamer&) = delete;
+
+            TextureStreamer(TextureStreamer&&) = delete;
+            TextureStreamer& operator=(TextureStreamer&&) = delete;
+
+            // newLevels must contain the sizes of all the levels and the data of the first level
+            void addTexture(TextureResource* resource,
+                            const std::vector<Texture::Level>& newLevels,
+                            PixelFormat pixelFormat);
+            // drops the pending work of the resource (must be called on the render thread)
+            void cancel(TextureResource* resource);
+
+            // uploads the levels that are ready until the budget (in bytes) is used up, at least one level is uploaded
+            // on every call, returns the number of uploaded bytes (must be called on the render thread)
+            uint64_t upload(uint64_t budget);
+
+            inline uint32_t getPendingCount() const { return pendingCount; }
+
+        private:
+            struct Job
+            {
+                TextureResource* resource;
+                std::vector<Texture::Level> levels;
+                PixelFormat pixelFormat;
+            };
+
+            struct Upload
+            {
+                TextureResource* resource;
+                uint32_t level;
+                std::vector<uint8_t> data;
+            };
+
+            void main();
+            void generate(Job& job);
+
+            std::atomic<uint32_t> pendingCount;
+
+            Mutex jobMutex;
+            std::deque<Job> jobs;
+            TextureResource* currentResource = nullptr; // resource whose levels are being generated
+            bool currentCancelled = false;
+            bool running = true;
+            bool workerRunning = false;
+
+            Mutex uploadMutex;
+            std::deque<Upload> uploads;
+
+#if OUZEL_MULTITHREADED
+            Thread workerThread;
+#endif
+        };
+    } // namespace graphics
+} // namespace ouzel
@@ -32,7 +32,9 @@ namespace ouzel
                     POINT_SIZE,
                     TANGENT,
                     TEXTURE_COORDINATES0,
-                    TEXTURE_COORDINATES1
+                    TEXTURE_COORDINATES1,
+                    INSTANCE_TRANSFORM, // per-instance attribute, four float vectors (matrix columns)
+                    INSTANCE_COLOR // per-instance attribute
                 };
 
                 Attribute(Usage initUsage, DataType initDataType):
@@ -55,5 +57,12 @@ namespace ouzel
             Vector2 texCoords[2];
             Vector3 normal;
         };
+
+        // per-instance data of instanced draw calls
+        struct Instance
+        {
+            float transform[16]; // column-major model matrix
+            float color[4];
+        };
     } // namespace graphics
 } // namespace ouzel
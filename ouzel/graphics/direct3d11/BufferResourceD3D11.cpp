@@ -4,6 +4,7 @@
 
 #if OUZEL_COMPILE_DIRECT3D11
 
+#include <algorithm>
 #include "BufferResourceD3D11.hpp"
 #include "RenderDeviceD3D11.hpp"
 #include "utils/Errors.hpp"
@@ -58,6 +59,45 @@ namespace ouzel
             }
         }
 
+        void BufferResourceD3D11::setData(const std::vector<uint8_t>& newData, uint32_t dataOffset)
+        {
+            BufferResource::setData(newData, dataOffset);
+
+            // dynamic buffers can only be mapped with discard, so the whole shadow copy is written
+            setData(data);
+        }
+
+        void BufferResourceD3D11::upload(const uint8_t* newData, uint32_t newSize)
+        {
+            // contents of streaming buffers are not kept on the CPU
+            data.clear();
+
+            bool append = allocateRing(newSize);
+
+            if (!buffer || bufferSize < ringSize)
+            {
+                createBuffer(ringSize);
+                append = false;
+            }
+
+            D3D11_MAPPED_SUBRESOURCE mappedSubresource;
+            mappedSubresource.pData = nullptr;
+            mappedSubresource.RowPitch = 0;
+            mappedSubresource.DepthPitch = 0;
+
+            // appending to the ring doesn't have to wait for the draw calls that read the previous contents
+            RenderDeviceD3D11& renderDeviceD3D11 = static_cast<RenderDeviceD3D11&>(renderDevice);
+            HRESULT hr = renderDeviceD3D11.getContext()->Map(buffer, 0,
+                                                             append ? D3D11_MAP_WRITE_NO_OVERWRITE : D3D11_MAP_WRITE_DISCARD,
+                                                             0, &mappedSubresource);
+            if (FAILED(hr))
+                throw DataError("Failed to lock Direct3D 11 buffer, error: " + std::to_string(hr));
+
+            std::copy(newData, newData + newSize, static_cast<uint8_t*>(mappedSubresource.pData) + offset);
+
+            renderDeviceD3D11.getContext()->Unmap(buffer, 0);
+        }
+
         void BufferResourceD3D11::createBuffer(UINT newSize)
         {
             if (buffer)
@@ -26,6 +26,8 @@ namespace ouzel
                               uint32_t newSize) override;
 
             virtual void setData(const std::vector<uint8_t>& newData) override;
+            virtual void setData(const std::vector<uint8_t>& newData, uint32_t dataOffset) override;
+            virtual void upload(const uint8_t* newData, uint32_t newSize) override;
 
             ID3D11Buffer* getBuffer() const { return buffer; }
 
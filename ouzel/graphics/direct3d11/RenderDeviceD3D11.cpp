@@ -122,7 +122,26 @@ namespace ouzel
                 throw SystemError("Failed to create the Direct3D 11 device, error: " + std::to_string(hr));
 
             if (device->GetFeatureLevel() < D3D_FEATURE_LEVEL_10_0)
+            {
                 npotTexturesSupported = false;
+                rgtcSupported = false;
+            }
+
+            if (device->GetFeatureLevel() < D3D_FEATURE_LEVEL_11_0)
+                bptcSupported = false;
+
+            if (device->GetFeatureLevel() >= D3D_FEATURE_LEVEL_11_0)
+                maxTextureSize = D3D11_REQ_TEXTURE2D_U_OR_V_DIMENSION;
+            else if (device->GetFeatureLevel() >= D3D_FEATURE_LEVEL_10_0)
+                maxTextureSize = 8192; // D3D10_REQ_TEXTURE2D_U_OR_V_DIMENSION
+            else if (device->GetFeatureLevel() >= D3D_FEATURE_LEVEL_9_3)
+                maxTextureSize = D3D_FL9_3_REQ_TEXTURE2D_U_OR_V_DIMENSION;
+            else
+                maxTextureSize = D3D_FL9_1_REQ_TEXTURE2D_U_OR_V_DIMENSION;
+
+            // Direct3D 11 hardware does not support ETC2 and ASTC
+            etc2Supported = false;
+            astcSupported = false;
 
             IDXGIDevice* dxgiDevice;
             IDXGIFactory* factory;
@@ -329,8 +348,6 @@ namespace ouzel
 
         void RenderDeviceD3D11::processCommands(CommandBuffer& commands)
         {
-            std::vector<float> shaderData;
-
             uint32_t fillModeIndex = 0;
             uint32_t scissorEnableIndex = 0;
             uint32_t cullModeIndex = 0;
@@ -562,7 +579,7 @@ namespace ouzel
 
                         ID3D11Buffer* buffers[] = {vertexBufferD3D11->getBuffer()};
                         UINT strides[] = {sizeof(Vertex)};
-                        UINT offsets[] = {0};
+                        UINT offsets[] = {vertexBufferD3D11->getOffset()};
                         context->IASetVertexBuffers(0, 1, buffers, strides, offsets);
 
                         DXGI_FORMAT indexFormat;
@@ -576,7 +593,7 @@ namespace ouzel
                                 throw SystemError("Invalid index size");
                         }
 
-                        context->IASetIndexBuffer(indexBufferD3D11->getBuffer(), indexFormat, 0);
+                        context->IASetIndexBuffer(indexBufferD3D11->getBuffer(), indexFormat, indexBufferD3D11->getOffset());
 
                         D3D_PRIMITIVE_TOPOLOGY topology;
 
@@ -596,7 +613,67 @@ namespace ouzel
                         assert(indexBufferD3D11->getSize());
                         assert(vertexBufferD3D11->getSize());
 
-                        context->DrawIndexed(drawCommand->indexCount, drawCommand->startIndex, 0);
+                        context->DrawIndexed(drawCommand->indexCount, drawCommand->startIndex, static_cast<INT>(drawCommand->baseVertex));
+
+                        break;
+                    }
+
+                    case Command::Type::DRAW_INSTANCED:
+                    {
+                        const DrawInstancedCommand* drawInstancedCommand = static_cast<const DrawInstancedCommand*>(command);
+
+                        // draw mesh buffer
+                        BufferResourceD3D11* indexBufferD3D11 = static_cast<BufferResourceD3D11*>(drawInstancedCommand->indexBuffer);
+                        BufferResourceD3D11* vertexBufferD3D11 = static_cast<BufferResourceD3D11*>(drawInstancedCommand->vertexBuffer);
+                        BufferResourceD3D11* instanceBufferD3D11 = static_cast<BufferResourceD3D11*>(drawInstancedCommand->instanceBuffer);
+
+                        assert(indexBufferD3D11);
+                        assert(indexBufferD3D11->getBuffer());
+                        assert(vertexBufferD3D11);
+                        assert(vertexBufferD3D11->getBuffer());
+                        assert(instanceBufferD3D11);
+                        assert(instanceBufferD3D11->getBuffer());
+
+                        ID3D11Buffer* buffers[] = {vertexBufferD3D11->getBuffer(), instanceBufferD3D11->getBuffer()};
+                        UINT strides[] = {sizeof(Vertex), sizeof(Instance)};
+                        UINT offsets[] = {vertexBufferD3D11->getOffset(), instanceBufferD3D11->getOffset()};
+                        context->IASetVertexBuffers(0, 2, buffers, strides, offsets);
+
+                        DXGI_FORMAT indexFormat;
+
+                        switch (drawInstancedCommand->indexSize)
+                        {
+                            case 2: indexFormat = DXGI_FORMAT_R16_UINT; break;
+                            case 4: indexFormat = DXGI_FORMAT_R32_UINT; break;
+                            default:
+                                indexFormat = DXGI_FORMAT_UNKNOWN;
+                                throw SystemError("Invalid index size");
+                        }
+
+                        context->IASetIndexBuffer(indexBufferD3D11->getBuffer(), indexFormat, indexBufferD3D11->getOffset());
+
+                        D3D_PRIMITIVE_TOPOLOGY topology;
+
+                        switch (drawInstancedCommand->drawMode)
+                        {
+                            case Renderer::DrawMode::POINT_LIST: topology = D3D_PRIMITIVE_TOPOLOGY_POINTLIST; break;
+                            case Renderer::DrawMode::LINE_LIST: topology = D3D_PRIMITIVE_TOPOLOGY_LINELIST; break;
+                            case Renderer::DrawMode::LINE_STRIP: topology = D3D_PRIMITIVE_TOPOLOGY_LINESTRIP; break;
+                            case Renderer::DrawMode::TRIANGLE_LIST: topology = D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST; break;
+                            case Renderer::DrawMode::TRIANGLE_STRIP: topology = D3D_PRIMITIVE_TOPOLOGY_TRIANGLESTRIP; break;
+                            default: throw SystemError("Invalid draw mode");
+                        }
+
+                        context->IASetPrimitiveTopology(topology);
+
+                        assert(drawInstancedCommand->indexCount);
+                        assert(indexBufferD3D11->getSize());
+                        assert(vertexBufferD3D11->getSize());
+                        assert(instanceBufferD3D11->getSize() >= drawInstancedCommand->instanceCount * sizeof(Instance));
+
+                        context->DrawIndexedInstanced(drawInstancedCommand->indexCount,
+                                                      drawInstancedCommand->instanceCount,
+                                                      drawInstancedCommand->startIndex, 0, 0);
 
                         break;
                     }
@@ -649,6 +726,24 @@ namespace ouzel
                         break;
                     }
 
+                    case Command::Type::SET_BUFFER_DATA_RANGE:
+                    {
+                        const SetBufferDataRangeCommand* setBufferDataRangeCommand = static_cast<const SetBufferDataRangeCommand*>(command);
+
+                        setBufferDataRangeCommand->buffer->setData(setBufferDataRangeCommand->data,
+                                                                   setBufferDataRangeCommand->offset);
+                        break;
+                    }
+
+                    case Command::Type::UPLOAD_BUFFER_DATA:
+                    {
+                        const UploadBufferDataCommand* uploadBufferDataCommand = static_cast<const UploadBufferDataCommand*>(command);
+
+                        uploadBufferDataCommand->buffer->upload(commands.getUploadData(uploadBufferDataCommand->dataOffset),
+                                                                uploadBufferDataCommand->size);
+                        break;
+                    }
+
                     case Command::Type::INIT_SHADER:
                     {
                         const InitShaderCommand* initShaderCommand = static_cast<const InitShaderCommand*>(command);
@@ -676,25 +771,22 @@ namespace ouzel
                         // pixel shader constants
                         const std::vector<ShaderResourceD3D11::Location>& fragmentShaderConstantLocations = currentShader->getFragmentShaderConstantLocations();
 
-                        if (setShaderConstantsCommand->fragmentShaderConstants.size() > fragmentShaderConstantLocations.size())
-                            throw SystemError("Invalid pixel shader constant size");
-
-                        shaderData.clear();
+                        const float* fragmentShaderData = commands.getData(setShaderConstantsCommand->fragmentShaderConstantOffset);
+                        uint32_t fragmentShaderDataSize = static_cast<uint32_t>(sizeof(float) * setShaderConstantsCommand->fragmentShaderConstantSize);
+                        uint32_t fragmentShaderConstantsSize = 0;
 
-                        for (size_t i = 0; i < setShaderConstantsCommand->fragmentShaderConstants.size(); ++i)
+                        for (const ShaderResourceD3D11::Location& fragmentShaderConstantLocation : fragmentShaderConstantLocations)
                         {
-                            const ShaderResourceD3D11::Location& fragmentShaderConstantLocation = fragmentShaderConstantLocations[i];
-                            const std::vector<float>& fragmentShaderConstant = setShaderConstantsCommand->fragmentShaderConstants[i];
-
-                            if (sizeof(float) * fragmentShaderConstant.size() != fragmentShaderConstantLocation.size)
-                                throw SystemError("Invalid pixel shader constant size");
-
-                            shaderData.insert(shaderData.end(), fragmentShaderConstant.begin(), fragmentShaderConstant.end());
+                            if (fragmentShaderConstantsSize >= fragmentShaderDataSize) break;
+                            fragmentShaderConstantsSize += fragmentShaderConstantLocation.size;
                         }
 
+                        if (fragmentShaderConstantsSize != fragmentShaderDataSize)
+                            throw SystemError("Invalid pixel shader constant size");
+
                         uploadBuffer(currentShader->getFragmentShaderConstantBuffer(),
-                                     shaderData.data(),
-                                     static_cast<uint32_t>(sizeof(float) * shaderData.size()));
+                                     fragmentShaderData,
+                                     fragmentShaderDataSize);
 
                         ID3D11Buffer* fragmentShaderConstantBuffers[1] = {currentShader->getFragmentShaderConstantBuffer()};
                         context->PSSetConstantBuffers(0, 1, fragmentShaderConstantBuffers);
@@ -702,25 +794,22 @@ namespace ouzel
                         // vertex shader constants
                         const std::vector<ShaderResourceD3D11::Location>& vertexShaderConstantLocations = currentShader->getVertexShaderConstantLocations();
 
-                        if (setShaderConstantsCommand->vertexShaderConstants.size() > vertexShaderConstantLocations.size())
-                            throw SystemError("Invalid vertex shader constant size");
-
-                        shaderData.clear();
+                        const float* vertexShaderData = commands.getData(setShaderConstantsCommand->vertexShaderConstantOffset);
+                        uint32_t vertexShaderDataSize = static_cast<uint32_t>(sizeof(float) * setShaderConstantsCommand->vertexShaderConstantSize);
+                        uint32_t vertexShaderConstantsSize = 0;
 
-                        for (size_t i = 0; i < setShaderConstantsCommand->vertexShaderConstants.size(); ++i)
+                        for (const ShaderResourceD3D11::Location& vertexShaderConstantLocation : vertexShaderConstantLocations)
                         {
-                            const ShaderResourceD3D11::Location& vertexShaderConstantLocation = vertexShaderConstantLocations[i];
-                            const std::vector<float>& vertexShaderConstant = setShaderConstantsCommand->vertexShaderConstants[i];
-
-                            if (sizeof(float) * vertexShaderConstant.size() != vertexShaderConstantLocation.size)
-                                throw SystemError("Invalid pixel shader constant size");
-
-                            shaderData.insert(shaderData.end(), vertexShaderConstant.begin(), vertexShaderConstant.end());
+                            if (vertexShaderConstantsSize >= vertexShaderDataSize) break;
+                            vertexShaderConstantsSize += vertexShaderConstantLocation.size;
                         }
 
+                        if (vertexShaderConstantsSize != vertexShaderDataSize)
+                            throw SystemError("Invalid vertex shader constant size");
+
                         uploadBuffer(currentShader->getVertexShaderConstantBuffer(),
-                                     shaderData.data(),
-                                     static_cast<uint32_t>(sizeof(float) * shaderData.size()));
+                                     vertexShaderData,
+                                     vertexShaderDataSize);
 
                         ID3D11Buffer* vertexShaderConstantBuffers[1] = {currentShader->getVertexShaderConstantBuffer()};
                         context->VSSetConstantBuffers(0, 1, vertexShaderConstantBuffers);
@@ -4,6 +4,7 @@
 
 #if OUZEL_COMPILE_DIRECT3D11
 
+#include <cstddef>
 #include "ShaderResourceD3D11.hpp"
 #include "RenderDeviceD3D11.hpp"
 #include "utils/Errors.hpp"
@@ -203,6 +204,30 @@ namespace ouzel
                 offset += getDataTypeSize(vertexAttribute.dataType);
             }
 
+            // per-instance attributes are read from the second vertex buffer slot
+            if (vertexAttributes.find(Vertex::Attribute::Usage::INSTANCE_TRANSFORM) != vertexAttributes.end())
+            {
+                for (UINT column = 0; column < 4; ++column)
+                {
+                    vertexInputElements.push_back({
+                        "INSTANCE_TRANSFORM", column,
+                        DXGI_FORMAT_R32G32B32A32_FLOAT,
+                        1, static_cast<UINT>(offsetof(Instance, transform) + column * 4 * sizeof(float)),
+                        D3D11_INPUT_PER_INSTANCE_DATA, 1
+                    });
+                }
+            }
+
+            if (vertexAttributes.find(Vertex::Attribute::Usage::INSTANCE_COLOR) != vertexAttributes.end())
+            {
+                vertexInputElements.push_back({
+                    "INSTANCE_COLOR", 0,
+                    DXGI_FORMAT_R32G32B32A32_FLOAT,
+                    1, static_cast<UINT>(offsetof(Instance, color)),
+                    D3D11_INPUT_PER_INSTANCE_DATA, 1
+                });
+            }
+
             if (inputLayout) inputLayout->Release();
 
             hr = renderDeviceD3D11.getDevice()->CreateInputLayout(vertexInputElements.data(),
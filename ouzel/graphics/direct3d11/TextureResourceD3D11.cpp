@@ -45,6 +45,12 @@ namespace ouzel
                 case PixelFormat::RGBA32_UINT: return DXGI_FORMAT_R32G32B32A32_UINT;
                 case PixelFormat::RGBA32_SINT: return DXGI_FORMAT_R32G32B32A32_SINT;
                 case PixelFormat::RGBA32_FLOAT: return DXGI_FORMAT_R32G32B32A32_FLOAT;
+                case PixelFormat::BC1_UNORM: return DXGI_FORMAT_BC1_UNORM;
+                case PixelFormat::BC2_UNORM: return DXGI_FORMAT_BC2_UNORM;
+                case PixelFormat::BC3_UNORM: return DXGI_FORMAT_BC3_UNORM;
+                case PixelFormat::BC4_UNORM: return DXGI_FORMAT_BC4_UNORM;
+                case PixelFormat::BC5_UNORM: return DXGI_FORMAT_BC5_UNORM;
+                case PixelFormat::BC7_UNORM: return DXGI_FORMAT_BC7_UNORM;
                 default: return DXGI_FORMAT_UNKNOWN;
             }
         }
@@ -144,76 +150,125 @@ namespace ouzel
         {
             TextureResource::setData(newData, newSize);
 
-            RenderDeviceD3D11& renderDeviceD3D11 = static_cast<RenderDeviceD3D11&>(renderDevice);
-
             if (!texture ||
                 static_cast<UINT>(size.width) != width ||
                 static_cast<UINT>(size.height) != height)
                 createTexture();
             else if (!(flags & Texture::RENDER_TARGET))
+                uploadLevels();
+        }
+
+        void TextureResourceD3D11::setRegionData(const std::vector<uint8_t>& newData,
+                                                 uint32_t x, uint32_t y,
+                                                 uint32_t regionWidth, uint32_t regionHeight)
+        {
+            TextureResource::setRegionData(newData, x, y, regionWidth, regionHeight);
+
+            if (!texture)
+                throw DataError("Texture not initialized");
+
+            RenderDeviceD3D11& renderDeviceD3D11 = static_cast<RenderDeviceD3D11&>(renderDevice);
+
+            // the dynamic usage allows only discarding maps of the whole level, and the region changes all the generated levels
+            if ((flags & Texture::STREAMING) && levels.size() == 1)
+            {
+                D3D11_BOX box;
+                box.left = x;
+                box.top = y;
+                box.front = 0;
+                box.right = x + regionWidth;
+                box.bottom = y + regionHeight;
+                box.back = 1;
+
+                renderDeviceD3D11.getContext()->UpdateSubresource(texture, 0, &box,
+                                                                  levels[0].data.data() + y * levels[0].pitch + x * getPixelSize(pixelFormat),
+                                                                  static_cast<UINT>(levels[0].pitch), 0);
+            }
+            else
+                uploadLevels();
+        }
+
+        void TextureResourceD3D11::uploadLevels()
+        {
+            RenderDeviceD3D11& renderDeviceD3D11 = static_cast<RenderDeviceD3D11&>(renderDevice);
+
+            // dynamic textures have the dynamic usage unless they are streamed, see createTexture
+            if (!(flags & Texture::STREAMING))
             {
-                if (flags & Texture::DYNAMIC)
+                for (size_t level = 0; level < levels.size(); ++level)
                 {
-                    for (size_t level = 0; level < levels.size(); ++level)
+                    if (!levels[level].data.empty())
                     {
-                        if (!levels[level].data.empty())
-                        {
-                            D3D11_MAPPED_SUBRESOURCE mappedSubresource;
-                            mappedSubresource.pData = nullptr;
-                            mappedSubresource.RowPitch = 0;
-                            mappedSubresource.DepthPitch = 0;
+                        D3D11_MAPPED_SUBRESOURCE mappedSubresource;
+                        mappedSubresource.pData = nullptr;
+                        mappedSubresource.RowPitch = 0;
+                        mappedSubresource.DepthPitch = 0;
+
+                        HRESULT hr = renderDeviceD3D11.getContext()->Map(texture, static_cast<UINT>(level),
+                                                                         (level == 0) ? D3D11_MAP_WRITE_DISCARD : D3D11_MAP_WRITE,
+                                                                         0, &mappedSubresource);
 
-                            HRESULT hr = renderDeviceD3D11.getContext()->Map(texture, static_cast<UINT>(level),
-                                                                             (level == 0) ? D3D11_MAP_WRITE_DISCARD : D3D11_MAP_WRITE,
-                                                                             0, &mappedSubresource);
+                        if (FAILED(hr))
+                            throw DataError("Failed to map Direct3D 11 texture, error: " + std::to_string(hr));
 
-                            if (FAILED(hr))
-                                throw DataError("Failed to map Direct3D 11 texture, error: " + std::to_string(hr));
+                        uint8_t* destination = static_cast<uint8_t*>(mappedSubresource.pData);
 
-                            uint8_t* destination = static_cast<uint8_t*>(mappedSubresource.pData);
+                        if (mappedSubresource.RowPitch == levels[level].pitch)
+                        {
+                            std::copy(levels[level].data.begin(),
+                                      levels[level].data.end(),
+                                      destination);
+                        }
+                        else
+                        {
+                            auto source = levels[level].data.begin();
+                            UINT rowSize = static_cast<UINT>(levels[level].size.width) * getPixelSize(pixelFormat);
+                            UINT rows = static_cast<UINT>(levels[level].size.height);
 
-                            if (mappedSubresource.RowPitch == levels[level].pitch)
+                            for (UINT row = 0; row < rows; ++row)
                             {
-                                std::copy(levels[level].data.begin(),
-                                          levels[level].data.end(),
+                                std::copy(source,
+                                          source + rowSize,
                                           destination);
-                            }
-                            else
-                            {
-                                auto source = levels[level].data.begin();
-                                UINT rowSize = static_cast<UINT>(levels[level].size.width) * getPixelSize(pixelFormat);
-                                UINT rows = static_cast<UINT>(levels[level].size.height);
-
-                                for (UINT row = 0; row < rows; ++row)
-                                {
-                                    std::copy(source,
-                                              source + rowSize,
-                                              destination);
-
-                                    source += levels[level].pitch;
-                                    destination += mappedSubresource.RowPitch;
-                                }
-                            }
 
-                            renderDeviceD3D11.getContext()->Unmap(texture, static_cast<UINT>(level));
+                                source += levels[level].pitch;
+                                destination += mappedSubresource.RowPitch;
+                            }
                         }
+
+                        renderDeviceD3D11.getContext()->Unmap(texture, static_cast<UINT>(level));
                     }
                 }
-                else
+            }
+            else
+            {
+                for (size_t level = 0; level < levels.size(); ++level)
                 {
-                    for (size_t level = 0; level < levels.size(); ++level)
+                    if (!levels[level].data.empty())
                     {
-                        if (!levels[level].data.empty())
-                        {
-                            renderDeviceD3D11.getContext()->UpdateSubresource(texture, static_cast<UINT>(level),
-                                                                              nullptr, levels[level].data.data(),
-                                                                              static_cast<UINT>(levels[level].pitch), 0);
-                        }
+                        renderDeviceD3D11.getContext()->UpdateSubresource(texture, static_cast<UINT>(level),
+                                                                          nullptr, levels[level].data.data(),
+                                                                          static_cast<UINT>(levels[level].pitch), 0);
                     }
                 }
             }
         }
 
+        void TextureResourceD3D11::setLevelData(uint32_t level, const std::vector<uint8_t>& newData)
+        {
+            TextureResource::setLevelData(level, newData);
+
+            if (!texture)
+                throw DataError("Texture not initialized");
+
+            RenderDeviceD3D11& renderDeviceD3D11 = static_cast<RenderDeviceD3D11&>(renderDevice);
+
+            renderDeviceD3D11.getContext()->UpdateSubresource(texture, static_cast<UINT>(level),
+                                                              nullptr, levels[level].data.data(),
+                                                              static_cast<UINT>(levels[level].pitch), 0);
+            renderDeviceD3D11.getContext()->SetResourceMinLOD(texture, static_cast<FLOAT>(baseLevel));
+        }
+
         void TextureResourceD3D11::setFilter(Texture::Filter newFilter)
         {
             TextureResource::setFilter(newFilter);
@@ -313,7 +368,7 @@ namespace ouzel
                 textureDescriptor.Format = d3d11PixelFormat;
                 textureDescriptor.SampleDesc.Count = sampleCount;
                 textureDescriptor.SampleDesc.Quality = 0;
-                if (flags & Texture::RENDER_TARGET) textureDescriptor.Usage = D3D11_USAGE_DEFAULT;
+                if (flags & (Texture::RENDER_TARGET | Texture::STREAMING)) textureDescriptor.Usage = D3D11_USAGE_DEFAULT;
                 else if (flags & Texture::DYNAMIC) textureDescriptor.Usage = D3D11_USAGE_DYNAMIC;
                 else textureDescriptor.Usage = D3D11_USAGE_IMMUTABLE;
 
@@ -336,6 +391,25 @@ namespace ouzel
                     if (FAILED(hr))
                         throw DataError("Failed to create Direct3D 11 texture, error: " + std::to_string(hr));
                 }
+                else if (flags & Texture::STREAMING)
+                {
+                    HRESULT hr = renderDeviceD3D11.getDevice()->CreateTexture2D(&textureDescriptor, nullptr, &texture);
+                    if (FAILED(hr))
+                        throw DataError("Failed to create Direct3D 11 texture, error: " + std::to_string(hr));
+
+                    // only the levels that are already streamed in have data
+                    for (size_t level = 0; level < levels.size(); ++level)
+                    {
+                        if (!levels[level].data.empty())
+                        {
+                            renderDeviceD3D11.getContext()->UpdateSubresource(texture, static_cast<UINT>(level),
+                                                                              nullptr, levels[level].data.data(),
+                                                                              static_cast<UINT>(levels[level].pitch), 0);
+                        }
+                    }
+
+                    renderDeviceD3D11.getContext()->SetResourceMinLOD(texture, static_cast<FLOAT>(baseLevel));
+                }
                 else
                 {
                     std::vector<D3D11_SUBRESOURCE_DATA> subresourceData(levels.size());
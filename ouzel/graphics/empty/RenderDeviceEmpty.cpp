@@ -37,8 +37,11 @@ namespace ouzel
                                newDebugRenderer);
         }
 
-        void RenderDeviceEmpty::processCommands(CommandBuffer&)
+        void RenderDeviceEmpty::processCommands(CommandBuffer& commands)
         {
+            // consume the commands so that the buffer and its data arena are reset for the next frame
+            while (commands.front())
+                commands.pop();
         }
 
         BlendStateResource* RenderDeviceEmpty::createBlendState()
@@ -46,6 +46,32 @@ namespace ouzel
                 std::copy(data.begin(), data.end(), static_cast<uint8_t*>([buffer contents]));
         }
 
+        void BufferResourceMetal::setData(const std::vector<uint8_t>& newData, uint32_t dataOffset)
+        {
+            BufferResource::setData(newData, dataOffset);
+
+            if (!buffer || data.size() > bufferSize)
+            {
+                createBuffer(static_cast<uint32_t>(data.size()));
+                std::copy(data.begin(), data.end(), static_cast<uint8_t*>([buffer contents]));
+            }
+            else
+                std::copy(newData.begin(), newData.end(), static_cast<uint8_t*>([buffer contents]) + dataOffset);
+        }
+
+        void BufferResourceMetal::upload(const uint8_t* newData, uint32_t newSize)
+        {
+            // contents of streaming buffers are not kept on the CPU
+            data.clear();
+
+            // instead of overwriting the buffer that the GPU might still be reading, a new one is created,
+            // command buffers retain the buffers they use
+            if (!allocateRing(newSize) || !buffer || bufferSize < ringSize)
+                createBuffer(ringSize);
+
+            std::copy(newData, newData + newSize, static_cast<uint8_t*>([buffer contents]) + offset);
+        }
+
         void BufferResourceMetal::createBuffer(NSUInteger newSize)
         {
             if (buffer)
@@ -73,10 +73,11 @@ namespace ouzel
                 Texture::Address addressX;
                 Texture::Address addressY;
                 uint32_t maxAnisotropy;
+                uint32_t baseLevel;
 
                 bool operator<(const SamplerStateDescriptor& other) const
                 {
-                    return std::tie(filter, addressX, addressY, maxAnisotropy) < std::tie(other.filter, other.addressX, other.addressY, other.maxAnisotropy);
+                    return std::tie(filter, addressX, addressY, maxAnisotropy, baseLevel) < std::tie(other.filter, other.addressX, other.addressY, other.maxAnisotropy, other.baseLevel);
                 }
             };
 
@@ -106,6 +106,23 @@ namespace ouzel
             if (device.name)
                 Log(Log::Level::INFO) << "Using " << [device.name cStringUsingEncoding:NSUTF8StringEncoding] << " for rendering";
 
+#if OUZEL_PLATFORM_MACOS
+            // the BC formats are the only compressed formats on macOS
+            etc2Supported = false;
+            astcSupported = false;
+#else
+            s3tcSupported = false;
+            rgtcSupported = false;
+            bptcSupported = false;
+#  if OUZEL_PLATFORM_IOS
+            astcSupported = [device supportsFeatureSet:MTLFeatureSet_iOS_GPUFamily2_v1];
+            // the GPUs before the A9 support only 8192x8192 textures
+            if (![device supportsFeatureSet:MTLFeatureSet_iOS_GPUFamily3_v1]) maxTextureSize = 8192;
+#  elif OUZEL_PLATFORM_TVOS
+            if (![device supportsFeatureSet:MTLFeatureSet_tvOS_GPUFamily2_v1]) maxTextureSize = 8192;
+#  endif
+#endif
+
             commandQueue = [device newCommandQueue];
 
             if (!commandQueue)
@@ -289,8 +306,6 @@ namespace ouzel
             PipelineStateDesc currentPipelineStateDesc;
             MTLTexturePtr currentRenderTarget = nil;
 
-            std::vector<float> shaderData;
-
             MTLViewport viewport;
             viewport.znear = 0.0;
             viewport.zfar = 1.0;
@@ -562,7 +577,7 @@ namespace ouzel
                         assert(vertexBufferMetal);
                         assert(vertexBufferMetal->getBuffer());
 
-                        [currentRenderCommandEncoder setVertexBuffer:vertexBufferMetal->getBuffer() offset:0 atIndex:0];
+                        [currentRenderCommandEncoder setVertexBuffer:vertexBufferMetal->getBuffer() offset:vertexBufferMetal->getOffset() + drawCommand->baseVertex * sizeof(Vertex) atIndex:0];
 
                         // draw
                         MTLPrimitiveType primitiveType;
@@ -595,7 +610,66 @@ namespace ouzel
                                                                 indexCount:drawCommand->indexCount
                                                                  indexType:indexType
                                                                indexBuffer:indexBufferMetal->getBuffer()
-                                                         indexBufferOffset:drawCommand->startIndex * drawCommand->indexSize];
+                                                         indexBufferOffset:indexBufferMetal->getOffset() + drawCommand->startIndex * drawCommand->indexSize];
+
+                        break;
+                    }
+
+                    case Command::Type::DRAW_INSTANCED:
+                    {
+                        const DrawInstancedCommand* drawInstancedCommand = static_cast<const DrawInstancedCommand*>(command);
+
+                        if (!currentRenderCommandEncoder)
+                            throw DataError("Metal render command encoder not initialized");
+
+                        // mesh buffer
+                        BufferResourceMetal* indexBufferMetal = static_cast<BufferResourceMetal*>(drawInstancedCommand->indexBuffer);
+                        BufferResourceMetal* vertexBufferMetal = static_cast<BufferResourceMetal*>(drawInstancedCommand->vertexBuffer);
+                        BufferResourceMetal* instanceBufferMetal = static_cast<BufferResourceMetal*>(drawInstancedCommand->instanceBuffer);
+
+                        assert(indexBufferMetal);
+                        assert(indexBufferMetal->getBuffer());
+                        assert(vertexBufferMetal);
+                        assert(vertexBufferMetal->getBuffer());
+                        assert(instanceBufferMetal);
+                        assert(instanceBufferMetal->getBuffer());
+
+                        [currentRenderCommandEncoder setVertexBuffer:vertexBufferMetal->getBuffer() offset:vertexBufferMetal->getOffset() atIndex:0];
+                        [currentRenderCommandEncoder setVertexBuffer:instanceBufferMetal->getBuffer() offset:instanceBufferMetal->getOffset() atIndex:2];
+
+                        // draw
+                        MTLPrimitiveType primitiveType;
+
+                        switch (drawInstancedCommand->drawMode)
+                        {
+                            case Renderer::DrawMode::POINT_LIST: primitiveType = MTLPrimitiveTypePoint; break;
+                            case Renderer::DrawMode::LINE_LIST: primitiveType = MTLPrimitiveTypeLine; break;
+                            case Renderer::DrawMode::LINE_STRIP: primitiveType = MTLPrimitiveTypeLineStrip; break;
+                            case Renderer::DrawMode::TRIANGLE_LIST: primitiveType = MTLPrimitiveTypeTriangle; break;
+                            case Renderer::DrawMode::TRIANGLE_STRIP: primitiveType = MTLPrimitiveTypeTriangleStrip; break;
+                            default: throw DataError("Invalid draw mode");
+                        }
+
+                        assert(drawInstancedCommand->indexCount);
+                        assert(indexBufferMetal->getSize());
+                        assert(vertexBufferMetal->getSize());
+                        assert(instanceBufferMetal->getSize() >= drawInstancedCommand->instanceCount * sizeof(Instance));
+
+                        MTLIndexType indexType;
+
+                        switch (drawInstancedCommand->indexSize)
+                        {
+                            case 2: indexType = MTLIndexTypeUInt16; break;
+                            case 4: indexType = MTLIndexTypeUInt32; break;
+                            default: throw DataError("Invalid index size");
+                        }
+
+                        [currentRenderCommandEncoder drawIndexedPrimitives:primitiveType
+                                                                indexCount:drawInstancedCommand->indexCount
+                                                                 indexType:indexType
+                                                               indexBuffer:indexBufferMetal->getBuffer()
+                                                         indexBufferOffset:indexBufferMetal->getOffset() + drawInstancedCommand->startIndex * drawInstancedCommand->indexSize
+                                                             instanceCount:drawInstancedCommand->instanceCount];
 
                         break;
                     }
@@ -656,6 +730,24 @@ namespace ouzel
                         break;
                     }
 
+                    case Command::Type::SET_BUFFER_DATA_RANGE:
+                    {
+                        const SetBufferDataRangeCommand* setBufferDataRangeCommand = static_cast<const SetBufferDataRangeCommand*>(command);
+
+                        setBufferDataRangeCommand->buffer->setData(setBufferDataRangeCommand->data,
+                                                                   setBufferDataRangeCommand->offset);
+                        break;
+                    }
+
+                    case Command::Type::UPLOAD_BUFFER_DATA:
+                    {
+                        const UploadBufferDataCommand* uploadBufferDataCommand = static_cast<const UploadBufferDataCommand*>(command);
+
+                        uploadBufferDataCommand->buffer->upload(commands.getUploadData(uploadBufferDataCommand->dataOffset),
+                                                                uploadBufferDataCommand->size);
+                        break;
+                    }
+
                     case Command::Type::INIT_SHADER:
                     {
                         const InitShaderCommand* initShaderCommand = static_cast<const InitShaderCommand*>(command);
@@ -686,72 +778,66 @@ namespace ouzel
                         // pixel shader constants
                         const std::vector<ShaderResourceMetal::Location>& fragmentShaderConstantLocations = currentShader->getFragmentShaderConstantLocations();
 
-                        if (setShaderConstantsCommand->fragmentShaderConstants.size() > fragmentShaderConstantLocations.size())
-                            throw DataError("Invalid pixel shader constant size");
-
-                        shaderData.clear();
+                        const float* fragmentShaderData = commands.getData(setShaderConstantsCommand->fragmentShaderConstantOffset);
+                        uint32_t fragmentShaderDataSize = static_cast<uint32_t>(sizeof(float) * setShaderConstantsCommand->fragmentShaderConstantSize);
+                        uint32_t fragmentShaderConstantsSize = 0;
 
-                        for (size_t i = 0; i < setShaderConstantsCommand->fragmentShaderConstants.size(); ++i)
+                        for (const ShaderResourceMetal::Location& fragmentShaderConstantLocation : fragmentShaderConstantLocations)
                         {
-                            const ShaderResourceMetal::Location& fragmentShaderConstantLocation = fragmentShaderConstantLocations[i];
-                            const std::vector<float>& fragmentShaderConstant = setShaderConstantsCommand->fragmentShaderConstants[i];
-
-                            if (sizeof(float) * fragmentShaderConstant.size() != fragmentShaderConstantLocation.size)
-                                throw DataError("Invalid pixel shader constant size");
-
-                            shaderData.insert(shaderData.end(), fragmentShaderConstant.begin(), fragmentShaderConstant.end());
+                            if (fragmentShaderConstantsSize >= fragmentShaderDataSize) break;
+                            fragmentShaderConstantsSize += fragmentShaderConstantLocation.size;
                         }
 
+                        if (fragmentShaderConstantsSize != fragmentShaderDataSize)
+                            throw DataError("Invalid pixel shader constant size");
+
                         shaderConstantBuffer.offset = ((shaderConstantBuffer.offset + currentShader->getFragmentShaderAlignment() - 1) /
                                                        currentShader->getFragmentShaderAlignment()) * currentShader->getFragmentShaderAlignment(); // round up to nearest aligned pointer
 
-                        if (shaderConstantBuffer.offset + getVectorSize(shaderData) > BUFFER_SIZE)
+                        if (shaderConstantBuffer.offset + fragmentShaderDataSize > BUFFER_SIZE)
                             shaderConstantBuffer.offset = 0;
 
-                        std::copy(reinterpret_cast<const char*>(shaderData.data()),
-                                  reinterpret_cast<const char*>(shaderData.data()) + static_cast<uint32_t>(sizeof(float) * shaderData.size()),
+                        std::copy(reinterpret_cast<const char*>(fragmentShaderData),
+                                  reinterpret_cast<const char*>(fragmentShaderData) + fragmentShaderDataSize,
                                   static_cast<char*>([shaderConstantBuffer.buffer contents]) + shaderConstantBuffer.offset);
 
                         [currentRenderCommandEncoder setFragmentBuffer:shaderConstantBuffer.buffer
                                                                 offset:shaderConstantBuffer.offset
                                                                atIndex:1];
 
-                        shaderConstantBuffer.offset += static_cast<uint32_t>(getVectorSize(shaderData));
+                        shaderConstantBuffer.offset += fragmentShaderDataSize;
 
                         // vertex shader constants
                         const std::vector<ShaderResourceMetal::Location>& vertexShaderConstantLocations = currentShader->getVertexShaderConstantLocations();
 
-                        if (setShaderConstantsCommand->vertexShaderConstants.size() > vertexShaderConstantLocations.size())
-                            throw DataError("Invalid vertex shader constant size");
-
-                        shaderData.clear();
+                        const float* vertexShaderData = commands.getData(setShaderConstantsCommand->vertexShaderConstantOffset);
+                        uint32_t vertexShaderDataSize = static_cast<uint32_t>(sizeof(float) * setShaderConstantsCommand->vertexShaderConstantSize);
+                        uint32_t vertexShaderConstantsSize = 0;
 
-                        for (size_t i = 0; i < setShaderConstantsCommand->vertexShaderConstants.size(); ++i)
+                        for (const ShaderResourceMetal::Location& vertexShaderConstantLocation : vertexShaderConstantLocations)
                         {
-                            const ShaderResourceMetal::Location& vertexShaderConstantLocation = vertexShaderConstantLocations[i];
-                            const std::vector<float>& vertexShaderConstant = setShaderConstantsCommand->vertexShaderConstants[i];
-
-                            if (sizeof(float) * vertexShaderConstant.size() != vertexShaderConstantLocation.size)
-                                throw DataError("Invalid vertex shader constant size");
-
-                            shaderData.insert(shaderData.end(), vertexShaderConstant.begin(), vertexShaderConstant.end());
+                            if (vertexShaderConstantsSize >= vertexShaderDataSize) break;
+                            vertexShaderConstantsSize += vertexShaderConstantLocation.size;
                         }
 
+                        if (vertexShaderConstantsSize != vertexShaderDataSize)
+                            throw DataError("Invalid vertex shader constant size");
+
                         shaderConstantBuffer.offset = ((shaderConstantBuffer.offset + currentShader->getVertexShaderAlignment() - 1) /
                                                        currentShader->getVertexShaderAlignment()) * currentShader->getVertexShaderAlignment(); // round up to nearest aligned pointer
 
-                        if (shaderConstantBuffer.offset + getVectorSize(shaderData) > BUFFER_SIZE)
+                        if (shaderConstantBuffer.offset + vertexShaderDataSize > BUFFER_SIZE)
                             shaderConstantBuffer.offset = 0;
 
-                        std::copy(reinterpret_cast<const char*>(shaderData.data()),
-                                  reinterpret_cast<const char*>(shaderData.data()) + static_cast<uint32_t>(sizeof(float) * shaderData.size()),
+                        std::copy(reinterpret_cast<const char*>(vertexShaderData),
+                                  reinterpret_cast<const char*>(vertexShaderData) + vertexShaderDataSize,
                                   static_cast<char*>([shaderConstantBuffer.buffer contents]) + shaderConstantBuffer.offset);
 
                         [currentRenderCommandEncoder setVertexBuffer:shaderConstantBuffer.buffer
                                                               offset:shaderConstantBuffer.offset
                                                              atIndex:1];
 
-                        shaderConstantBuffer.offset += static_cast<uint32_t>(getVectorSize(shaderData));
+                        shaderConstantBuffer.offset += vertexShaderDataSize;
 
                         break;
                     }
@@ -987,6 +1073,7 @@ namespace ouzel
                 }
 
                 samplerDescriptor.maxAnisotropy = descriptor.maxAnisotropy;
+                samplerDescriptor.lodMinClamp = static_cast<float>(descriptor.baseLevel);
 
                 MTLSamplerStatePtr samplerState = [device newSamplerStateWithDescriptor:samplerDescriptor];
                 [samplerDescriptor release];
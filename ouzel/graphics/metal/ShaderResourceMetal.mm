@@ -5,6 +5,7 @@
 #if OUZEL_COMPILE_METAL
 
 #include <algorithm>
+#include <cstddef>
 #include "ShaderResourceMetal.hpp"
 #include "RenderDeviceMetal.hpp"
 #include "files/FileSystem.hpp"
@@ -142,6 +143,30 @@ namespace ouzel
             vertexDescriptor.layouts[0].stepRate = 1;
             vertexDescriptor.layouts[0].stepFunction = MTLVertexStepFunctionPerVertex;
 
+            // per-instance attributes are read from buffer 2 (buffer 1 holds the shader constants)
+            if (vertexAttributes.find(Vertex::Attribute::Usage::INSTANCE_TRANSFORM) != vertexAttributes.end())
+            {
+                for (NSUInteger column = 0; column < 4; ++column)
+                {
+                    vertexDescriptor.attributes[index].format = MTLVertexFormatFloat4;
+                    vertexDescriptor.attributes[index].offset = offsetof(Instance, transform) + column * 4 * sizeof(float);
+                    vertexDescriptor.attributes[index].bufferIndex = 2;
+                    ++index;
+                }
+            }
+
+            if (vertexAttributes.find(Vertex::Attribute::Usage::INSTANCE_COLOR) != vertexAttributes.end())
+            {
+                vertexDescriptor.attributes[index].format = MTLVertexFormatFloat4;
+                vertexDescriptor.attributes[index].offset = offsetof(Instance, color);
+                vertexDescriptor.attributes[index].bufferIndex = 2;
+                ++index;
+            }
+
+            vertexDescriptor.layouts[2].stride = sizeof(Instance);
+            vertexDescriptor.layouts[2].stepRate = 1;
+            vertexDescriptor.layouts[2].stepFunction = MTLVertexStepFunctionPerInstance;
+
             RenderDeviceMetal& renderDeviceMetal = static_cast<RenderDeviceMetal&>(renderDevice);
             NSError* err;
 
@@ -46,6 +46,19 @@ namespace ouzel
                 case PixelFormat::RGBA32_UINT: return MTLPixelFormatRGBA32Uint;
                 case PixelFormat::RGBA32_SINT: return MTLPixelFormatRGBA32Sint;
                 case PixelFormat::RGBA32_FLOAT: return MTLPixelFormatRGBA32Float;
+#if OUZEL_PLATFORM_MACOS
+                case PixelFormat::BC1_UNORM: return MTLPixelFormatBC1_RGBA;
+                case PixelFormat::BC2_UNORM: return MTLPixelFormatBC2_RGBA;
+                case PixelFormat::BC3_UNORM: return MTLPixelFormatBC3_RGBA;
+                case PixelFormat::BC4_UNORM: return MTLPixelFormatBC4_RUnorm;
+                case PixelFormat::BC5_UNORM: return MTLPixelFormatBC5_RGUnorm;
+                case PixelFormat::BC7_UNORM: return MTLPixelFormatBC7_RGBAUnorm;
+#else
+                case PixelFormat::ETC2_RGB8_UNORM: return MTLPixelFormatETC2_RGB8;
+                case PixelFormat::ETC2_RGBA8_UNORM: return MTLPixelFormatEAC_RGBA8;
+                case PixelFormat::ASTC_4X4_UNORM: return MTLPixelFormatASTC_4x4_LDR;
+                case PixelFormat::ASTC_8X8_UNORM: return MTLPixelFormatASTC_8x8_LDR;
+#endif
                 default: return MTLPixelFormatInvalid;
             }
         }
@@ -197,6 +210,46 @@ namespace ouzel
             }
         }
 
+        void TextureResourceMetal::setRegionData(const std::vector<uint8_t>& newData,
+                                                 uint32_t x, uint32_t y,
+                                                 uint32_t regionWidth, uint32_t regionHeight)
+        {
+            TextureResource::setRegionData(newData, x, y, regionWidth, regionHeight);
+
+            if (!texture)
+                throw DataError("Texture not initialized");
+
+            // only the region of every level that depends on the updated region is replaced
+            for (size_t level = 0; level < levels.size(); ++level)
+            {
+                uint32_t levelX = x;
+                uint32_t levelY = y;
+                uint32_t levelWidth = regionWidth;
+                uint32_t levelHeight = regionHeight;
+                getLevelRegion(level, levelX, levelY, levelWidth, levelHeight);
+
+                [texture replaceRegion:MTLRegionMake2D(levelX, levelY, levelWidth, levelHeight)
+                           mipmapLevel:level withBytes:levels[level].data.data() + levelY * levels[level].pitch + levelX * getPixelSize(pixelFormat)
+                           bytesPerRow:static_cast<NSUInteger>(levels[level].pitch)];
+            }
+        }
+
+        void TextureResourceMetal::setLevelData(uint32_t level, const std::vector<uint8_t>& newData)
+        {
+            TextureResource::setLevelData(level, newData);
+
+            if (!texture)
+                throw DataError("Texture not initialized");
+
+            [texture replaceRegion:MTLRegionMake2D(0, 0,
+                                                   static_cast<NSUInteger>(levels[level].size.width),
+                                                   static_cast<NSUInteger>(levels[level].size.height))
+                       mipmapLevel:level withBytes:levels[level].data.data()
+                       bytesPerRow:static_cast<NSUInteger>(levels[level].pitch)];
+
+            updateSamplerState();
+        }
+
         void TextureResourceMetal::setFilter(Texture::Filter newFilter)
         {
             TextureResource::setFilter(newFilter);
@@ -392,6 +445,7 @@ namespace ouzel
             samplerDescriptor.addressX = addressX;
             samplerDescriptor.addressY = addressY;
             samplerDescriptor.maxAnisotropy = (maxAnisotropy == 0) ? renderDeviceMetal.getMaxAnisotropy() : maxAnisotropy;
+            samplerDescriptor.baseLevel = baseLevel;
 
             if (samplerState) [samplerState release];
             samplerState = renderDeviceMetal.getSamplerState(samplerDescriptor);
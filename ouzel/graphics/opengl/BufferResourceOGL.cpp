@@ -4,6 +4,7 @@
 
 #if OUZEL_COMPILE_OPENGL
 
+#include <algorithm>
 #include "BufferResourceOGL.hpp"
 #include "RenderDeviceOGL.hpp"
 #include "utils/Errors.hpp"
@@ -61,7 +62,28 @@ namespace ouzel
 
             createBuffer();
 
-            if (bufferSize > 0)
+            if (flags & Buffer::STREAMING)
+            {
+                if (bufferSize > 0)
+                {
+                    RenderDeviceOGL& renderDeviceOGL = static_cast<RenderDeviceOGL&>(renderDevice);
+
+                    renderDeviceOGL.bindBuffer(bufferType, bufferId);
+
+                    glBufferDataProc(bufferType, bufferSize, nullptr, GL_STREAM_DRAW);
+
+                    // restores only the current contents of the ring
+                    if (!data.empty())
+                        glBufferSubDataProc(bufferType, static_cast<GLintptr>(offset),
+                                            static_cast<GLsizeiptr>(data.size()), data.data());
+
+                    GLenum error;
+
+                    if ((error = glGetError()) != GL_NO_ERROR)
+                        throw DataError("Failed to create buffer, error: " + std::to_string(error));
+                }
+            }
+            else if (bufferSize > 0)
             {
                 RenderDeviceOGL& renderDeviceOGL = static_cast<RenderDeviceOGL&>(renderDevice);
 
@@ -114,6 +136,84 @@ namespace ouzel
             }
         }
 
+        void BufferResourceOGL::setData(const std::vector<uint8_t>& newData, uint32_t dataOffset)
+        {
+            BufferResource::setData(newData, dataOffset);
+
+            if (!bufferId)
+                throw DataError("Buffer not initialized");
+
+            RenderDeviceOGL& renderDeviceOGL = static_cast<RenderDeviceOGL&>(renderDevice);
+            renderDeviceOGL.bindBuffer(bufferType, bufferId);
+
+            GLenum error;
+
+            if (static_cast<GLsizeiptr>(data.size()) > bufferSize)
+            {
+                bufferSize = static_cast<GLsizeiptr>(data.size());
+
+                glBufferDataProc(bufferType, bufferSize, data.data(),
+                                 (flags & Texture::DYNAMIC) ? GL_DYNAMIC_DRAW : GL_STATIC_DRAW);
+
+                if ((error = glGetError()) != GL_NO_ERROR)
+                    throw DataError("Failed to create buffer, error: " + std::to_string(error));
+            }
+            else
+            {
+                glBufferSubDataProc(bufferType, static_cast<GLintptr>(dataOffset), static_cast<GLsizeiptr>(newData.size()), newData.data());
+
+                if ((error = glGetError()) != GL_NO_ERROR)
+                    throw DataError("Failed to upload buffer, error: " + std::to_string(error));
+            }
+        }
+
+        void BufferResourceOGL::upload(const uint8_t* newData, uint32_t newSize)
+        {
+            if (!bufferId)
+                throw DataError("Buffer not initialized");
+
+            RenderDeviceOGL& renderDeviceOGL = static_cast<RenderDeviceOGL&>(renderDevice);
+            renderDeviceOGL.bindBuffer(bufferType, bufferId);
+
+            GLenum error;
+
+            if (!allocateRing(newSize))
+            {
+                // orphans the old storage, the draw calls that are still in flight keep using it
+                bufferSize = static_cast<GLsizeiptr>(ringSize);
+
+                glBufferDataProc(bufferType, bufferSize, nullptr, GL_STREAM_DRAW);
+
+                if ((error = glGetError()) != GL_NO_ERROR)
+                    throw DataError("Failed to create buffer, error: " + std::to_string(error));
+            }
+
+            if (glMapBufferRangeProc && glUnmapBufferProc)
+            {
+                // the range was not used since the storage was orphaned, so the driver doesn't have to synchronize
+                void* bufferData = glMapBufferRangeProc(bufferType,
+                                                        static_cast<GLintptr>(offset),
+                                                        static_cast<GLsizeiptr>(newSize),
+                                                        GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+
+                if (!bufferData)
+                    throw DataError("Failed to map buffer");
+
+                std::copy(newData, newData + newSize, static_cast<uint8_t*>(bufferData));
+
+                if (glUnmapBufferProc(bufferType) != GL_TRUE)
+                    throw DataError("Failed to unmap buffer");
+            }
+            else
+                glBufferSubDataProc(bufferType, static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(newSize), newData);
+
+            if ((error = glGetError()) != GL_NO_ERROR)
+                throw DataError("Failed to upload buffer, error: " + std::to_string(error));
+
+            // kept for restoring the contents after the context is lost
+            data.assign(newData, newData + newSize);
+        }
+
         void BufferResourceOGL::createBuffer()
         {
             RenderDeviceOGL& renderDeviceOGL = static_cast<RenderDeviceOGL&>(renderDevice);
@@ -39,6 +39,8 @@ namespace ouzel
             virtual void reload() override;
 
             virtual void setData(const std::vector<uint8_t>& newData) override;
+            virtual void setData(const std::vector<uint8_t>& newData, uint32_t dataOffset) override;
+            virtual void upload(const uint8_t* newData, uint32_t newSize) override;
 
             inline GLuint getBufferId() const { return bufferId; }
             inline GLuint getBufferType() const { return bufferType; }
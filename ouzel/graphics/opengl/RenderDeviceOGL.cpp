@@ -65,6 +65,7 @@ PFNGLUNIFORMMATRIX3FVPROC glUniformMatrix3fvProc;
 PFNGLUNIFORMMATRIX4FVPROC glUniformMatrix4fvProc;
 
 PFNGLACTIVETEXTUREPROC glActiveTextureProc;
+PFNGLCOMPRESSEDTEXIMAGE2DPROC glCompressedTexImage2DProc;
 PFNGLGENRENDERBUFFERSPROC glGenRenderbuffersProc;
 PFNGLDELETERENDERBUFFERSPROC glDeleteRenderbuffersProc;
 PFNGLBINDRENDERBUFFERPROC glBindRenderbufferProc;
@@ -115,6 +116,8 @@ PFNGLDELETEVERTEXARRAYSPROC glDeleteVertexArraysProc;
 PFNGLENABLEVERTEXATTRIBARRAYPROC glEnableVertexAttribArrayProc;
 PFNGLDISABLEVERTEXATTRIBARRAYPROC glDisableVertexAttribArrayProc;
 PFNGLVERTEXATTRIBPOINTERPROC glVertexAttribPointerProc;
+PFNGLVERTEXATTRIBDIVISORPROC glVertexAttribDivisorProc;
+PFNGLDRAWELEMENTSINSTANCEDPROC glDrawElementsInstancedProc;
 
 PFNGLGETSTRINGIPROC glGetStringiProc;
 
@@ -367,6 +370,7 @@ namespace ouzel
             glUniformMatrix4fvProc = glUniformMatrix4fv;
 
             glActiveTextureProc = glActiveTexture;
+            glCompressedTexImage2DProc = glCompressedTexImage2D;
             glGenRenderbuffersProc = glGenRenderbuffers;
             glDeleteRenderbuffersProc = glDeleteRenderbuffers;
             glBindRenderbufferProc = glBindRenderbuffer;
@@ -428,6 +432,7 @@ namespace ouzel
             glUniformMatrix4fvProc = reinterpret_cast<PFNGLUNIFORMMATRIX4FVPROC>(getProcAddress("glUniformMatrix4fv"));
 
             glActiveTextureProc = reinterpret_cast<PFNGLACTIVETEXTUREPROC>(getProcAddress("glActiveTexture"));
+            glCompressedTexImage2DProc = reinterpret_cast<PFNGLCOMPRESSEDTEXIMAGE2DPROC>(getProcAddress("glCompressedTexImage2D"));
 
             glClearDepthProc = reinterpret_cast<PFNGLCLEARDEPTHPROC>(getProcAddress("glClearDepth"));
 
@@ -516,6 +521,35 @@ namespace ouzel
                 }
             }
 
+#if OUZEL_SUPPORTS_OPENGLES
+            s3tcSupported = false;
+            rgtcSupported = false;
+            bptcSupported = false;
+            etc2Supported = (apiMajorVersion >= 3); // ETC2 is a core feature of OpenGL ES 3
+#else
+            s3tcSupported = false;
+            rgtcSupported = (apiMajorVersion >= 3); // RGTC is a core feature since OpenGL 3.0
+            bptcSupported = (apiMajorVersion > 4 || (apiMajorVersion == 4 && apiMinorVersion >= 2));
+            etc2Supported = (apiMajorVersion > 4 || (apiMajorVersion == 4 && apiMinorVersion >= 3));
+#endif
+            astcSupported = false;
+
+            for (const std::string& extension : extensions)
+            {
+                if (extension == "GL_EXT_texture_compression_s3tc")
+                    s3tcSupported = true;
+                else if (extension == "GL_ARB_texture_compression_rgtc" ||
+                         extension == "GL_EXT_texture_compression_rgtc")
+                    rgtcSupported = true;
+                else if (extension == "GL_ARB_texture_compression_bptc" ||
+                         extension == "GL_EXT_texture_compression_bptc")
+                    bptcSupported = true;
+                else if (extension == "GL_ARB_ES3_compatibility")
+                    etc2Supported = true;
+                else if (extension == "GL_KHR_texture_compression_astc_ldr")
+                    astcSupported = true;
+            }
+
             if (apiMajorVersion >= 3)
             {
                 for (const std::string& extension : extensions)
@@ -533,6 +567,9 @@ namespace ouzel
                 glGenVertexArraysProc = glGenVertexArraysOES;
                 glBindVertexArrayProc = glBindVertexArrayOES;
                 glDeleteVertexArraysProc = glDeleteVertexArraysOES;
+
+                glVertexAttribDivisorProc = glVertexAttribDivisor;
+                glDrawElementsInstancedProc = glDrawElementsInstanced;
                 glMapBufferProc = glMapBufferOES;
                 glUnmapBufferProc = glUnmapBufferOES;
                 glMapBufferRangeProc = glMapBufferRangeEXT;
@@ -547,6 +584,9 @@ namespace ouzel
                 glGenVertexArraysProc = reinterpret_cast<PFNGLGENVERTEXARRAYSPROC>(getProcAddress("glGenVertexArrays"));
                 glBindVertexArrayProc = reinterpret_cast<PFNGLBINDVERTEXARRAYPROC>(getProcAddress("glBindVertexArray"));
                 glDeleteVertexArraysProc = reinterpret_cast<PFNGLDELETEVERTEXARRAYSPROC>(getProcAddress("glDeleteVertexArrays"));
+
+                glVertexAttribDivisorProc = reinterpret_cast<PFNGLVERTEXATTRIBDIVISORPROC>(getProcAddress("glVertexAttribDivisor"));
+                glDrawElementsInstancedProc = reinterpret_cast<PFNGLDRAWELEMENTSINSTANCEDPROC>(getProcAddress("glDrawElementsInstanced"));
 #if OUZEL_OPENGL_INTERFACE_EGL
                 glMapBufferProc = reinterpret_cast<PFNGLMAPBUFFEROESPROC>(getProcAddress("glMapBuffer"));
 #elif !OUZEL_SUPPORTS_OPENGLES
@@ -578,10 +618,13 @@ namespace ouzel
             {
                 npotTexturesSupported = false;
                 multisamplingSupported = false;
+                instancingSupported = false;
 
 #if OUZEL_SUPPORTS_OPENGLES
                 textureBaseLevelSupported = false;
                 textureMaxLevelSupported = false;
+                unpackRowLengthSupported = false;
+                uint32IndicesSupported = false;
 #else
                 renderTargetsSupported = false;
 #endif
@@ -597,6 +640,12 @@ namespace ouzel
                     {
                         npotTexturesSupported = true;
                     }
+#if OUZEL_SUPPORTS_OPENGLES
+                    else if (extension == "GL_OES_element_index_uint")
+                    {
+                        uint32IndicesSupported = true;
+                    }
+#endif
 #if !OUZEL_SUPPORTS_OPENGLES
                     else if (extension == "GL_EXT_framebuffer_object")
                     {
@@ -665,6 +714,14 @@ namespace ouzel
                 if (!multisamplingSupported) sampleCount = 1;
             }
 
+            GLint maxTextureSizeValue;
+            glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxTextureSizeValue);
+
+            if ((error = glGetError()) != GL_NO_ERROR)
+                Log(Log::Level::WARN) << "Failed to get OpenGL maximum texture size, error: " + std::to_string(error);
+            else
+                maxTextureSize = static_cast<uint32_t>(maxTextureSizeValue);
+
             glDisable(GL_DITHER);
             glDepthFunc(GL_LEQUAL);
 
@@ -1050,7 +1107,8 @@ namespace ouzel
                         bindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBufferOGL->getBufferId());
                         bindBuffer(GL_ARRAY_BUFFER, vertexBufferOGL->getBufferId());
 
-                        GLuint vertexOffset = 0;
+                        // the base vertex is applied by offsetting the attributes, glDrawElementsBaseVertex is not available everywhere
+                        GLuint vertexOffset = drawCommand->baseVertex * static_cast<GLuint>(sizeof(Vertex));
 
                         for (GLuint index = 0; index < Vertex::ATTRIBUTES.size(); ++index)
                         {
@@ -1062,7 +1120,7 @@ namespace ouzel
                                                       getVertexFormat(vertexAttribute.dataType),
                                                       isNormalized(vertexAttribute.dataType),
                                                       static_cast<GLsizei>(sizeof(Vertex)),
-                                                      static_cast<const GLchar*>(nullptr) + vertexOffset);
+                                                      static_cast<const GLchar*>(nullptr) + vertexBufferOGL->getOffset() + vertexOffset);
 
                             vertexOffset += getDataTypeSize(vertexAttribute.dataType);
                         }
@@ -1088,7 +1146,7 @@ namespace ouzel
                         glDrawElements(mode,
                                        static_cast<GLsizei>(drawCommand->indexCount),
                                        indexType,
-                                       static_cast<const char*>(nullptr) + (drawCommand->startIndex * drawCommand->indexSize));
+                                       static_cast<const char*>(nullptr) + indexBufferOGL->getOffset() + (drawCommand->startIndex * drawCommand->indexSize));
 
                         if ((error = glGetError()) != GL_NO_ERROR)
                             throw DataError("Failed to draw elements, error: " + std::to_string(error));
@@ -1096,6 +1154,108 @@ namespace ouzel
                         break;
                     }
 
+                    case Command::Type::DRAW_INSTANCED:
+                    {
+                        const DrawInstancedCommand* drawInstancedCommand = static_cast<const DrawInstancedCommand*>(command);
+
+                        // mesh buffer
+                        BufferResourceOGL* indexBufferOGL = static_cast<BufferResourceOGL*>(drawInstancedCommand->indexBuffer);
+                        BufferResourceOGL* vertexBufferOGL = static_cast<BufferResourceOGL*>(drawInstancedCommand->vertexBuffer);
+                        BufferResourceOGL* instanceBufferOGL = static_cast<BufferResourceOGL*>(drawInstancedCommand->instanceBuffer);
+
+                        assert(indexBufferOGL);
+                        assert(indexBufferOGL->getBufferId());
+                        assert(vertexBufferOGL);
+                        assert(vertexBufferOGL->getBufferId());
+                        assert(instanceBufferOGL);
+                        assert(instanceBufferOGL->getBufferId());
+
+                        // draw
+                        GLenum mode;
+
+                        switch (drawInstancedCommand->drawMode)
+                        {
+                            case Renderer::DrawMode::POINT_LIST: mode = GL_POINTS; break;
+                            case Renderer::DrawMode::LINE_LIST: mode = GL_LINES; break;
+                            case Renderer::DrawMode::LINE_STRIP: mode = GL_LINE_STRIP; break;
+                            case Renderer::DrawMode::TRIANGLE_LIST: mode = GL_TRIANGLES; break;
+                            case Renderer::DrawMode::TRIANGLE_STRIP: mode = GL_TRIANGLE_STRIP; break;
+                            default: throw DataError("Invalid draw mode");
+                        }
+
+                        bindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBufferOGL->getBufferId());
+                        bindBuffer(GL_ARRAY_BUFFER, vertexBufferOGL->getBufferId());
+
+                        GLuint vertexOffset = 0;
+
+                        for (GLuint index = 0; index < Vertex::ATTRIBUTES.size(); ++index)
+                        {
+                            const Vertex::Attribute& vertexAttribute = Vertex::ATTRIBUTES[index];
+
+                            glEnableVertexAttribArrayProc(index);
+                            glVertexAttribPointerProc(index,
+                                                      getArraySize(vertexAttribute.dataType),
+                                                      getVertexFormat(vertexAttribute.dataType),
+                                                      isNormalized(vertexAttribute.dataType),
+                                                      static_cast<GLsizei>(sizeof(Vertex)),
+                                                      static_cast<const GLchar*>(nullptr) + vertexBufferOGL->getOffset() + vertexOffset);
+
+                            vertexOffset += getDataTypeSize(vertexAttribute.dataType);
+                        }
+
+                        // per-instance attributes follow the vertex attributes, four columns of the transform and the color
+                        bindBuffer(GL_ARRAY_BUFFER, instanceBufferOGL->getBufferId());
+
+                        const GLuint instanceIndex = static_cast<GLuint>(Vertex::ATTRIBUTES.size());
+
+                        for (GLuint column = 0; column < 5; ++column)
+                        {
+                            glEnableVertexAttribArrayProc(instanceIndex + column);
+                            glVertexAttribPointerProc(instanceIndex + column,
+                                                      4, GL_FLOAT, GL_FALSE,
+                                                      static_cast<GLsizei>(sizeof(Instance)),
+                                                      static_cast<const GLchar*>(nullptr) + instanceBufferOGL->getOffset() + column * 4 * sizeof(float));
+                            glVertexAttribDivisorProc(instanceIndex + column, 1);
+                        }
+
+                        GLenum error;
+
+                        if ((error = glGetError()) != GL_NO_ERROR)
+                            throw DataError("Failed to update vertex attributes, error: " + std::to_string(error));
+
+                        assert(drawInstancedCommand->indexCount);
+                        assert(indexBufferOGL->getSize());
+                        assert(vertexBufferOGL->getSize());
+                        assert(instanceBufferOGL->getSize() >= drawInstancedCommand->instanceCount * sizeof(Instance));
+
+                        GLenum indexType;
+
+                        switch (drawInstancedCommand->indexSize)
+                        {
+                            case 2: indexType = GL_UNSIGNED_SHORT; break;
+                            case 4: indexType = GL_UNSIGNED_INT; break;
+                            default: throw DataError("Invalid index size");
+                        }
+
+                        glDrawElementsInstancedProc(mode,
+                                                    static_cast<GLsizei>(drawInstancedCommand->indexCount),
+                                                    indexType,
+                                                    static_cast<const char*>(nullptr) + indexBufferOGL->getOffset() + (drawInstancedCommand->startIndex * drawInstancedCommand->indexSize),
+                                                    static_cast<GLsizei>(drawInstancedCommand->instanceCount));
+
+                        if ((error = glGetError()) != GL_NO_ERROR)
+                            throw DataError("Failed to draw instanced elements, error: " + std::to_string(error));
+
+                        // regular draw calls don't expect per-instance attributes
+                        for (GLuint column = 0; column < 5; ++column)
+                        {
+                            glVertexAttribDivisorProc(instanceIndex + column, 0);
+                            glDisableVertexAttribArrayProc(instanceIndex + column);
+                        }
+
+                        break;
+                    }
+
                     case Command::Type::PUSH_DEBUG_MARKER:
                     {
                         //const PushDebugMarkerCommand* pushDebugMarkerCommand = static_cast<const PushDebugMarkerCommand*>(command);
@@ -1148,6 +1308,24 @@ namespace ouzel
                         break;
                     }
 
+                    case Command::Type::SET_BUFFER_DATA_RANGE:
+                    {
+                        const SetBufferDataRangeCommand* setBufferDataRangeCommand = static_cast<const SetBufferDataRangeCommand*>(command);
+
+                        setBufferDataRangeCommand->buffer->setData(setBufferDataRangeCommand->data,
+                                                                   setBufferDataRangeCommand->offset);
+                        break;
+                    }
+
+                    case Command::Type::UPLOAD_BUFFER_DATA:
+                    {
+                        const UploadBufferDataCommand* uploadBufferDataCommand = static_cast<const UploadBufferDataCommand*>(command);
+
+                        uploadBufferDataCommand->buffer->upload(commands.getUploadData(uploadBufferDataCommand->dataOffset),
+                                                                uploadBufferDataCommand->size);
+                        break;
+                    }
+
                     case Command::Type::INIT_SHADER:
                     {
                         const InitShaderCommand* initShaderCommand = static_cast<const InitShaderCommand*>(command);
@@ -1175,35 +1353,53 @@ namespace ouzel
                         // pixel shader constants
                         const std::vector<ShaderResourceOGL::Location>& fragmentShaderConstantLocations = currentShader->getFragmentShaderConstantLocations();
 
-                        if (setShaderConstantsCommand->fragmentShaderConstants.size() > fragmentShaderConstantLocations.size())
-                            throw DataError("Invalid pixel shader constant size");
+                        const float* fragmentShaderConstant = commands.getData(setShaderConstantsCommand->fragmentShaderConstantOffset);
+                        const float* fragmentShaderConstantEnd = fragmentShaderConstant + setShaderConstantsCommand->fragmentShaderConstantSize;
 
-                        for (size_t i = 0; i < setShaderConstantsCommand->fragmentShaderConstants.size(); ++i)
+                        for (const ShaderResourceOGL::Location& fragmentShaderConstantLocation : fragmentShaderConstantLocations)
                         {
-                            const ShaderResourceOGL::Location& fragmentShaderConstantLocation = fragmentShaderConstantLocations[i];
-                            const std::vector<float>& fragmentShaderConstant = setShaderConstantsCommand->fragmentShaderConstants[i];
+                            if (fragmentShaderConstant == fragmentShaderConstantEnd) break;
+
+                            uint32_t constantSize = getDataTypeSize(fragmentShaderConstantLocation.dataType) / sizeof(float);
+
+                            if (fragmentShaderConstant + constantSize > fragmentShaderConstantEnd)
+                                throw DataError("Invalid pixel shader constant size");
 
                             setUniform(fragmentShaderConstantLocation.location,
                                        fragmentShaderConstantLocation.dataType,
-                                       fragmentShaderConstant.data());
+                                       fragmentShaderConstant);
+
+                            fragmentShaderConstant += constantSize;
                         }
 
+                        if (fragmentShaderConstant != fragmentShaderConstantEnd)
+                            throw DataError("Invalid pixel shader constant size");
+
                         // vertex shader constants
                         const std::vector<ShaderResourceOGL::Location>& vertexShaderConstantLocations = currentShader->getVertexShaderConstantLocations();
 
-                        if (setShaderConstantsCommand->vertexShaderConstants.size() > vertexShaderConstantLocations.size())
-                            throw DataError("Invalid vertex shader constant size");
+                        const float* vertexShaderConstant = commands.getData(setShaderConstantsCommand->vertexShaderConstantOffset);
+                        const float* vertexShaderConstantEnd = vertexShaderConstant + setShaderConstantsCommand->vertexShaderConstantSize;
 
-                        for (size_t i = 0; i < setShaderConstantsCommand->vertexShaderConstants.size(); ++i)
+                        for (const ShaderResourceOGL::Location& vertexShaderConstantLocation : vertexShaderConstantLocations)
                         {
-                            const ShaderResourceOGL::Location& vertexShaderConstantLocation = vertexShaderConstantLocations[i];
-                            const std::vector<float>& vertexShaderConstant = setShaderConstantsCommand->vertexShaderConstants[i];
+                            if (vertexShaderConstant == vertexShaderConstantEnd) break;
+
+                            uint32_t constantSize = getDataTypeSize(vertexShaderConstantLocation.dataType) / sizeof(float);
+
+                            if (vertexShaderConstant + constantSize > vertexShaderConstantEnd)
+                                throw DataError("Invalid vertex shader constant size");
 
                             setUniform(vertexShaderConstantLocation.location,
                                        vertexShaderConstantLocation.dataType,
-                                       vertexShaderConstant.data());
+                                       vertexShaderConstant);
+
+                            vertexShaderConstant += constantSize;
                         }
 
+                        if (vertexShaderConstant != vertexShaderConstantEnd)
+                            throw DataError("Invalid vertex shader constant size");
+
                         break;
                     }
 
@@ -44,6 +44,7 @@ extern PFNGLUNIFORMMATRIX3FVPROC glUniformMatrix3fvProc;
 extern PFNGLUNIFORMMATRIX4FVPROC glUniformMatrix4fvProc;
 
 extern PFNGLACTIVETEXTUREPROC glActiveTextureProc;
+extern PFNGLCOMPRESSEDTEXIMAGE2DPROC glCompressedTexImage2DProc;
 extern PFNGLGENRENDERBUFFERSPROC glGenRenderbuffersProc;
 extern PFNGLDELETERENDERBUFFERSPROC glDeleteRenderbuffersProc;
 extern PFNGLBINDRENDERBUFFERPROC glBindRenderbufferProc;
@@ -94,6 +95,8 @@ extern PFNGLDELETEVERTEXARRAYSPROC glDeleteVertexArraysProc;
 extern PFNGLENABLEVERTEXATTRIBARRAYPROC glEnableVertexAttribArrayProc;
 extern PFNGLDISABLEVERTEXATTRIBARRAYPROC glDisableVertexAttribArrayProc;
 extern PFNGLVERTEXATTRIBPOINTERPROC glVertexAttribPointerProc;
+extern PFNGLVERTEXATTRIBDIVISORPROC glVertexAttribDivisorProc;
+extern PFNGLDRAWELEMENTSINSTANCEDPROC glDrawElementsInstancedProc;
 
 extern PFNGLGETSTRINGIPROC glGetStringiProc;
 
@@ -130,6 +133,7 @@ namespace ouzel
 
             bool isTextureBaseLevelSupported() const { return textureBaseLevelSupported; }
             bool isTextureMaxLevelSupported() const { return textureMaxLevelSupported; }
+            bool isUnpackRowLengthSupported() const { return unpackRowLengthSupported; }
 
             inline void bindTexture(GLuint textureId, uint32_t layer)
             {
@@ -529,6 +533,7 @@ namespace ouzel
             GLfloat frameBufferClearColor[4];
             bool textureBaseLevelSupported = true;
             bool textureMaxLevelSupported = true;
+            bool unpackRowLengthSupported = true;
 
             class StateCache
             {
@@ -197,6 +197,13 @@ namespace ouzel
                 }
             }
 
+            // per-instance attributes are bound after all the vertex attributes (see DRAW_INSTANCED in RenderDeviceOGL)
+            if (vertexAttributes.find(Vertex::Attribute::Usage::INSTANCE_TRANSFORM) != vertexAttributes.end())
+                glBindAttribLocationProc(programId, static_cast<GLuint>(Vertex::ATTRIBUTES.size()), "instanceTransform0");
+
+            if (vertexAttributes.find(Vertex::Attribute::Usage::INSTANCE_COLOR) != vertexAttributes.end())
+                glBindAttribLocationProc(programId, static_cast<GLuint>(Vertex::ATTRIBUTES.size() + 4), "instanceColor0");
+
             glLinkProgramProc(programId);
 
             glGetProgramivProc(programId, GL_LINK_STATUS, &status);
@@ -9,6 +9,49 @@
 #include "utils/Utils.hpp"
 #include "utils/Errors.hpp"
 
+#ifndef GL_TEXTURE_SWIZZLE_R
+#  define GL_TEXTURE_SWIZZLE_R 0x8E42
+#endif
+#ifndef GL_TEXTURE_SWIZZLE_G
+#  define GL_TEXTURE_SWIZZLE_G 0x8E43
+#endif
+#ifndef GL_TEXTURE_SWIZZLE_B
+#  define GL_TEXTURE_SWIZZLE_B 0x8E44
+#endif
+#ifndef GL_TEXTURE_SWIZZLE_A
+#  define GL_TEXTURE_SWIZZLE_A 0x8E45
+#endif
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT1_EXT
+#  define GL_COMPRESSED_RGBA_S3TC_DXT1_EXT 0x83F1
+#endif
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT3_EXT
+#  define GL_COMPRESSED_RGBA_S3TC_DXT3_EXT 0x83F2
+#endif
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+#  define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+#ifndef GL_COMPRESSED_RED_RGTC1
+#  define GL_COMPRESSED_RED_RGTC1 0x8DBB
+#endif
+#ifndef GL_COMPRESSED_RG_RGTC2
+#  define GL_COMPRESSED_RG_RGTC2 0x8DBD
+#endif
+#ifndef GL_COMPRESSED_RGBA_BPTC_UNORM
+#  define GL_COMPRESSED_RGBA_BPTC_UNORM 0x8E8C
+#endif
+#ifndef GL_COMPRESSED_RGB8_ETC2
+#  define GL_COMPRESSED_RGB8_ETC2 0x9274
+#endif
+#ifndef GL_COMPRESSED_RGBA8_ETC2_EAC
+#  define GL_COMPRESSED_RGBA8_ETC2_EAC 0x9278
+#endif
+#ifndef GL_COMPRESSED_RGBA_ASTC_4x4_KHR
+#  define GL_COMPRESSED_RGBA_ASTC_4x4_KHR 0x93B0
+#endif
+#ifndef GL_COMPRESSED_RGBA_ASTC_8x8_KHR
+#  define GL_COMPRESSED_RGBA_ASTC_8x8_KHR 0x93B7
+#endif
+
 namespace ouzel
 {
     namespace graphics
@@ -40,6 +83,22 @@ namespace ouzel
 
         static GLenum getOGLInternalPixelFormat(PixelFormat pixelFormat, uint32_t openGLVersion)
         {
+            // the compressed formats are available on all versions if the device supports them
+            switch (pixelFormat)
+            {
+                case PixelFormat::BC1_UNORM: return GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+                case PixelFormat::BC2_UNORM: return GL_COMPRESSED_RGBA_S3TC_DXT3_EXT;
+                case PixelFormat::BC3_UNORM: return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+                case PixelFormat::BC4_UNORM: return GL_COMPRESSED_RED_RGTC1;
+                case PixelFormat::BC5_UNORM: return GL_COMPRESSED_RG_RGTC2;
+                case PixelFormat::BC7_UNORM: return GL_COMPRESSED_RGBA_BPTC_UNORM;
+                case PixelFormat::ETC2_RGB8_UNORM: return GL_COMPRESSED_RGB8_ETC2;
+                case PixelFormat::ETC2_RGBA8_UNORM: return GL_COMPRESSED_RGBA8_ETC2_EAC;
+                case PixelFormat::ASTC_4X4_UNORM: return GL_COMPRESSED_RGBA_ASTC_4x4_KHR;
+                case PixelFormat::ASTC_8X8_UNORM: return GL_COMPRESSED_RGBA_ASTC_8x8_KHR;
+                default: break;
+            }
+
 #if OUZEL_SUPPORTS_OPENGLES
             if (openGLVersion >= 3)
             {
@@ -89,11 +148,10 @@ namespace ouzel
                 }
             }
 #else
-            OUZEL_UNUSED(openGLVersion);
-
             switch (pixelFormat)
             {
-                case PixelFormat::A8_UNORM: return GL_ALPHA8_EXT;
+                // alpha textures are not available in the core profile, they are stored in the red channel
+                case PixelFormat::A8_UNORM: return (openGLVersion >= 3) ? GL_R8 : GL_ALPHA8_EXT;
 
                 case PixelFormat::R8_UNORM: return GL_R8;
                 case PixelFormat::R8_SNORM: return GL_R8_SNORM;
@@ -130,12 +188,20 @@ namespace ouzel
 #endif
         }
 
-        static GLenum getOGLPixelFormat(PixelFormat pixelFormat)
+        static GLenum getOGLPixelFormat(PixelFormat pixelFormat, uint32_t openGLVersion)
         {
+#if OUZEL_SUPPORTS_OPENGLES
+            OUZEL_UNUSED(openGLVersion);
+#endif
+
             switch (pixelFormat)
             {
                 case PixelFormat::A8_UNORM:
+#if OUZEL_SUPPORTS_OPENGLES
                     return GL_ALPHA;
+#else
+                    return (openGLVersion >= 3) ? GL_RED : GL_ALPHA;
+#endif
                 case PixelFormat::R8_UNORM:
                 case PixelFormat::R8_SNORM:
                 case PixelFormat::R16_UNORM:
@@ -248,7 +314,7 @@ namespace ouzel
             {
                 if (!levels.empty())
                 {
-                    if (renderDeviceOGL.isTextureBaseLevelSupported()) glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
+                    if (renderDeviceOGL.isTextureBaseLevelSupported()) glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, static_cast<GLint>(baseLevel));
                     if (renderDeviceOGL.isTextureMaxLevelSupported()) glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<GLsizei>(levels.size()) - 1);
 
                     GLenum error;
@@ -295,7 +361,7 @@ namespace ouzel
             {
                 if (!levels.empty())
                 {
-                    if (renderDeviceOGL.isTextureBaseLevelSupported()) glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
+                    if (renderDeviceOGL.isTextureBaseLevelSupported()) glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, static_cast<GLint>(baseLevel));
                     if (renderDeviceOGL.isTextureMaxLevelSupported()) glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<GLsizei>(levels.size()) - 1);
 
                     GLenum error;
@@ -306,7 +372,15 @@ namespace ouzel
 
                 for (size_t level = 0; level < levels.size(); ++level)
                 {
-                    if (!levels[level].data.empty())
+                    if (isCompressed(pixelFormat))
+                    {
+                        glCompressedTexImage2DProc(GL_TEXTURE_2D, static_cast<GLint>(level), oglInternalPixelFormat,
+                                                   static_cast<GLsizei>(levels[level].size.width),
+                                                   static_cast<GLsizei>(levels[level].size.height), 0,
+                                                   static_cast<GLsizei>(levels[level].data.size()),
+                                                   levels[level].data.data());
+                    }
+                    else if (!levels[level].data.empty())
                     {
                         glTexImage2D(GL_TEXTURE_2D, static_cast<GLint>(level), static_cast<GLint>(oglInternalPixelFormat),
                                      static_cast<GLsizei>(levels[level].size.width),
@@ -350,7 +424,7 @@ namespace ouzel
             {
                 if (!levels.empty())
                 {
-                    if (renderDeviceOGL.isTextureBaseLevelSupported()) glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
+                    if (renderDeviceOGL.isTextureBaseLevelSupported()) glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, static_cast<GLint>(baseLevel));
                     if (renderDeviceOGL.isTextureMaxLevelSupported()) glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<GLsizei>(levels.size()) - 1);
 
                     GLenum error;
@@ -361,7 +435,15 @@ namespace ouzel
 
                 for (size_t level = 0; level < levels.size(); ++level)
                 {
-                    if (!levels[level].data.empty())
+                    if (isCompressed(pixelFormat))
+                    {
+                        glCompressedTexImage2DProc(GL_TEXTURE_2D, static_cast<GLint>(level), oglInternalPixelFormat,
+                                                   static_cast<GLsizei>(levels[level].size.width),
+                                                   static_cast<GLsizei>(levels[level].size.height), 0,
+                                                   static_cast<GLsizei>(levels[level].data.size()),
+                                                   levels[level].data.data());
+                    }
+                    else if (!levels[level].data.empty())
                     {
                         glTexImage2D(GL_TEXTURE_2D, static_cast<GLint>(level), static_cast<GLint>(oglInternalPixelFormat),
                                      static_cast<GLsizei>(levels[level].size.width),
@@ -403,7 +485,7 @@ namespace ouzel
             {
                 if (!levels.empty())
                 {
-                    if (renderDeviceOGL.isTextureBaseLevelSupported()) glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
+                    if (renderDeviceOGL.isTextureBaseLevelSupported()) glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, static_cast<GLint>(baseLevel));
                     if (renderDeviceOGL.isTextureMaxLevelSupported()) glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<GLsizei>(levels.size()) - 1);
 
                     GLenum error;
@@ -414,7 +496,15 @@ namespace ouzel
 
                 for (size_t level = 0; level < levels.size(); ++level)
                 {
-                    if (!levels[level].data.empty())
+                    if (isCompressed(pixelFormat))
+                    {
+                        glCompressedTexImage2DProc(GL_TEXTURE_2D, static_cast<GLint>(level), oglInternalPixelFormat,
+                                                   static_cast<GLsizei>(levels[level].size.width),
+                                                   static_cast<GLsizei>(levels[level].size.height), 0,
+                                                   static_cast<GLsizei>(levels[level].data.size()),
+                                                   levels[level].data.data());
+                    }
+                    else if (!levels[level].data.empty())
                     {
                         glTexImage2D(GL_TEXTURE_2D, static_cast<GLint>(level), static_cast<GLint>(oglInternalPixelFormat),
                                      static_cast<GLsizei>(levels[level].size.width),
@@ -489,7 +579,7 @@ namespace ouzel
                 {
                     if (!levels.empty())
                     {
-                        if (renderDeviceOGL.isTextureBaseLevelSupported()) glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
+                        if (renderDeviceOGL.isTextureBaseLevelSupported()) glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, static_cast<GLint>(baseLevel));
                         if (renderDeviceOGL.isTextureMaxLevelSupported()) glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<GLsizei>(levels.size()) - 1);
 
                         GLenum error;
@@ -536,7 +626,7 @@ namespace ouzel
 
                     if (!levels.empty())
                     {
-                        if (renderDeviceOGL.isTextureBaseLevelSupported()) glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
+                        if (renderDeviceOGL.isTextureBaseLevelSupported()) glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, static_cast<GLint>(baseLevel));
                         if (renderDeviceOGL.isTextureMaxLevelSupported()) glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<GLsizei>(levels.size()) - 1);
 
                         GLenum error;
@@ -589,6 +679,83 @@ namespace ouzel
             }
         }
 
+        void TextureResourceOGL::setRegionData(const std::vector<uint8_t>& newData,
+                                               uint32_t x, uint32_t y,
+                                               uint32_t regionWidth, uint32_t regionHeight)
+        {
+            TextureResource::setRegionData(newData, x, y, regionWidth, regionHeight);
+
+            if (!textureId)
+                throw DataError("Texture not initialized");
+
+            RenderDeviceOGL& renderDeviceOGL = static_cast<RenderDeviceOGL&>(renderDevice);
+            renderDeviceOGL.bindTexture(textureId, 0);
+
+            // the rows of the level data are tightly packed
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+            for (size_t level = 0; level < levels.size(); ++level)
+            {
+                uint32_t levelX = x;
+                uint32_t levelY = y;
+                uint32_t levelWidth = regionWidth;
+                uint32_t levelHeight = regionHeight;
+                getLevelRegion(level, levelX, levelY, levelWidth, levelHeight);
+
+                if (renderDeviceOGL.isUnpackRowLengthSupported())
+                {
+                    glPixelStorei(GL_UNPACK_ROW_LENGTH, static_cast<GLint>(levels[level].size.width));
+
+                    glTexSubImage2D(GL_TEXTURE_2D, static_cast<GLint>(level),
+                                    static_cast<GLint>(levelX), static_cast<GLint>(levelY),
+                                    static_cast<GLsizei>(levelWidth), static_cast<GLsizei>(levelHeight),
+                                    oglPixelFormat, oglPixelType,
+                                    levels[level].data.data() + levelY * levels[level].pitch + levelX * getPixelSize(pixelFormat));
+                }
+                else
+                {
+                    // the whole rows of the region are uploaded without the unpack row length
+                    glTexSubImage2D(GL_TEXTURE_2D, static_cast<GLint>(level),
+                                    0, static_cast<GLint>(levelY),
+                                    static_cast<GLsizei>(levels[level].size.width), static_cast<GLsizei>(levelHeight),
+                                    oglPixelFormat, oglPixelType,
+                                    levels[level].data.data() + levelY * levels[level].pitch);
+                }
+            }
+
+            if (renderDeviceOGL.isUnpackRowLengthSupported()) glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+            GLenum error;
+
+            if ((error = glGetError()) != GL_NO_ERROR)
+                throw DataError("Failed to upload texture region data, error: " + std::to_string(error));
+        }
+
+        void TextureResourceOGL::setLevelData(uint32_t level, const std::vector<uint8_t>& newData)
+        {
+            TextureResource::setLevelData(level, newData);
+
+            if (!textureId)
+                throw DataError("Texture not initialized");
+
+            RenderDeviceOGL& renderDeviceOGL = static_cast<RenderDeviceOGL&>(renderDevice);
+            renderDeviceOGL.bindTexture(textureId, 0);
+
+            glTexSubImage2D(GL_TEXTURE_2D, static_cast<GLint>(level), 0, 0,
+                            static_cast<GLsizei>(levels[level].size.width),
+                            static_cast<GLsizei>(levels[level].size.height),
+                            oglPixelFormat, oglPixelType,
+                            levels[level].data.data());
+
+            if (renderDeviceOGL.isTextureBaseLevelSupported()) glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, static_cast<GLint>(baseLevel));
+
+            GLenum error;
+
+            if ((error = glGetError()) != GL_NO_ERROR)
+                throw DataError("Failed to upload texture level data, error: " + std::to_string(error));
+        }
+
         void TextureResourceOGL::setFilter(Texture::Filter newFilter)
         {
             TextureResource::setFilter(newFilter);
@@ -796,15 +963,24 @@ namespace ouzel
             if (oglInternalPixelFormat == GL_NONE)
                 throw DataError("Invalid pixel format");
 
-            oglPixelFormat = getOGLPixelFormat(pixelFormat);
+            // compressed data is uploaded with glCompressedTexImage2D, which takes only the internal format
+            if (isCompressed(pixelFormat))
+            {
+                oglPixelFormat = GL_NONE;
+                oglPixelType = GL_NONE;
+            }
+            else
+            {
+                oglPixelFormat = getOGLPixelFormat(pixelFormat, renderDeviceOGL.getAPIMajorVersion());
 
-            if (oglPixelFormat == GL_NONE)
-                throw DataError("Invalid pixel format");
+                if (oglPixelFormat == GL_NONE)
+                    throw DataError("Invalid pixel format");
 
-            oglPixelType = getOGLPixelType(pixelFormat);
+                oglPixelType = getOGLPixelType(pixelFormat);
 
-            if (oglPixelType == GL_NONE)
-                throw DataError("Invalid pixel format");
+                if (oglPixelType == GL_NONE)
+                    throw DataError("Invalid pixel format");
+            }
 
             if ((flags & Texture::RENDER_TARGET) && renderDeviceOGL.isRenderTargetsSupported())
             {
@@ -973,6 +1149,20 @@ namespace ouzel
                 if ((error = glGetError()) != GL_NO_ERROR)
                     throw DataError("Failed to set texture max anisotrophy, error: " + std::to_string(error));
             }
+
+#if !OUZEL_SUPPORTS_OPENGLES
+            // the alpha textures stored in the red channel are sampled as (0, 0, 0, alpha)
+            if (pixelFormat == PixelFormat::A8_UNORM && renderDeviceOGL.getAPIMajorVersion() >= 3)
+            {
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_R, GL_ZERO);
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_G, GL_ZERO);
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_B, GL_ZERO);
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_A, GL_RED);
+
+                if ((error = glGetError()) != GL_NO_ERROR)
+                    throw DataError("Failed to set texture swizzle, error: " + std::to_string(error));
+            }
+#endif
         }
     } // namespace graphics
 } // namespace ouzel
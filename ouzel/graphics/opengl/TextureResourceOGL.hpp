@@ -51,6 +51,10 @@ namespace ouzel
 
             virtual void setSize(const Size2& newSize) override;
             virtual void setData(const std::vector<uint8_t>& newData, const Size2& newSize) override;
+            virtual void setRegionData(const std::vector<uint8_t>& newData,
+                                       uint32_t x, uint32_t y,
+                                       uint32_t regionWidth, uint32_t regionHeight) override;
+            virtual void setLevelData(uint32_t level, const std::vector<uint8_t>& newData) override;
             virtual void setFilter(Texture::Filter newFilter) override;
             virtual void setAddressX(Texture::Address newAddressX) override;
             virtual void setAddressY(Texture::Address newAddressY) override;
@@ -1,5 +1,6 @@
 // Copyright 2015-2018 Elviss Strazdins. All rights reserved.
 
+#include <algorithm>
 #include <string>
 #include <iterator>
 #include "BMFont.hpp"
@@ -10,6 +11,11 @@
 
 namespace ouzel
 {
+    static inline uint64_t getKerningKey(uint32_t first, uint32_t second)
+    {
+        return (static_cast<uint64_t>(first) << 32) | second;
+    }
+
     static inline bool isWhitespace(uint8_t c)
     {
         return c == ' ' || c == '\t';
@@ -343,21 +349,27 @@ namespace ouzel
                         }
                         else
                             value = parseString(data, iterator);
-
-                        kern[std::make_pair(first, second)] = amount;
                     }
+
+                    kern.push_back(std::make_pair(getKerningKey(first, second), amount));
                 }
                 else
                     skipLine(data, iterator);
             }
         }
+
+        // the kerning pairs are looked up with a binary search
+        std::stable_sort(kern.begin(), kern.end(), [](const std::pair<uint64_t, int16_t>& a,
+                                                      const std::pair<uint64_t, int16_t>& b) {
+            return a.first < b.first;
+        });
     }
 
     void BMFont::getVertices(const std::string& text,
                              const Color& color,
                              float fontSize,
                              const Vector2& anchor,
-                             std::vector<uint16_t>& indices,
+                             std::vector<uint32_t>& indices,
                              std::vector<graphics::Vertex>& vertices,
                              std::shared_ptr<graphics::Texture>& texture)
     {
@@ -383,7 +395,7 @@ namespace ouzel
             {
                 const CharDescriptor& f = iter->second;
 
-                uint16_t startIndex = static_cast<uint16_t>(vertices.size());
+                uint32_t startIndex = static_cast<uint32_t>(vertices.size());
                 indices.push_back(startIndex + 0);
                 indices.push_back(startIndex + 1);
                 indices.push_back(startIndex + 2);
@@ -447,9 +459,13 @@ namespace ouzel
 
     int16_t BMFont::getKerningPair(uint32_t first, uint32_t second)
     {
-        auto i = kern.find(std::make_pair(first, second));
+        uint64_t key = getKerningKey(first, second);
+
+        auto i = std::lower_bound(kern.begin(), kern.end(), key, [](const std::pair<uint64_t, int16_t>& pair, uint64_t k) {
+            return pair.first < k;
+        });
 
-        if (i != kern.end())
+        if (i != kern.end() && i->first == key)
             return i->second;
 
         return 0;
@@ -16,10 +16,12 @@ namespace ouzel
                                  const Color& color,
                                  float fontSize,
                                  const Vector2& anchor,
-                                 std::vector<uint16_t>& indices,
+                                 std::vector<uint32_t>& indices,
                                  std::vector<graphics::Vertex>& vertices,
                                  std::shared_ptr<graphics::Texture>& texture) override;
 
+        virtual float getLineHeight(float fontSize) const override { return lineHeight * fontSize; }
+
     private:
         int16_t getKerningPair(uint32_t, uint32_t);
         float getStringWidth(const std::string& text);
@@ -45,7 +47,7 @@ namespace ouzel
         uint16_t outline = 0;
         uint16_t kernCount = 0;
         std::unordered_map<uint32_t, CharDescriptor> chars;
-        std::map<std::pair<uint32_t, uint32_t>, int16_t> kern;
+        std::vector<std::pair<uint64_t, int16_t>> kern; // sorted by the pair of the characters
         std::shared_ptr<graphics::Texture> fontTexture;
     };
 }
@@ -9,6 +9,7 @@
 #include <unordered_map>
 #include <vector>
 #include "math/Color.hpp"
+#include "graphics/Shader.hpp"
 #include "graphics/Texture.hpp"
 #include "graphics/Vertex.hpp"
 
@@ -30,8 +31,14 @@ namespace ouzel
                                  const Color& color,
                                  float fontSize,
                                  const Vector2& anchor,
-                                 std::vector<uint16_t>& indices,
+                                 std::vector<uint32_t>& indices,
                                  std::vector<graphics::Vertex>& vertices,
                                  std::shared_ptr<graphics::Texture>& texture) = 0;
+
+        // distance between the tops of the lines in the vertices
+        virtual float getLineHeight(float fontSize) const = 0;
+
+        // shader for drawing the vertices, null for the default texture shader
+        virtual std::shared_ptr<graphics::Shader> getShader() const { return nullptr; }
     };
 }
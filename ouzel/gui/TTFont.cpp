@@ -1,25 +1,63 @@
 // Copyright 2015-2018 Elviss Strazdins. All rights reserved.
 
+#include <algorithm>
 #include <cassert>
 #define STB_TRUETYPE_IMPLEMENTATION
 #include "TTFont.hpp"
 #include "core/Engine.hpp"
+#include "assets/Cache.hpp"
+#include "math/MathUtils.hpp"
+#include "thread/Lock.hpp"
 #include "utils/Errors.hpp"
 #include "utils/Utils.hpp"
 
 namespace ouzel
 {
+    static const uint32_t SPACING = 2;
+    static const uint32_t MIN_ATLAS_SIZE = 256;
+    static const uint32_t MAX_ATLAS_SIZE = 2048;
+
+    // the distance fields are generated at this size and scaled for the other sizes
+    static const float SDF_FONT_SIZE = 48.0F;
+    static const int SDF_PADDING = 6;
+    static const unsigned char SDF_ON_EDGE = 128;
+    static const float SDF_DISTANCE_SCALE = static_cast<float>(SDF_ON_EDGE) / SDF_PADDING;
+
+    TTFont::GlyphAtlas::GlyphAtlas(uint32_t initWidth, uint32_t initHeight):
+        packer(initWidth, initHeight, SPACING),
+        data(initWidth * initHeight),
+        dirtyMinX(initWidth),
+        dirtyMinY(initHeight)
+    {
+    }
+
     TTFont::TTFont()
     {
     }
 
-    TTFont::TTFont(const std::vector<uint8_t>& initData, bool initMipmaps):
+    TTFont::TTFont(const std::vector<uint8_t>& initData, bool initMipmaps, bool initDistanceField):
         data(initData),
-        mipmaps(initMipmaps)
+        mipmaps(initMipmaps),
+        distanceField(initDistanceField)
     {
         if (!stbtt_InitFont(&font, data.data(), stbtt_GetFontOffsetForIndex(data.data(), 0)))
             throw ParseError("Failed to load font");
 
+        stbtt_GetFontVMetrics(&font, &ascent, &descent, &lineGap);
+
+        // the glyphs are uploaded as alpha textures if the renderer can draw them, otherwise they are expanded to RGBA
+        if (distanceField)
+        {
+            shader = engine->getCache()->getShader(graphics::SHADER_SDF);
+
+            if (!shader)
+                throw DataError("Distance field fonts are not supported by the renderer");
+        }
+        else
+            shader = engine->getCache()->getShader(graphics::SHADER_TEXT);
+
+        if (shader) pixelFormat = graphics::PixelFormat::A8_UNORM;
+
         loaded = true;
     }
 
@@ -27,114 +65,46 @@ namespace ouzel
                              const Color& color,
                              float fontSize,
                              const Vector2& anchor,
-                             std::vector<uint16_t>& indices,
+                             std::vector<uint32_t>& indices,
                              std::vector<graphics::Vertex>& vertices,
                              std::shared_ptr<graphics::Texture>& texture)
     {
         if (!loaded)
             throw DataError("Font not loaded");
 
-        static const uint32_t SPACING = 2;
-
-        struct CharDescriptor
-        {
-            uint16_t x = 0;
-            uint16_t y = 0;
-            uint16_t width = 0;
-            uint16_t height = 0;
-            Vector2 offset;
-            float advance = 0;
-            std::vector<uint8_t> bitmap;
-        };
-
-        std::unordered_map<uint32_t, CharDescriptor> chars;
+        Lock lock(atlasMutex);
 
         float s = stbtt_ScaleForPixelHeight(&font, fontSize);
 
         std::vector<uint32_t> utf32Text = utf8ToUtf32(text);
 
-        std::set<uint32_t> glyphs;
-        for (uint32_t i : utf32Text)
-            glyphs.insert(i);
+        // all the sizes of a distance field font share one atlas
+        float atlasFontSize = distanceField ? SDF_FONT_SIZE : fontSize;
+        float atlasScale = stbtt_ScaleForPixelHeight(&font, atlasFontSize);
+        float glyphScale = fontSize / atlasFontSize;
 
-        uint16_t width = 0;
-        uint16_t height = 0;
+        std::unique_ptr<GlyphAtlas>& atlas = atlases[atlasFontSize];
 
-        int ascent;
-        int descent;
-        int lineGap;
-        stbtt_GetFontVMetrics(&font, &ascent, &descent, &lineGap);
-
-        for (uint32_t c : glyphs)
-        {
-            int w;
-            int h;
-            int xoff;
-            int yoff;
-
-            if (int index = stbtt_FindGlyphIndex(&font, static_cast<int>(c)))
-            {
-                int advance;
-                int leftBearing;
-                stbtt_GetGlyphHMetrics(&font, index, &advance, &leftBearing);
-
-                CharDescriptor charDesc;
-
-                if (unsigned char* bitmap = stbtt_GetGlyphBitmapSubpixel(&font, s, s, 0.0F, 0.0F, index, &w, &h, &xoff, &yoff))
-                {
-                    charDesc.width = static_cast<uint16_t>(w);
-                    charDesc.height = static_cast<uint16_t>(h);
-                    charDesc.offset.x = static_cast<float>(leftBearing * s);
-                    charDesc.offset.y = static_cast<float>(yoff + (ascent - descent) * s);
-                    charDesc.bitmap = std::vector<uint8_t>(bitmap, bitmap + h * w);
-                    charDesc.x = width;
+        // room for about 16 x 16 glyphs
+        uint32_t glyphSize = static_cast<uint32_t>(atlasFontSize) + (distanceField ? 2 * SDF_PADDING : 0);
+        uint32_t atlasSize = std::min(std::max(nextPOT(glyphSize * 16), MIN_ATLAS_SIZE), MAX_ATLAS_SIZE);
 
-                    width += static_cast<uint16_t>(w);
-                    height = height > static_cast<uint16_t>(h) ? height : static_cast<uint16_t>(h);
+        if (!atlas) atlas.reset(new GlyphAtlas(atlasSize, atlasSize));
 
-                    stbtt_FreeBitmap(bitmap, nullptr);
-                }
-
-                charDesc.advance = static_cast<float>(advance * s);
-
-                if (!chars.empty())
-                    width += SPACING;
-
-                chars[c] = charDesc;
-            }
-        }
-
-        std::vector<uint8_t> textureData(width * height * 4);
-
-        for (uint16_t posX = 0; posX < width; ++posX)
-        {
-            for (uint16_t posY = 0; posY < height; ++posY)
-            {
-                textureData[(posY * width + posX) * 4 + 0] = 255;
-                textureData[(posY * width + posX) * 4 + 1] = 255;
-                textureData[(posY * width + posX) * 4 + 2] = 255;
-                textureData[(posY * width + posX) * 4 + 3] = 0;
-            }
-        }
-
-        for (auto& c : chars)
+        if (!addGlyphs(*atlas, utf32Text, atlasScale))
         {
-            CharDescriptor& charDesc = c.second;
+            // the full atlas is replaced, the text that was already built keeps the texture of the old one
+            atlas.reset(new GlyphAtlas(atlasSize, atlasSize));
 
-            for (uint16_t posX = 0; posX < charDesc.width; ++posX)
-            {
-                for (uint16_t posY = 0; posY < charDesc.height; ++posY)
-                {
-                    textureData[(posY * width + posX + charDesc.x) * 4 + 0] = 255;
-                    textureData[(posY * width + posX + charDesc.x) * 4 + 1] = 255;
-                    textureData[(posY * width + posX + charDesc.x) * 4 + 2] = 255;
-                    textureData[(posY * width + posX + charDesc.x) * 4 + 3] = charDesc.bitmap[posY * charDesc.width + posX];
-                }
-            }
+            if (!addGlyphs(*atlas, utf32Text, atlasScale))
+                throw DataError("Glyphs do not fit in the font atlas");
         }
 
-        texture = std::make_shared<graphics::Texture>(*engine->getRenderer());
-        texture->init(textureData, Size2(width, height), 0, mipmaps ? 0 : 1);
+        uploadAtlas(*atlas);
+        texture = atlas->texture;
+
+        float width = static_cast<float>(atlas->packer.getWidth());
+        float height = static_cast<float>(atlas->packer.getHeight());
 
         Vector2 position;
 
@@ -150,13 +120,13 @@ namespace ouzel
 
         for (auto i = utf32Text.begin(); i != utf32Text.end(); ++i)
         {
-            auto iter = chars.find(*i);
+            auto iter = atlas->glyphs.find(*i);
 
-            if (iter != chars.end())
+            if (iter != atlas->glyphs.end())
             {
-                const CharDescriptor& f = iter->second;
+                const Glyph& f = iter->second;
 
-                uint16_t startIndex = static_cast<uint16_t>(vertices.size());
+                uint32_t startIndex = static_cast<uint32_t>(vertices.size());
                 indices.push_back(startIndex + 0);
                 indices.push_back(startIndex + 1);
                 indices.push_back(startIndex + 2);
@@ -165,24 +135,29 @@ namespace ouzel
                 indices.push_back(startIndex + 3);
                 indices.push_back(startIndex + 2);
 
-                Vector2 leftTop(f.x / static_cast<float>(width),
-                                f.y / static_cast<float>(height));
+                Vector2 leftTop(f.x / width,
+                                f.y / height);
 
-                Vector2 rightBottom((f.x + f.width) / static_cast<float>(width),
-                                    (f.y + f.height) / static_cast<float>(height));
+                Vector2 rightBottom((f.x + f.width) / width,
+                                    (f.y + f.height) / height);
 
                 textCoords[0] = Vector2(leftTop.x, rightBottom.y);
                 textCoords[1] = Vector2(rightBottom.x, rightBottom.y);
                 textCoords[2] = Vector2(leftTop.x, leftTop.y);
                 textCoords[3] = Vector2(rightBottom.x, leftTop.y);
 
-                vertices.push_back(graphics::Vertex(Vector3(position.x + f.offset.x, -position.y - f.offset.y - f.height, 0.0F),
+                float left = position.x + f.offset.x * glyphScale;
+                float right = left + f.width * glyphScale;
+                float top = -position.y - f.offset.y * glyphScale;
+                float bottom = top - f.height * glyphScale;
+
+                vertices.push_back(graphics::Vertex(Vector3(left, bottom, 0.0F),
                                                     color, textCoords[0], Vector3(0.0F, 0.0F, -1.0F)));
-                vertices.push_back(graphics::Vertex(Vector3(position.x + f.offset.x + f.width, -position.y - f.offset.y - f.height, 0.0F),
+                vertices.push_back(graphics::Vertex(Vector3(right, bottom, 0.0F),
                                                     color, textCoords[1], Vector3(0.0F, 0.0F, -1.0F)));
-                vertices.push_back(graphics::Vertex(Vector3(position.x + f.offset.x, -position.y - f.offset.y, 0.0F),
+                vertices.push_back(graphics::Vertex(Vector3(left, top, 0.0F),
                                                     color, textCoords[2], Vector3(0.0F, 0.0F, -1.0F)));
-                vertices.push_back(graphics::Vertex(Vector3(position.x + f.offset.x + f.width, -position.y - f.offset.y, 0.0F),
+                vertices.push_back(graphics::Vertex(Vector3(right, top, 0.0F),
                                                     color, textCoords[3], Vector3(0.0F, 0.0F, -1.0F)));
 
                 if ((i + 1) != utf32Text.end())
@@ -193,7 +168,7 @@ namespace ouzel
                     position.x += static_cast<float>(kernAdvance) * s;
                 }
 
-                position.x += f.advance;
+                position.x += f.advance * glyphScale;
             }
 
             if (*i == static_cast<uint32_t>('\n') || // line feed
@@ -215,4 +190,146 @@ namespace ouzel
         for (size_t c = 0; c < vertices.size(); ++c)
             vertices[c].position.y += textHeight * (1.0F - anchor.y);
     }
+
+    bool TTFont::addGlyphs(GlyphAtlas& atlas, const std::vector<uint32_t>& utf32Text, float scale)
+    {
+        uint32_t atlasWidth = atlas.packer.getWidth();
+
+        for (uint32_t c : utf32Text)
+        {
+            if (atlas.glyphs.find(c) != atlas.glyphs.end()) continue;
+
+            int index = stbtt_FindGlyphIndex(&font, static_cast<int>(c));
+            if (!index) continue;
+
+            int advance;
+            int leftBearing;
+            stbtt_GetGlyphHMetrics(&font, index, &advance, &leftBearing);
+
+            Glyph glyph;
+            glyph.advance = static_cast<float>(advance * scale);
+
+            int w;
+            int h;
+            int xoff;
+            int yoff;
+
+            unsigned char* bitmap = distanceField ?
+                stbtt_GetGlyphSDF(&font, scale, index, SDF_PADDING, SDF_ON_EDGE, SDF_DISTANCE_SCALE, &w, &h, &xoff, &yoff) :
+                stbtt_GetGlyphBitmapSubpixel(&font, scale, scale, 0.0F, 0.0F, index, &w, &h, &xoff, &yoff);
+
+            if (bitmap)
+            {
+                uint32_t x;
+                uint32_t y;
+
+                if (!atlas.packer.insert(static_cast<uint32_t>(w), static_cast<uint32_t>(h), x, y))
+                {
+                    freeBitmap(bitmap);
+                    return false;
+                }
+
+                glyph.x = static_cast<uint16_t>(x);
+                glyph.y = static_cast<uint16_t>(y);
+                glyph.width = static_cast<uint16_t>(w);
+                glyph.height = static_cast<uint16_t>(h);
+                // the distance field includes the padding around the glyph
+                glyph.offset.x = distanceField ? static_cast<float>(xoff) : static_cast<float>(leftBearing * scale);
+                glyph.offset.y = static_cast<float>(yoff + (ascent - descent) * scale);
+
+                for (uint32_t row = 0; row < glyph.height; ++row)
+                    std::copy(bitmap + row * glyph.width,
+                              bitmap + (row + 1) * glyph.width,
+                              atlas.data.begin() + (y + row) * atlasWidth + x);
+
+                freeBitmap(bitmap);
+
+                atlas.dirtyMinX = std::min(atlas.dirtyMinX, x);
+                atlas.dirtyMinY = std::min(atlas.dirtyMinY, y);
+                atlas.dirtyMaxX = std::max(atlas.dirtyMaxX, x + glyph.width);
+                atlas.dirtyMaxY = std::max(atlas.dirtyMaxY, y + glyph.height);
+            }
+
+            atlas.glyphs[c] = glyph;
+        }
+
+        return true;
+    }
+
+    void TTFont::freeBitmap(unsigned char* bitmap)
+    {
+        if (distanceField)
+            stbtt_FreeSDF(bitmap, nullptr);
+        else
+            stbtt_FreeBitmap(bitmap, nullptr);
+    }
+
+    void TTFont::uploadAtlas(GlyphAtlas& atlas)
+    {
+        uint32_t atlasWidth = atlas.packer.getWidth();
+        uint32_t atlasHeight = atlas.packer.getHeight();
+
+        uint32_t pixelSize = graphics::getPixelSize(pixelFormat);
+
+        if (!atlas.texture)
+        {
+            std::vector<uint8_t> textureData;
+
+            if (pixelFormat == graphics::PixelFormat::A8_UNORM)
+                textureData = atlas.data;
+            else
+            {
+                textureData.resize(atlas.data.size() * pixelSize);
+
+                for (size_t i = 0; i < atlas.data.size(); ++i)
+                {
+                    textureData[i * 4 + 0] = 255;
+                    textureData[i * 4 + 1] = 255;
+                    textureData[i * 4 + 2] = 255;
+                    textureData[i * 4 + 3] = atlas.data[i];
+                }
+            }
+
+            atlas.texture = std::make_shared<graphics::Texture>(*engine->getRenderer());
+            atlas.texture->init(textureData, Size2(static_cast<float>(atlasWidth), static_cast<float>(atlasHeight)),
+                                graphics::Texture::DYNAMIC, mipmaps ? 0 : 1, pixelFormat);
+
+            // the distances between the texels are interpolated when the glyphs are scaled up
+            if (distanceField) atlas.texture->setFilter(graphics::Texture::Filter::BILINEAR);
+        }
+        else if (atlas.dirtyMinX < atlas.dirtyMaxX && atlas.dirtyMinY < atlas.dirtyMaxY)
+        {
+            // only the rectangle of the new glyphs is uploaded
+            uint32_t regionWidth = atlas.dirtyMaxX - atlas.dirtyMinX;
+            uint32_t regionHeight = atlas.dirtyMaxY - atlas.dirtyMinY;
+
+            std::vector<uint8_t> regionData(regionWidth * regionHeight * pixelSize);
+
+            for (uint32_t y = 0; y < regionHeight; ++y)
+            {
+                const uint8_t* source = atlas.data.data() + (atlas.dirtyMinY + y) * atlasWidth + atlas.dirtyMinX;
+                uint8_t* destination = regionData.data() + y * regionWidth * pixelSize;
+
+                if (pixelFormat == graphics::PixelFormat::A8_UNORM)
+                    std::copy(source, source + regionWidth, destination);
+                else
+                {
+                    for (uint32_t x = 0; x < regionWidth; ++x)
+                    {
+                        destination[x * 4 + 0] = 255;
+                        destination[x * 4 + 1] = 255;
+                        destination[x * 4 + 2] = 255;
+                        destination[x * 4 + 3] = source[x];
+                    }
+                }
+            }
+
+            atlas.texture->setRegionData(regionData, atlas.dirtyMinX, atlas.dirtyMinY, regionWidth, regionHeight);
+        }
+
+        atlas.dirtyMinX = atlasWidth;
+        atlas.dirtyMinY = atlasHeight;
+        atlas.dirtyMaxX = 0;
+        atlas.dirtyMaxY = 0;
+    }
 }
@@ -2,8 +2,14 @@
 
 #pragma once
 
+#include <map>
+#include <memory>
+#include <unordered_map>
 #include "stb_truetype.h"
 #include "gui/Font.hpp"
+#include "graphics/AtlasPacker.hpp"
+#include "graphics/PixelFormat.hpp"
+#include "thread/Mutex.hpp"
 
 namespace ouzel
 {
@@ -11,23 +17,73 @@ namespace ouzel
     {
     public:
         TTFont();
-        TTFont(const std::vector<uint8_t>& newData, bool newMipmaps = true);
+        // distance field fonts rasterize the glyphs once for all the font sizes
+        TTFont(const std::vector<uint8_t>& newData, bool newMipmaps = true, bool newDistanceField = false);
 
         virtual void getVertices(const std::string& text,
                                  const Color& color,
                                  float fontSize,
                                  const Vector2& anchor,
-                                 std::vector<uint16_t>& indices,
+                                 std::vector<uint32_t>& indices,
                                  std::vector<graphics::Vertex>& vertices,
                                  std::shared_ptr<graphics::Texture>& texture) override;
 
+        virtual float getLineHeight(float fontSize) const override { return fontSize + lineGap; }
+        virtual std::shared_ptr<graphics::Shader> getShader() const override { return shader; }
+
+        inline bool isDistanceField() const { return distanceField; }
+
     private:
+        // in the pixels of the atlas
+        struct Glyph
+        {
+            uint16_t x = 0;
+            uint16_t y = 0;
+            uint16_t width = 0;
+            uint16_t height = 0;
+            Vector2 offset;
+            float advance = 0.0F;
+        };
+
+        // glyphs of one font size, rasterized once and kept in a single channel page
+        struct GlyphAtlas
+        {
+            GlyphAtlas(uint32_t initWidth, uint32_t initHeight);
+
+            graphics::AtlasPacker packer;
+            std::vector<uint8_t> data;
+            std::unordered_map<uint32_t, Glyph> glyphs;
+            std::shared_ptr<graphics::Texture> texture;
+
+            // rectangle that was changed since the last upload
+            uint32_t dirtyMinX;
+            uint32_t dirtyMinY;
+            uint32_t dirtyMaxX = 0;
+            uint32_t dirtyMaxY = 0;
+        };
+
+        // returns false if the glyphs do not fit in the atlas
+        bool addGlyphs(GlyphAtlas& atlas, const std::vector<uint32_t>& utf32Text, float scale);
+        void freeBitmap(unsigned char* bitmap);
+        void uploadAtlas(GlyphAtlas& atlas);
+
         int16_t getKerningPair(uint32_t, uint32_t);
         float getStringWidth(const std::string& text);
 
         bool loaded = false;
         bool mipmaps = true;
+        bool distanceField = false;
         stbtt_fontinfo font;
         std::vector<unsigned char> data;
+        int ascent = 0;
+        int descent = 0;
+        int lineGap = 0;
+
+        // the text of the layers recorded in parallel can be laid out with the same font
+        Mutex atlasMutex;
+        std::map<float, std::unique_ptr<GlyphAtlas>> atlases;
+        // the text or distance field shader if the glyphs are uploaded as alpha textures, null if they are expanded to RGBA
+        std::shared_ptr<graphics::Shader> shader;
+        graphics::PixelFormat pixelFormat = graphics::PixelFormat::RGBA8_UNORM;
     };
 }
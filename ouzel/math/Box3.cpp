@@ -31,13 +31,13 @@ namespace ouzel
         // Left-top-front
         dst[3].set(min.x, max.y, min.z);
         // Left-bottom-back
-        dst[0].set(min.x, min.y, max.z);
+        dst[4].set(min.x, min.y, max.z);
         // Right-bottom-back
-        dst[1].set(max.x, min.y, max.z);
+        dst[5].set(max.x, min.y, max.z);
         // Right-top-back
-        dst[2].set(max.x, max.y, max.z);
+        dst[6].set(max.x, max.y, max.z);
         // Left-top-back
-        dst[3].set(min.x, max.y, max.z);
+        dst[7].set(min.x, max.y, max.z);
     }
 
     void Box3::merge(const Box3& box)
@@ -50,6 +50,6 @@ namespace ouzel
         // Calculate the new maximum point
         max.x = std::max(max.x, box.max.x);
         max.y = std::max(max.y, box.max.y);
-        max.z = std::max(max.y, box.max.z);
+        max.z = std::max(max.z, box.max.z);
     }
 }
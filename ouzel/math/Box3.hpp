@@ -127,5 +127,15 @@ namespace ouzel
         {
             return Size3(max.x - min.x, max.y - min.y, max.z - min.z);
         }
+
+        inline bool operator==(const Box3& box) const
+        {
+            return min == box.min && max == box.max;
+        }
+
+        inline bool operator!=(const Box3& box) const
+        {
+            return min != box.min || max != box.max;
+        }
     };
 }
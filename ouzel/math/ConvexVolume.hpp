@@ -12,6 +12,13 @@ namespace ouzel
     class ConvexVolume
     {
     public:
+        enum class Intersection
+        {
+            OUTSIDE,
+            INTERSECTS,
+            INSIDE
+        };
+
         ConvexVolume()
         {
         }
@@ -21,7 +28,7 @@ namespace ouzel
         {
         }
 
-        bool isPointInside(const Vector4& position)
+        bool isPointInside(const Vector4& position) const
         {
             for (const Plane& plane : planes)
             {
@@ -32,7 +39,7 @@ namespace ouzel
             return true;
         }
 
-        bool isSphereInside(const Vector4& position, float radius)
+        bool isSphereInside(const Vector4& position, float radius) const
         {
             for (const Plane& plane : planes)
             {
@@ -43,7 +50,7 @@ namespace ouzel
             return true;
         }
 
-        bool isBoxInside(const Box3& box)
+        bool isBoxInside(const Box3& box) const
         {
             for (const Plane& plane : planes)
             {
@@ -77,6 +84,33 @@ namespace ouzel
             return true;
         }
 
+        Intersection classifyBox(const Box3& box) const
+        {
+            Intersection result = Intersection::INSIDE;
+
+            for (const Plane& plane : planes)
+            {
+                // test only the corners that are the farthest along and against the normal of the plane
+                Vector4 positiveCorner(plane.a >= 0.0F ? box.max.x : box.min.x,
+                                       plane.b >= 0.0F ? box.max.y : box.min.y,
+                                       plane.c >= 0.0F ? box.max.z : box.min.z,
+                                       1.0F);
+
+                if (plane.dot(positiveCorner) < 0.0F)
+                    return Intersection::OUTSIDE;
+
+                Vector4 negativeCorner(plane.a >= 0.0F ? box.min.x : box.max.x,
+                                       plane.b >= 0.0F ? box.min.y : box.max.y,
+                                       plane.c >= 0.0F ? box.min.z : box.max.z,
+                                       1.0F);
+
+                if (plane.dot(negativeCorner) < 0.0F)
+                    result = Intersection::INTERSECTS;
+            }
+
+            return result;
+        }
+
         std::vector<Plane> planes;
     };
 }
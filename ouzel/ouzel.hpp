@@ -16,8 +16,10 @@
 #include "assets/Loader.hpp"
 #include "assets/LoaderBMF.hpp"
 #include "assets/LoaderCollada.hpp"
+#include "assets/LoaderDDS.hpp"
 #include "assets/LoaderGLTF.hpp"
 #include "assets/LoaderImage.hpp"
+#include "assets/LoaderKTX.hpp"
 #include "assets/LoaderMTL.hpp"
 #include "assets/LoaderOBJ.hpp"
 #include "assets/LoaderParticleSystem.hpp"
@@ -44,10 +46,14 @@
 #include "files/Archive.hpp"
 #include "files/File.hpp"
 #include "files/FileSystem.hpp"
+#include "graphics/AtlasPacker.hpp"
 #include "graphics/BlendState.hpp"
 #include "graphics/BlendStateResource.hpp"
 #include "graphics/ImageData.hpp"
+#include "graphics/ImageDataDDS.hpp"
+#include "graphics/ImageDataKTX.hpp"
 #include "graphics/ImageDataSTB.hpp"
+#include "graphics/ImageDownsample.hpp"
 #include "graphics/Buffer.hpp"
 #include "graphics/BufferResource.hpp"
 #include "graphics/Material.hpp"
@@ -57,7 +63,9 @@
 #include "graphics/Shader.hpp"
 #include "graphics/ShaderResource.hpp"
 #include "graphics/Texture.hpp"
+#include "graphics/TextureAtlas.hpp"
 #include "graphics/TextureResource.hpp"
+#include "graphics/TextureStreamer.hpp"
 #include "graphics/Vertex.hpp"
 #include "gui/BMFont.hpp"
 #include "gui/Button.hpp"
@@ -109,11 +117,15 @@
 #include "scene/Scene.hpp"
 #include "scene/SceneManager.hpp"
 #include "scene/ShapeRenderer.hpp"
+#include "scene/SpatialIndex.hpp"
 #include "scene/Sprite.hpp"
+#include "scene/SpriteBatch.hpp"
 #include "scene/SpriteData.hpp"
 #include "scene/TextRenderer.hpp"
+#include "scene/TransformSystem.hpp"
 #include "scene/UpdateCallback.hpp"
 #include "thread/Condition.hpp"
+#include "thread/JobSystem.hpp"
 #include "thread/Lock.hpp"
 #include "thread/Mutex.hpp"
 #include "thread/Thread.hpp"
@@ -122,5 +134,6 @@
 #include "utils/JSON.hpp"
 #include "utils/Log.hpp"
 #include "utils/OBF.hpp"
+#include "utils/Profiler.hpp"
 #include "utils/Utils.hpp"
 #include "utils/XML.hpp"
@@ -1,6 +1,7 @@
 // Copyright 2015-2018 Elviss Strazdins. All rights reserved.
 
 #include <cassert>
+#include <cmath>
 #include <algorithm>
 #include "Actor.hpp"
 #include "core/Engine.hpp"
@@ -9,6 +10,7 @@
 #include "Camera.hpp"
 #include "math/MathUtils.hpp"
 #include "Component.hpp"
+#include "thread/Lock.hpp"
 
 namespace ouzel
 {
@@ -33,31 +35,9 @@ namespace ouzel
                           int32_t parentOrder,
                           bool parentHidden)
         {
-            worldOrder = parentOrder + order;
-            worldHidden = parentHidden || hidden;
-
-            if (parentTransformDirty) updateTransform(newParentTransform);
-            if (transformDirty) calculateTransform();
-
-            if (!worldHidden)
-            {
-                Box3 boundingBox = getBoundingBox();
-
-                if (cullDisabled || (!boundingBox.isEmpty() && camera->checkVisibility(getTransform(), boundingBox)))
-                {
-                    auto upperBound = std::upper_bound(drawQueue.begin(), drawQueue.end(), this,
-                                                       [](Actor* a, Actor* b) {
-                                                           return a->worldOrder > b->worldOrder;
-                                                       });
-
-                    drawQueue.insert(upperBound, this);
-                }
-            }
-
-            for (Actor* actor : children)
-                actor->visit(drawQueue, transform, updateChildrenTransform, camera, worldOrder, worldHidden);
-
-            updateChildrenTransform = false;
+            uint32_t nextTraversalIndex = 0;
+            updateWorld(newParentTransform, parentTransformDirty, parentOrder, parentHidden, nextTraversalIndex);
+            cull(drawQueue, camera->getFrustum(), false);
         }
 
         void Actor::draw(Camera* camera, bool wireframe)
@@ -65,10 +45,21 @@ namespace ouzel
             if (transformDirty)
                 calculateTransform();
 
+            SpriteBatch* spriteBatch = (!wireframe && layer) ? layer->getSpriteBatch() : nullptr;
+
             for (Component* component : components)
             {
                 if (!component->isHidden())
                 {
+                    if (spriteBatch)
+                    {
+                        if (component->batch(*spriteBatch, transform, opacity))
+                            continue;
+
+                        // keep the draw order of the non-batched components
+                        spriteBatch->flush();
+                    }
+
                     component->draw(transform,
                                     opacity,
                                     camera->getRenderViewProjection(),
@@ -160,6 +151,13 @@ namespace ouzel
             updateLocalTransform();
         }
 
+        void Actor::setPickable(bool newPickable)
+        {
+            pickable = newPickable;
+
+            invalidateSpatialIndex();
+        }
+
         void Actor::setHidden(bool newHidden)
         {
             hidden = newHidden;
@@ -204,17 +202,136 @@ namespace ouzel
 
         void Actor::updateLocalTransform()
         {
-            localTransformDirty = transformDirty = inverseTransformDirty = true;
+            if (transformSystem)
+                transformSystem->setLocalTransform(transformHandle, position, rotation,
+                                                   Vector3(scale.x * (flipX ? -1.0F : 1.0F),
+                                                           scale.y * (flipY ? -1.0F : 1.0F),
+                                                           scale.z));
+
+            localTransformDirty = transformDirty = inverseTransformDirty = boundingBoxDirty = true;
             for (Component* component : components)
                 component->updateTransform();
+            invalidateSpatialIndex();
         }
 
         void Actor::updateTransform(const Matrix4& newParentTransform)
         {
             parentTransform = newParentTransform;
-            transformDirty = inverseTransformDirty = true;
+            transformDirty = inverseTransformDirty = boundingBoxDirty = true;
             for (Component* component : components)
                 component->updateTransform();
+            invalidateSpatialIndex();
+        }
+
+        static Box3 transformBox(const Matrix4& matrix, const Box3& box)
+        {
+            if (box.isEmpty()) return box;
+
+            Vector3 center((box.min.x + box.max.x) / 2.0F,
+                           (box.min.y + box.max.y) / 2.0F,
+                           (box.min.z + box.max.z) / 2.0F);
+            Vector3 extent((box.max.x - box.min.x) / 2.0F,
+                           (box.max.y - box.min.y) / 2.0F,
+                           (box.max.z - box.min.z) / 2.0F);
+
+            matrix.transformPoint(center);
+
+            Vector3 worldExtent(fabsf(matrix.m[0]) * extent.x + fabsf(matrix.m[4]) * extent.y + fabsf(matrix.m[8]) * extent.z,
+                                fabsf(matrix.m[1]) * extent.x + fabsf(matrix.m[5]) * extent.y + fabsf(matrix.m[9]) * extent.z,
+                                fabsf(matrix.m[2]) * extent.x + fabsf(matrix.m[6]) * extent.y + fabsf(matrix.m[10]) * extent.z);
+
+            return Box3(center - worldExtent, center + worldExtent);
+        }
+
+        void Actor::updateWorld(const Matrix4& newParentTransform,
+                                bool parentTransformDirty,
+                                int32_t parentOrder,
+                                bool parentHidden,
+                                uint32_t& nextTraversalIndex)
+        {
+            worldOrder = parentOrder + order;
+            worldHidden = parentHidden || hidden;
+            traversalIndex = nextTraversalIndex++;
+
+            // the transform system propagates the parent transforms itself
+            if (parentTransformDirty && !transformSystem) updateTransform(newParentTransform);
+            if (transformDirty) calculateTransform();
+
+            Box3 newLocalBoundingBox = getBoundingBox();
+
+            if (boundingBoxDirty || newLocalBoundingBox != localBoundingBox)
+            {
+                // the components might have changed their bounding boxes
+                if (!boundingBoxDirty) invalidateSpatialIndex();
+
+                localBoundingBox = newLocalBoundingBox;
+                worldBoundingBox = transformBox(transform, localBoundingBox);
+                boundingBoxDirty = false;
+            }
+
+            subtreeBoundingBox = worldBoundingBox;
+            subtreeCullDisabled = cullDisabled;
+
+            for (Actor* actor : children)
+            {
+                actor->updateWorld(transform, updateChildrenTransform, worldOrder, worldHidden, nextTraversalIndex);
+
+                if (!actor->worldHidden)
+                {
+                    subtreeBoundingBox.merge(actor->subtreeBoundingBox);
+                    subtreeCullDisabled = subtreeCullDisabled || actor->subtreeCullDisabled;
+                }
+            }
+
+            updateChildrenTransform = false;
+        }
+
+        void Actor::cull(std::vector<Actor*>& drawQueue, const ConvexVolume& frustum, bool parentInside)
+        {
+            // the descendants of hidden actors are hidden too
+            if (worldHidden) return;
+
+            bool inside = parentInside;
+
+            if (!inside && !subtreeCullDisabled)
+            {
+                if (subtreeBoundingBox.isEmpty()) return;
+
+                ConvexVolume::Intersection intersection = frustum.classifyBox(subtreeBoundingBox);
+
+                if (intersection == ConvexVolume::Intersection::OUTSIDE) return;
+                inside = (intersection == ConvexVolume::Intersection::INSIDE);
+            }
+
+            if (cullDisabled ||
+                (!worldBoundingBox.isEmpty() &&
+                 (inside || frustum.classifyBox(worldBoundingBox) != ConvexVolume::Intersection::OUTSIDE)))
+                drawQueue.push_back(this);
+
+            for (Actor* actor : children)
+                actor->cull(drawQueue, frustum, inside);
+        }
+
+        void Actor::invalidateSpatialIndex()
+        {
+            if (layer && layer->isSpatialIndexEnabled() && !spatialIndexDirty)
+            {
+                spatialIndexDirty = true;
+
+                Lock lock(layer->dirtyActorsMutex);
+                layer->dirtyActors.push_back(this);
+            }
+        }
+
+        Box3 Actor::calculatePickingBoundingBox() const
+        {
+            // hidden components can be picked too
+            Box3 boundingBox;
+
+            for (Component* component : components)
+                boundingBox.merge(component->getBoundingBox());
+
+            return transformBox(getTransform(), boundingBox);
         }
 
         Vector3 Actor::getWorldPosition() const
@@ -245,27 +362,58 @@ namespace ouzel
             return worldPosition;
         }
 
-        void Actor::calculateLocalTransform() const
+        void Actor::composeLocalTransform(Matrix4& result) const
         {
-            localTransform.setIdentity();
-            localTransform.translate(position);
+            result.setIdentity();
+            result.translate(position);
 
             Matrix4 rotationMatrix;
             rotationMatrix.setRotation(rotation);
 
-            localTransform *= rotationMatrix;
+            result *= rotationMatrix;
 
             Vector3 finalScale = Vector3(scale.x * (flipX ? -1.0F : 1.0F),
                                          scale.y * (flipY ? -1.0F : 1.0F),
                                          scale.z);
 
-            localTransform.scale(finalScale);
+            result.scale(finalScale);
+        }
+
+        void Actor::calculateLocalTransform() const
+        {
+            composeLocalTransform(localTransform);
 
             localTransformDirty = false;
         }
 
         void Actor::calculateTransform() const
         {
+            if (transformSystem)
+            {
+                // only the chain of this actor is calculated without changing the ancestors, the transform system
+                // updates the whole layer in SceneManager::updateTransforms and Layer::draw, so the getters can be
+                // called from the parallel update callbacks
+                Matrix4 chainTransform = getLocalTransform();
+
+                // the parent is either an actor in the same transform system or the layer
+                for (const Actor* ancestor = (parent && parent != layer) ? static_cast<const Actor*>(parent) : nullptr;
+                     ancestor;
+                     ancestor = (ancestor->parent && ancestor->parent != layer) ? static_cast<const Actor*>(ancestor->parent) : nullptr)
+                {
+                    Matrix4 ancestorLocalTransform;
+                    if (ancestor->localTransformDirty)
+                        ancestor->composeLocalTransform(ancestorLocalTransform);
+                    else
+                        ancestorLocalTransform = ancestor->localTransform;
+
+                    chainTransform = ancestorLocalTransform * chainTransform;
+                }
+
+                transform = chainTransform;
+                transformDirty = false;
+                return;
+            }
+
             transform = parentTransform * getLocalTransform();
             transformDirty = false;
 
@@ -279,6 +427,41 @@ namespace ouzel
             inverseTransformDirty = false;
         }
 
+        void Actor::addToTransformSystem(TransformSystem* newTransformSystem)
+        {
+            // the parent is either an actor in the same transform system or the layer
+            Actor* parentActor = (parent && parent != layer) ? static_cast<Actor*>(parent) : nullptr;
+
+            assert(!parentActor || parentActor->transformSystem == newTransformSystem);
+
+            transformSystem = newTransformSystem;
+            transformHandle = transformSystem->addActor(this, parentActor ? parentActor->transformHandle : TransformSystem::INVALID_HANDLE);
+
+            updateLocalTransform();
+        }
+
+        void Actor::removeFromTransformSystem()
+        {
+            if (transformSystem)
+            {
+                transformSystem->removeActor(transformHandle);
+                transformSystem = nullptr;
+                transformHandle = TransformSystem::INVALID_HANDLE;
+            }
+        }
+
+        void Actor::setWorldTransform(const Matrix4& newTransform)
+        {
+            transform = newTransform;
+            transformDirty = false;
+            inverseTransformDirty = boundingBoxDirty = true;
+
+            for (Component* component : components)
+                component->updateTransform();
+
+            invalidateSpatialIndex();
+        }
+
         void Actor::removeFromParent()
         {
             if (parent) parent->removeChild(this);
@@ -293,6 +476,8 @@ namespace ouzel
 
             component->setActor(this);
             components.push_back(component);
+
+            invalidateSpatialIndex();
         }
 
         bool Actor::removeComponent(Component* component)
@@ -306,6 +491,8 @@ namespace ouzel
                 component->setActor(nullptr);
                 components.erase(componentIterator);
                 result = true;
+
+                invalidateSpatialIndex();
             }
 
             auto ownedIterator = std::find_if(ownedComponents.begin(), ownedComponents.end(), [component](const std::unique_ptr<Component>& other) {
@@ -322,14 +509,31 @@ namespace ouzel
         {
             components.clear();
             ownedComponents.clear();
+
+            invalidateSpatialIndex();
         }
 
         void Actor::setLayer(Layer* newLayer)
         {
+            if (layer && layer != newLayer)
+            {
+                layer->removeFromSpatialIndex(this);
+                removeFromTransformSystem();
+            }
+
+            // the parent is added to the transform system before its children
+            if (newLayer && newLayer != layer && newLayer->transformSystem)
+            {
+                layer = newLayer;
+                addToTransformSystem(newLayer->transformSystem.get());
+            }
+
             ActorContainer::setLayer(newLayer);
 
             for (Component* component : components)
                 component->setLayer(newLayer);
+
+            invalidateSpatialIndex();
         }
 
         std::vector<Component*> Actor::getComponents(uint32_t cls) const
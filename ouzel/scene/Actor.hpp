@@ -5,10 +5,13 @@
 #include "scene/ActorContainer.hpp"
 #include "math/Box3.hpp"
 #include "math/Color.hpp"
+#include "math/ConvexVolume.hpp"
 #include "math/Matrix4.hpp"
 #include "math/Quaternion.hpp"
 #include "math/Vector2.hpp"
 #include "math/Vector3.hpp"
+#include "scene/SpatialIndex.hpp"
+#include "scene/TransformSystem.hpp"
 #include "scene/UpdateCallback.hpp"
 
 namespace ouzel
@@ -23,6 +26,7 @@ namespace ouzel
         {
             friend ActorContainer;
             friend Layer;
+            friend TransformSystem;
         public:
             Actor();
             virtual ~Actor();
@@ -60,7 +64,7 @@ namespace ouzel
             virtual void setFlipY(bool newFlipY);
             virtual bool getFlipY() const { return flipY; }
 
-            virtual void setPickable(bool newPickable) { pickable = newPickable; }
+            virtual void setPickable(bool newPickable);
             virtual bool isPickable() const { return pickable; }
 
             virtual bool isCullDisabled() const { return cullDisabled; }
@@ -103,6 +107,7 @@ namespace ouzel
             inline ActorContainer* getParent() const { return parent; }
             void removeFromParent();
 
+            using ActorContainer::addChild;
             virtual void addChild(Actor* actor) override;
 
             void addComponent(Component* component);
@@ -137,11 +142,31 @@ namespace ouzel
             void updateLocalTransform();
             void updateTransform(const Matrix4& newParentTransform);
 
+            // updates the transforms, the world order and visibility and the world space bounding boxes of the subtree
+            void updateWorld(const Matrix4& newParentTransform,
+                             bool parentTransformDirty,
+                             int32_t parentOrder,
+                             bool parentHidden,
+                             uint32_t& nextTraversalIndex);
+            // adds the visible actors of the subtree to the draw queue, skips the subtrees outside of the frustum and
+            // stops testing the subtrees that are entirely inside of it
+            void cull(std::vector<Actor*>& drawQueue, const ConvexVolume& frustum, bool parentInside);
+
+            void invalidateSpatialIndex();
+            // world space bounding box of all the components that is used by the spatial index of the layer
+            Box3 calculatePickingBoundingBox() const;
+
+            void composeLocalTransform(Matrix4& result) const;
             virtual void calculateLocalTransform() const;
             virtual void calculateTransform() const;
 
             virtual void calculateInverseTransform() const;
 
+            void addToTransformSystem(TransformSystem* newTransformSystem);
+            void removeFromTransformSystem();
+            // called by the transform system after it has calculated the new world transform
+            void setWorldTransform(const Matrix4& newTransform);
+
             Matrix4 parentTransform;
             mutable Matrix4 transform;
             mutable Matrix4 inverseTransform;
@@ -151,6 +176,19 @@ namespace ouzel
             mutable bool inverseTransformDirty = true;
             mutable bool localTransformDirty = true;
             mutable bool updateChildrenTransform = true;
+            bool boundingBoxDirty = true;
+
+            Box3 localBoundingBox;
+            Box3 worldBoundingBox;
+            Box3 subtreeBoundingBox; // world space bounding box of the actor and its visible descendants
+            bool subtreeCullDisabled = false;
+            uint32_t traversalIndex = 0; // position of the actor in the draw order of the actors with the same world order
+
+            TransformSystem* transformSystem = nullptr; // set if the transform is stored in the transform system of the layer
+            uint32_t transformHandle = TransformSystem::INVALID_HANDLE;
+
+            int32_t spatialIndexNode = SpatialIndex::NULL_NODE;
+            bool spatialIndexDirty = false;
 
             bool flipX = false;
             bool flipY = false;
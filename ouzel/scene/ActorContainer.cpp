@@ -96,6 +96,7 @@ namespace ouzel
             {
                 if (entered) actor->leave();
                 actor->parent = nullptr;
+                actor->setLayer(nullptr);
             }
 
             children.clear();
@@ -166,6 +166,13 @@ namespace ouzel
             return inverseViewProjection;
         }
 
+        const ConvexVolume& Camera::getFrustum() const
+        {
+            if (viewProjectionDirty) calculateViewProjection();
+
+            return frustum;
+        }
+
         void Camera::calculateViewProjection() const
         {
             if (actor)
@@ -174,6 +181,12 @@ namespace ouzel
 
                 renderViewProjection = engine->getRenderer()->getDevice()->getProjectionTransform(renderTarget != nullptr) * viewProjection;
 
+                frustum = viewProjection.getFrustum();
+
+                // 2D content is not culled by its depth
+                if (projectionMode == ProjectionMode::ORTHOGRAPHIC)
+                    frustum.planes.resize(4);
+
                 viewProjectionDirty = false;
             }
         }
@@ -4,6 +4,7 @@
 
 #include <memory>
 #include "scene/Component.hpp"
+#include "math/ConvexVolume.hpp"
 #include "math/MathUtils.hpp"
 #include "math/Rect.hpp"
 #include "graphics/Texture.hpp"
@@ -63,6 +64,8 @@ namespace ouzel
             Vector2 convertWorldToNormalized(const Vector3& worldPosition) const;
 
             bool checkVisibility(const Matrix4& boxTransform, const Box3& box) const;
+            // planes of the view frustum in world space (orthographic cameras ignore the depth)
+            const ConvexVolume& getFrustum() const;
 
             void setViewport(const Rect& newViewport);
             inline const Rect& getViewport() const { return viewport; }
@@ -119,6 +122,7 @@ namespace ouzel
             mutable bool viewProjectionDirty = true;
             mutable Matrix4 viewProjection;
             mutable Matrix4 renderViewProjection;
+            mutable ConvexVolume frustum;
 
             mutable bool inverseViewProjectionDirty = true;
             mutable Matrix4 inverseViewProjection;
@@ -25,6 +25,13 @@ namespace ouzel
         {
         }
 
+        bool Component::batch(SpriteBatch&,
+                              const Matrix4&,
+                              float)
+        {
+            return false;
+        }
+
         bool Component::pointOn(const Vector2& position) const
         {
             return boundingBox.containsPoint(position);
@@ -17,6 +17,7 @@ namespace ouzel
         class Camera;
         class Actor;
         class Layer;
+        class SpriteBatch;
 
         class Component
         {
@@ -53,6 +54,11 @@ namespace ouzel
                               const Matrix4& renderViewProjection,
                               bool wireframe);
 
+            // returns true if the component was added to the sprite batch and does not need to be drawn
+            virtual bool batch(SpriteBatch& spriteBatch,
+                               const Matrix4& transformMatrix,
+                               float opacity);
+
             virtual void setBoundingBox(const Box3& newBoundingBox) { boundingBox = newBoundingBox; }
             virtual const Box3& getBoundingBox() const { return boundingBox; }
 
@@ -2,6 +2,7 @@
 
 #include <cassert>
 #include <algorithm>
+#include <chrono>
 #include "Layer.hpp"
 #include "core/Engine.hpp"
 #include "Actor.hpp"
@@ -10,6 +11,7 @@
 #include "Scene.hpp"
 #include "math/Matrix4.hpp"
 #include "Component.hpp"
+#include "utils/Profiler.hpp"
 
 namespace ouzel
 {
@@ -23,32 +25,107 @@ namespace ouzel
         Layer::~Layer()
         {
             if (scene) scene->removeLayer(this);
+
+            // detach the actors while the spatial index and the transform system still exist
+            for (Actor* actor : children)
+                actor->setLayer(nullptr);
         }
 
         void Layer::draw()
         {
+            ProfilerZone zone("Layer::draw");
+
+            spriteBatch.reset();
+
+            std::chrono::steady_clock::time_point visitStartTime = std::chrono::steady_clock::now();
+
+            if (transformSystem) transformSystem->update();
+
+            std::chrono::steady_clock::duration visitDuration = std::chrono::steady_clock::now() - visitStartTime;
+
             for (Camera* camera : cameras)
             {
-                std::vector<Actor*> drawQueue;
+                visitStartTime = std::chrono::steady_clock::now();
+
+                drawQueue.clear();
+
+                uint32_t nextTraversalIndex = 0;
 
                 for (Actor* actor : children)
-                    actor->visit(drawQueue, Matrix4::identity(), false, camera, 0, false);
+                {
+                    actor->updateWorld(Matrix4::identity(), false, 0, false, nextTraversalIndex);
+                    actor->cull(drawQueue, camera->getFrustum(), false);
+                }
+
+                sortDrawQueue();
+
+                visitDuration += std::chrono::steady_clock::now() - visitStartTime;
 
                 engine->getRenderer()->setRenderTarget(camera->getRenderTarget());
                 engine->getRenderer()->setViewport(camera->getRenderViewport());
                 engine->getRenderer()->setDepthState(camera->getDepthTest(), camera->getDepthWrite());
 
+                spriteBatch.begin(camera->getRenderViewProjection());
+
                 for (Actor* actor : drawQueue)
                 {
                     actor->draw(camera, false);
 
                     if (camera->getWireframe())
                     {
+                        spriteBatch.flush();
                         engine->getRenderer()->setFillMode(graphics::Renderer::FillMode::WIREFRAME);
                         actor->draw(camera, true);
                         engine->getRenderer()->setFillMode(graphics::Renderer::FillMode::SOLID);
                     }
                 }
+
+                spriteBatch.end();
+            }
+
+            visitTime = std::chrono::duration_cast<std::chrono::nanoseconds>(visitDuration).count() / 1000000000.0F;
+        }
+
+        void Layer::sortDrawQueue()
+        {
+            if (drawQueue.empty()) return;
+
+            // stable LSD radix sort by the descending world order, the keys are flipped so that the highest order comes first
+            drawKeys.resize(drawQueue.size());
+            sortedDrawKeys.resize(drawQueue.size());
+            sortedDrawQueue.resize(drawQueue.size());
+
+            for (size_t i = 0; i < drawQueue.size(); ++i)
+                drawKeys[i] = ~(static_cast<uint32_t>(drawQueue[i]->worldOrder) ^ 0x80000000U);
+
+            for (uint32_t shift = 0; shift < 32; shift += 8)
+            {
+                uint32_t offsets[256] = {0};
+
+                for (uint32_t key : drawKeys)
+                    ++offsets[(key >> shift) & 0xFF];
+
+                // skip the digits that are the same for all the keys
+                if (offsets[(drawKeys[0] >> shift) & 0xFF] == drawKeys.size())
+                    continue;
+
+                uint32_t offset = 0;
+                for (uint32_t& bucketOffset : offsets)
+                {
+                    uint32_t count = bucketOffset;
+                    bucketOffset = offset;
+                    offset += count;
+                }
+
+                for (size_t i = 0; i < drawKeys.size(); ++i)
+                {
+                    uint32_t position = offsets[(drawKeys[i] >> shift) & 0xFF]++;
+                    sortedDrawKeys[position] = drawKeys[i];
+                    sortedDrawQueue[position] = drawQueue[i];
+                }
+
+                drawKeys.swap(sortedDrawKeys);
+                drawQueue.swap(sortedDrawQueue);
             }
         }
 
@@ -102,7 +179,10 @@ namespace ouzel
 
                     Vector2 worldPosition = camera->convertNormalizedToWorld(position);
 
-                    findActors(worldPosition, actors);
+                    if (spatialIndexEnabled)
+                        queryActors(worldPosition, actors);
+                    else
+                        findActors(worldPosition, actors);
 
                     if (!actors.empty()) return actors.front();
                 }
@@ -124,7 +204,11 @@ namespace ouzel
                     Vector2 worldPosition = camera->convertNormalizedToWorld(position);
 
                     std::vector<std::pair<Actor*, ouzel::Vector3>> actors;
-                    findActors(worldPosition, actors);
+
+                    if (spatialIndexEnabled)
+                        queryActors(worldPosition, actors);
+                    else
+                        findActors(worldPosition, actors);
 
                     result.insert(result.end(), actors.begin(), actors.end());
                 }
@@ -150,7 +234,11 @@ namespace ouzel
                         worldEdges.push_back(camera->convertNormalizedToWorld(edge));
 
                     std::vector<Actor*> actors;
-                    findActors(worldEdges, actors);
+
+                    if (spatialIndexEnabled)
+                        queryActors(worldEdges, actors);
+                    else
+                        findActors(worldEdges, actors);
 
                     result.insert(result.end(), actors.begin(), actors.end());
                 }
@@ -159,6 +247,184 @@ namespace ouzel
             return result;
         }
 
+        void Layer::setSpatialIndexEnabled(bool newSpatialIndexEnabled)
+        {
+            if (spatialIndexEnabled == newSpatialIndexEnabled) return;
+
+            spatialIndexEnabled = newSpatialIndexEnabled;
+
+            spatialIndex.clear();
+            dirtyActors.clear();
+
+            std::vector<Actor*> actors(children.begin(), children.end());
+
+            while (!actors.empty())
+            {
+                Actor* actor = actors.back();
+                actors.pop_back();
+
+                actor->spatialIndexNode = SpatialIndex::NULL_NODE;
+                actor->spatialIndexDirty = false;
+                actor->invalidateSpatialIndex();
+
+                actors.insert(actors.end(), actor->children.begin(), actor->children.end());
+            }
+        }
+
+        void Layer::setTransformSystemEnabled(bool newTransformSystemEnabled)
+        {
+            if (isTransformSystemEnabled() == newTransformSystemEnabled) return;
+
+            // visit the parents before their children
+            std::vector<Actor*> actors;
+            for (auto i = children.rbegin(); i != children.rend(); ++i)
+                actors.push_back(*i);
+
+            if (newTransformSystemEnabled)
+            {
+                transformSystem.reset(new TransformSystem());
+
+                while (!actors.empty())
+                {
+                    Actor* actor = actors.back();
+                    actors.pop_back();
+
+                    actor->addToTransformSystem(transformSystem.get());
+
+                    for (auto i = actor->children.rbegin(); i != actor->children.rend(); ++i)
+                        actors.push_back(*i);
+                }
+            }
+            else
+            {
+                transformSystem->update();
+
+                while (!actors.empty())
+                {
+                    Actor* actor = actors.back();
+                    actors.pop_back();
+
+                    actor->removeFromTransformSystem();
+
+                    // the parent has already left the transform system, so its transform is calculated by itself
+                    Actor* parentActor = (actor->parent != this) ? static_cast<Actor*>(actor->parent) : nullptr;
+                    actor->updateTransform(parentActor ? parentActor->getTransform() : Matrix4::identity());
+
+                    for (auto i = actor->children.rbegin(); i != actor->children.rend(); ++i)
+                        actors.push_back(*i);
+                }
+
+                transformSystem.reset();
+            }
+        }
+
+        void Layer::removeFromSpatialIndex(Actor* actor)
+        {
+            if (actor->spatialIndexNode != SpatialIndex::NULL_NODE)
+            {
+                spatialIndex.remove(actor->spatialIndexNode);
+                actor->spatialIndexNode = SpatialIndex::NULL_NODE;
+            }
+
+            if (actor->spatialIndexDirty)
+            {
+                auto i = std::find(dirtyActors.begin(), dirtyActors.end(), actor);
+                if (i != dirtyActors.end()) dirtyActors.erase(i);
+                actor->spatialIndexDirty = false;
+            }
+        }
+
+        void Layer::updateSpatialIndex() const
+        {
+            for (Actor* actor : dirtyActors)
+            {
+                actor->spatialIndexDirty = false;
+
+                Box3 boundingBox = actor->pickable ? actor->calculatePickingBoundingBox() : Box3();
+
+                if (!boundingBox.isEmpty())
+                {
+                    Box2 box(Vector2(boundingBox.min.x, boundingBox.min.y),
+                             Vector2(boundingBox.max.x, boundingBox.max.y));
+
+                    if (actor->spatialIndexNode == SpatialIndex::NULL_NODE)
+                        actor->spatialIndexNode = spatialIndex.insert(actor, box);
+                    else
+                        spatialIndex.update(actor->spatialIndexNode, box);
+                }
+                else if (actor->spatialIndexNode != SpatialIndex::NULL_NODE)
+                {
+                    spatialIndex.remove(actor->spatialIndexNode);
+                    actor->spatialIndexNode = SpatialIndex::NULL_NODE;
+                }
+            }
+
+            dirtyActors.clear();
+        }
+
+        // returns true if neither the actor nor any of its ancestors is hidden
+        static bool isActorVisible(const Actor* actor)
+        {
+            for (;;)
+            {
+                if (actor->isHidden()) return false;
+
+                ActorContainer* parent = actor->getParent();
+                if (!parent || parent == actor->getLayer()) return true;
+
+                actor = static_cast<const Actor*>(parent);
+            }
+        }
+
+        // the topmost actors come first, which are the ones with the lowest world order that are drawn last
+        bool Layer::isActorAbove(const Actor* a, const Actor* b)
+        {
+            return (a->getWorldOrder() == b->getWorldOrder()) ?
+                a->traversalIndex > b->traversalIndex :
+                a->getWorldOrder() < b->getWorldOrder();
+        }
+
+        void Layer::queryActors(const Vector2& position, std::vector<std::pair<Actor*, Vector3>>& actors) const
+        {
+            updateSpatialIndex();
+
+            candidates.clear();
+            spatialIndex.query(position, candidates);
+
+            for (Actor* actor : candidates)
+            {
+                if (actor->isPickable() && isActorVisible(actor) && actor->pointOn(position))
+                    actors.push_back(std::make_pair(actor, actor->convertWorldToLocal(position)));
+            }
+
+            std::sort(actors.begin(), actors.end(), [](const std::pair<Actor*, Vector3>& a,
+                                                       const std::pair<Actor*, Vector3>& b) {
+                return isActorAbove(a.first, b.first);
+            });
+        }
+
+        void Layer::queryActors(const std::vector<Vector2>& edges, std::vector<Actor*>& actors) const
+        {
+            if (edges.empty()) return;
+
+            updateSpatialIndex();
+
+            Box2 box;
+            for (const Vector2& edge : edges)
+                box.insertPoint(edge);
+
+            candidates.clear();
+            spatialIndex.query(box, candidates);
+
+            for (Actor* actor : candidates)
+            {
+                if (actor->isPickable() && isActorVisible(actor) && actor->shapeOverlaps(edges))
+                    actors.push_back(actor);
+            }
+
+            std::sort(actors.begin(), actors.end(), isActorAbove);
+        }
+
         void Layer::setOrder(int32_t newOrder)
         {
             order = newOrder;
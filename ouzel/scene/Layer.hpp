@@ -3,9 +3,15 @@
 #pragma once
 
 #include <cstdint>
+#include <memory>
 #include <vector>
 #include "scene/ActorContainer.hpp"
+#include "graphics/CommandBuffer.hpp"
+#include "scene/SpatialIndex.hpp"
+#include "scene/SpriteBatch.hpp"
+#include "scene/TransformSystem.hpp"
 #include "math/Vector2.hpp"
+#include "thread/Mutex.hpp"
 
 namespace ouzel
 {
@@ -18,6 +24,7 @@ namespace ouzel
         class Layer: public ActorContainer
         {
             friend Scene;
+            friend Actor;
             friend Camera;
             friend Light;
         public:
@@ -26,6 +33,7 @@ namespace ouzel
 
             virtual void draw();
 
+            using ActorContainer::addChild;
             virtual void addChild(Actor* actor) override;
 
             inline const std::vector<Camera*>& getCameras() const { return cameras; }
@@ -37,6 +45,25 @@ namespace ouzel
             inline int32_t getOrder() const { return order; }
             void setOrder(int32_t newOrder);
 
+            // keeps the bounding boxes of the pickable actors in a bounding volume tree to speed up the picking
+            void setSpatialIndexEnabled(bool newSpatialIndexEnabled);
+            inline bool isSpatialIndexEnabled() const { return spatialIndexEnabled; }
+
+            // stores the transforms of the actors in the transform system that updates them in one pass before drawing
+            void setTransformSystemEnabled(bool newTransformSystemEnabled);
+            inline bool isTransformSystemEnabled() const { return transformSystem != nullptr; }
+            inline TransformSystem* getTransformSystem() const { return transformSystem.get(); }
+
+            inline bool isBatching() const { return batching; }
+            inline void setBatching(bool newBatching) { batching = newBatching; }
+
+            inline SpriteBatch* getSpriteBatch() { return (batching && spriteBatch.isActive()) ? &spriteBatch : nullptr; }
+            inline uint32_t getBatchDrawCount() const { return spriteBatch.getDrawCount(); }
+            inline uint32_t getBatchedCount() const { return spriteBatch.getBatchedCount(); }
+
+            // time (in seconds) spent updating, culling and sorting the actors in the last draw
+            inline float getVisitTime() const { return visitTime; }
+
             inline Scene* getScene() const { return scene; }
             void removeFromScene();
 
@@ -50,12 +77,40 @@ namespace ouzel
             virtual void recalculateProjection();
             virtual void enter() override;
 
+            void sortDrawQueue();
+
+            void removeFromSpatialIndex(Actor* actor);
+            void updateSpatialIndex() const;
+            void queryActors(const Vector2& position, std::vector<std::pair<Actor*, Vector3>>& actors) const;
+            void queryActors(const std::vector<Vector2>& edges, std::vector<Actor*>& actors) const;
+            static bool isActorAbove(const Actor* a, const Actor* b);
+
             Scene* scene = nullptr;
 
             std::vector<Camera*> cameras;
             std::vector<Light*> lights;
 
             int32_t order = 0;
+
+            std::vector<Actor*> drawQueue;
+            std::vector<Actor*> sortedDrawQueue;
+            std::vector<uint32_t> drawKeys;
+            std::vector<uint32_t> sortedDrawKeys;
+            float visitTime = 0.0F;
+
+            std::unique_ptr<TransformSystem> transformSystem;
+
+            bool spatialIndexEnabled = false;
+            mutable SpatialIndex spatialIndex;
+            mutable std::vector<Actor*> dirtyActors; // actors whose bounding boxes have to be updated in the spatial index
+            Mutex dirtyActorsMutex; // actors can be moved by parallel update callbacks
+            mutable std::vector<Actor*> candidates;
+
+            SpriteBatch spriteBatch;
+            bool batching = true;
+
+            // commands recorded by the layer when the scene is drawn in parallel
+            graphics::CommandBuffer commandBuffer;
         };
     } // namespace scene
 } // namespace ouzel
@@ -2,6 +2,7 @@
 
 #include "MeshRenderer.hpp"
 #include "core/Engine.hpp"
+#include "SpriteBatch.hpp"
 
 namespace ouzel
 {
@@ -11,16 +12,18 @@ namespace ouzel
             Component(CLASS)
         {
             whitePixelTexture = engine->getCache()->getTexture(graphics::TEXTURE_WHITE_PIXEL);
+            textureShader = engine->getCache()->getShader(graphics::SHADER_TEXTURE);
+            instancedShader = engine->getCache()->getShader(graphics::SHADER_INSTANCED);
         }
 
         MeshRenderer::MeshRenderer(const MeshData& meshData):
-            Component(CLASS)
+            MeshRenderer()
         {
             init(meshData);
         }
 
         MeshRenderer::MeshRenderer(const std::string& filename, bool mipmaps):
-            Component(CLASS)
+            MeshRenderer()
         {
             init(filename, mipmaps);
         }
@@ -55,12 +58,6 @@ namespace ouzel
             Matrix4 modelViewProj = renderViewProjection * transformMatrix;
             float colorVector[] = {material->diffuseColor.normR(), material->diffuseColor.normG(), material->diffuseColor.normB(), material->diffuseColor.normA() * opacity * material->opacity};
 
-            std::vector<std::vector<float>> fragmentShaderConstants(1);
-            fragmentShaderConstants[0] = {std::begin(colorVector), std::end(colorVector)};
-
-            std::vector<std::vector<float>> vertexShaderConstants(1);
-            vertexShaderConstants[0] = {std::begin(modelViewProj.m), std::end(modelViewProj.m)};
-
             std::vector<std::shared_ptr<graphics::Texture>> textures;
             if (wireframe) textures.push_back(whitePixelTexture);
             else textures.assign(std::begin(material->textures), std::end(material->textures));
@@ -68,8 +65,10 @@ namespace ouzel
             engine->getRenderer()->setCullMode(material->cullMode);
             engine->getRenderer()->setPipelineState(material->blendState,
                                                     material->shader);
-            engine->getRenderer()->setShaderConstants(fragmentShaderConstants,
-                                                      vertexShaderConstants);
+            engine->getRenderer()->setShaderConstants(colorVector,
+                                                      sizeof(colorVector) / sizeof(float),
+                                                      modelViewProj.m,
+                                                      sizeof(modelViewProj.m) / sizeof(float));
             engine->getRenderer()->setTextures(textures);
             engine->getRenderer()->draw(indexBuffer,
                                         indexCount,
@@ -78,5 +77,26 @@ namespace ouzel
                                         graphics::Renderer::DrawMode::TRIANGLE_LIST,
                                         0);
         }
+
+        bool MeshRenderer::batch(SpriteBatch& spriteBatch,
+                                 const Matrix4& transformMatrix,
+                                 float opacity)
+        {
+            // the instanced shader is registered only if the render device supports instancing
+            if (!material || !indexBuffer || !vertexBuffer || !instancedShader ||
+                material->shader != textureShader)
+                return false;
+
+            material->cullMode = graphics::Renderer::CullMode::NONE;
+
+            return spriteBatch.addInstance(*material,
+                                           opacity,
+                                           transformMatrix,
+                                           instancedShader,
+                                           indexBuffer,
+                                           indexCount,
+                                           indexSize,
+                                           vertexBuffer);
+        }
     } // namespace scene
 } // namespace ouzel
@@ -26,6 +26,11 @@ namespace ouzel
                               const Matrix4& renderViewProjection,
                               bool wireframe) override;
 
+            // meshes drawn with the default texture shader are batched into instanced draw calls
+            virtual bool batch(SpriteBatch& spriteBatch,
+                               const Matrix4& transformMatrix,
+                               float opacity) override;
+
             virtual const std::shared_ptr<graphics::Material>& getMaterial() const { return material; }
             virtual void setMaterial(const std::shared_ptr<graphics::Material>& newMaterial) { material = newMaterial; }
 
@@ -37,6 +42,8 @@ namespace ouzel
             std::shared_ptr<graphics::Buffer> vertexBuffer;
 
             std::shared_ptr<graphics::Texture> whitePixelTexture;
+            std::shared_ptr<graphics::Shader> textureShader;
+            std::shared_ptr<graphics::Shader> instancedShader;
         };
     } // namespace scene
 } // namespace ouzel
@@ -1,7 +1,13 @@
 // Copyright 2015-2018 Elviss Strazdins. All rights reserved.
 
+#include <algorithm>
 #include <cstdlib>
 #include "core/Setup.h"
+#if OUZEL_SUPPORTS_NEON
+#include <arm_neon.h>
+#elif OUZEL_SUPPORTS_SSE
+#include <xmmintrin.h>
+#endif
 #include "ParticleSystem.hpp"
 #include "core/Engine.hpp"
 #include "SceneManager.hpp"
@@ -18,10 +24,302 @@ namespace ouzel
 {
     namespace scene
     {
+        static const float UPDATE_STEP = 1.0F / 60.0F;
+        // number of particles whose vertices can be addressed with 16-bit indices
+        static const uint32_t MAX_CHUNK_PARTICLES = 65536 / 4;
+        // the GPU simulation time is moved back to zero after this many seconds to keep the float precision
+        static const float MAX_SIMULATION_TIME = 1024.0F;
+
+        // direction += (gravity + radial + tangential) * step, position += direction * step
+        static void integrateGravity(float* positionX, float* positionY,
+                                     float* directionX, float* directionY,
+                                     const float* radialAcceleration, const float* tangentialAcceleration,
+                                     uint32_t count, const Vector2& gravity, float yCoordFlipped, float step)
+        {
+            uint32_t i = 0;
+
+            // the radial direction is the normalized position of the particles that lie on one of the axes, the same as
+            // with Vector2::normalize in the scalar loop
+#if OUZEL_SUPPORTS_NEON && OUZEL_64BITS
+#  if OUZEL_SUPPORTS_NEON_CHECK
+            if (anrdoidNEONChecker.isNEONAvailable())
+#  endif
+            {
+                const float32x4_t zero = vdupq_n_f32(0.0F);
+                const float32x4_t one = vdupq_n_f32(1.0F);
+                const float32x4_t epsilon = vdupq_n_f32(EPSILON);
+                const float32x4_t gravityX = vdupq_n_f32(gravity.x);
+                const float32x4_t gravityY = vdupq_n_f32(gravity.y);
+                const float32x4_t steps = vdupq_n_f32(step);
+                const float32x4_t flip = vdupq_n_f32(yCoordFlipped);
+
+                for (; i + 4 <= count; i += 4)
+                {
+                    float32x4_t x = vld1q_f32(positionX + i);
+                    float32x4_t y = vld1q_f32(positionY + i);
+
+                    uint32x4_t onAxis = vorrq_u32(vceqq_f32(x, zero), vceqq_f32(y, zero));
+                    float32x4_t lengthSquared = vaddq_f32(vmulq_f32(x, x), vmulq_f32(y, y));
+                    float32x4_t length = vsqrtq_f32(lengthSquared);
+                    uint32x4_t keep = vorrq_u32(vceqq_f32(lengthSquared, one), vcltq_f32(length, epsilon));
+                    float32x4_t scale = vbslq_f32(keep, one, vdivq_f32(one, length));
+
+                    float32x4_t radialX = vbslq_f32(onAxis, vmulq_f32(x, scale), zero);
+                    float32x4_t radialY = vbslq_f32(onAxis, vmulq_f32(y, scale), zero);
+
+                    float32x4_t radial = vld1q_f32(radialAcceleration + i);
+                    float32x4_t tangential = vld1q_f32(tangentialAcceleration + i);
+
+                    float32x4_t accelerationX = vaddq_f32(vaddq_f32(vmulq_f32(radialX, radial), vmulq_f32(radialY, vnegq_f32(tangential))), gravityX);
+                    float32x4_t accelerationY = vaddq_f32(vaddq_f32(vmulq_f32(radialY, radial), vmulq_f32(radialX, tangential)), gravityY);
+
+                    float32x4_t dirX = vaddq_f32(vld1q_f32(directionX + i), vmulq_f32(accelerationX, steps));
+                    float32x4_t dirY = vaddq_f32(vld1q_f32(directionY + i), vmulq_f32(accelerationY, steps));
+                    vst1q_f32(directionX + i, dirX);
+                    vst1q_f32(directionY + i, dirY);
+
+                    vst1q_f32(positionX + i, vaddq_f32(x, vmulq_f32(vmulq_f32(dirX, steps), flip)));
+                    vst1q_f32(positionY + i, vaddq_f32(y, vmulq_f32(vmulq_f32(dirY, steps), flip)));
+                }
+            }
+#elif OUZEL_SUPPORTS_SSE
+            const __m128 zero = _mm_setzero_ps();
+            const __m128 one = _mm_set1_ps(1.0F);
+            const __m128 epsilon = _mm_set1_ps(EPSILON);
+            const __m128 gravityX = _mm_set1_ps(gravity.x);
+            const __m128 gravityY = _mm_set1_ps(gravity.y);
+            const __m128 steps = _mm_set1_ps(step);
+            const __m128 flip = _mm_set1_ps(yCoordFlipped);
+            const __m128 signMask = _mm_set1_ps(-0.0F);
+
+            for (; i + 4 <= count; i += 4)
+            {
+                __m128 x = _mm_loadu_ps(positionX + i);
+                __m128 y = _mm_loadu_ps(positionY + i);
+
+                __m128 onAxis = _mm_or_ps(_mm_cmpeq_ps(x, zero), _mm_cmpeq_ps(y, zero));
+                __m128 lengthSquared = _mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y));
+                __m128 length = _mm_sqrt_ps(lengthSquared);
+                __m128 keep = _mm_or_ps(_mm_cmpeq_ps(lengthSquared, one), _mm_cmplt_ps(length, epsilon));
+                __m128 scale = _mm_or_ps(_mm_and_ps(keep, one), _mm_andnot_ps(keep, _mm_div_ps(one, length)));
+
+                __m128 radialX = _mm_and_ps(onAxis, _mm_mul_ps(x, scale));
+                __m128 radialY = _mm_and_ps(onAxis, _mm_mul_ps(y, scale));
+
+                __m128 radial = _mm_loadu_ps(radialAcceleration + i);
+                __m128 tangential = _mm_loadu_ps(tangentialAcceleration + i);
+
+                __m128 accelerationX = _mm_add_ps(_mm_add_ps(_mm_mul_ps(radialX, radial), _mm_mul_ps(radialY, _mm_xor_ps(tangential, signMask))), gravityX);
+                __m128 accelerationY = _mm_add_ps(_mm_add_ps(_mm_mul_ps(radialY, radial), _mm_mul_ps(radialX, tangential)), gravityY);
+
+                __m128 dirX = _mm_add_ps(_mm_loadu_ps(directionX + i), _mm_mul_ps(accelerationX, steps));
+                __m128 dirY = _mm_add_ps(_mm_loadu_ps(directionY + i), _mm_mul_ps(accelerationY, steps));
+                _mm_storeu_ps(directionX + i, dirX);
+                _mm_storeu_ps(directionY + i, dirY);
+
+                _mm_storeu_ps(positionX + i, _mm_add_ps(x, _mm_mul_ps(_mm_mul_ps(dirX, steps), flip)));
+                _mm_storeu_ps(positionY + i, _mm_add_ps(y, _mm_mul_ps(_mm_mul_ps(dirY, steps), flip)));
+            }
+#endif
+
+            for (; i < count; ++i)
+            {
+                Vector2 radial;
+
+                if (positionX[i] == 0.0F || positionY[i] == 0.0F)
+                {
+                    radial = Vector2(positionX[i], positionY[i]);
+                    radial.normalize();
+                }
+
+                float accelerationX = radial.x * radialAcceleration[i] + radial.y * -tangentialAcceleration[i] + gravity.x;
+                float accelerationY = radial.y * radialAcceleration[i] + radial.x * tangentialAcceleration[i] + gravity.y;
+
+                directionX[i] += accelerationX * step;
+                directionY[i] += accelerationY * step;
+                positionX[i] += directionX[i] * step * yCoordFlipped;
+                positionY[i] += directionY[i] * step * yCoordFlipped;
+            }
+        }
+
+        // values += deltas * step, the values are clamped to zero if nonNegative is set
+        static void interpolate(float* values, const float* deltas, uint32_t count, float step, bool nonNegative)
+        {
+            uint32_t i = 0;
+
+#if OUZEL_SUPPORTS_NEON
+#  if OUZEL_SUPPORTS_NEON_CHECK
+            if (anrdoidNEONChecker.isNEONAvailable())
+#  endif
+            {
+                const float32x4_t steps = vdupq_n_f32(step);
+                const float32x4_t zero = vdupq_n_f32(0.0F);
+
+                for (; i + 4 <= count; i += 4)
+                {
+                    float32x4_t result = vaddq_f32(vld1q_f32(values + i), vmulq_f32(vld1q_f32(deltas + i), steps));
+                    if (nonNegative) result = vmaxq_f32(result, zero);
+                    vst1q_f32(values + i, result);
+                }
+            }
+#elif OUZEL_SUPPORTS_SSE
+            const __m128 steps = _mm_set1_ps(step);
+            const __m128 zero = _mm_setzero_ps();
+
+            for (; i + 4 <= count; i += 4)
+            {
+                __m128 result = _mm_add_ps(_mm_loadu_ps(values + i), _mm_mul_ps(_mm_loadu_ps(deltas + i), steps));
+                if (nonNegative) result = _mm_max_ps(result, zero);
+                _mm_storeu_ps(values + i, result);
+            }
+#endif
+
+            for (; i < count; ++i)
+            {
+                values[i] += deltas[i] * step;
+                if (nonNegative) values[i] = std::max(0.0F, values[i]);
+            }
+        }
+
+        // calculates the corners of rotated quads, the corners of a quad with the half size h rotated by r are
+        // (-f, -e), (e, -f), (-e, f) and (f, e), where e = h * cos(r) + h * sin(r) and f = h * cos(r) - h * sin(r)
+        static void expandQuads(const float* positionX, const float* positionY,
+                                const float* size, const float* rotation,
+                                uint32_t count, float offsetX, float offsetY,
+                                float* cornerX, float* cornerY)
+        {
+            uint32_t i = 0;
+
+#if OUZEL_SUPPORTS_NEON
+#  if OUZEL_SUPPORTS_NEON_CHECK
+            if (anrdoidNEONChecker.isNEONAvailable())
+#  endif
+            {
+                const float32x4_t half = vdupq_n_f32(0.5F);
+                const float32x4_t offsetXs = vdupq_n_f32(offsetX);
+                const float32x4_t offsetYs = vdupq_n_f32(offsetY);
+                float cosines[4];
+                float sines[4];
+
+                for (; i + 4 <= count; i += 4, cornerX += 16, cornerY += 16)
+                {
+                    for (uint32_t j = 0; j < 4; ++j)
+                    {
+                        float r = -degToRad(rotation[i + j]);
+                        cosines[j] = cosf(r);
+                        sines[j] = sinf(r);
+                    }
+
+                    float32x4_t h = vmulq_f32(vld1q_f32(size + i), half);
+                    float32x4_t u = vmulq_f32(h, vld1q_f32(cosines));
+                    float32x4_t v = vmulq_f32(h, vld1q_f32(sines));
+                    float32x4_t e = vaddq_f32(u, v);
+                    float32x4_t f = vsubq_f32(u, v);
+                    float32x4_t x = vaddq_f32(offsetXs, vld1q_f32(positionX + i));
+                    float32x4_t y = vaddq_f32(offsetYs, vld1q_f32(positionY + i));
+
+                    // the interleaving store puts the four corners of a particle next to each other
+                    float32x4x4_t cornersX = {{vsubq_f32(x, f), vaddq_f32(x, e), vsubq_f32(x, e), vaddq_f32(x, f)}};
+                    float32x4x4_t cornersY = {{vsubq_f32(y, e), vsubq_f32(y, f), vaddq_f32(y, f), vaddq_f32(y, e)}};
+                    vst4q_f32(cornerX, cornersX);
+                    vst4q_f32(cornerY, cornersY);
+                }
+            }
+#elif OUZEL_SUPPORTS_SSE
+            alignas(16) float cosines[4];
+            alignas(16) float sines[4];
+            const __m128 half = _mm_set1_ps(0.5F);
+            const __m128 offsetXs = _mm_set1_ps(offsetX);
+            const __m128 offsetYs = _mm_set1_ps(offsetY);
+
+            for (; i + 4 <= count; i += 4, cornerX += 16, cornerY += 16)
+            {
+                for (uint32_t j = 0; j < 4; ++j)
+                {
+                    float r = -degToRad(rotation[i + j]);
+                    cosines[j] = cosf(r);
+                    sines[j] = sinf(r);
+                }
+
+                __m128 h = _mm_mul_ps(_mm_loadu_ps(size + i), half);
+                __m128 u = _mm_mul_ps(h, _mm_load_ps(cosines));
+                __m128 v = _mm_mul_ps(h, _mm_load_ps(sines));
+                __m128 e = _mm_add_ps(u, v);
+                __m128 f = _mm_sub_ps(u, v);
+                __m128 x = _mm_add_ps(offsetXs, _mm_loadu_ps(positionX + i));
+                __m128 y = _mm_add_ps(offsetYs, _mm_loadu_ps(positionY + i));
+
+                // transpose so that the four corners of a particle are stored next to each other
+                __m128 x0 = _mm_sub_ps(x, f);
+                __m128 x1 = _mm_add_ps(x, e);
+                __m128 x2 = _mm_sub_ps(x, e);
+                __m128 x3 = _mm_add_ps(x, f);
+                _MM_TRANSPOSE4_PS(x0, x1, x2, x3);
+                _mm_storeu_ps(cornerX, x0);
+                _mm_storeu_ps(cornerX + 4, x1);
+                _mm_storeu_ps(cornerX + 8, x2);
+                _mm_storeu_ps(cornerX + 12, x3);
+
+                __m128 y0 = _mm_sub_ps(y, e);
+                __m128 y1 = _mm_sub_ps(y, f);
+                __m128 y2 = _mm_add_ps(y, f);
+                __m128 y3 = _mm_add_ps(y, e);
+                _MM_TRANSPOSE4_PS(y0, y1, y2, y3);
+                _mm_storeu_ps(cornerY, y0);
+                _mm_storeu_ps(cornerY + 4, y1);
+                _mm_storeu_ps(cornerY + 8, y2);
+                _mm_storeu_ps(cornerY + 12, y3);
+            }
+#endif
+
+            for (; i < count; ++i, cornerX += 4, cornerY += 4)
+            {
+                float h = size[i] * 0.5F;
+                float r = -degToRad(rotation[i]);
+                float u = h * cosf(r);
+                float v = h * sinf(r);
+                float e = u + v;
+                float f = u - v;
+                float x = offsetX + positionX[i];
+                float y = offsetY + positionY[i];
+
+                cornerX[0] = x - f; cornerY[0] = y - e;
+                cornerX[1] = x + e; cornerY[1] = y - f;
+                cornerX[2] = x - e; cornerY[2] = y + f;
+                cornerX[3] = x + f; cornerY[3] = y + e;
+            }
+        }
+
+        // range of position + (velocity * t + acceleration * t * (t + step) / 2) * scale for t from 0 to life, the
+        // position of the GPU simulated particle after t / step updates
+        static void getTrajectoryRange(float position, float velocity, float acceleration, float scale,
+                                       float step, float life, float& minimum, float& maximum)
+        {
+            float a = 0.5F * acceleration * scale;
+            float b = (velocity + 0.5F * acceleration * step) * scale;
+            float end = position + (a * life + b) * life;
+
+            minimum = std::min(position, end);
+            maximum = std::max(position, end);
+
+            if (a != 0.0F)
+            {
+                float t = -b / (2.0F * a);
+
+                if (t > 0.0F && t < life)
+                {
+                    float extremum = position + (a * t + b) * t;
+                    minimum = std::min(minimum, extremum);
+                    maximum = std::max(maximum, extremum);
+                }
+            }
+        }
+
         ParticleSystem::ParticleSystem():
             Component(CLASS)
         {
             shader = engine->getCache()->getShader(graphics::SHADER_TEXTURE);
+            particleShader = engine->getCache()->getShader(graphics::SHADER_PARTICLE);
             blendState = engine->getCache()->getBlendState(graphics::BLEND_ALPHA);
             whitePixelTexture = engine->getCache()->getTexture(graphics::TEXTURE_WHITE_PIXEL);
 
@@ -44,7 +342,55 @@ namespace ouzel
                             renderViewProjection,
                             wireframe);
 
-            if (particleCount)
+            if (particleCount && simulatedOnGPU)
+            {
+                // the update can run on a worker thread, so the spawned particles are uploaded here
+                if (dirtyInstanceCount) uploadInstances();
+
+                Matrix4 transform;
+                Vector2 offset;
+
+                if (particleSystemData.positionType == ParticleSystemData::PositionType::FREE)
+                    transform = renderViewProjection;
+                else if (particleSystemData.positionType == ParticleSystemData::PositionType::PARENT)
+                {
+                    transform = renderViewProjection;
+                    if (actor) offset = actor->getPosition();
+                }
+                else if (particleSystemData.positionType == ParticleSystemData::PositionType::GROUPED)
+                    transform = renderViewProjection * transformMatrix;
+
+                float colorVector[] = {1.0F, 1.0F, 1.0F, opacity};
+
+                // modelViewProj, params (time, y flip, offset) and gravity (gravity, update step)
+                float vertexConstants[24];
+                std::copy(std::begin(transform.m), std::end(transform.m), vertexConstants);
+                vertexConstants[16] = simulationTime + timeSinceUpdate;
+                vertexConstants[17] = particleSystemData.yCoordFlipped;
+                vertexConstants[18] = offset.x;
+                vertexConstants[19] = offset.y;
+                vertexConstants[20] = particleSystemData.gravity.x;
+                vertexConstants[21] = particleSystemData.gravity.y;
+                vertexConstants[22] = UPDATE_STEP;
+                vertexConstants[23] = 0.0F;
+
+                engine->getRenderer()->setCullMode(graphics::Renderer::CullMode::NONE);
+                engine->getRenderer()->setPipelineState(blendState, particleShader);
+                engine->getRenderer()->setShaderConstants(colorVector,
+                                                          sizeof(colorVector) / sizeof(float),
+                                                          vertexConstants,
+                                                          sizeof(vertexConstants) / sizeof(float));
+                engine->getRenderer()->setTextures({wireframe ? whitePixelTexture : texture});
+                engine->getRenderer()->drawInstanced(indexBuffer,
+                                                     6,
+                                                     sizeof(uint16_t),
+                                                     vertexBuffer,
+                                                     instanceBuffer,
+                                                     particleCount,
+                                                     graphics::Renderer::DrawMode::TRIANGLE_LIST,
+                                                     0);
+            }
+            else if (particleCount)
             {
                 if (needsMeshUpdate)
                 {
@@ -62,23 +408,23 @@ namespace ouzel
 
                 float colorVector[] = {1.0F, 1.0F, 1.0F, opacity};
 
-                std::vector<std::vector<float>> pixelShaderConstants(1);
-                pixelShaderConstants[0] = {std::begin(colorVector), std::end(colorVector)};
-
-                std::vector<std::vector<float>> vertexShaderConstants(1);
-                vertexShaderConstants[0] = {std::begin(transform.m), std::end(transform.m)};
-
                 engine->getRenderer()->setCullMode(graphics::Renderer::CullMode::NONE);
                 engine->getRenderer()->setPipelineState(blendState, shader);
-                engine->getRenderer()->setShaderConstants(pixelShaderConstants,
-                                                          vertexShaderConstants);
+                engine->getRenderer()->setShaderConstants(colorVector,
+                                                          sizeof(colorVector) / sizeof(float),
+                                                          transform.m,
+                                                          sizeof(transform.m) / sizeof(float));
                 engine->getRenderer()->setTextures({wireframe ? whitePixelTexture : texture});
-                engine->getRenderer()->draw(indexBuffer,
-                                            particleCount * 6,
-                                            sizeof(uint16_t),
-                                            vertexBuffer,
-                                            graphics::Renderer::DrawMode::TRIANGLE_LIST,
-                                            0);
+
+                // all the chunks use the same indices with a different base vertex
+                for (uint32_t first = 0; first < particleCount; first += MAX_CHUNK_PARTICLES)
+                    engine->getRenderer()->draw(indexBuffer,
+                                                std::min(particleCount - first, MAX_CHUNK_PARTICLES) * 6,
+                                                sizeof(uint16_t),
+                                                vertexBuffer,
+                                                graphics::Renderer::DrawMode::TRIANGLE_LIST,
+                                                0,
+                                                first * 4);
             }
         }
 
@@ -86,7 +432,6 @@ namespace ouzel
         {
             timeSinceUpdate += delta;
 
-            static const float UPDATE_STEP = 1.0F / 60.0F;
             bool needsBoundingBoxUpdate = false;
 
             while (timeSinceUpdate >= UPDATE_STEP)
@@ -97,15 +442,21 @@ namespace ouzel
                 {
                     float rate = 1.0F / particleSystemData.emissionRate;
 
-                    if (particleCount < particleSystemData.maxParticles)
+                    // the GPU simulated particles can be spawned only if the next slot in the ring is free
+                    bool hasFreeSlots = simulatedOnGPU ?
+                        particleSystemData.maxParticles > 0 && deathTimes[nextSlot] <= simulationTime :
+                        particleCount < particleSystemData.maxParticles;
+
+                    if (hasFreeSlots)
                     {
                         emitCounter += UPDATE_STEP;
                         if (emitCounter < 0.0F)
                             emitCounter = 0.0F;
                     }
 
-                    uint32_t emitCount = static_cast<uint32_t>(std::min(static_cast<float>(particleSystemData.maxParticles - particleCount), emitCounter / rate));
-                    emitParticles(emitCount);
+                    uint32_t freeCount = simulatedOnGPU ? particleSystemData.maxParticles : particleSystemData.maxParticles - particleCount;
+                    uint32_t emitCount = static_cast<uint32_t>(std::min(static_cast<float>(freeCount), emitCounter / rate));
+                    emitCount = spawnParticles(emitCount);
                     emitCounter -= rate * emitCount;
 
                     elapsed += UPDATE_STEP;
@@ -117,7 +468,7 @@ namespace ouzel
                         stop();
                     }
                 }
-                else if (active && !particleCount)
+                else if (active && (simulatedOnGPU ? simulationTime > lastDeathTime : !particleCount))
                 {
                     active = false;
                     updateCallback.remove();
@@ -130,73 +481,61 @@ namespace ouzel
                     return;
                 }
 
-                if (active)
+                if (simulatedOnGPU)
                 {
-                    for (uint32_t counter = particleCount; counter > 0; --counter)
-                    {
-                        size_t i = counter - 1;
+                    // the vertex shader calculates the particles from the time
+                    simulationTime += UPDATE_STEP;
+                    if (simulationTime >= MAX_SIMULATION_TIME) rebaseSimulationTime();
+                    needsBoundingBoxUpdate = true;
+                }
+                else if (active)
+                {
+                    float* life = getField(LIFE);
 
-                        particles[i].life -= UPDATE_STEP;
+                    for (uint32_t i = 0; i < particleCount; ++i)
+                        life[i] -= UPDATE_STEP;
 
-                        if (particles[i].life >= 0.0F)
+                    // all the particles are advanced and the dead ones are removed afterwards
+                    if (particleSystemData.emitterType == ParticleSystemData::EmitterType::GRAVITY)
+                    {
+                        integrateGravity(getField(POSITION_X), getField(POSITION_Y),
+                                         getField(DIRECTION_X), getField(DIRECTION_Y),
+                                         getField(RADIAL_ACCELERATION), getField(TANGENTIAL_ACCELERATION),
+                                         particleCount, particleSystemData.gravity,
+                                         particleSystemData.yCoordFlipped, UPDATE_STEP);
+                    }
+                    else
+                    {
+                        float* positionX = getField(POSITION_X);
+                        float* positionY = getField(POSITION_Y);
+                        float* angle = getField(ANGLE);
+                        float* radius = getField(RADIUS);
+                        const float* degreesPerSecond = getField(DEGREES_PER_SECOND);
+                        const float* deltaRadius = getField(DELTA_RADIUS);
+
+                        for (uint32_t i = 0; i < particleCount; ++i)
                         {
-                            if (particleSystemData.emitterType == ParticleSystemData::EmitterType::GRAVITY)
-                            {
-                                Vector2 tmp;
-                                Vector2 radial;
-                                Vector2 tangential;
-
-                                // radial acceleration
-                                if (particles[i].position.x == 0.0F || particles[i].position.y == 0.0F)
-                                {
-                                    radial = particles[i].position;
-                                    radial.normalize();
-                                }
-                                tangential = radial;
-                                radial *= particles[i].radialAcceleration;
-
-                                // tangential acceleration
-                                std::swap(tangential.x, tangential.y);
-                                tangential.x *= - particles[i].tangentialAcceleration;
-                                tangential.y *= particles[i].tangentialAcceleration;
-
-                                // (gravity + radial + tangential) * UPDATE_STEP
-                                tmp.x = radial.x + tangential.x + particleSystemData.gravity.x;
-                                tmp.y = radial.y + tangential.y + particleSystemData.gravity.y;
-                                tmp.x *= UPDATE_STEP;
-                                tmp.y *= UPDATE_STEP;
-
-                                particles[i].direction.x += tmp.x;
-                                particles[i].direction.y += tmp.y;
-                                tmp.x = particles[i].direction.x * UPDATE_STEP * particleSystemData.yCoordFlipped;
-                                tmp.y = particles[i].direction.y * UPDATE_STEP * particleSystemData.yCoordFlipped;
-                                particles[i].position.x += tmp.x;
-                                particles[i].position.y += tmp.y;
-                            }
-                            else
-                            {
-                                particles[i].angle += particles[i].degreesPerSecond * UPDATE_STEP;
-                                particles[i].radius += particles[i].deltaRadius * UPDATE_STEP;
-                                particles[i].position.x = -cosf(particles[i].angle) * particles[i].radius;
-                                particles[i].position.y = -sinf(particles[i].angle) * particles[i].radius * particleSystemData.yCoordFlipped;
-                            }
-
-                            // color r,g,b,a
-                            particles[i].colorRed += particles[i].deltaColorRed * UPDATE_STEP;
-                            particles[i].colorGreen += particles[i].deltaColorGreen * UPDATE_STEP;
-                            particles[i].colorBlue += particles[i].deltaColorBlue * UPDATE_STEP;
-                            particles[i].colorAlpha += particles[i].deltaColorAlpha * UPDATE_STEP;
-
-                            // size
-                            particles[i].size += (particles[i].deltaSize * UPDATE_STEP);
-                            particles[i].size = std::max(0.0F, particles[i].size);
-
-                            // angle
-                            particles[i].rotation += particles[i].deltaRotation * UPDATE_STEP;
+                            angle[i] += degreesPerSecond[i] * UPDATE_STEP;
+                            radius[i] += deltaRadius[i] * UPDATE_STEP;
+                            positionX[i] = -cosf(angle[i]) * radius[i];
+                            positionY[i] = -sinf(angle[i]) * radius[i] * particleSystemData.yCoordFlipped;
                         }
-                        else
+                    }
+
+                    interpolate(getField(COLOR_RED), getField(DELTA_COLOR_RED), particleCount, UPDATE_STEP, false);
+                    interpolate(getField(COLOR_GREEN), getField(DELTA_COLOR_GREEN), particleCount, UPDATE_STEP, false);
+                    interpolate(getField(COLOR_BLUE), getField(DELTA_COLOR_BLUE), particleCount, UPDATE_STEP, false);
+                    interpolate(getField(COLOR_ALPHA), getField(DELTA_COLOR_ALPHA), particleCount, UPDATE_STEP, false);
+                    interpolate(getField(SIZE), getField(DELTA_SIZE), particleCount, UPDATE_STEP, true);
+                    interpolate(getField(ROTATION), getField(DELTA_ROTATION), particleCount, UPDATE_STEP, false);
+
+                    for (uint32_t counter = particleCount; counter > 0; --counter)
+                    {
+                        uint32_t i = counter - 1;
+
+                        if (!(life[i] >= 0.0F))
                         {
-                            particles[i] = particles[particleCount - 1];
+                            moveParticle(particleCount - 1, i);
                             particleCount--;
                         }
                     }
@@ -207,9 +546,21 @@ namespace ouzel
             }
 
             if (needsBoundingBoxUpdate)
+                updateBoundingBox();
+        }
+
+        void ParticleSystem::updateBoundingBox()
+        {
+            boundingBox.reset();
+
+            if (simulatedOnGPU)
             {
-                // Update bounding box
-                boundingBox.reset();
+                Box2 particleBox;
+
+                for (uint32_t i = 0; i < particleCount; ++i)
+                    if (deathTimes[i] >= simulationTime) particleBox.merge(lifetimeBoxes[i]);
+
+                if (particleBox.isEmpty()) return;
 
                 if (particleSystemData.positionType == ParticleSystemData::PositionType::FREE ||
                     particleSystemData.positionType == ParticleSystemData::PositionType::PARENT)
@@ -217,21 +568,45 @@ namespace ouzel
                     if (actor)
                     {
                         const Matrix4& inverseTransform = actor->getInverseTransform();
+                        Vector2 corners[4];
+                        particleBox.getCorners(corners);
 
-                        for (uint32_t i = 0; i < particleCount; i++)
+                        for (const Vector2& corner : corners)
                         {
-                            Vector3 position = particles[i].position;
+                            Vector3 position(corner.x, corner.y, 0.0F);
                             inverseTransform.transformPoint(position);
                             boundingBox.insertPoint(Vector2(position.x, position.y));
                         }
                     }
                 }
                 else if (particleSystemData.positionType == ParticleSystemData::PositionType::GROUPED)
+                    boundingBox = particleBox;
+            }
+            else if (particleSystemData.positionType == ParticleSystemData::PositionType::FREE ||
+                     particleSystemData.positionType == ParticleSystemData::PositionType::PARENT)
+            {
+                if (actor)
                 {
+                    const Matrix4& inverseTransform = actor->getInverseTransform();
+                    const float* positionX = getField(POSITION_X);
+                    const float* positionY = getField(POSITION_Y);
+
                     for (uint32_t i = 0; i < particleCount; i++)
-                        boundingBox.insertPoint(particles[i].position);
+                    {
+                        Vector3 position(positionX[i], positionY[i], 0.0F);
+                        inverseTransform.transformPoint(position);
+                        boundingBox.insertPoint(Vector2(position.x, position.y));
+                    }
                 }
             }
+            else if (particleSystemData.positionType == ParticleSystemData::PositionType::GROUPED)
+            {
+                const float* positionX = getField(POSITION_X);
+                const float* positionY = getField(POSITION_Y);
+
+                for (uint32_t i = 0; i < particleCount; i++)
+                    boundingBox.insertPoint(Vector2(positionX[i], positionY[i]));
+            }
         }
 
         void ParticleSystem::init(const ParticleSystemData& newParticleSystemData)
@@ -295,96 +670,333 @@ namespace ouzel
             timeSinceUpdate = 0.0F;
             particleCount = 0;
             finished = false;
+
+            if (simulatedOnGPU)
+            {
+                // the old particles must not show up when the time reaches their spawn time again
+                std::fill(instances.begin(), instances.end(), graphics::Instance());
+                std::fill(deathTimes.begin(), deathTimes.end(), 0.0F);
+                instanceBuffer->setData(instances.data(), static_cast<uint32_t>(getVectorSize(instances)));
+                dirtyInstanceCount = 0;
+
+                nextSlot = 0;
+                simulationTime = 0.0F;
+                lastDeathTime = 0.0F;
+            }
+        }
+
+        void ParticleSystem::setGPUSimulation(bool newGPUSimulation)
+        {
+            gpuSimulation = newGPUSimulation;
+
+            // the mesh of an initialized particle system is recreated for the new mode
+            if (indexBuffer)
+            {
+                reset();
+                createParticleMesh();
+            }
         }
 
         void ParticleSystem::createParticleMesh()
         {
-            indices.reserve(particleSystemData.maxParticles * 6);
-            vertices.reserve(particleSystemData.maxParticles * 4);
+            simulatedOnGPU = gpuSimulation && particleShader &&
+                particleSystemData.emitterType == ParticleSystemData::EmitterType::GRAVITY &&
+                particleSystemData.radialAcceleration == 0.0F &&
+                particleSystemData.tangentialAcceleration == 0.0F;
+
+            indices.clear();
+
+            if (simulatedOnGPU)
+            {
+                // one quad that is drawn for every particle
+                indices = {0, 1, 2, 1, 3, 2};
+
+                const graphics::Vertex vertices[] = {
+                    graphics::Vertex(Vector3(-0.5F, -0.5F, 0.0F), Color::WHITE, Vector2(0.0F, 1.0F), Vector3(0.0F, 0.0F, -1.0F)),
+                    graphics::Vertex(Vector3(0.5F, -0.5F, 0.0F), Color::WHITE, Vector2(1.0F, 1.0F), Vector3(0.0F, 0.0F, -1.0F)),
+                    graphics::Vertex(Vector3(-0.5F, 0.5F, 0.0F), Color::WHITE, Vector2(0.0F, 0.0F), Vector3(0.0F, 0.0F, -1.0F)),
+                    graphics::Vertex(Vector3(0.5F, 0.5F, 0.0F), Color::WHITE, Vector2(1.0F, 0.0F), Vector3(0.0F, 0.0F, -1.0F))
+                };
+
+                indexBuffer = std::make_shared<graphics::Buffer>(*engine->getRenderer());
+                indexBuffer->init(graphics::Buffer::Usage::INDEX, 0, indices.data(), static_cast<uint32_t>(getVectorSize(indices)));
+
+                vertexBuffer = std::make_shared<graphics::Buffer>(*engine->getRenderer());
+                vertexBuffer->init(graphics::Buffer::Usage::VERTEX, 0, vertices, static_cast<uint32_t>(sizeof(vertices)));
+
+                instances.assign(particleSystemData.maxParticles, graphics::Instance());
+                deathTimes.assign(particleSystemData.maxParticles, 0.0F);
+                lifetimeBoxes.assign(particleSystemData.maxParticles, Box2());
+
+                instanceBuffer = std::make_shared<graphics::Buffer>(*engine->getRenderer());
+                instanceBuffer->init(graphics::Buffer::Usage::VERTEX, graphics::Buffer::DYNAMIC,
+                                     instances.data(), static_cast<uint32_t>(getVectorSize(instances)));
+                dirtyInstanceCount = 0;
+
+                nextSlot = 0;
+                simulationTime = 0.0F;
+                lastDeathTime = 0.0F;
+
+                // the particle arrays hold only the particles that are being spawned
+                resizeParticles(particleSystemData.maxParticles);
+                return;
+            }
+
+            instanceBuffer.reset();
+            instances.clear();
+            deathTimes.clear();
+            lifetimeBoxes.clear();
+
+            uint32_t quadCount = std::min(particleSystemData.maxParticles, MAX_CHUNK_PARTICLES);
+            indices.reserve(quadCount * 6);
 
-            for (uint16_t i = 0; i < particleSystemData.maxParticles; ++i)
+            for (uint32_t i = 0; i < quadCount; ++i)
             {
-                indices.push_back(i * 4 + 0);
-                indices.push_back(i * 4 + 1);
-                indices.push_back(i * 4 + 2);
-                indices.push_back(i * 4 + 1);
-                indices.push_back(i * 4 + 3);
-                indices.push_back(i * 4 + 2);
-
-                vertices.push_back(graphics::Vertex(Vector3(-1.0F, -1.0F, 0.0F), Color::WHITE,
-                                                    Vector2(0.0F, 1.0F), Vector3(0.0F, 0.0F, -1.0F)));
-                vertices.push_back(graphics::Vertex(Vector3(1.0F, -1.0F, 0.0F), Color::WHITE,
-                                                    Vector2(1.0F, 1.0F), Vector3(0.0F, 0.0F, -1.0F)));
-                vertices.push_back(graphics::Vertex(Vector3(-1.0F, 1.0F, 0.0F), Color::WHITE,
-                                                    Vector2(0.0F, 0.0F), Vector3(0.0F, 0.0F, -1.0F)));
-                vertices.push_back(graphics::Vertex(Vector3(1.0F, 1.0F, 0.0F), Color::WHITE,
-                                                    Vector2(1.0F, 0.0F), Vector3(0.0F, 0.0F, -1.0F)));
+                uint16_t startVertex = static_cast<uint16_t>(i * 4);
+                indices.push_back(startVertex + 0);
+                indices.push_back(startVertex + 1);
+                indices.push_back(startVertex + 2);
+                indices.push_back(startVertex + 1);
+                indices.push_back(startVertex + 3);
+                indices.push_back(startVertex + 2);
             }
 
             indexBuffer = std::make_shared<graphics::Buffer>(*engine->getRenderer());
             indexBuffer->init(graphics::Buffer::Usage::INDEX, 0, indices.data(), static_cast<uint32_t>(getVectorSize(indices)));
 
             vertexBuffer = std::make_shared<graphics::Buffer>(*engine->getRenderer());
-            vertexBuffer->init(graphics::Buffer::Usage::VERTEX, graphics::Buffer::DYNAMIC, vertices.data(), static_cast<uint32_t>(getVectorSize(vertices)));
+            vertexBuffer->init(graphics::Buffer::Usage::VERTEX, graphics::Buffer::STREAMING);
 
-            particles.resize(particleSystemData.maxParticles);
+            resizeParticles(particleSystemData.maxParticles);
+        }
+
+        void ParticleSystem::resizeParticles(uint32_t newCapacity)
+        {
+            std::vector<float> newParticleData(FIELD_COUNT * newCapacity);
+            uint32_t keptCount = std::min(particleCapacity, newCapacity);
+
+            for (uint32_t field = 0; field < FIELD_COUNT; ++field)
+                std::copy(particleData.begin() + field * particleCapacity,
+                          particleData.begin() + field * particleCapacity + keptCount,
+                          newParticleData.begin() + field * newCapacity);
+
+            particleData.swap(newParticleData);
+            particleCapacity = newCapacity;
+            particleCount = std::min(particleCount, newCapacity);
+        }
+
+        void ParticleSystem::moveParticle(uint32_t from, uint32_t to)
+        {
+            for (uint32_t field = 0; field < FIELD_COUNT; ++field)
+                particleData[field * particleCapacity + to] = particleData[field * particleCapacity + from];
         }
 
         void ParticleSystem::updateParticleMesh()
         {
-            if (actor)
+            if (actor && particleCount)
             {
-                for (uint32_t counter = particleCount; counter > 0; --counter)
-                {
-                    size_t i = counter - 1;
+                Vector2 offset;
 
-                    Vector2 position;
+                if (particleSystemData.positionType == ParticleSystemData::PositionType::PARENT)
+                    offset = actor->getPosition();
 
-                    if (particleSystemData.positionType == ParticleSystemData::PositionType::FREE)
-                        position = particles[i].position;
-                    else if (particleSystemData.positionType == ParticleSystemData::PositionType::PARENT)
-                        position = actor->getPosition() + particles[i].position;
+                cornersX.resize(particleCount * 4);
+                cornersY.resize(particleCount * 4);
 
-                    float size_2 = particles[i].size / 2.0F;
-                    Vector2 v1(-size_2, -size_2);
-                    Vector2 v2(size_2, size_2);
+                expandQuads(getField(POSITION_X), getField(POSITION_Y),
+                            getField(SIZE), getField(ROTATION),
+                            particleCount, offset.x, offset.y,
+                            cornersX.data(), cornersY.data());
 
-                    float r = -degToRad(particles[i].rotation);
-                    float cr = cosf(r);
-                    float sr = sinf(r);
+                const float* colorRed = getField(COLOR_RED);
+                const float* colorGreen = getField(COLOR_GREEN);
+                const float* colorBlue = getField(COLOR_BLUE);
+                const float* colorAlpha = getField(COLOR_ALPHA);
+
+                // vertices of the live particles are written directly to the upload memory
+                graphics::Vertex* vertices = static_cast<graphics::Vertex*>(vertexBuffer->map(particleCount * 4 * sizeof(graphics::Vertex)));
+
+                for (uint32_t i = 0; i < particleCount; ++i)
+                {
+                    Color color(static_cast<uint8_t>(colorRed[i] * 255),
+                                static_cast<uint8_t>(colorGreen[i] * 255),
+                                static_cast<uint8_t>(colorBlue[i] * 255),
+                                static_cast<uint8_t>(colorAlpha[i] * 255));
+
+                    const float* x = cornersX.data() + i * 4;
+                    const float* y = cornersY.data() + i * 4;
+
+                    vertices[i * 4 + 0] = graphics::Vertex(Vector3(x[0], y[0], 0.0F), color,
+                                                           Vector2(0.0F, 1.0F), Vector3(0.0F, 0.0F, -1.0F));
+                    vertices[i * 4 + 1] = graphics::Vertex(Vector3(x[1], y[1], 0.0F), color,
+                                                           Vector2(1.0F, 1.0F), Vector3(0.0F, 0.0F, -1.0F));
+                    vertices[i * 4 + 2] = graphics::Vertex(Vector3(x[2], y[2], 0.0F), color,
+                                                           Vector2(0.0F, 0.0F), Vector3(0.0F, 0.0F, -1.0F));
+                    vertices[i * 4 + 3] = graphics::Vertex(Vector3(x[3], y[3], 0.0F), color,
+                                                           Vector2(1.0F, 0.0F), Vector3(0.0F, 0.0F, -1.0F));
+                }
+
+                vertexBuffer->unmap();
+            }
+        }
 
-                    Vector2 a(v1.x * cr - v1.y * sr, v1.x * sr + v1.y * cr);
-                    Vector2 b(v2.x * cr - v1.y * sr, v2.x * sr + v1.y * cr);
-                    Vector2 c(v2.x * cr - v2.y * sr, v2.x * sr + v2.y * cr);
-                    Vector2 d(v1.x * cr - v2.y * sr, v1.x * sr + v2.y * cr);
+        uint32_t ParticleSystem::spawnParticles(uint32_t count)
+        {
+            if (!simulatedOnGPU)
+            {
+                if (particleCount + count > particleSystemData.maxParticles)
+                    count = particleSystemData.maxParticles - particleCount;
 
-                    Color color(static_cast<uint8_t>(particles[i].colorRed * 255),
-                                static_cast<uint8_t>(particles[i].colorGreen * 255),
-                                static_cast<uint8_t>(particles[i].colorBlue * 255),
-                                static_cast<uint8_t>(particles[i].colorAlpha * 255));
+                if (count && actor)
+                {
+                    emitParticles(particleCount, count);
+                    particleCount += count;
+                }
 
-                    vertices[i * 4 + 0].position = a + position;
-                    vertices[i * 4 + 0].color = color;
+                return count;
+            }
 
-                    vertices[i * 4 + 1].position = b + position;
-                    vertices[i * 4 + 1].color = color;
+            uint32_t maxParticles = particleSystemData.maxParticles;
+            uint32_t spawnCount = 0;
+
+            // a slot is reused only after its particle has died
+            while (spawnCount < count && spawnCount < maxParticles &&
+                   deathTimes[(nextSlot + spawnCount) % maxParticles] <= simulationTime)
+                ++spawnCount;
+
+            if (!actor) return spawnCount;
+
+            const float* life = getField(LIFE);
+            const float* positionX = getField(POSITION_X);
+            const float* positionY = getField(POSITION_Y);
+            const float* directionX = getField(DIRECTION_X);
+            const float* directionY = getField(DIRECTION_Y);
+            const float* size = getField(SIZE);
+            const float* deltaSize = getField(DELTA_SIZE);
+            const float* rotation = getField(ROTATION);
+            const float* deltaRotation = getField(DELTA_ROTATION);
+            const float* colorRed = getField(COLOR_RED);
+            const float* colorGreen = getField(COLOR_GREEN);
+            const float* colorBlue = getField(COLOR_BLUE);
+            const float* colorAlpha = getField(COLOR_ALPHA);
+            const float* deltaColorRed = getField(DELTA_COLOR_RED);
+            const float* deltaColorGreen = getField(DELTA_COLOR_GREEN);
+            const float* deltaColorBlue = getField(DELTA_COLOR_BLUE);
+            const float* deltaColorAlpha = getField(DELTA_COLOR_ALPHA);
+
+            // the ring wraps around at most once
+            for (uint32_t remaining = spawnCount; remaining > 0;)
+            {
+                uint32_t first = nextSlot;
+                uint32_t rangeCount = std::min(remaining, maxParticles - first);
 
-                    vertices[i * 4 + 2].position = d + position;
-                    vertices[i * 4 + 2].color = color;
+                emitParticles(first, rangeCount);
 
-                    vertices[i * 4 + 3].position = c + position;
-                    vertices[i * 4 + 3].color = color;
+                for (uint32_t i = first; i < first + rangeCount; ++i)
+                {
+                    // the columns of the transform are the position and direction, the spawn time, life and size,
+                    // the rotation and the color delta
+                    graphics::Instance& instance = instances[i];
+                    instance.transform[0] = positionX[i];
+                    instance.transform[1] = positionY[i];
+                    instance.transform[2] = directionX[i];
+                    instance.transform[3] = directionY[i];
+                    instance.transform[4] = simulationTime;
+                    instance.transform[5] = life[i];
+                    instance.transform[6] = size[i];
+                    instance.transform[7] = deltaSize[i];
+                    instance.transform[8] = rotation[i];
+                    instance.transform[9] = deltaRotation[i];
+                    instance.transform[10] = 0.0F;
+                    instance.transform[11] = 0.0F;
+                    instance.transform[12] = deltaColorRed[i];
+                    instance.transform[13] = deltaColorGreen[i];
+                    instance.transform[14] = deltaColorBlue[i];
+                    instance.transform[15] = deltaColorAlpha[i];
+                    instance.color[0] = colorRed[i];
+                    instance.color[1] = colorGreen[i];
+                    instance.color[2] = colorBlue[i];
+                    instance.color[3] = colorAlpha[i];
+
+                    deathTimes[i] = simulationTime + life[i];
+                    lastDeathTime = std::max(lastDeathTime, deathTimes[i]);
+
+                    Box2& box = lifetimeBoxes[i];
+                    getTrajectoryRange(positionX[i], directionX[i], particleSystemData.gravity.x, particleSystemData.yCoordFlipped,
+                                       UPDATE_STEP, life[i], box.min.x, box.max.x);
+                    getTrajectoryRange(positionY[i], directionY[i], particleSystemData.gravity.y, particleSystemData.yCoordFlipped,
+                                       UPDATE_STEP, life[i], box.min.y, box.max.y);
                 }
 
-                vertexBuffer->setData(vertices.data(), static_cast<uint32_t>(getVectorSize(vertices)));
+                markInstancesDirty(first, rangeCount);
+
+                nextSlot = (first + rangeCount) % maxParticles;
+                particleCount = std::max(particleCount, first + rangeCount);
+                remaining -= rangeCount;
+            }
+
+            return spawnCount;
+        }
+
+        void ParticleSystem::rebaseSimulationTime()
+        {
+            float base = simulationTime;
+
+            // the spawn times of the dead particles are moved as well, so that they don't come back to life
+            for (uint32_t i = 0; i < particleCount; ++i)
+            {
+                instances[i].transform[4] -= base;
+                deathTimes[i] = std::max(deathTimes[i] - base, 0.0F);
+            }
+
+            lastDeathTime = std::max(lastDeathTime - base, 0.0F);
+            simulationTime = 0.0F;
+
+            dirtyInstanceFirst = 0;
+            dirtyInstanceCount = particleCount;
+        }
+
+        void ParticleSystem::markInstancesDirty(uint32_t first, uint32_t count)
+        {
+            uint32_t maxParticles = particleSystemData.maxParticles;
+
+            // the particles are spawned one after another in the ring, so the dirty range is usually extended
+            if (!dirtyInstanceCount)
+            {
+                dirtyInstanceFirst = first;
+                dirtyInstanceCount = count;
+            }
+            else if ((dirtyInstanceFirst + dirtyInstanceCount) % maxParticles == first)
+                dirtyInstanceCount = std::min(dirtyInstanceCount + count, maxParticles);
+            else
+            {
+                dirtyInstanceFirst = 0;
+                dirtyInstanceCount = maxParticles;
             }
         }
 
-        void ParticleSystem::emitParticles(uint32_t count)
+        void ParticleSystem::uploadInstances()
         {
-            if (particleCount + count > particleSystemData.maxParticles)
-                count = particleSystemData.maxParticles - particleCount;
+            uint32_t maxParticles = particleSystemData.maxParticles;
+
+            // the range wraps around the end of the ring at most once
+            for (uint32_t first = dirtyInstanceFirst, remaining = dirtyInstanceCount; remaining > 0;)
+            {
+                uint32_t rangeCount = std::min(remaining, maxParticles - first);
+
+                instanceBuffer->setData(instances.data() + first,
+                                        rangeCount * static_cast<uint32_t>(sizeof(graphics::Instance)),
+                                        first * static_cast<uint32_t>(sizeof(graphics::Instance)));
+
+                first = (first + rangeCount) % maxParticles;
+                remaining -= rangeCount;
+            }
+
+            dirtyInstanceCount = 0;
+        }
 
+        void ParticleSystem::emitParticles(uint32_t first, uint32_t count)
+        {
             if (count && actor)
             {
                 Vector2 position;
@@ -394,42 +1006,69 @@ namespace ouzel
                 else if (particleSystemData.positionType == ParticleSystemData::PositionType::PARENT)
                     position = actor->convertLocalToWorld(Vector2()) - actor->getPosition();
 
-                for (uint32_t i = particleCount; i < particleCount + count; ++i)
+                float* life = getField(LIFE);
+                float* positionX = getField(POSITION_X);
+                float* positionY = getField(POSITION_Y);
+                float* directionX = getField(DIRECTION_X);
+                float* directionY = getField(DIRECTION_Y);
+                float* colorRed = getField(COLOR_RED);
+                float* colorGreen = getField(COLOR_GREEN);
+                float* colorBlue = getField(COLOR_BLUE);
+                float* colorAlpha = getField(COLOR_ALPHA);
+                float* deltaColorRed = getField(DELTA_COLOR_RED);
+                float* deltaColorGreen = getField(DELTA_COLOR_GREEN);
+                float* deltaColorBlue = getField(DELTA_COLOR_BLUE);
+                float* deltaColorAlpha = getField(DELTA_COLOR_ALPHA);
+                float* size = getField(SIZE);
+                float* deltaSize = getField(DELTA_SIZE);
+                float* rotation = getField(ROTATION);
+                float* deltaRotation = getField(DELTA_ROTATION);
+                float* radialAcceleration = getField(RADIAL_ACCELERATION);
+                float* tangentialAcceleration = getField(TANGENTIAL_ACCELERATION);
+                float* angle = getField(ANGLE);
+                float* radius = getField(RADIUS);
+                float* degreesPerSecond = getField(DEGREES_PER_SECOND);
+                float* deltaRadius = getField(DELTA_RADIUS);
+
+                for (uint32_t i = first; i < first + count; ++i)
                 {
                     if (particleSystemData.emitterType == ParticleSystemData::EmitterType::GRAVITY)
                     {
-                        particles[i].life = fmaxf(particleSystemData.particleLifespan + particleSystemData.particleLifespanVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine), 0.0F);
+                        life[i] = fmaxf(particleSystemData.particleLifespan + particleSystemData.particleLifespanVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine), 0.0F);
+
+                        Vector2 particlePosition = particleSystemData.sourcePosition + position + Vector2(particleSystemData.sourcePositionVariance.x * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine),
+                                                                                                            particleSystemData.sourcePositionVariance.y * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine));
 
-                        particles[i].position = particleSystemData.sourcePosition + position + Vector2(particleSystemData.sourcePositionVariance.x * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine),
-                                                                                                         particleSystemData.sourcePositionVariance.y * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine));
+                        positionX[i] = particlePosition.x;
+                        positionY[i] = particlePosition.y;
 
-                        particles[i].size = fmaxf(particleSystemData.startParticleSize + particleSystemData.startParticleSizeVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine), 0.0F);
+                        size[i] = fmaxf(particleSystemData.startParticleSize + particleSystemData.startParticleSizeVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine), 0.0F);
 
                         float finishSize = fmaxf(particleSystemData.finishParticleSize + particleSystemData.finishParticleSizeVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine), 0.0F);
-                        particles[i].deltaSize = (finishSize - particles[i].size) / particles[i].life;
+                        deltaSize[i] = (finishSize - size[i]) / life[i];
 
-                        particles[i].colorRed = clamp(particleSystemData.startColorRed + particleSystemData.startColorRedVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine), 0.0F, 1.0F);
-                        particles[i].colorGreen = clamp(particleSystemData.startColorGreen + particleSystemData.startColorGreenVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine), 0.0F, 1.0F);
-                        particles[i].colorBlue = clamp(particleSystemData.startColorBlue + particleSystemData.startColorBlueVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine), 0.0F, 1.0F);
-                        particles[i].colorAlpha = clamp(particleSystemData.startColorAlpha + particleSystemData.startColorAlphaVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine), 0.0F, 1.0F);
+                        colorRed[i] = clamp(particleSystemData.startColorRed + particleSystemData.startColorRedVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine), 0.0F, 1.0F);
+                        colorGreen[i] = clamp(particleSystemData.startColorGreen + particleSystemData.startColorGreenVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine), 0.0F, 1.0F);
+                        colorBlue[i] = clamp(particleSystemData.startColorBlue + particleSystemData.startColorBlueVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine), 0.0F, 1.0F);
+                        colorAlpha[i] = clamp(particleSystemData.startColorAlpha + particleSystemData.startColorAlphaVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine), 0.0F, 1.0F);
 
                         float finishColorRed = clamp(particleSystemData.finishColorRed + particleSystemData.finishColorRedVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine), 0.0F, 1.0F);
                         float finishColorGreen = clamp(particleSystemData.finishColorGreen + particleSystemData.finishColorGreenVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine), 0.0F, 1.0F);
                         float finishColorBlue = clamp(particleSystemData.finishColorBlue + particleSystemData.finishColorBlueVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine), 0.0F, 1.0F);
                         float finishColorAlpha = clamp(particleSystemData.finishColorAlpha + particleSystemData.finishColorAlphaVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine), 0.0F, 1.0F);
 
-                        particles[i].deltaColorRed = (finishColorRed - particles[i].colorRed) / particles[i].life;
-                        particles[i].deltaColorGreen = (finishColorGreen - particles[i].colorGreen) / particles[i].life;
-                        particles[i].deltaColorBlue = (finishColorBlue - particles[i].colorBlue) / particles[i].life;
-                        particles[i].deltaColorAlpha = (finishColorAlpha - particles[i].colorAlpha) / particles[i].life;
+                        deltaColorRed[i] = (finishColorRed - colorRed[i]) / life[i];
+                        deltaColorGreen[i] = (finishColorGreen - colorGreen[i]) / life[i];
+                        deltaColorBlue[i] = (finishColorBlue - colorBlue[i]) / life[i];
+                        deltaColorAlpha[i] = (finishColorAlpha - colorAlpha[i]) / life[i];
 
-                        particles[i].rotation = particleSystemData.startRotation + particleSystemData.startRotationVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine);
+                        rotation[i] = particleSystemData.startRotation + particleSystemData.startRotationVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine);
 
                         float finishRotation = particleSystemData.finishRotation + particleSystemData.finishRotationVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine);
-                        particles[i].deltaRotation = (finishRotation - particles[i].rotation) / particles[i].life;
+                        deltaRotation[i] = (finishRotation - rotation[i]) / life[i];
 
-                        particles[i].radialAcceleration = particleSystemData.radialAcceleration + particleSystemData.radialAcceleration * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine);
-                        particles[i].tangentialAcceleration = particleSystemData.tangentialAcceleration + particleSystemData.tangentialAcceleration * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine);
+                        radialAcceleration[i] = particleSystemData.radialAcceleration + particleSystemData.radialAcceleration * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine);
+                        tangentialAcceleration[i] = particleSystemData.tangentialAcceleration + particleSystemData.tangentialAcceleration * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine);
 
                         if (particleSystemData.rotationIsDir)
                         {
@@ -437,8 +1076,9 @@ namespace ouzel
                             Vector2 v(cosf(a), sinf(a));
                             float s = particleSystemData.speed + particleSystemData.speedVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine);
                             Vector2 dir = v * s;
-                            particles[i].direction = dir;
-                            particles[i].rotation = -radToDeg(dir.getAngle());
+                            directionX[i] = dir.x;
+                            directionY[i] = dir.y;
+                            rotation[i] = -radToDeg(dir.getAngle());
                         }
                         else
                         {
@@ -446,21 +1086,20 @@ namespace ouzel
                             Vector2 v(cosf(a), sinf(a));
                             float s = particleSystemData.speed + particleSystemData.speedVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine);
                             Vector2 dir = v * s;
-                            particles[i].direction = dir;
+                            directionX[i] = dir.x;
+                            directionY[i] = dir.y;
                         }
                     }
                     else
                     {
-                        particles[i].radius = particleSystemData.maxRadius + particleSystemData.maxRadiusVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine);
-                        particles[i].angle = degToRad(particleSystemData.angle + particleSystemData.angleVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine));
-                        particles[i].degreesPerSecond = degToRad(particleSystemData.rotatePerSecond + particleSystemData.rotatePerSecondVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine));
+                        radius[i] = particleSystemData.maxRadius + particleSystemData.maxRadiusVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine);
+                        angle[i] = degToRad(particleSystemData.angle + particleSystemData.angleVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine));
+                        degreesPerSecond[i] = degToRad(particleSystemData.rotatePerSecond + particleSystemData.rotatePerSecondVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine));
 
                         float endRadius = particleSystemData.minRadius + particleSystemData.minRadiusVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine);
-                        particles[i].deltaRadius = (endRadius - particles[i].radius) / particles[i].life;
+                        deltaRadius[i] = (endRadius - radius[i]) / life[i];
                     }
                 }
-
-                particleCount += count;
             }
         }
     } // namespace scene
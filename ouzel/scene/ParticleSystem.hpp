@@ -7,6 +7,7 @@
 #include <functional>
 #include "scene/Component.hpp"
 #include "scene/ParticleSystemData.hpp"
+#include "math/Box2.hpp"
 #include "math/Vector2.hpp"
 #include "math/Color.hpp"
 #include "graphics/Vertex.hpp"
@@ -43,16 +44,32 @@ namespace ouzel
             bool isRunning() const { return running; }
             bool isActive() const { return active; }
 
+            // runs the update on the job system, the actor of the particle system must not be moved by other updates
+            inline bool isParallelUpdate() const { return updateCallback.parallel; }
+            inline void setParallelUpdate(bool newParallelUpdate) { updateCallback.parallel = newParallelUpdate; }
+
             inline void setPositionType(ParticleSystemData::PositionType newPositionType) { particleSystemData.positionType = newPositionType; }
             inline ParticleSystemData::PositionType getPositionType() const { return particleSystemData.positionType; }
 
+            // moves the particles in the vertex shader, the CPU only spawns them, works only for the gravity emitters
+            // without the radial and tangential acceleration and only with the renderers that have the particle shader
+            void setGPUSimulation(bool newGPUSimulation);
+            inline bool isGPUSimulation() const { return gpuSimulation; }
+            // true if the particles are actually simulated on the GPU
+            inline bool isSimulatedOnGPU() const { return simulatedOnGPU; }
+
         private:
             void update(float delta);
 
             void createParticleMesh();
             void updateParticleMesh();
 
-            void emitParticles(uint32_t count);
+            void emitParticles(uint32_t first, uint32_t count);
+            uint32_t spawnParticles(uint32_t count);
+            void updateBoundingBox();
+            void rebaseSimulationTime();
+            void markInstancesDirty(uint32_t first, uint32_t count);
+            void uploadInstances();
 
             ParticleSystemData particleSystemData;
 
@@ -61,49 +78,67 @@ namespace ouzel
             std::shared_ptr<graphics::Texture> texture;
             std::shared_ptr<graphics::Texture> whitePixelTexture;
 
-            struct Particle
+            // every attribute of the particles is stored in its own array, so that the particles can be updated
+            // four at a time with SIMD
+            enum Field
             {
-                float life = 0.0F;
-
-                Vector2 position;
-
-                float colorRed = 0.0F;
-                float colorGreen = 0.0F;
-                float colorBlue = 0.0F;
-                float colorAlpha = 0.0F;
-
-                float deltaColorRed = 0.0F;
-                float deltaColorGreen = 0.0F;
-                float deltaColorBlue = 0.0F;
-                float deltaColorAlpha = 0.0F;
-
-                float angle = 0.0F;
-                float speed = 0.0F;
-
-                float size = 0.0F;
-                float deltaSize = 0.0F;
-
-                float rotation = 0.0F;
-                float deltaRotation = 0.0F;
+                LIFE,
+                POSITION_X,
+                POSITION_Y,
+                DIRECTION_X,
+                DIRECTION_Y,
+                COLOR_RED,
+                COLOR_GREEN,
+                COLOR_BLUE,
+                COLOR_ALPHA,
+                DELTA_COLOR_RED,
+                DELTA_COLOR_GREEN,
+                DELTA_COLOR_BLUE,
+                DELTA_COLOR_ALPHA,
+                SIZE,
+                DELTA_SIZE,
+                ROTATION,
+                DELTA_ROTATION,
+                RADIAL_ACCELERATION,
+                TANGENTIAL_ACCELERATION,
+                ANGLE,
+                RADIUS,
+                DEGREES_PER_SECOND,
+                DELTA_RADIUS,
+                FIELD_COUNT
+            };
 
-                float radialAcceleration = 0.0F;
-                float tangentialAcceleration = 0.0F;
+            inline float* getField(Field field) { return particleData.data() + field * particleCapacity; }
 
-                Vector2 direction;
-                float radius = 0.0F;
-                float degreesPerSecond = 0.0F;
-                float deltaRadius = 0.0F;
-            };
+            void resizeParticles(uint32_t newCapacity);
+            void moveParticle(uint32_t from, uint32_t to);
 
-            std::vector<Particle> particles;
+            std::vector<float> particleData; // FIELD_COUNT arrays of particleCapacity floats
+            uint32_t particleCapacity = 0;
+            std::vector<float> cornersX;
+            std::vector<float> cornersY;
 
             std::shared_ptr<graphics::Buffer> indexBuffer;
             std::shared_ptr<graphics::Buffer> vertexBuffer;
+            std::shared_ptr<graphics::Buffer> instanceBuffer;
 
             std::vector<uint16_t> indices;
-            std::vector<graphics::Vertex> vertices;
 
-            uint32_t particleCount = 0;
+            uint32_t particleCount = 0; // number of the used slots with the GPU simulation
+
+            bool gpuSimulation = false;
+            bool simulatedOnGPU = false;
+            std::shared_ptr<graphics::Shader> particleShader;
+            // the particles are spawned to the slots in a ring and live in the instance buffer until they die
+            std::vector<graphics::Instance> instances;
+            std::vector<float> deathTimes;
+            std::vector<Box2> lifetimeBoxes; // area that the particle covers during its life
+            uint32_t nextSlot = 0;
+            // ring range of the instances that were changed by the update and are uploaded by the draw
+            uint32_t dirtyInstanceFirst = 0;
+            uint32_t dirtyInstanceCount = 0;
+            float simulationTime = 0.0F;
+            float lastDeathTime = 0.0F;
 
             float emitCounter = 0.0F;
             float elapsed = 0.0F;
@@ -38,6 +38,47 @@ namespace ouzel
                 return a->getOrder() > b->getOrder();
             });
 
+            bool parallel = parallelDraw && layers.size() > 1;
+
+            if (parallel)
+            {
+                // the components record only into the command buffer of their layer, the state that they share
+                // (the font and sprite atlases and the render thread queue) is locked
+                auto recordLayer = [this](size_t index) {
+                    engine->getRenderer()->setCommandBuffer(&layers[index]->commandBuffer);
+
+                    try
+                    {
+                        layers[index]->draw();
+                    }
+                    catch (...)
+                    {
+                        engine->getRenderer()->setCommandBuffer(nullptr);
+                        throw;
+                    }
+
+                    engine->getRenderer()->setCommandBuffer(nullptr);
+                };
+
+                JobSystem::Group group;
+
+                for (size_t i = 1; i < layers.size(); ++i)
+                    engine->getJobSystem()->run(group, std::bind(recordLayer, i));
+
+                try
+                {
+                    recordLayer(0);
+                }
+                catch (...)
+                {
+                    // the jobs reference the layers, so they have to finish before unwinding
+                    try { engine->getJobSystem()->wait(group); } catch (...) {}
+                    throw;
+                }
+
+                engine->getJobSystem()->wait(group);
+            }
+
             std::set<graphics::Texture*> clearedRenderTargets;
 
             for (Layer* layer : layers)
@@ -49,7 +90,11 @@ namespace ouzel
                         engine->getRenderer()->clear(camera->getRenderTarget());
                 }
 
-                layer->draw();
+                // layers are submitted in the draw order, no matter in which order they were recorded
+                if (parallel)
+                    engine->getRenderer()->submitCommandBuffer(layer->commandBuffer);
+                else
+                    layer->draw();
             }
         }
 
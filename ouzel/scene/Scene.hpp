@@ -30,6 +30,10 @@ namespace ouzel
 
             virtual void draw();
 
+            // records the commands of the layers on the job system, layers must not share mutable state while drawing
+            inline bool isParallelDraw() const { return parallelDraw; }
+            inline void setParallelDraw(bool newParallelDraw) { parallelDraw = newParallelDraw; }
+
             virtual void addLayer(Layer* layer);
 
             template<typename T> void addLayer(const std::unique_ptr<T>& layer)
@@ -84,6 +88,7 @@ namespace ouzel
             std::unordered_map<uint64_t, std::pair<Actor*, ouzel::Vector3>> pointerDownOnActors;
 
             bool entered = false;
+            bool parallelDraw = false;
         };
     } // namespace scene
 } // namespace ouzel
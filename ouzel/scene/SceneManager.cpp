@@ -5,7 +5,10 @@
 #include "SceneManager.hpp"
 #include "Scene.hpp"
 #include "Actor.hpp"
+#include "Layer.hpp"
+#include "core/Engine.hpp"
 #include "thread/Lock.hpp"
+#include "utils/Profiler.hpp"
 
 namespace ouzel
 {
@@ -35,6 +38,8 @@ namespace ouzel
 
         void SceneManager::update()
         {
+            ProfilerZone zone("SceneManager::update");
+
             executeAllOnUpdateThread();
 
             std::chrono::steady_clock::time_point currentTime = std::chrono::steady_clock::now();
@@ -47,51 +52,96 @@ namespace ouzel
                 previousUpdateTime = currentTime;
                 float delta = std::chrono::duration_cast<std::chrono::microseconds>(diff).count() / 1000000.0F;
 
-                for (UpdateCallback* updateCallback : updateCallbackDeleteSet)
                 {
-                    auto i = std::find(updateCallbacks.begin(), updateCallbacks.end(), updateCallback);
+                    Lock lock(updateCallbackMutex);
 
-                    if (i != updateCallbacks.end())
-                        updateCallbacks.erase(i);
-                }
+                    for (UpdateCallback* updateCallback : updateCallbackDeleteSet)
+                    {
+                        auto i = std::find(updateCallbacks.begin(), updateCallbacks.end(), updateCallback);
 
-                updateCallbackDeleteSet.clear();
+                        if (i != updateCallbacks.end())
+                            updateCallbacks.erase(i);
+                    }
 
-                for (UpdateCallback* updateCallback : updateCallbackAddSet)
-                {
-                    auto i = std::find(updateCallbacks.begin(), updateCallbacks.end(), updateCallback);
+                    updateCallbackDeleteSet.clear();
 
-                    if (i == updateCallbacks.end())
+                    for (UpdateCallback* updateCallback : updateCallbackAddSet)
                     {
-                        auto upperBound = std::upper_bound(updateCallbacks.begin(), updateCallbacks.end(), updateCallback,
-                                                           [](const UpdateCallback* a, const UpdateCallback* b) {
-                                                               return a->priority > b->priority;
-                                                           });
+                        auto i = std::find(updateCallbacks.begin(), updateCallbacks.end(), updateCallback);
+
+                        if (i == updateCallbacks.end())
+                        {
+                            auto upperBound = std::upper_bound(updateCallbacks.begin(), updateCallbacks.end(), updateCallback,
+                                                               [](const UpdateCallback* a, const UpdateCallback* b) {
+                                                                   return a->priority > b->priority;
+                                                               });
 
-                        updateCallbacks.insert(upperBound, updateCallback);
+                            updateCallbacks.insert(upperBound, updateCallback);
+                        }
                     }
+
+                    updateCallbackAddSet.clear();
                 }
 
-                updateCallbackAddSet.clear();
+                // consecutive parallel callbacks are run as one batch of jobs, the batch is finished before the next
+                // serial callback and before the scene is drawn
+                JobSystem::Group batch;
+                bool batchRunning = false;
 
                 for (UpdateCallback* updateCallback : updateCallbacks)
                 {
-                    auto i = std::find(updateCallbackDeleteSet.begin(), updateCallbackDeleteSet.end(), updateCallback);
+                    {
+                        Lock lock(updateCallbackMutex);
+                        if (updateCallbackDeleteSet.find(updateCallback) != updateCallbackDeleteSet.end()) continue;
+                    }
+
+                    updateCallback->timeSinceLastUpdate += delta;
 
-                    if (i == updateCallbackDeleteSet.end())
+                    if (updateCallback->timeSinceLastUpdate >= updateCallback->interval)
                     {
-                        updateCallback->timeSinceLastUpdate += delta;
+                        updateCallback->timeSinceLastUpdate = (updateCallback->interval > 0.0F) ? fmodf(updateCallback->timeSinceLastUpdate, updateCallback->interval) : 0.0F;
 
-                        if (updateCallback->timeSinceLastUpdate >= updateCallback->interval)
+                        if (!updateCallback->callback) continue;
+
+                        if (updateCallback->parallel)
+                        {
+                            if (!batchRunning)
+                            {
+                                // resolve the pending transforms before they are read by the parallel callbacks
+                                updateTransforms();
+                                batchRunning = true;
+                            }
+
+                            engine->getJobSystem()->run(batch, [updateCallback, delta]() {
+                                updateCallback->callback(delta);
+                            });
+                        }
+                        else
                         {
-                            updateCallback->timeSinceLastUpdate = (updateCallback->interval > 0.0F) ? fmodf(updateCallback->timeSinceLastUpdate, updateCallback->interval) : 0.0F;
-                            if (updateCallback->callback) updateCallback->callback(delta);
+                            if (batchRunning)
+                            {
+                                engine->getJobSystem()->wait(batch);
+                                batchRunning = false;
+                            }
+
+                            updateCallback->callback(delta);
                         }
                     }
                 }
+
+                if (batchRunning) engine->getJobSystem()->wait(batch);
             }
         }
 
+        void SceneManager::updateTransforms()
+        {
+            if (scenes.empty()) return;
+
+            for (Layer* layer : scenes.back()->getLayers())
+                if (TransformSystem* transformSystem = layer->getTransformSystem())
+                    transformSystem->update();
+        }
+
         void SceneManager::setScene(Scene* scene)
         {
             assert(scene);
@@ -148,6 +198,8 @@ namespace ouzel
 
             callback->sceneManager = this;
 
+            Lock lock(updateCallbackMutex);
+
             updateCallbackAddSet.insert(callback);
 
             auto setIterator = updateCallbackDeleteSet.find(callback);
@@ -161,6 +213,8 @@ namespace ouzel
             if (callback->sceneManager == this)
                 callback->sceneManager = nullptr;
 
+            Lock lock(updateCallbackMutex);
+
             updateCallbackDeleteSet.insert(callback);
 
             auto setIterator = updateCallbackAddSet.find(callback);
@@ -13,6 +13,7 @@
 namespace ouzel
 {
     class Engine;
+    class EngineHeadless;
 
     namespace scene
     {
@@ -22,6 +23,7 @@ namespace ouzel
         class SceneManager final
         {
             friend Engine;
+            friend EngineHeadless;
         public:
             ~SceneManager();
 
@@ -66,6 +68,7 @@ namespace ouzel
         private:
             void update();
             void executeAllOnUpdateThread();
+            void updateTransforms();
 
             std::vector<Scene*> scenes;
             std::vector<std::unique_ptr<Scene>> ownedScenes;
@@ -75,6 +78,7 @@ namespace ouzel
             std::vector<UpdateCallback*> updateCallbacks;
             std::set<UpdateCallback*> updateCallbackAddSet;
             std::set<UpdateCallback*> updateCallbackDeleteSet;
+            Mutex updateCallbackMutex; // parallel callbacks can schedule and unschedule updates
 
             std::queue<std::function<void(void)>> updateThreadExecuteQueue;
             Mutex updateThreadExecuteMutex;
@@ -1,11 +1,14 @@
 // Copyright 2015-2018 Elviss Strazdins. All rights reserved.
 
 #include <cassert>
+#include <unordered_map>
 #include "ShapeRenderer.hpp"
 #include "core/Engine.hpp"
+#include "graphics/RenderDevice.hpp"
 #include "graphics/Renderer.hpp"
 #include "graphics/BufferResource.hpp"
 #include "Camera.hpp"
+#include "utils/Errors.hpp"
 #include "utils/Utils.hpp"
 
 namespace ouzel
@@ -19,10 +22,10 @@ namespace ouzel
             blendState = engine->getCache()->getBlendState(graphics::BLEND_ALPHA);
 
             indexBuffer = std::make_shared<graphics::Buffer>(*engine->getRenderer());
-            indexBuffer->init(graphics::Buffer::Usage::INDEX, graphics::Buffer::DYNAMIC);
+            indexBuffer->init(graphics::Buffer::Usage::INDEX, graphics::Buffer::STREAMING);
 
             vertexBuffer = std::make_shared<graphics::Buffer>(*engine->getRenderer());
-            vertexBuffer->init(graphics::Buffer::Usage::VERTEX, graphics::Buffer::DYNAMIC);
+            vertexBuffer->init(graphics::Buffer::Usage::VERTEX, graphics::Buffer::STREAMING);
         }
 
         void ShapeRenderer::draw(const Matrix4& transformMatrix,
@@ -37,32 +40,128 @@ namespace ouzel
 
             if (dirty)
             {
-                indexBuffer->setData(indices.data(), static_cast<uint32_t>(getVectorSize(indices)));
-                vertexBuffer->setData(vertices.data(), static_cast<uint32_t>(getVectorSize(vertices)));
+                uploadMesh();
                 dirty = false;
             }
 
             Matrix4 modelViewProj = renderViewProjection * transformMatrix;
             float colorVector[] = {1.0F, 1.0F, 1.0F, opacity};
 
-            for (const DrawCommand& drawCommand : drawCommands)
+            for (const Chunk& chunk : chunks)
             {
-                std::vector<std::vector<float>> fragmentShaderConstants(1);
-                fragmentShaderConstants[0] = {std::begin(colorVector), std::end(colorVector)};
-
-                std::vector<std::vector<float>> vertexShaderConstants(1);
-                vertexShaderConstants[0] = {std::begin(modelViewProj.m), std::end(modelViewProj.m)};
-
                 engine->getRenderer()->setCullMode(graphics::Renderer::CullMode::NONE);
                 engine->getRenderer()->setPipelineState(blendState, shader);
-                engine->getRenderer()->setShaderConstants(fragmentShaderConstants,
-                                                          vertexShaderConstants);
+                engine->getRenderer()->setShaderConstants(colorVector,
+                                                          sizeof(colorVector) / sizeof(float),
+                                                          modelViewProj.m,
+                                                          sizeof(modelViewProj.m) / sizeof(float));
                 engine->getRenderer()->draw(indexBuffer,
-                                            drawCommand.indexCount,
-                                            sizeof(uint16_t),
+                                            chunk.indexCount,
+                                            indexSize,
                                             vertexBuffer,
-                                            drawCommand.mode,
-                                            drawCommand.startIndex);
+                                            chunk.mode,
+                                            chunk.startIndex,
+                                            chunk.baseVertex);
+            }
+        }
+
+        void ShapeRenderer::uploadMesh()
+        {
+            chunks.clear();
+
+            if (indices.empty()) return;
+
+            // 16-bit indices are used while they can address all the vertices, otherwise 32-bit indices or, if the
+            // device doesn't support them, chunks of 16-bit indices
+            if (vertices.size() <= 65536 || engine->getRenderer()->getDevice()->isUInt32IndicesSupported())
+            {
+                if (vertices.size() <= 65536)
+                {
+                    indexSize = sizeof(uint16_t);
+
+                    shortIndices.resize(indices.size());
+                    for (size_t i = 0; i < indices.size(); ++i)
+                        shortIndices[i] = static_cast<uint16_t>(indices[i]);
+
+                    indexBuffer->setData(shortIndices.data(), static_cast<uint32_t>(getVectorSize(shortIndices)));
+                }
+                else
+                {
+                    indexSize = sizeof(uint32_t);
+
+                    indexBuffer->setData(indices.data(), static_cast<uint32_t>(getVectorSize(indices)));
+                }
+
+                vertexBuffer->setData(vertices.data(), static_cast<uint32_t>(getVectorSize(vertices)));
+
+                for (const DrawCommand& drawCommand : drawCommands)
+                    chunks.push_back(Chunk{drawCommand.mode, drawCommand.startIndex, drawCommand.indexCount, 0});
+            }
+            else
+            {
+                // the vertices of every chunk are copied after the vertices of the previous chunk, so that the
+                // primitives that reference distant vertices (like the center of a filled circle) can be split too
+                indexSize = sizeof(uint16_t);
+                shortIndices.clear();
+                chunkVertices.clear();
+
+                std::unordered_map<uint32_t, uint16_t> chunkIndices;
+
+                for (const DrawCommand& drawCommand : drawCommands)
+                {
+                    bool strip = drawCommand.mode == graphics::Renderer::DrawMode::LINE_STRIP ||
+                        drawCommand.mode == graphics::Renderer::DrawMode::TRIANGLE_STRIP;
+                    uint32_t primitiveSize = (drawCommand.mode == graphics::Renderer::DrawMode::LINE_LIST ||
+                                              drawCommand.mode == graphics::Renderer::DrawMode::LINE_STRIP) ? 2 : 3;
+                    uint32_t endIndex = drawCommand.startIndex + drawCommand.indexCount;
+
+                    Chunk chunk{drawCommand.mode, 0, 0, 0};
+
+                    for (uint32_t i = drawCommand.startIndex; i + primitiveSize <= endIndex; i += strip ? 1 : primitiveSize)
+                    {
+                        uint32_t newVertexCount = 0;
+                        for (uint32_t p = i; p < i + primitiveSize; ++p)
+                            if (chunkIndices.find(indices[p]) == chunkIndices.end()) ++newVertexCount;
+
+                        if (chunk.indexCount && chunkIndices.size() + newVertexCount > 65536)
+                        {
+                            chunks.push_back(chunk);
+                            chunk.indexCount = 0;
+                        }
+
+                        // a strip is restarted in every chunk, the culling is disabled, so the winding of the
+                        // restarted triangle strip does not matter
+                        if (!chunk.indexCount)
+                        {
+                            chunkIndices.clear();
+                            chunk.startIndex = static_cast<uint32_t>(shortIndices.size());
+                            chunk.baseVertex = static_cast<uint32_t>(chunkVertices.size());
+                        }
+
+                        for (uint32_t p = (strip && chunk.indexCount) ? i + primitiveSize - 1 : i; p < i + primitiveSize; ++p)
+                        {
+                            auto chunkIndex = chunkIndices.find(indices[p]);
+
+                            if (chunkIndex == chunkIndices.end())
+                            {
+                                uint16_t index = static_cast<uint16_t>(chunkVertices.size() - chunk.baseVertex);
+                                chunkIndex = chunkIndices.insert(std::make_pair(indices[p], index)).first;
+                                chunkVertices.push_back(vertices[indices[p]]);
+                            }
+
+                            shortIndices.push_back(chunkIndex->second);
+                            ++chunk.indexCount;
+                        }
+                    }
+
+                    if (chunk.indexCount) chunks.push_back(chunk);
+                }
+
+                if (!shortIndices.empty())
+                {
+                    indexBuffer->setData(shortIndices.data(), static_cast<uint32_t>(getVectorSize(shortIndices)));
+                    vertexBuffer->setData(chunkVertices.data(), static_cast<uint32_t>(getVectorSize(chunkVertices)));
+                }
             }
         }
 
@@ -84,7 +183,7 @@ namespace ouzel
             DrawCommand command;
             command.startIndex = static_cast<uint32_t>(indices.size());
 
-            uint16_t startVertex = static_cast<uint16_t>(vertices.size());
+            uint32_t startVertex = static_cast<uint32_t>(vertices.size());
 
             if (thickness == 0.0F)
             {
@@ -154,7 +253,7 @@ namespace ouzel
             DrawCommand command;
             command.startIndex = static_cast<uint32_t>(indices.size());
 
-            uint16_t startVertex = static_cast<uint16_t>(vertices.size());
+            uint32_t startVertex = static_cast<uint32_t>(vertices.size());
 
             if (fill)
             {
@@ -171,7 +270,7 @@ namespace ouzel
 
                 command.indexCount = segments * 2 + 1;
 
-                for (uint16_t i = 0; i < segments; ++i)
+                for (uint32_t i = 0; i < segments; ++i)
                 {
                     indices.push_back(startVertex + i + 1);
                     indices.push_back(startVertex); // center
@@ -197,7 +296,7 @@ namespace ouzel
 
                     command.indexCount = segments + 1;
 
-                    for (uint16_t i = 0; i < segments; ++i)
+                    for (uint32_t i = 0; i < segments; ++i)
                         indices.push_back(startVertex + i);
 
                     indices.push_back(startVertex);
@@ -227,7 +326,7 @@ namespace ouzel
 
                     command.indexCount = segments * 6;
 
-                    for (uint16_t i = 0; i < segments; ++i)
+                    for (uint32_t i = 0; i < segments; ++i)
                     {
                         if (i < segments - 1)
                         {
@@ -268,7 +367,7 @@ namespace ouzel
             DrawCommand command;
             command.startIndex = static_cast<uint32_t>(indices.size());
 
-            uint16_t startVertex = static_cast<uint16_t>(vertices.size());
+            uint32_t startVertex = static_cast<uint32_t>(vertices.size());
 
             if (fill)
             {
@@ -416,25 +515,25 @@ namespace ouzel
             DrawCommand command;
             command.startIndex = static_cast<uint32_t>(indices.size());
 
-            uint16_t startVertex = static_cast<uint16_t>(vertices.size());
+            uint32_t startVertex = static_cast<uint32_t>(vertices.size());
 
             if (fill)
             {
                 command.mode = graphics::Renderer::DrawMode::TRIANGLE_LIST;
 
-                for (uint16_t i = 0; i < edges.size(); ++i)
+                for (size_t i = 0; i < edges.size(); ++i)
                     vertices.push_back(graphics::Vertex(edges[i], color, Vector2(), Vector3(0.0F, 0.0F, -1.0F)));
 
                 command.indexCount = static_cast<uint32_t>(edges.size() - 2) * 3;
 
-                for (uint16_t i = 1; i < edges.size() - 1; ++i)
+                for (uint32_t i = 1; i < edges.size() - 1; ++i)
                 {
                     indices.push_back(startVertex);
                     indices.push_back(startVertex + i);
                     indices.push_back(startVertex + i + 1);
                 }
 
-                for (uint16_t i = 0; i < edges.size(); ++i)
+                for (size_t i = 0; i < edges.size(); ++i)
                     boundingBox.insertPoint(edges[i]);
             }
             else
@@ -443,17 +542,17 @@ namespace ouzel
                 {
                     command.mode = graphics::Renderer::DrawMode::LINE_STRIP;
 
-                    for (uint16_t i = 0; i < edges.size(); ++i)
+                    for (size_t i = 0; i < edges.size(); ++i)
                         vertices.push_back(graphics::Vertex(edges[i], color, Vector2(), Vector3(0.0F, 0.0F, -1.0F)));
 
                     command.indexCount = static_cast<uint32_t>(edges.size()) + 1;
 
-                    for (uint16_t i = 0; i < edges.size(); ++i)
+                    for (size_t i = 0; i < edges.size(); ++i)
                         indices.push_back(startVertex + i);
 
                     indices.push_back(startVertex);
 
-                    for (uint16_t i = 0; i < edges.size(); ++i)
+                    for (size_t i = 0; i < edges.size(); ++i)
                         boundingBox.insertPoint(edges[i]);
                 }
                 else
@@ -488,7 +587,7 @@ namespace ouzel
             DrawCommand command;
             command.startIndex = static_cast<uint32_t>(indices.size());
 
-            uint16_t startVertex = static_cast<uint16_t>(vertices.size());
+            uint32_t startVertex = static_cast<uint32_t>(vertices.size());
 
             if (thickness == 0.0F)
             {
@@ -497,9 +596,9 @@ namespace ouzel
 
                 if (controlPoints.size() == 2)
                 {
-                    for (uint16_t i = 0; i < controlPoints.size(); ++i)
+                    for (size_t i = 0; i < controlPoints.size(); ++i)
                     {
-                        indices.push_back(startVertex + static_cast<uint16_t>(command.indexCount));
+                        indices.push_back(startVertex + command.indexCount);
                         ++command.indexCount;
                         vertices.push_back(graphics::Vertex(controlPoints[i], color, Vector2(), Vector3(0.0F, 0.0F, -1.0F)));
                         boundingBox.insertPoint(controlPoints[i]);
@@ -515,13 +614,13 @@ namespace ouzel
 
                         graphics::Vertex vertex(Vector3(), color, Vector2(), Vector3(0.0F, 0.0F, -1.0F));
 
-                        for (uint16_t n = 0; n < controlPoints.size(); ++n)
+                        for (uint32_t n = 0; n < controlPoints.size(); ++n)
                         {
                             vertex.position += static_cast<float>(binomialCoefficients[n]) * powf(t, n) *
                                                powf(1.0F - t, static_cast<float>(controlPoints.size() - n - 1)) * controlPoints[n];
                         }
 
-                        indices.push_back(startVertex + static_cast<uint16_t>(command.indexCount));
+                        indices.push_back(startVertex + command.indexCount);
                         ++command.indexCount;
                         vertices.push_back(vertex);
                         boundingBox.insertPoint(vertex.position);
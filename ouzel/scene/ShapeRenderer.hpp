@@ -69,15 +69,30 @@ namespace ouzel
                 uint32_t startIndex;
             };
 
+            // part of a draw command whose vertices can be addressed with the index size from the base vertex
+            struct Chunk
+            {
+                graphics::Renderer::DrawMode mode;
+                uint32_t startIndex;
+                uint32_t indexCount;
+                uint32_t baseVertex;
+            };
+
+            void uploadMesh();
+
             std::shared_ptr<graphics::Shader> shader;
             std::shared_ptr<graphics::BlendState> blendState;
             std::shared_ptr<graphics::Buffer> indexBuffer;
             std::shared_ptr<graphics::Buffer> vertexBuffer;
 
             std::vector<DrawCommand> drawCommands;
+            std::vector<Chunk> chunks;
 
-            std::vector<uint16_t> indices;
+            std::vector<uint32_t> indices;
+            std::vector<uint16_t> shortIndices; // indices converted to the 16-bit format
             std::vector<ouzel::graphics::Vertex> vertices;
+            std::vector<ouzel::graphics::Vertex> chunkVertices; // vertices copied for every chunk
+            uint32_t indexSize = sizeof(uint16_t);
             bool dirty = false;
         };
     } // namespace scene
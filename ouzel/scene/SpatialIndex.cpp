@@ -0,0 +1,344 @@
+// Copyright 2015-2018 Elviss Strazdins. All rights reserved.
+
+#include <algorithm>
+#include <cassert>
+#include "SpatialIndex.hpp"
+
+namespace ouzel
+{
+    namespace scene
+    {
+        static const float BOX_MARGIN = 0.1F; // fraction of the box size that is added on each side
+
+        static inline Box2 mergeBoxes(const Box2& a, const Box2& b)
+        {
+            return Box2(Vector2(std::min(a.min.x, b.min.x), std::min(a.min.y, b.min.y)),
+                        Vector2(std::max(a.max.x, b.max.x), std::max(a.max.y, b.max.y)));
+        }
+
+        static inline float getPerimeter(const Box2& box)
+        {
+            return 2.0F * ((box.max.x - box.min.x) + (box.max.y - box.min.y));
+        }
+
+        static inline bool containsBox(const Box2& outer, const Box2& inner)
+        {
+            return outer.min.x <= inner.min.x && outer.min.y <= inner.min.y &&
+                inner.max.x <= outer.max.x && inner.max.y <= outer.max.y;
+        }
+
+        static inline Box2 fattenBox(const Box2& box)
+        {
+            Vector2 margin((box.max.x - box.min.x) * BOX_MARGIN, (box.max.y - box.min.y) * BOX_MARGIN);
+            return Box2(box.min - margin, box.max + margin);
+        }
+
+        int32_t SpatialIndex::insert(Actor* actor, const Box2& box)
+        {
+            int32_t leaf = allocateNode();
+            Node& node = nodes[static_cast<size_t>(leaf)];
+            node.box = fattenBox(box);
+            node.actor = actor;
+            node.height = 0;
+
+            insertLeaf(leaf);
+            ++leafCount;
+
+            return leaf;
+        }
+
+        void SpatialIndex::remove(int32_t node)
+        {
+            assert(node >= 0 && static_cast<size_t>(node) < nodes.size() && nodes[static_cast<size_t>(node)].isLeaf());
+
+            removeLeaf(node);
+            freeNode(node);
+            --leafCount;
+        }
+
+        bool SpatialIndex::update(int32_t node, const Box2& box)
+        {
+            assert(node >= 0 && static_cast<size_t>(node) < nodes.size() && nodes[static_cast<size_t>(node)].isLeaf());
+
+            if (containsBox(nodes[static_cast<size_t>(node)].box, box)) return false;
+
+            removeLeaf(node);
+            nodes[static_cast<size_t>(node)].box = fattenBox(box);
+            insertLeaf(node);
+
+            return true;
+        }
+
+        void SpatialIndex::clear()
+        {
+            nodes.clear();
+            root = NULL_NODE;
+            freeList = NULL_NODE;
+            leafCount = 0;
+        }
+
+        void SpatialIndex::query(const Vector2& point, std::vector<Actor*>& result) const
+        {
+            if (root == NULL_NODE) return;
+
+            stack.clear();
+            stack.push_back(root);
+
+            while (!stack.empty())
+            {
+                const Node& node = nodes[static_cast<size_t>(stack.back())];
+                stack.pop_back();
+
+                if (!node.box.containsPoint(point)) continue;
+
+                if (node.isLeaf())
+                    result.push_back(node.actor);
+                else
+                {
+                    stack.push_back(node.left);
+                    stack.push_back(node.right);
+                }
+            }
+        }
+
+        void SpatialIndex::query(const Box2& box, std::vector<Actor*>& result) const
+        {
+            if (root == NULL_NODE) return;
+
+            stack.clear();
+            stack.push_back(root);
+
+            while (!stack.empty())
+            {
+                const Node& node = nodes[static_cast<size_t>(stack.back())];
+                stack.pop_back();
+
+                if (!node.box.intersects(box)) continue;
+
+                if (node.isLeaf())
+                    result.push_back(node.actor);
+                else
+                {
+                    stack.push_back(node.left);
+                    stack.push_back(node.right);
+                }
+            }
+        }
+
+        int32_t SpatialIndex::allocateNode()
+        {
+            int32_t node;
+
+            if (freeList != NULL_NODE)
+            {
+                node = freeList;
+                freeList = nodes[static_cast<size_t>(node)].parent;
+                nodes[static_cast<size_t>(node)] = Node();
+            }
+            else
+            {
+                node = static_cast<int32_t>(nodes.size());
+                nodes.push_back(Node());
+            }
+
+            return node;
+        }
+
+        void SpatialIndex::freeNode(int32_t node)
+        {
+            Node& freedNode = nodes[static_cast<size_t>(node)];
+            freedNode.actor = nullptr;
+            freedNode.left = freedNode.right = NULL_NODE;
+            freedNode.height = -1;
+            freedNode.parent = freeList;
+            freeList = node;
+        }
+
+        void SpatialIndex::insertLeaf(int32_t leaf)
+        {
+            if (root == NULL_NODE)
+            {
+                root = leaf;
+                nodes[static_cast<size_t>(leaf)].parent = NULL_NODE;
+                return;
+            }
+
+            // find the best sibling by the surface area heuristic (perimeter in 2D)
+            Box2 leafBox = nodes[static_cast<size_t>(leaf)].box;
+            int32_t index = root;
+
+            while (!nodes[static_cast<size_t>(index)].isLeaf())
+            {
+                const Node& node = nodes[static_cast<size_t>(index)];
+
+                float perimeter = getPerimeter(node.box);
+                float combinedPerimeter = getPerimeter(mergeBoxes(node.box, leafBox));
+
+                // cost of creating a new parent for this node and the new leaf
+                float cost = 2.0F * combinedPerimeter;
+                // minimum cost of pushing the leaf further down the tree
+                float inheritanceCost = 2.0F * (combinedPerimeter - perimeter);
+
+                auto getDescendCost = [this, &leafBox, inheritanceCost](int32_t child) {
+                    const Node& childNode = nodes[static_cast<size_t>(child)];
+                    float mergedPerimeter = getPerimeter(mergeBoxes(leafBox, childNode.box));
+                    return childNode.isLeaf() ?
+                        mergedPerimeter + inheritanceCost :
+                        mergedPerimeter - getPerimeter(childNode.box) + inheritanceCost;
+                };
+
+                float leftCost = getDescendCost(node.left);
+                float rightCost = getDescendCost(node.right);
+
+                if (cost < leftCost && cost < rightCost) break;
+
+                index = (leftCost < rightCost) ? node.left : node.right;
+            }
+
+            int32_t sibling = index;
+            int32_t oldParent = nodes[static_cast<size_t>(sibling)].parent;
+            int32_t newParent = allocateNode(); // may reallocate the nodes
+
+            Node& parentNode = nodes[static_cast<size_t>(newParent)];
+            parentNode.parent = oldParent;
+            parentNode.box = mergeBoxes(leafBox, nodes[static_cast<size_t>(sibling)].box);
+            parentNode.height = nodes[static_cast<size_t>(sibling)].height + 1;
+            parentNode.left = sibling;
+            parentNode.right = leaf;
+
+            if (oldParent != NULL_NODE)
+            {
+                Node& oldParentNode = nodes[static_cast<size_t>(oldParent)];
+                if (oldParentNode.left == sibling) oldParentNode.left = newParent;
+                else oldParentNode.right = newParent;
+            }
+            else
+                root = newParent;
+
+            nodes[static_cast<size_t>(sibling)].parent = newParent;
+            nodes[static_cast<size_t>(leaf)].parent = newParent;
+
+            fixUpwards(newParent);
+        }
+
+        void SpatialIndex::removeLeaf(int32_t leaf)
+        {
+            if (leaf == root)
+            {
+                root = NULL_NODE;
+                return;
+            }
+
+            int32_t parent = nodes[static_cast<size_t>(leaf)].parent;
+            int32_t grandParent = nodes[static_cast<size_t>(parent)].parent;
+            int32_t sibling = (nodes[static_cast<size_t>(parent)].left == leaf) ?
+                nodes[static_cast<size_t>(parent)].right :
+                nodes[static_cast<size_t>(parent)].left;
+
+            if (grandParent != NULL_NODE)
+            {
+                // replace the parent with the sibling
+                Node& grandParentNode = nodes[static_cast<size_t>(grandParent)];
+                if (grandParentNode.left == parent) grandParentNode.left = sibling;
+                else grandParentNode.right = sibling;
+
+                nodes[static_cast<size_t>(sibling)].parent = grandParent;
+                freeNode(parent);
+
+                fixUpwards(grandParent);
+            }
+            else
+            {
+                root = sibling;
+                nodes[static_cast<size_t>(sibling)].parent = NULL_NODE;
+                freeNode(parent);
+            }
+        }
+
+        void SpatialIndex::fixUpwards(int32_t node)
+        {
+            while (node != NULL_NODE)
+            {
+                node = balance(node);
+
+                Node& current = nodes[static_cast<size_t>(node)];
+                const Node& left = nodes[static_cast<size_t>(current.left)];
+                const Node& right = nodes[static_cast<size_t>(current.right)];
+
+                current.height = 1 + std::max(left.height, right.height);
+                current.box = mergeBoxes(left.box, right.box);
+
+                node = current.parent;
+            }
+        }
+
+        // performs a left or right rotation if the node is imbalanced, returns the new root of the subtree
+        int32_t SpatialIndex::balance(int32_t a)
+        {
+            Node& nodeA = nodes[static_cast<size_t>(a)];
+
+            if (nodeA.isLeaf() || nodeA.height < 2) return a;
+
+            int32_t b = nodeA.left;
+            int32_t c = nodeA.right;
+            Node& nodeB = nodes[static_cast<size_t>(b)];
+            Node& nodeC = nodes[static_cast<size_t>(c)];
+
+            int32_t difference = nodeC.height - nodeB.height;
+
+            // rotate the higher child up
+            auto rotate = [this, a, &nodeA](int32_t up, int32_t other, bool upIsRight) {
+                Node& upNode = nodes[static_cast<size_t>(up)];
+                int32_t f = upNode.left;
+                int32_t g = upNode.right;
+                Node& nodeF = nodes[static_cast<size_t>(f)];
+                Node& nodeG = nodes[static_cast<size_t>(g)];
+                const Node& otherNode = nodes[static_cast<size_t>(other)];
+
+                upNode.left = a;
+                upNode.parent = nodeA.parent;
+                nodeA.parent = up;
+
+                if (upNode.parent != NULL_NODE)
+                {
+                    Node& parentNode = nodes[static_cast<size_t>(upNode.parent)];
+                    if (parentNode.left == a) parentNode.left = up;
+                    else parentNode.right = up;
+                }
+                else
+                    root = up;
+
+                // the higher grandchild stays under the rotated node, the lower one goes to the old root
+                int32_t keep = (nodeF.height > nodeG.height) ? f : g;
+                int32_t move = (keep == f) ? g : f;
+                Node& keepNode = nodes[static_cast<size_t>(keep)];
+                Node& moveNode = nodes[static_cast<size_t>(move)];
+
+                upNode.right = keep;
+
+                if (upIsRight) nodeA.right = move;
+                else nodeA.left = move;
+                moveNode.parent = a;
+
+                nodeA.box = mergeBoxes(otherNode.box, moveNode.box);
+                upNode.box = mergeBoxes(nodeA.box, keepNode.box);
+
+                nodeA.height = 1 + std::max(otherNode.height, moveNode.height);
+                upNode.height = 1 + std::max(nodeA.height, keepNode.height);
+            };
+
+            if (difference > 1)
+            {
+                rotate(c, b, true);
+                return c;
+            }
+            else if (difference < -1)
+            {
+                rotate(b, c, false);
+                return b;
+            }
+
+            return a;
+        }
+    } // namespace scene
+} // namespace ouzel
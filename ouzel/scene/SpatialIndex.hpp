@@ -0,0 +1,71 @@
+// Copyright 2015-2018 Elviss Strazdins. All rights reserved.
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "math/Box2.hpp"
+#include "math/Vector2.hpp"
+
+namespace ouzel
+{
+    namespace scene
+    {
+        class Actor;
+
+        // dynamic bounding volume tree of the actors' world space bounding boxes, the leaves are kept in fattened
+        // boxes, so that small movements of the actors don't change the tree
+        class SpatialIndex final
+        {
+        public:
+            static const int32_t NULL_NODE = -1;
+
+            SpatialIndex() {}
+
+            SpatialIndex(const SpatialIndex&) = delete;
+            SpatialIndex& operator=(const SpatialIndex&) = delete;
+
+            SpatialIndex(SpatialIndex&&) = delete;
+            SpatialIndex& operator=(SpatialIndex&&) = delete;
+
+            int32_t insert(Actor* actor, const Box2& box);
+            void remove(int32_t node);
+            // returns true if the leaf had to be moved
+            bool update(int32_t node, const Box2& box);
+            void clear();
+
+            void query(const Vector2& point, std::vector<Actor*>& result) const;
+            void query(const Box2& box, std::vector<Actor*>& result) const;
+
+            inline uint32_t getLeafCount() const { return leafCount; }
+            inline int32_t getHeight() const { return (root == NULL_NODE) ? 0 : nodes[static_cast<size_t>(root)].height; }
+
+        private:
+            struct Node
+            {
+                Box2 box;
+                Actor* actor = nullptr;
+                int32_t parent = NULL_NODE; // next free node for the nodes in the free list
+                int32_t left = NULL_NODE;
+                int32_t right = NULL_NODE;
+                int32_t height = -1;
+
+                inline bool isLeaf() const { return left == NULL_NODE; }
+            };
+
+            int32_t allocateNode();
+            void freeNode(int32_t node);
+
+            void insertLeaf(int32_t leaf);
+            void removeLeaf(int32_t leaf);
+            int32_t balance(int32_t node);
+            void fixUpwards(int32_t node);
+
+            std::vector<Node> nodes;
+            int32_t root = NULL_NODE;
+            int32_t freeList = NULL_NODE;
+            uint32_t leafCount = 0;
+            mutable std::vector<int32_t> stack;
+        };
+    } // namespace scene
+} // namespace ouzel
@@ -8,6 +8,7 @@
 #include "SceneManager.hpp"
 #include "files/FileSystem.hpp"
 #include "Layer.hpp"
+#include "SpriteBatch.hpp"
 #include "assets/Cache.hpp"
 
 namespace ouzel
@@ -209,12 +210,6 @@ namespace ouzel
                 Matrix4 modelViewProj = renderViewProjection * transformMatrix * offsetMatrix;
                 float colorVector[] = {material->diffuseColor.normR(), material->diffuseColor.normG(), material->diffuseColor.normB(), material->diffuseColor.normA() * opacity * material->opacity};
 
-                std::vector<std::vector<float>> fragmentShaderConstants(1);
-                fragmentShaderConstants[0] = {std::begin(colorVector), std::end(colorVector)};
-
-                std::vector<std::vector<float>> vertexShaderConstants(1);
-                vertexShaderConstants[0] = {std::begin(modelViewProj.m), std::end(modelViewProj.m)};
-
                 std::vector<std::shared_ptr<graphics::Texture>> textures;
                 if (wireframe) textures.push_back(whitePixelTexture);
                 else textures.assign(std::begin(material->textures), std::end(material->textures));
@@ -222,8 +217,10 @@ namespace ouzel
                 engine->getRenderer()->setCullMode(material->cullMode);
                 engine->getRenderer()->setPipelineState(material->blendState,
                                                         material->shader);
-                engine->getRenderer()->setShaderConstants(fragmentShaderConstants,
-                                                          vertexShaderConstants);
+                engine->getRenderer()->setShaderConstants(colorVector,
+                                                          sizeof(colorVector) / sizeof(float),
+                                                          modelViewProj.m,
+                                                          sizeof(modelViewProj.m) / sizeof(float));
                 engine->getRenderer()->setTextures(textures);
 
                 const SpriteData::Frame& frame = currentAnimation->animation->frames[currentFrame];
@@ -237,6 +234,31 @@ namespace ouzel
             }
         }
 
+        bool Sprite::batch(SpriteBatch& spriteBatch,
+                           const Matrix4& transformMatrix,
+                           float opacity)
+        {
+            if (currentAnimation != animationQueue.end() &&
+                currentAnimation->animation->frameInterval > 0.0F &&
+                !currentAnimation->animation->frames.empty() &&
+                material)
+            {
+                size_t currentFrame = static_cast<size_t>(currentTime / currentAnimation->animation->frameInterval);
+                if (currentFrame >= currentAnimation->animation->frames.size()) currentFrame = currentAnimation->animation->frames.size() - 1;
+
+                const SpriteData::Frame& frame = currentAnimation->animation->frames[currentFrame];
+
+                return spriteBatch.add(*material,
+                                       opacity,
+                                       transformMatrix * offsetMatrix,
+                                       frame.getIndices(),
+                                       frame.getVertices());
+            }
+
+            // nothing to draw
+            return true;
+        }
+
         void Sprite::setOffset(const Vector2& newOffset)
         {
             offset = newOffset;
@@ -42,6 +42,9 @@ namespace ouzel
                               float opacity,
                               const Matrix4& renderViewProjection,
                               bool wireframe) override;
+            virtual bool batch(SpriteBatch& spriteBatch,
+                               const Matrix4& transformMatrix,
+                               float opacity) override;
 
             inline const std::shared_ptr<graphics::Material>& getMaterial() const { return material; }
             inline void setMaterial(const std::shared_ptr<graphics::Material>& newMaterial) { material = newMaterial; }
@@ -0,0 +1,206 @@
+// Copyright 2015-2018 Elviss Strazdins. All rights reserved.
+
+#include <algorithm>
+#include <limits>
+#include "SpriteBatch.hpp"
+#include "core/Engine.hpp"
+#include "utils/Utils.hpp"
+
+namespace ouzel
+{
+    namespace scene
+    {
+        void SpriteBatch::reset()
+        {
+            indices.clear();
+            vertices.clear();
+            instances.clear();
+            drawCount = 0;
+            batchedCount = 0;
+        }
+
+        void SpriteBatch::begin(const Matrix4& newRenderViewProjection)
+        {
+            renderViewProjection = newRenderViewProjection;
+            active = true;
+        }
+
+        void SpriteBatch::end()
+        {
+            flush();
+            active = false;
+        }
+
+        bool SpriteBatch::add(const graphics::Material& material,
+                              float opacity,
+                              const Matrix4& transformMatrix,
+                              const std::vector<uint16_t>& newIndices,
+                              const std::vector<graphics::Vertex>& newVertices)
+        {
+            if (!active || newIndices.empty() ||
+                newVertices.size() > std::numeric_limits<uint16_t>::max() + 1U)
+                return false;
+
+            float newColorVector[] = {material.diffuseColor.normR(), material.diffuseColor.normG(), material.diffuseColor.normB(), material.diffuseColor.normA() * opacity * material.opacity};
+
+            bool sameState = !indices.empty() &&
+                vertices.size() + newVertices.size() <= std::numeric_limits<uint16_t>::max() + 1U &&
+                blendState == material.blendState &&
+                shader == material.shader &&
+                cullMode == material.cullMode &&
+                std::equal(std::begin(colorVector), std::end(colorVector), std::begin(newColorVector)) &&
+                std::equal(textures.begin(), textures.end(), std::begin(material.textures));
+
+            if (!sameState)
+            {
+                flush();
+
+                blendState = material.blendState;
+                shader = material.shader;
+                cullMode = material.cullMode;
+                std::copy(std::begin(newColorVector), std::end(newColorVector), std::begin(colorVector));
+                textures.assign(std::begin(material.textures), std::end(material.textures));
+            }
+
+            uint16_t startVertex = static_cast<uint16_t>(vertices.size());
+
+            for (uint16_t index : newIndices)
+                indices.push_back(static_cast<uint16_t>(startVertex + index));
+
+            for (const graphics::Vertex& newVertex : newVertices)
+            {
+                graphics::Vertex vertex = newVertex;
+                transformMatrix.transformPoint(vertex.position);
+                transformMatrix.transformVector(vertex.normal);
+                vertex.normal.normalize();
+                vertices.push_back(vertex);
+            }
+
+            ++batchedCount;
+
+            return true;
+        }
+
+        bool SpriteBatch::addInstance(const graphics::Material& material,
+                                      float opacity,
+                                      const Matrix4& transformMatrix,
+                                      const std::shared_ptr<graphics::Shader>& instancedShader,
+                                      const std::shared_ptr<graphics::Buffer>& newMeshIndexBuffer,
+                                      uint32_t newMeshIndexCount,
+                                      uint32_t newMeshIndexSize,
+                                      const std::shared_ptr<graphics::Buffer>& newMeshVertexBuffer)
+        {
+            if (!active || !instancedShader || !newMeshIndexBuffer || !newMeshVertexBuffer || !newMeshIndexCount)
+                return false;
+
+            bool sameState = !instances.empty() &&
+                meshIndexBuffer == newMeshIndexBuffer &&
+                meshIndexCount == newMeshIndexCount &&
+                meshIndexSize == newMeshIndexSize &&
+                meshVertexBuffer == newMeshVertexBuffer &&
+                blendState == material.blendState &&
+                shader == instancedShader &&
+                cullMode == material.cullMode &&
+                std::equal(textures.begin(), textures.end(), std::begin(material.textures));
+
+            if (!sameState)
+            {
+                flush();
+
+                meshIndexBuffer = newMeshIndexBuffer;
+                meshIndexCount = newMeshIndexCount;
+                meshIndexSize = newMeshIndexSize;
+                meshVertexBuffer = newMeshVertexBuffer;
+                blendState = material.blendState;
+                shader = instancedShader;
+                cullMode = material.cullMode;
+                textures.assign(std::begin(material.textures), std::end(material.textures));
+            }
+
+            // the color of the material is applied per instance, so instances with different colors share the draw call
+            graphics::Instance instance;
+            std::copy(std::begin(transformMatrix.m), std::end(transformMatrix.m), std::begin(instance.transform));
+            instance.color[0] = material.diffuseColor.normR();
+            instance.color[1] = material.diffuseColor.normG();
+            instance.color[2] = material.diffuseColor.normB();
+            instance.color[3] = material.diffuseColor.normA() * opacity * material.opacity;
+            instances.push_back(instance);
+
+            ++batchedCount;
+
+            return true;
+        }
+
+        void SpriteBatch::flush()
+        {
+            if (!instances.empty())
+            {
+                if (!instanceBuffer)
+                {
+                    instanceBuffer = std::make_shared<graphics::Buffer>(*engine->getRenderer());
+                    instanceBuffer->init(graphics::Buffer::Usage::VERTEX, graphics::Buffer::STREAMING);
+                }
+
+                instanceBuffer->setData(instances.data(), static_cast<uint32_t>(getVectorSize(instances)));
+
+                float instanceColorVector[] = {1.0F, 1.0F, 1.0F, 1.0F};
+
+                engine->getRenderer()->setCullMode(cullMode);
+                engine->getRenderer()->setPipelineState(blendState, shader);
+                engine->getRenderer()->setShaderConstants(instanceColorVector,
+                                                          sizeof(instanceColorVector) / sizeof(float),
+                                                          renderViewProjection.m,
+                                                          sizeof(renderViewProjection.m) / sizeof(float));
+                engine->getRenderer()->setTextures(textures);
+                engine->getRenderer()->drawInstanced(meshIndexBuffer,
+                                                     meshIndexCount,
+                                                     meshIndexSize,
+                                                     meshVertexBuffer,
+                                                     instanceBuffer,
+                                                     static_cast<uint32_t>(instances.size()),
+                                                     graphics::Renderer::DrawMode::TRIANGLE_LIST,
+                                                     0);
+
+                ++drawCount;
+
+                instances.clear();
+                meshIndexBuffer.reset();
+                meshVertexBuffer.reset();
+            }
+
+            if (indices.empty()) return;
+
+            if (!indexBuffer)
+            {
+                indexBuffer = std::make_shared<graphics::Buffer>(*engine->getRenderer());
+                indexBuffer->init(graphics::Buffer::Usage::INDEX, graphics::Buffer::STREAMING);
+
+                vertexBuffer = std::make_shared<graphics::Buffer>(*engine->getRenderer());
+                vertexBuffer->init(graphics::Buffer::Usage::VERTEX, graphics::Buffer::STREAMING);
+            }
+
+            // every upload of a streaming buffer gets its own range, so the data of the previous batches is not overwritten
+            indexBuffer->setData(indices.data(), static_cast<uint32_t>(getVectorSize(indices)));
+            vertexBuffer->setData(vertices.data(), static_cast<uint32_t>(getVectorSize(vertices)));
+
+            engine->getRenderer()->setCullMode(cullMode);
+            engine->getRenderer()->setPipelineState(blendState, shader);
+            engine->getRenderer()->setShaderConstants(colorVector,
+                                                      sizeof(colorVector) / sizeof(float),
+                                                      renderViewProjection.m,
+                                                      sizeof(renderViewProjection.m) / sizeof(float));
+            engine->getRenderer()->setTextures(textures);
+            engine->getRenderer()->draw(indexBuffer,
+                                        static_cast<uint32_t>(indices.size()),
+                                        sizeof(uint16_t),
+                                        vertexBuffer,
+                                        graphics::Renderer::DrawMode::TRIANGLE_LIST,
+                                        0);
+
+            ++drawCount;
+
+            indices.clear();
+            vertices.clear();
+        }
+    } // namespace scene
+} // namespace ouzel
@@ -0,0 +1,82 @@
+// Copyright 2015-2018 Elviss Strazdins. All rights reserved.
+
+#pragma once
+
+#include <memory>
+#include <vector>
+#include "graphics/Buffer.hpp"
+#include "graphics/Material.hpp"
+#include "graphics/Renderer.hpp"
+#include "graphics/Vertex.hpp"
+#include "math/Matrix4.hpp"
+
+namespace ouzel
+{
+    namespace scene
+    {
+        // merges adjacent draws that share the same render state into a single pre-transformed draw call, adjacent
+        // draws of the same mesh are merged into a single instanced draw call
+        class SpriteBatch final
+        {
+        public:
+            SpriteBatch() {}
+
+            SpriteBatch(const SpriteBatch&) = delete;
+            SpriteBatch& operator=(const SpriteBatch&) = delete;
+
+            SpriteBatch(SpriteBatch&&) = delete;
+            SpriteBatch& operator=(SpriteBatch&&) = delete;
+
+            void reset();
+            void begin(const Matrix4& newRenderViewProjection);
+            void end();
+
+            inline bool isActive() const { return active; }
+
+            bool add(const graphics::Material& material,
+                     float opacity,
+                     const Matrix4& transformMatrix,
+                     const std::vector<uint16_t>& newIndices,
+                     const std::vector<graphics::Vertex>& newVertices);
+            bool addInstance(const graphics::Material& material,
+                             float opacity,
+                             const Matrix4& transformMatrix,
+                             const std::shared_ptr<graphics::Shader>& instancedShader,
+                             const std::shared_ptr<graphics::Buffer>& newMeshIndexBuffer,
+                             uint32_t newMeshIndexCount,
+                             uint32_t newMeshIndexSize,
+                             const std::shared_ptr<graphics::Buffer>& newMeshVertexBuffer);
+            void flush();
+
+            inline uint32_t getDrawCount() const { return drawCount; }
+            inline uint32_t getBatchedCount() const { return batchedCount; }
+
+        private:
+            bool active = false;
+            Matrix4 renderViewProjection;
+
+            std::shared_ptr<graphics::BlendState> blendState;
+            std::shared_ptr<graphics::Shader> shader;
+            std::vector<std::shared_ptr<graphics::Texture>> textures;
+            graphics::Renderer::CullMode cullMode = graphics::Renderer::CullMode::NONE;
+            float colorVector[4];
+
+            std::vector<uint16_t> indices;
+            std::vector<graphics::Vertex> vertices;
+
+            std::shared_ptr<graphics::Buffer> indexBuffer;
+            std::shared_ptr<graphics::Buffer> vertexBuffer;
+
+            std::vector<graphics::Instance> instances;
+            std::shared_ptr<graphics::Buffer> meshIndexBuffer;
+            uint32_t meshIndexCount = 0;
+            uint32_t meshIndexSize = 0;
+            std::shared_ptr<graphics::Buffer> meshVertexBuffer;
+
+            std::shared_ptr<graphics::Buffer> instanceBuffer;
+
+            uint32_t drawCount = 0;
+            uint32_t batchedCount = 0;
+        };
+    } // namespace scene
+} // namespace ouzel
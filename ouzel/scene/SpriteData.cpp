@@ -17,7 +17,7 @@ namespace ouzel
                                  const Vector2& pivot):
             name(frameName)
         {
-            std::vector<uint16_t> indices = {0, 1, 2, 1, 3, 2};
+            indices = {0, 1, 2, 1, 3, 2};
             indexCount = static_cast<uint32_t>(indices.size());
 
             Vector2 textCoords[4];
@@ -51,7 +51,7 @@ namespace ouzel
                 textCoords[3] = Vector2(rightBottom.x, rightBottom.y);
             }
 
-            std::vector<graphics::Vertex> vertices = {
+            vertices = {
                 graphics::Vertex(Vector3(finalOffset.x, finalOffset.y, 0.0F), Color::WHITE,
                                  textCoords[0], Vector3(0.0F, 0.0F, -1.0F)),
                 graphics::Vertex(Vector3(finalOffset.x + frameRectangle.size.width, finalOffset.y, 0.0F), Color::WHITE,
@@ -72,9 +72,11 @@ namespace ouzel
         }
 
         SpriteData::Frame::Frame(const std::string& frameName,
-                                 const std::vector<uint16_t>& indices,
-                                 const std::vector<graphics::Vertex>& vertices):
-            name(frameName)
+                                 const std::vector<uint16_t>& initIndices,
+                                 const std::vector<graphics::Vertex>& initVertices):
+            name(frameName),
+            indices(initIndices),
+            vertices(initVertices)
         {
             indexCount = static_cast<uint32_t>(indices.size());
 
@@ -89,13 +91,15 @@ namespace ouzel
         }
 
         SpriteData::Frame::Frame(const std::string& frameName,
-                                 const std::vector<uint16_t>& indices,
-                                 const std::vector<graphics::Vertex>& vertices,
+                                 const std::vector<uint16_t>& initIndices,
+                                 const std::vector<graphics::Vertex>& initVertices,
                                  const Rect& frameRectangle,
                                  const Size2& sourceSize,
                                  const Vector2& sourceOffset,
                                  const Vector2& pivot):
-            name(frameName)
+            name(frameName),
+            indices(initIndices),
+            vertices(initVertices)
         {
             indexCount = static_cast<uint32_t>(indices.size());
 
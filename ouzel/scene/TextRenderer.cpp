@@ -1,10 +1,15 @@
 // Copyright 2015-2018 Elviss Strazdins. All rights reserved.
 
+#include <algorithm>
+#include <iterator>
+#include <unordered_map>
 #include "TextRenderer.hpp"
 #include "core/Engine.hpp"
+#include "graphics/RenderDevice.hpp"
 #include "graphics/Renderer.hpp"
 #include "scene/Camera.hpp"
 #include "assets/Cache.hpp"
+#include "utils/Errors.hpp"
 #include "utils/Utils.hpp"
 
 namespace ouzel
@@ -39,9 +44,9 @@ namespace ouzel
             updateText();
         }
 
-        void TextRenderer::setFont(const std::string& fontFile)
+        void TextRenderer::setFont(const std::string& fontFile, bool distanceField)
         {
-            font = engine->getCache()->getFont(fontFile);
+            font = engine->getCache()->getFont(fontFile, mipmaps, distanceField);
 
             updateText();
         }
@@ -72,39 +77,136 @@ namespace ouzel
 
             if (needsMeshUpdate)
             {
-                indexBuffer->setData(indices.data(), static_cast<uint32_t>(getVectorSize(indices)));
-                vertexBuffer->setData(vertices.data(), static_cast<uint32_t>(getVectorSize(vertices)));
+                uploadIndices();
 
+                // only the vertices of the changed lines are uploaded
+                if (dirtyVertex < vertices.size())
+                    vertexBuffer->setData(vertices.data() + dirtyVertex,
+                                          static_cast<uint32_t>((vertices.size() - dirtyVertex) * sizeof(graphics::Vertex)),
+                                          static_cast<uint32_t>(dirtyVertex * sizeof(graphics::Vertex)));
+
+                dirtyIndex = static_cast<uint32_t>(indices.size());
+                dirtyVertex = static_cast<uint32_t>(vertices.size());
                 needsMeshUpdate = false;
             }
 
-            Matrix4 modelViewProj = renderViewProjection * transformMatrix;
-            float colorVector[] = {color.normR(), color.normG(), color.normB(), color.normA() * opacity};
+            // the vertical anchor and the row of the first line are applied here, so that adding or removing lines
+            // does not move the vertices of the other lines
+            float firstRow = lines.empty() ? 0.0F : static_cast<float>(lines.front().row);
 
-            std::vector<std::vector<float>> fragmentShaderConstants(1);
-            fragmentShaderConstants[0] = {std::begin(colorVector), std::end(colorVector)};
+            Matrix4 anchorTransform;
+            Matrix4::createTranslation(0.0F, getAnchorOffset() + firstRow * lineHeight, 0.0F, anchorTransform);
 
-            std::vector<std::vector<float>> vertexShaderConstants(1);
-            vertexShaderConstants[0] = {std::begin(modelViewProj.m), std::end(modelViewProj.m)};
+            Matrix4 modelViewProj = renderViewProjection * transformMatrix * anchorTransform;
+            float colorVector[] = {color.normR(), color.normG(), color.normB(), color.normA() * opacity};
 
             engine->getRenderer()->setCullMode(graphics::Renderer::CullMode::NONE);
             engine->getRenderer()->setPipelineState(blendState, shader);
-            engine->getRenderer()->setShaderConstants(fragmentShaderConstants,
-                                                      vertexShaderConstants);
+            engine->getRenderer()->setShaderConstants(colorVector,
+                                                      sizeof(colorVector) / sizeof(float),
+                                                      modelViewProj.m,
+                                                      sizeof(modelViewProj.m) / sizeof(float));
             engine->getRenderer()->setTextures({wireframe ? whitePixelTexture : texture});
-            engine->getRenderer()->draw(indexBuffer,
-                                        static_cast<uint32_t>(indices.size()),
-                                        sizeof(uint16_t),
-                                        vertexBuffer,
-                                        graphics::Renderer::DrawMode::TRIANGLE_LIST,
-                                        0);
+
+            for (const Chunk& chunk : chunks)
+                engine->getRenderer()->draw(indexBuffer,
+                                            chunk.indexCount,
+                                            indexSize,
+                                            vertexBuffer,
+                                            graphics::Renderer::DrawMode::TRIANGLE_LIST,
+                                            chunk.startIndex,
+                                            chunk.baseVertex);
+        }
+
+        void TextRenderer::uploadIndices()
+        {
+            if (indices.empty())
+            {
+                chunks.clear();
+                return;
+            }
+
+            // the indices before the first line belong to the removed lines
+            uint32_t startIndex = lines.front().firstIndex;
+
+            // 16-bit indices are used while they can address all the vertices
+            if (vertices.size() <= 65536)
+            {
+                // the indices before the dirty one are already uploaded if the format did not change
+                uint32_t firstIndex = (indexSize == sizeof(uint16_t) && !chunkedIndices) ? dirtyIndex : 0;
+
+                indexSize = sizeof(uint16_t);
+                chunkedIndices = false;
+
+                shortIndices.resize(indices.size());
+                for (size_t i = firstIndex; i < indices.size(); ++i)
+                    shortIndices[i] = static_cast<uint16_t>(indices[i]);
+
+                if (firstIndex < indices.size())
+                    indexBuffer->setData(shortIndices.data() + firstIndex,
+                                         static_cast<uint32_t>((shortIndices.size() - firstIndex) * sizeof(uint16_t)),
+                                         static_cast<uint32_t>(firstIndex * sizeof(uint16_t)));
+
+                chunks.assign(1, Chunk{startIndex, static_cast<uint32_t>(indices.size()) - startIndex, 0});
+            }
+            else if (engine->getRenderer()->getDevice()->isUInt32IndicesSupported())
+            {
+                uint32_t firstIndex = (indexSize == sizeof(uint32_t)) ? dirtyIndex : 0;
+
+                indexSize = sizeof(uint32_t);
+                chunkedIndices = false;
+
+                if (firstIndex < indices.size())
+                    indexBuffer->setData(indices.data() + firstIndex,
+                                         static_cast<uint32_t>((indices.size() - firstIndex) * sizeof(uint32_t)),
+                                         static_cast<uint32_t>(firstIndex * sizeof(uint32_t)));
+
+                chunks.assign(1, Chunk{startIndex, static_cast<uint32_t>(indices.size()) - startIndex, 0});
+            }
+            else
+            {
+                // the triangles are split into chunks whose vertices can be addressed with 16-bit indices from the
+                // base vertex of the chunk
+                indexSize = sizeof(uint16_t);
+                chunkedIndices = true;
+                shortIndices.resize(indices.size());
+                chunks.clear();
+
+                Chunk chunk{startIndex, 0, 0};
+
+                for (uint32_t i = startIndex; i + 2 < indices.size(); i += 3)
+                {
+                    uint32_t minIndex = std::min(indices[i], std::min(indices[i + 1], indices[i + 2]));
+                    uint32_t maxIndex = std::max(indices[i], std::max(indices[i + 1], indices[i + 2]));
+
+                    if (chunk.indexCount == 0)
+                        chunk.baseVertex = minIndex;
+                    else if (minIndex < chunk.baseVertex || maxIndex - chunk.baseVertex > 65535)
+                    {
+                        chunks.push_back(chunk);
+                        chunk = {i, 0, minIndex};
+                    }
+
+                    if (maxIndex - chunk.baseVertex > 65535)
+                        throw DataError("Triangle vertices are too far apart");
+
+                    shortIndices[i + 0] = static_cast<uint16_t>(indices[i + 0] - chunk.baseVertex);
+                    shortIndices[i + 1] = static_cast<uint16_t>(indices[i + 1] - chunk.baseVertex);
+                    shortIndices[i + 2] = static_cast<uint16_t>(indices[i + 2] - chunk.baseVertex);
+                    chunk.indexCount += 3;
+                }
+
+                if (chunk.indexCount) chunks.push_back(chunk);
+
+                indexBuffer->setData(shortIndices.data(), static_cast<uint32_t>(getVectorSize(shortIndices)), 0);
+            }
         }
 
         void TextRenderer::setText(const std::string& newText)
         {
             text = newText;
 
-            updateText();
+            updateText(false);
         }
 
         void TextRenderer::setColor(const Color& newColor)
@@ -112,24 +214,201 @@ namespace ouzel
             color = newColor;
         }
 
-        void TextRenderer::updateText()
+        void TextRenderer::setShader(const std::shared_ptr<graphics::Shader>& newShader)
+        {
+            shader = newShader;
+            customShader = true;
+        }
+
+        void TextRenderer::updateText(bool layoutAll)
         {
             boundingBox.reset();
 
-            if (font)
-            {
-                font->getVertices(text, Color::WHITE, fontSize, textAnchor, indices, vertices, texture);
-                needsMeshUpdate = true;
-
-                for (const graphics::Vertex& vertex : vertices)
-                    boundingBox.insertPoint(Vector2(vertex.position.x, vertex.position.y));
-            }
-            else
+            if (!font)
             {
+                lines.clear();
                 indices.clear();
                 vertices.clear();
+                chunks.clear();
                 texture.reset();
+                dirtyIndex = 0;
+                dirtyVertex = 0;
+                return;
             }
+
+            if (!customShader)
+            {
+                shader = font->getShader();
+                if (!shader) shader = engine->getCache()->getShader(graphics::SHADER_TEXTURE);
+            }
+
+            lineHeight = font->getLineHeight(fontSize);
+
+            // a line feed at the end of the text does not start a new line, the same as in the fonts
+            std::vector<std::string> newLines;
+
+            for (size_t start = 0; start < text.size();)
+            {
+                size_t end = text.find('\n', start);
+                if (end == std::string::npos) end = text.size();
+
+                newLines.push_back(text.substr(start, end - start));
+                start = end + 1;
+            }
+
+            for (uint32_t attempt = 0;; ++attempt)
+            {
+                size_t removed = 0;
+                size_t unchanged = 0;
+
+                if (layoutAll)
+                    texture.reset();
+                else
+                {
+                    // the lines removed from the front (e.g. of a scrolling console) are skipped, so that the lines
+                    // after them keep their regions of the buffers
+                    for (removed = 0; removed < lines.size(); ++removed)
+                    {
+                        while (removed + unchanged < lines.size() && unchanged < newLines.size() &&
+                               lines[removed + unchanged].text == newLines[unchanged])
+                            ++unchanged;
+
+                        if (unchanged > 0) break;
+                    }
+
+                    if (unchanged == 0) removed = 0;
+                }
+
+                // the old lines that were removed or moved keep their layout
+                std::vector<Line> oldLines(std::make_move_iterator(lines.begin()),
+                                           std::make_move_iterator(lines.begin() + static_cast<std::ptrdiff_t>(removed)));
+                oldLines.insert(oldLines.end(),
+                                std::make_move_iterator(lines.begin() + static_cast<std::ptrdiff_t>(removed + unchanged)),
+                                std::make_move_iterator(lines.end()));
+                std::unordered_multimap<std::string, size_t> oldLineIndices;
+
+                if (!layoutAll)
+                    for (size_t i = 0; i < oldLines.size(); ++i)
+                        oldLineIndices.insert(std::make_pair(oldLines[i].text, i));
+
+                lines.erase(lines.begin() + static_cast<std::ptrdiff_t>(removed + unchanged), lines.end());
+                lines.erase(lines.begin(), lines.begin() + static_cast<std::ptrdiff_t>(removed));
+
+                bool textureChanged = false;
+
+                for (size_t i = unchanged; i < newLines.size(); ++i)
+                {
+                    auto oldLineIndex = oldLineIndices.find(newLines[i]);
+
+                    if (oldLineIndex != oldLineIndices.end())
+                    {
+                        lines.push_back(std::move(oldLines[oldLineIndex->second]));
+                        oldLineIndices.erase(oldLineIndex);
+                    }
+                    else
+                    {
+                        Line line;
+                        line.text = newLines[i];
+                        if (layoutLine(line)) textureChanged = true;
+                        lines.push_back(std::move(line));
+                    }
+                }
+
+                // the font replaced its texture, so the texture coordinates of the other lines are not valid anymore
+                if (textureChanged)
+                {
+                    if (attempt > 0)
+                        throw DataError("Glyphs do not fit in the font texture");
+
+                    layoutAll = true;
+                    continue;
+                }
+
+                // the space of the removed lines is reclaimed (and the rows start from zero again) once it is
+                // larger than the space of the lines that are kept
+                if (unchanged > 0)
+                {
+                    const Line& firstLine = lines.front();
+                    const Line& lastLine = lines[unchanged - 1];
+                    uint32_t keptVertexCount = lastLine.firstVertex + static_cast<uint32_t>(lastLine.vertices.size()) - firstLine.firstVertex;
+
+                    if (firstLine.firstVertex > keptVertexCount || firstLine.row > unchanged)
+                        unchanged = 0;
+                }
+
+                uint32_t firstIndex = 0;
+                uint32_t firstVertex = 0;
+                uint32_t row = 0;
+
+                if (unchanged > 0)
+                {
+                    const Line& lastLine = lines[unchanged - 1];
+                    firstIndex = lastLine.firstIndex + static_cast<uint32_t>(lastLine.indices.size());
+                    firstVertex = lastLine.firstVertex + static_cast<uint32_t>(lastLine.vertices.size());
+                    row = lastLine.row + 1;
+                }
+
+                indices.resize(firstIndex);
+                vertices.resize(firstVertex);
+
+                for (size_t i = unchanged; i < lines.size(); ++i, ++row)
+                {
+                    Line& line = lines[i];
+                    line.firstIndex = static_cast<uint32_t>(indices.size());
+                    line.firstVertex = static_cast<uint32_t>(vertices.size());
+                    line.row = row;
+
+                    float offsetY = -static_cast<float>(row) * lineHeight;
+
+                    for (uint32_t index : line.indices)
+                        indices.push_back(line.firstVertex + index);
+
+                    for (graphics::Vertex vertex : line.vertices)
+                    {
+                        vertex.position.y += offsetY;
+                        vertices.push_back(vertex);
+                    }
+                }
+
+                dirtyIndex = layoutAll ? 0 : std::min(dirtyIndex, firstIndex);
+                dirtyVertex = layoutAll ? 0 : std::min(dirtyVertex, firstVertex);
+                break;
+            }
+
+            float anchorOffset = getAnchorOffset();
+
+            for (size_t i = 0; i < lines.size(); ++i)
+            {
+                const Box3& lineBox = lines[i].boundingBox;
+
+                if (!lineBox.isEmpty())
+                {
+                    float offsetY = anchorOffset - static_cast<float>(i) * lineHeight;
+                    boundingBox.insertPoint(Vector2(lineBox.min.x, lineBox.min.y + offsetY));
+                    boundingBox.insertPoint(Vector2(lineBox.max.x, lineBox.max.y + offsetY));
+                }
+            }
+
+            needsMeshUpdate = true;
+        }
+
+        bool TextRenderer::layoutLine(Line& line)
+        {
+            std::shared_ptr<graphics::Texture> lineTexture;
+
+            // the lines are laid out from their top, the vertical anchor is applied to the whole text
+            font->getVertices(line.text, Color::WHITE, fontSize, Vector2(textAnchor.x, 1.0F),
+                              line.indices, line.vertices, lineTexture);
+
+            line.boundingBox.reset();
+
+            for (const graphics::Vertex& vertex : line.vertices)
+                line.boundingBox.insertPoint(Vector2(vertex.position.x, vertex.position.y));
+
+            bool textureChanged = texture && lineTexture != texture;
+            texture = lineTexture;
+
+            return textureChanged;
         }
     } // namespace scene
 } // namespace ouzel
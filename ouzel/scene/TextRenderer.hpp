@@ -3,6 +3,7 @@
 #pragma once
 
 #include <string>
+#include <vector>
 #include "scene/Component.hpp"
 #include "math/Color.hpp"
 #include "gui/BMFont.hpp"
@@ -32,7 +33,7 @@ namespace ouzel
                               const Matrix4& renderViewProjection,
                               bool wireframe) override;
 
-            void setFont(const std::string& fontFile);
+            void setFont(const std::string& fontFile, bool distanceField = false);
 
             inline float getFontSize() const { return fontSize; }
             void setFontSize(float newFontSize);
@@ -47,13 +48,39 @@ namespace ouzel
             void setColor(const Color& newColor);
 
             inline const std::shared_ptr<graphics::Shader>& getShader() const { return shader; }
-            inline void setShader(const std::shared_ptr<graphics::Shader>& newShader) { shader = newShader; }
+            // replaces the shader that the font draws with
+            void setShader(const std::shared_ptr<graphics::Shader>& newShader);
 
             inline const std::shared_ptr<graphics::BlendState>& getBlendState() const { return blendState; }
             inline void setBlendState(const std::shared_ptr<graphics::BlendState>& newBlendState)  { blendState = newBlendState; }
 
         private:
-            void updateText();
+            // range of the indices that is drawn with one draw call
+            struct Chunk
+            {
+                uint32_t startIndex;
+                uint32_t indexCount;
+                uint32_t baseVertex;
+            };
+
+            // laid out text of one line, the vertices are relative to the top of the line
+            struct Line
+            {
+                std::string text;
+                std::vector<uint32_t> indices;
+                std::vector<graphics::Vertex> vertices;
+                Box3 boundingBox;
+                // region of the buffers, the vertices in the buffer are moved down by the row of the line
+                uint32_t firstIndex = 0;
+                uint32_t firstVertex = 0;
+                uint32_t row = 0;
+            };
+
+            // lays out only the lines that changed unless the whole text has to be laid out again
+            void updateText(bool layoutAll = true);
+            bool layoutLine(Line& line);
+            inline float getAnchorOffset() const { return static_cast<float>(lines.size()) * lineHeight * (1.0F - textAnchor.y); }
+            void uploadIndices();
 
             std::shared_ptr<graphics::Shader> shader;
             std::shared_ptr<graphics::BlendState> blendState;
@@ -69,13 +96,25 @@ namespace ouzel
             float fontSize = 1.0F;
             Vector2 textAnchor;
 
-            std::vector<uint16_t> indices;
+            std::vector<Line> lines;
+            float lineHeight = 0.0F;
+
+            std::vector<uint32_t> indices;
+            std::vector<uint16_t> shortIndices; // indices converted to the 16-bit format
             std::vector<graphics::Vertex> vertices;
+            uint32_t indexSize = sizeof(uint16_t);
+            bool chunkedIndices = false;
+            std::vector<Chunk> chunks;
+
+            // the data after these was changed since the last upload
+            uint32_t dirtyIndex = 0;
+            uint32_t dirtyVertex = 0;
 
             Color color = Color::WHITE;
 
             bool mipmaps = true;
             bool needsMeshUpdate = false;
+            bool customShader = false;
         };
     } // namespace scene
 } // namespace ouzel
@@ -0,0 +1,208 @@
+// Copyright 2015-2018 Elviss Strazdins. All rights reserved.
+
+#include <cassert>
+#include "TransformSystem.hpp"
+#include "Actor.hpp"
+
+namespace ouzel
+{
+    namespace scene
+    {
+        // translation * rotation * scale, the same as Actor::calculateLocalTransform
+        static void composeTransform(const Vector3& position,
+                                     const Quaternion& rotation,
+                                     const Vector3& scale,
+                                     Matrix4& dst)
+        {
+            float wx = rotation.w * rotation.x;
+            float wy = rotation.w * rotation.y;
+            float wz = rotation.w * rotation.z;
+
+            float xx = rotation.x * rotation.x;
+            float xy = rotation.x * rotation.y;
+            float xz = rotation.x * rotation.z;
+
+            float yy = rotation.y * rotation.y;
+            float yz = rotation.y * rotation.z;
+
+            float zz = rotation.z * rotation.z;
+
+            dst.m[0] = (1.0F - 2.0F * (yy + zz)) * scale.x;
+            dst.m[1] = 2.0F * (xy + wz) * scale.x;
+            dst.m[2] = 2.0F * (xz - wy) * scale.x;
+            dst.m[3] = 0.0F;
+
+            dst.m[4] = 2.0F * (xy - wz) * scale.y;
+            dst.m[5] = (1.0F - 2.0F * (xx + zz)) * scale.y;
+            dst.m[6] = 2.0F * (yz + wx) * scale.y;
+            dst.m[7] = 0.0F;
+
+            dst.m[8] = 2.0F * (xz + wy) * scale.z;
+            dst.m[9] = 2.0F * (yz - wx) * scale.z;
+            dst.m[10] = (1.0F - 2.0F * (xx + yy)) * scale.z;
+            dst.m[11] = 0.0F;
+
+            dst.m[12] = position.x;
+            dst.m[13] = position.y;
+            dst.m[14] = position.z;
+            dst.m[15] = 1.0F;
+        }
+
+        uint32_t TransformSystem::addActor(Actor* actor, uint32_t parentHandle)
+        {
+            uint32_t levelIndex = (parentHandle == INVALID_HANDLE) ? 0 : slots[parentHandle].level + 1;
+
+            if (levelIndex >= levels.size()) levels.resize(levelIndex + 1);
+
+            uint32_t handle;
+
+            if (freeSlot != INVALID_HANDLE)
+            {
+                handle = freeSlot;
+                freeSlot = slots[handle].index;
+            }
+            else
+            {
+                handle = static_cast<uint32_t>(slots.size());
+                slots.push_back(Slot());
+            }
+
+            Level& level = levels[levelIndex];
+            slots[handle].level = levelIndex;
+            slots[handle].index = static_cast<uint32_t>(level.handles.size());
+
+            level.handles.push_back(handle);
+            level.parentHandles.push_back(parentHandle);
+            level.positions.push_back(Vector3());
+            level.rotations.push_back(Quaternion::identity());
+            level.scales.push_back(Vector3(1.0F, 1.0F, 1.0F));
+            level.localDirty.push_back(1);
+            level.changed.push_back(0);
+            level.localTransforms.push_back(Matrix4::identity());
+            level.worldTransforms.push_back(Matrix4::identity());
+            level.actors.push_back(actor);
+
+            ++actorCount;
+            dirty = true;
+
+            return handle;
+        }
+
+        void TransformSystem::removeActor(uint32_t handle)
+        {
+            assert(handle < slots.size());
+
+            Level& level = levels[slots[handle].level];
+            uint32_t index = slots[handle].index;
+            uint32_t last = static_cast<uint32_t>(level.handles.size() - 1);
+
+            // move the last element of the level to the place of the removed one
+            if (index != last)
+            {
+                level.handles[index] = level.handles[last];
+                level.parentHandles[index] = level.parentHandles[last];
+                level.positions[index] = level.positions[last];
+                level.rotations[index] = level.rotations[last];
+                level.scales[index] = level.scales[last];
+                level.localDirty[index] = level.localDirty[last];
+                level.changed[index] = level.changed[last];
+                level.localTransforms[index] = level.localTransforms[last];
+                level.worldTransforms[index] = level.worldTransforms[last];
+                level.actors[index] = level.actors[last];
+
+                slots[level.handles[index]].index = index;
+            }
+
+            level.handles.pop_back();
+            level.parentHandles.pop_back();
+            level.positions.pop_back();
+            level.rotations.pop_back();
+            level.scales.pop_back();
+            level.localDirty.pop_back();
+            level.changed.pop_back();
+            level.localTransforms.pop_back();
+            level.worldTransforms.pop_back();
+            level.actors.pop_back();
+
+            slots[handle].index = freeSlot;
+            freeSlot = handle;
+
+            while (!levels.empty() && levels.back().handles.empty())
+                levels.pop_back();
+
+            --actorCount;
+        }
+
+        void TransformSystem::setLocalTransform(uint32_t handle,
+                                                const Vector3& position,
+                                                const Quaternion& rotation,
+                                                const Vector3& scale)
+        {
+            assert(handle < slots.size());
+
+            Level& level = levels[slots[handle].level];
+            uint32_t index = slots[handle].index;
+
+            level.positions[index] = position;
+            level.rotations[index] = rotation;
+            level.scales[index] = scale;
+            level.localDirty[index] = 1;
+
+            dirty = true;
+        }
+
+        void TransformSystem::update()
+        {
+            if (!dirty) return;
+
+            for (size_t levelIndex = 0; levelIndex < levels.size(); ++levelIndex)
+            {
+                Level& level = levels[levelIndex];
+                const size_t count = level.handles.size();
+
+                for (size_t i = 0; i < count; ++i)
+                {
+                    bool changed = level.localDirty[i] != 0;
+
+                    if (changed)
+                    {
+                        composeTransform(level.positions[i], level.rotations[i], level.scales[i], level.localTransforms[i]);
+                        level.localDirty[i] = 0;
+                    }
+
+                    if (levelIndex == 0)
+                    {
+                        if (changed) level.worldTransforms[i] = level.localTransforms[i];
+                    }
+                    else
+                    {
+                        const Slot& parentSlot = slots[level.parentHandles[i]];
+                        const Level& parentLevel = levels[levelIndex - 1];
+
+                        assert(parentSlot.level == levelIndex - 1);
+
+                        if (changed || parentLevel.changed[parentSlot.index])
+                        {
+                            Matrix4::multiply(parentLevel.worldTransforms[parentSlot.index],
+                                              level.localTransforms[i],
+                                              level.worldTransforms[i]);
+                            changed = true;
+                        }
+                    }
+
+                    level.changed[i] = changed ? 1 : 0;
+                }
+            }
+
+            dirty = false;
+
+            for (Level& level : levels)
+            {
+                const size_t count = level.handles.size();
+
+                for (size_t i = 0; i < count; ++i)
+                    if (level.changed[i]) level.actors[i]->setWorldTransform(level.worldTransforms[i]);
+            }
+        }
+    } // namespace scene
+} // namespace ouzel
@@ -0,0 +1,77 @@
+// Copyright 2015-2018 Elviss Strazdins. All rights reserved.
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+#include "math/Matrix4.hpp"
+#include "math/Quaternion.hpp"
+#include "math/Vector3.hpp"
+
+namespace ouzel
+{
+    namespace scene
+    {
+        class Actor;
+
+        // stores the transforms of the actors in contiguous arrays grouped by the depth in the hierarchy, so that
+        // the world transforms can be updated in one linear pass, parents always before their children
+        class TransformSystem final
+        {
+        public:
+            static const uint32_t INVALID_HANDLE = 0xFFFFFFFF;
+
+            TransformSystem() {}
+
+            TransformSystem(const TransformSystem&) = delete;
+            TransformSystem& operator=(const TransformSystem&) = delete;
+
+            TransformSystem(TransformSystem&&) = delete;
+            TransformSystem& operator=(TransformSystem&&) = delete;
+
+            // the parent must be added before its children, INVALID_HANDLE for the actors at the root of the layer
+            uint32_t addActor(Actor* actor, uint32_t parentHandle);
+            void removeActor(uint32_t handle);
+
+            void setLocalTransform(uint32_t handle,
+                                   const Vector3& position,
+                                   const Quaternion& rotation,
+                                   const Vector3& scale);
+
+            // recalculates the changed world transforms and passes them to their actors
+            void update();
+
+            inline bool isDirty() const { return dirty; }
+            inline uint32_t getActorCount() const { return actorCount; }
+            inline uint32_t getDepth() const { return static_cast<uint32_t>(levels.size()); }
+
+        private:
+            struct Level
+            {
+                std::vector<uint32_t> handles;
+                std::vector<uint32_t> parentHandles;
+                std::vector<Vector3> positions;
+                std::vector<Quaternion> rotations;
+                std::vector<Vector3> scales;
+                std::vector<uint8_t> localDirty;
+                std::vector<uint8_t> changed;
+                std::vector<Matrix4> localTransforms;
+                std::vector<Matrix4> worldTransforms;
+                std::vector<Actor*> actors;
+            };
+
+            struct Slot
+            {
+                uint32_t level;
+                uint32_t index; // next free slot for the slots in the free list
+            };
+
+            std::vector<Level> levels;
+            std::vector<Slot> slots;
+            uint32_t freeSlot = INVALID_HANDLE;
+            uint32_t actorCount = 0;
+            std::atomic<bool> dirty{false}; // set by the parallel update callbacks
+        };
+    } // namespace scene
+} // namespace ouzel
@@ -25,6 +25,9 @@ namespace ouzel
 
             std::function<void(float)> callback;
             float interval = 0.0F;
+            // parallel callbacks can be run on the worker threads of the job system concurrently with each other,
+            // so they may only change the state of their own objects
+            bool parallel = false;
 
         private:
             int32_t priority;
@@ -0,0 +1,170 @@
+// Copyright 2015-2018 Elviss Strazdins. All rights reserved.
+
+#include "JobSystem.hpp"
+
+namespace ouzel
+{
+    // job system and index of the worker that runs on the current thread
+    static ThreadLocal JobSystem* currentJobSystem = nullptr;
+    static ThreadLocal uint32_t currentWorker = 0;
+
+    JobSystem::JobSystem(uint32_t workerCount):
+        queuedCount(0), nextWorker(0)
+    {
+        workers.reserve(workerCount);
+
+        for (uint32_t i = 0; i < workerCount; ++i)
+            workers.push_back(std::unique_ptr<Worker>(new Worker()));
+
+        // the threads are started after all the deques exist, because the workers steal from each other
+        for (uint32_t i = 0; i < workerCount; ++i)
+            workers[i]->thread = Thread(std::bind(&JobSystem::main, this, i), "Worker");
+    }
+
+    JobSystem::~JobSystem()
+    {
+        {
+            Lock lock(sleepMutex);
+            running = false;
+            sleepCondition.broadcast();
+        }
+
+        for (const std::unique_ptr<Worker>& worker : workers)
+            if (worker->thread.isJoinable()) worker->thread.join();
+    }
+
+    void JobSystem::run(Group& group, const std::function<void()>& job)
+    {
+        ++group.pending;
+
+        if (workers.empty())
+        {
+            Job inlineJob{job, &group};
+            execute(inlineJob);
+            return;
+        }
+
+        // workers push to their own deque, the other threads distribute the jobs between the workers
+        uint32_t index = (currentJobSystem == this) ?
+            currentWorker :
+            nextWorker++ % static_cast<uint32_t>(workers.size());
+
+        {
+            Lock lock(workers[index]->mutex);
+            workers[index]->jobs.push_back({job, &group});
+        }
+
+        ++queuedCount;
+
+        Lock lock(sleepMutex);
+        sleepCondition.signal();
+    }
+
+    void JobSystem::wait(Group& group)
+    {
+        uint32_t index = (currentJobSystem == this) ?
+            currentWorker :
+            nextWorker % static_cast<uint32_t>(workers.empty() ? 1 : workers.size());
+
+        while (group.pending > 0)
+        {
+            if (executeJob(index)) continue;
+
+            // sleep until a job is queued or a job of any group finishes
+            Lock lock(sleepMutex);
+
+            if (group.pending > 0 && queuedCount == 0)
+                sleepCondition.wait(lock);
+        }
+
+        Lock lock(group.exceptionMutex);
+
+        if (group.exception)
+        {
+            std::exception_ptr exception = group.exception;
+            group.exception = nullptr;
+            std::rethrow_exception(exception);
+        }
+    }
+
+    void JobSystem::main(uint32_t index)
+    {
+        currentJobSystem = this;
+        currentWorker = index;
+
+        for (;;)
+        {
+            if (executeJob(index)) continue;
+
+            Lock lock(sleepMutex);
+
+            while (running && queuedCount == 0)
+                sleepCondition.wait(lock);
+
+            if (!running) break;
+        }
+    }
+
+    bool JobSystem::executeJob(uint32_t index)
+    {
+        if (workers.empty() || queuedCount == 0) return false;
+
+        Job job;
+        bool found = false;
+
+        // the newest job of the own deque is the most likely to have its data in the cache
+        if (currentJobSystem == this)
+        {
+            Lock lock(workers[index]->mutex);
+
+            if (!workers[index]->jobs.empty())
+            {
+                job = std::move(workers[index]->jobs.back());
+                workers[index]->jobs.pop_back();
+                found = true;
+            }
+        }
+
+        // steal the oldest job from the other deques
+        for (size_t i = 0; !found && i < workers.size(); ++i)
+        {
+            Worker& victim = *workers[(index + i) % workers.size()];
+
+            Lock lock(victim.mutex);
+
+            if (!victim.jobs.empty())
+            {
+                job = std::move(victim.jobs.front());
+                victim.jobs.pop_front();
+                found = true;
+            }
+        }
+
+        if (!found) return false;
+
+        --queuedCount;
+        execute(job);
+
+        return true;
+    }
+
+    void JobSystem::execute(Job& job)
+    {
+        try
+        {
+            job.function();
+        }
+        catch (...)
+        {
+            Lock lock(job.group->exceptionMutex);
+            if (!job.group->exception) job.group->exception = std::current_exception();
+        }
+
+        // the group can be destroyed by the waiting thread right after this
+        if (--job.group->pending == 0)
+        {
+            Lock lock(sleepMutex);
+            sleepCondition.broadcast();
+        }
+    }
+}
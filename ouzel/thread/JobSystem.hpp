@@ -0,0 +1,86 @@
+// Copyright 2015-2018 Elviss Strazdins. All rights reserved.
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <vector>
+#include "thread/Condition.hpp"
+#include "thread/Mutex.hpp"
+#include "thread/Thread.hpp"
+
+namespace ouzel
+{
+    // runs jobs on a pool of worker threads, every worker has its own deque of jobs and steals jobs from the other
+    // workers when its deque is empty
+    class JobSystem final
+    {
+    public:
+        // set of jobs that can be waited for
+        class Group final
+        {
+            friend JobSystem;
+        public:
+            Group(): pending(0) {}
+
+            Group(const Group&) = delete;
+            Group& operator=(const Group&) = delete;
+
+            Group(Group&&) = delete;
+            Group& operator=(Group&&) = delete;
+
+            inline bool isDone() const { return pending == 0; }
+
+        private:
+            std::atomic<uint32_t> pending;
+            Mutex exceptionMutex;
+            std::exception_ptr exception; // first exception thrown by the jobs of the group
+        };
+
+        // jobs are executed on the calling thread if there are no workers
+        explicit JobSystem(uint32_t workerCount);
+        ~JobSystem();
+
+        JobSystem(const JobSystem&) = delete;
+        JobSystem& operator=(const JobSystem&) = delete;
+
+        JobSystem(JobSystem&&) = delete;
+        JobSystem& operator=(JobSystem&&) = delete;
+
+        void run(Group& group, const std::function<void()>& job);
+        // executes the queued jobs while waiting for the group, rethrows the first exception thrown by its jobs
+        void wait(Group& group);
+
+        inline uint32_t getWorkerCount() const { return static_cast<uint32_t>(workers.size()); }
+
+    private:
+        struct Job
+        {
+            std::function<void()> function;
+            Group* group;
+        };
+
+        struct Worker
+        {
+            Mutex mutex;
+            std::deque<Job> jobs;
+            Thread thread;
+        };
+
+        void main(uint32_t index);
+        bool executeJob(uint32_t index);
+        void execute(Job& job);
+
+        std::vector<std::unique_ptr<Worker>> workers;
+        std::atomic<uint32_t> queuedCount;
+        std::atomic<uint32_t> nextWorker;
+
+        Mutex sleepMutex;
+        Condition sleepCondition;
+        bool running = true;
+    };
+}
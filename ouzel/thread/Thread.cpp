@@ -8,6 +8,7 @@
 
 #include "Thread.hpp"
 #include "utils/Errors.hpp"
+#include "utils/Profiler.hpp"
 
 #if defined(_WIN32)
 static const DWORD MS_VC_EXCEPTION = 0x406D1388;
@@ -188,6 +189,8 @@ namespace ouzel
 
     void Thread::setCurrentThreadName(const std::string& name)
     {
+        Profiler::setCurrentThreadName(name);
+
 #if defined(_MSC_VER)
         THREADNAME_INFO info;
         info.dwType = 0x1000;
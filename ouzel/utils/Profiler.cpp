@@ -0,0 +1,143 @@
+// Copyright 2015-2018 Elviss Strazdins. All rights reserved.
+
+#include "Profiler.hpp"
+#include "thread/Lock.hpp"
+#include "utils/JSON.hpp"
+
+namespace ouzel
+{
+    std::atomic<bool> Profiler::enabled(false);
+    ThreadLocal Profiler::ThreadBuffer* Profiler::currentBuffer = nullptr;
+    Mutex Profiler::bufferMutex;
+    std::vector<std::unique_ptr<Profiler::ThreadBuffer>> Profiler::buffers;
+
+    void Profiler::setEnabled(bool newEnabled)
+    {
+        enabled = newEnabled;
+    }
+
+    void Profiler::setCurrentThreadName(const std::string& name)
+    {
+        ThreadBuffer* buffer = getThreadBuffer();
+
+        Lock lock(bufferMutex);
+        buffer->name = name;
+    }
+
+    void Profiler::addZone(const char* name,
+                           std::chrono::steady_clock::time_point start,
+                           std::chrono::steady_clock::time_point end)
+    {
+        ThreadBuffer* buffer = getThreadBuffer();
+
+        Lock lock(buffer->mutex);
+
+        if (!buffer->zones) buffer->zones.reset(new Zone[RING_SIZE]);
+
+        // the oldest zones are overwritten while the exporting thread can't read them
+        buffer->zones[buffer->count % RING_SIZE] = Zone{name, start, end};
+        ++buffer->count;
+    }
+
+    void Profiler::clear()
+    {
+        Lock lock(bufferMutex);
+
+        for (const std::unique_ptr<ThreadBuffer>& buffer : buffers)
+        {
+            Lock bufferLock(buffer->mutex);
+            buffer->count = 0;
+        }
+    }
+
+    std::vector<uint8_t> Profiler::exportChromeTrace()
+    {
+        Lock lock(bufferMutex);
+
+        bool empty = true;
+        std::chrono::steady_clock::time_point firstStart;
+
+        // the zones are copied, so that the threads that are still profiling are blocked only for a short time
+        std::vector<std::vector<Zone>> bufferZones(buffers.size());
+
+        for (size_t i = 0; i < buffers.size(); ++i)
+        {
+            const std::unique_ptr<ThreadBuffer>& buffer = buffers[i];
+
+            Lock bufferLock(buffer->mutex);
+
+            uint32_t count = buffer->count;
+            uint32_t first = (count > RING_SIZE) ? count - RING_SIZE : 0;
+
+            bufferZones[i].reserve(count - first);
+
+            for (uint32_t index = first; index < count; ++index)
+                bufferZones[i].push_back(buffer->zones[index % RING_SIZE]);
+        }
+
+        for (const std::vector<Zone>& zones : bufferZones)
+        {
+            for (const Zone& zone : zones)
+            {
+                if (empty || zone.start < firstStart)
+                {
+                    firstStart = zone.start;
+                    empty = false;
+                }
+            }
+        }
+
+        json::Data data;
+        data["displayTimeUnit"] = std::string("ms");
+        json::Value& events = data["traceEvents"];
+        events = json::Value::Type::ARRAY;
+
+        for (size_t i = 0; i < buffers.size(); ++i)
+        {
+            const std::unique_ptr<ThreadBuffer>& buffer = buffers[i];
+
+            if (!buffer->name.empty())
+            {
+                json::Value event = json::Value::Type::OBJECT;
+                event["name"] = std::string("thread_name");
+                event["ph"] = std::string("M");
+                event["pid"] = 0U;
+                event["tid"] = buffer->id;
+                event["args"] = json::Value::Type::OBJECT;
+                event["args"]["name"] = buffer->name;
+                events.asArray().push_back(event);
+            }
+
+            for (const Zone& zone : bufferZones[i])
+            {
+                // complete events nest by their time ranges, the timestamps are in microseconds
+                json::Value event = json::Value::Type::OBJECT;
+                event["name"] = std::string(zone.name);
+                event["cat"] = std::string("ouzel");
+                event["ph"] = std::string("X");
+                event["pid"] = 0U;
+                event["tid"] = buffer->id;
+                event["ts"] = std::chrono::duration_cast<std::chrono::nanoseconds>(zone.start - firstStart).count() / 1000.0;
+                event["dur"] = std::chrono::duration_cast<std::chrono::nanoseconds>(zone.end - zone.start).count() / 1000.0;
+                events.asArray().push_back(event);
+            }
+        }
+
+        return data.encode();
+    }
+
+    Profiler::ThreadBuffer* Profiler::getThreadBuffer()
+    {
+        if (!currentBuffer)
+        {
+            Lock lock(bufferMutex);
+
+            std::unique_ptr<ThreadBuffer> buffer(new ThreadBuffer());
+            buffer->id = static_cast<uint32_t>(buffers.size());
+            currentBuffer = buffer.get();
+            buffers.push_back(std::move(buffer));
+        }
+
+        return currentBuffer;
+    }
+}
@@ -0,0 +1,90 @@
+// Copyright 2015-2018 Elviss Strazdins. All rights reserved.
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "thread/Mutex.hpp"
+#include "thread/Thread.hpp"
+
+namespace ouzel
+{
+    // collects the zones of all the threads in per-thread ring buffers, the lock of a buffer is contended only while
+    // the capture is cleared or exported
+    class Profiler final
+    {
+    public:
+        static const uint32_t RING_SIZE = 65536; // the oldest zones of a thread are overwritten
+
+        Profiler() = delete;
+
+        static inline bool isEnabled() { return enabled.load(std::memory_order_relaxed); }
+        static void setEnabled(bool newEnabled);
+
+        static void setCurrentThreadName(const std::string& name);
+
+        // the name must outlive the capture
+        static void addZone(const char* name,
+                            std::chrono::steady_clock::time_point start,
+                            std::chrono::steady_clock::time_point end);
+
+        // the capture can be cleared or exported while the other threads are profiling
+        static void clear();
+        // Chrome trace event format (chrome://tracing)
+        static std::vector<uint8_t> exportChromeTrace();
+
+    private:
+        struct Zone
+        {
+            const char* name;
+            std::chrono::steady_clock::time_point start;
+            std::chrono::steady_clock::time_point end;
+        };
+
+        struct ThreadBuffer
+        {
+            uint32_t id = 0;
+            std::string name;
+            Mutex mutex; // guards the zones and the count
+            std::unique_ptr<Zone[]> zones; // allocated by the first zone of the thread
+            uint32_t count = 0; // number of the zones written, including the overwritten ones
+        };
+
+        static ThreadBuffer* getThreadBuffer();
+
+        static std::atomic<bool> enabled;
+        static ThreadLocal ThreadBuffer* currentBuffer;
+        static Mutex bufferMutex;
+        static std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+    };
+
+    // measures the time from its construction to its destruction, the name has to be a string literal
+    class ProfilerZone final
+    {
+    public:
+        explicit ProfilerZone(const char* initName):
+            name(Profiler::isEnabled() ? initName : nullptr)
+        {
+            if (name) start = std::chrono::steady_clock::now();
+        }
+
+        ~ProfilerZone()
+        {
+            if (name) Profiler::addZone(name, start, std::chrono::steady_clock::now());
+        }
+
+        ProfilerZone(const ProfilerZone&) = delete;
+        ProfilerZone& operator=(const ProfilerZone&) = delete;
+
+        ProfilerZone(ProfilerZone&&) = delete;
+        ProfilerZone& operator=(ProfilerZone&&) = delete;
+
+    private:
+        const char* name;
+        std::chrono::steady_clock::time_point start;
+    };
+}
@@ -0,0 +1,26 @@
+#version 400
+in vec3 position0;
+in vec4 color0;
+in vec2 texCoord0;
+in mat4 instanceTransform0;
+in vec4 instanceColor0;
+uniform mat4 modelViewProj;
+uniform vec4 params;
+uniform vec4 gravity;
+out vec4 exColor;
+out vec2 exTexCoord;
+void main()
+{
+    vec4 motion = instanceTransform0[0];
+    vec4 life = instanceTransform0[1];
+    vec4 rotation = instanceTransform0[2];
+    float age = params.x - life.x;
+    float size = (age >= 0.0 && age <= life.y) ? max(0.0, life.z + life.w * age) : 0.0;
+    float angle = -radians(rotation.x + rotation.y * age);
+    vec2 corner = position0.xy * size;
+    vec2 offset = vec2(corner.x * cos(angle) - corner.y * sin(angle), corner.x * sin(angle) + corner.y * cos(angle));
+    vec2 position = motion.xy + (motion.zw * age + 0.5 * gravity.xy * age * (age + gravity.z)) * params.y + params.zw;
+    gl_Position = modelViewProj * vec4(position + offset, 0.0, 1.0);
+    exColor = color0 * clamp(instanceColor0 + instanceTransform0[3] * age, 0.0, 1.0);
+    exTexCoord = texCoord0;
+}
@@ -0,0 +1,13 @@
+#version 400
+uniform vec4 color;
+uniform sampler2D texture0;
+in vec4 exColor;
+in vec2 exTexCoord;
+out vec4 outColor;
+void main()
+{
+    float distance = texture(texture0, exTexCoord).a;
+    float width = fwidth(distance);
+    float alpha = smoothstep(0.5 - width, 0.5 + width, distance);
+    outColor = vec4(exColor.rgb, exColor.a * alpha) * color;
+}
@@ -0,0 +1,11 @@
+precision mediump float;
+uniform lowp vec4 color;
+uniform lowp sampler2D texture0;
+varying lowp vec4 exColor;
+varying vec2 exTexCoord;
+void main()
+{
+    float distance = texture2D(texture0, exTexCoord).a;
+    float alpha = smoothstep(0.4, 0.6, distance);
+    gl_FragColor = vec4(exColor.rgb, exColor.a * alpha) * color;
+}
@@ -0,0 +1,14 @@
+#version 300 es
+precision mediump float;
+uniform lowp vec4 color;
+uniform lowp sampler2D texture0;
+in lowp vec4 exColor;
+in vec2 exTexCoord;
+out vec4 outColor;
+void main()
+{
+    float distance = texture(texture0, exTexCoord).a;
+    float width = fwidth(distance);
+    float alpha = smoothstep(0.5 - width, 0.5 + width, distance);
+    outColor = vec4(exColor.rgb, exColor.a * alpha) * color;
+}
@@ -0,0 +1,10 @@
+#version 400
+uniform vec4 color;
+uniform sampler2D texture0;
+in vec4 exColor;
+in vec2 exTexCoord;
+out vec4 outColor;
+void main()
+{
+    outColor = vec4(exColor.rgb, exColor.a * texture(texture0, exTexCoord).a) * color;
+}